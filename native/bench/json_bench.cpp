@@ -0,0 +1,579 @@
+/**
+ * @file json_bench.cpp
+ * @brief Host microbenchmarks of the JSON hot paths (PlatformIO env:native_bench)
+ *
+ * Builds the component set of a backups/*.json fixture, lets it run for a
+ * simulated minute so every component has output data, then measures:
+ *   - ComponentDataAggregator::collect (GET /api/components/data)
+ *   - ComponentDataAggregator::filter, core and diagnostics modes
+ *   - ComponentDataAggregator::collectDelta (GET /api/components/delta), full
+ *     resync and an idle poll with nothing changed
+ *   - BaseComponent::extractDefaultValues over every component's schema
+ *   - BaseComponent::mergeConfiguration of those defaults with the live config
+ *   - BaseComponent::validateConfiguration of each live config (compiled schemas)
+ *     against getDefaultSchema() and the parse + apply path of a config update
+ *
+ * Reported per operation: host ns, heap allocations, bytes allocated, and
+ * the peak of live heap bytes above the starting point. Allocation counts
+ * are deterministic, so --save/--compare can guard them against regressions
+ * while ns/op is only indicative (host CPU, not the ESP32).
+ *
+ * Usage:
+ *   pio run -e native_bench && .pio/build/native_bench/program [options]
+ *     --fixture FILE   Component backup to model (default: largest in backups/)
+ *     --min-ms N       Minimum timed run per benchmark (default 300)
+ *     --save FILE      Write results as JSON
+ *     --compare FILE   Compare with saved results; exit 1 if allocations/op grew
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <chrono>
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "../../src/core/ComponentDataAggregator.h"
+#include "../../src/core/Orchestrator.h"
+#include "../../src/storage/ConfigStorage.h"
+#include "../../src/utils/Logger.h"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define BENCH_TRACK_ALLOCATIONS 1
+#else
+#define BENCH_TRACK_ALLOCATIONS 0
+#endif
+
+// === Heap accounting ===
+// ArduinoJson allocates through malloc/realloc/free and the String shim
+// through operator new, which libstdc++ maps onto malloc, so wrapping the
+// C allocator sees every allocation of the code under test.
+
+namespace {
+
+struct AllocCounters {
+    bool enabled = false;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    int64_t live = 0;
+    int64_t peak = 0;
+};
+
+AllocCounters g_alloc;
+
+} // namespace
+
+#if BENCH_TRACK_ALLOCATIONS
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+static inline void trackAlloc(void* ptr) {
+    if (!g_alloc.enabled || !ptr) return;
+    size_t size = malloc_usable_size(ptr);
+    g_alloc.allocations++;
+    g_alloc.bytes += size;
+    g_alloc.live += (int64_t)size;
+    if (g_alloc.live > g_alloc.peak) g_alloc.peak = g_alloc.live;
+}
+
+static inline void trackFree(void* ptr) {
+    if (!g_alloc.enabled || !ptr) return;
+    g_alloc.live -= (int64_t)malloc_usable_size(ptr);
+}
+
+void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    trackAlloc(ptr);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    trackAlloc(ptr);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+    size_t oldSize = (g_alloc.enabled && ptr) ? malloc_usable_size(ptr) : 0;
+    void* result = __libc_realloc(ptr, size);
+    if (result || size == 0) g_alloc.live -= (int64_t)oldSize;  // Old block released
+    trackAlloc(result);
+    return result;
+}
+
+void free(void* ptr) {
+    trackFree(ptr);
+    __libc_free(ptr);
+}
+}
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock HostClock;
+
+struct BenchOptions {
+    std::string fixture;
+    double minMs = 300;
+    const char* savePath = nullptr;
+    const char* comparePath = nullptr;
+};
+
+struct BenchResult {
+    String name;
+    double nsPerOp = 0;
+    double allocsPerOp = 0;
+    double bytesPerOp = 0;
+    int64_t peakBytes = 0;
+};
+
+/**
+ * @brief Stand-in for fixture component types that have no native build
+ *        (web server, MQTT, disabled components); also exposes the
+ *        protected configuration helpers to the benchmarks
+ */
+class FixtureComponent : public BaseComponent {
+public:
+    FixtureComponent(const String& id, const String& type, const String& name, ConfigStorage& storage)
+        : BaseComponent(id, type, name, storage, nullptr) {}
+
+    using BaseComponent::mergeConfiguration;
+    using BaseComponent::extractDefaultValues;
+
+    JsonDocument getDefaultSchema() const override {
+        JsonDocument schema;
+        schema["type"] = "object";
+        schema["title"] = getType() + " Configuration";
+        JsonObject properties = schema["properties"].to<JsonObject>();
+        properties["intervalMs"]["type"] = "integer";
+        properties["intervalMs"]["default"] = 5000;
+        properties["enabled"]["type"] = "boolean";
+        properties["enabled"]["default"] = true;
+        return schema;
+    }
+
+    bool initialize(const JsonDocument& config) override {
+        setState(ComponentState::INITIALIZING);
+        if (!loadConfiguration(config) || !applyConfig(getConfiguration())) {
+            setError("Failed to load configuration");
+            return false;
+        }
+        setNextExecutionMs(millis() + m_intervalMs);
+        setState(ComponentState::READY);
+        return true;
+    }
+
+    ExecutionResult execute() override {
+        ExecutionResult result;
+        result.success = true;
+        result.data["timestamp"] = millis();
+        result.data["success"] = true;
+        result.data["status"] = "ok";
+        result.data["value"] = (float)(millis() % 1000) / 10.0f;
+
+        String dataStr;
+        serializeJson(result.data, dataStr);
+        storeExecutionDataString(dataStr);
+
+        updateExecutionStats();
+        setNextExecutionMs(millis() + m_intervalMs);
+        return result;
+    }
+
+    void cleanup() override {}
+
+protected:
+    JsonDocument getCurrentConfig() const override {
+        JsonDocument config;
+        config["intervalMs"] = m_intervalMs;
+        config["enabled"] = m_enabled;
+        return config;
+    }
+
+    bool applyConfig(const JsonDocument& config) override {
+        m_intervalMs = config["intervalMs"] | 5000;
+        m_enabled = config["enabled"] | true;
+        return true;
+    }
+
+    std::vector<ComponentAction> getSupportedActions() const override { return {}; }
+
+    ActionResult performAction(const String& actionName, const JsonDocument& /*parameters*/) override {
+        ActionResult result;
+        result.actionName = actionName;
+        result.message = "Unknown action: " + actionName;
+        return result;
+    }
+
+private:
+    uint32_t m_intervalMs = 5000;
+    bool m_enabled = true;
+};
+
+bool isNativeType(const String& type) {
+    return type == "DHT22" || type == "TSL2561" || type == "PeristalticPump" ||
+           type == "PHSensor" || type == "ECProbe";
+}
+
+/**
+ * @brief Configuration a native component needs to run (mock mode where available)
+ */
+JsonDocument nativeConfig(const String& type, const String& id, int index) {
+    JsonDocument config;
+    config["component_type"] = type;
+    config["component_id"] = id;
+    if (type == "DHT22") {
+        config["pin"] = 15;
+        config["samplingIntervalMs"] = 5000;
+    } else if (type == "PHSensor" || type == "ECProbe") {
+        config["gpio_pin"] = 0;  // Mock mode
+    } else if (type == "PeristalticPump") {
+        config["pin_no"] = 16 + index;
+    }
+    return config;
+}
+
+bool readFile(const std::string& path, std::string& content) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        content.append(buffer, n);
+    }
+    fclose(file);
+    return true;
+}
+
+size_t fixtureComponentCount(const std::string& path) {
+    std::string content;
+    JsonDocument doc;
+    if (!readFile(path, content) || deserializeJson(doc, content)) return 0;
+    return doc["components"].size();
+}
+
+std::string defaultFixture() {
+    std::string best;
+    size_t bestCount = 0;
+    DIR* dir = opendir("backups");
+    if (!dir) return best;
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() < 5 || name.compare(name.size() - 5, 5, ".json") != 0) continue;
+        std::string path = "backups/" + name;
+        size_t count = fixtureComponentCount(path);
+        if (count > bestCount || (count == bestCount && path < best)) {
+            best = path;
+            bestCount = count;
+        }
+    }
+    closedir(dir);
+    return best;
+}
+
+bool parseOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--fixture") == 0 && i + 1 < argc) {
+            options.fixture = argv[++i];
+        } else if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            options.minMs = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            options.savePath = argv[++i];
+        } else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) {
+            options.comparePath = argv[++i];
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return false;
+        }
+    }
+    if (options.fixture.empty()) options.fixture = defaultFixture();
+    return true;
+}
+
+/**
+ * @brief Recreate the fixture's component set: native types are loaded by the
+ *        orchestrator from saved configs, the rest become FixtureComponents
+ */
+bool buildFixture(const BenchOptions& options, Orchestrator& orchestrator, ConfigStorage& storage,
+                  std::vector<FixtureComponent*>& standIns) {
+    std::string content;
+    JsonDocument fixture;
+    if (!readFile(options.fixture, content) || deserializeJson(fixture, content)) {
+        fprintf(stderr, "Cannot read fixture %s\n", options.fixture.c_str());
+        return false;
+    }
+
+    int index = 0;
+    for (JsonObjectConst entry : fixture["components"].as<JsonArrayConst>()) {
+        String id = entry["id"] | "";
+        String type = entry["type"] | "";
+        if (isNativeType(type)) {
+            storage.saveComponentConfig(id, nativeConfig(type, id, index++));
+        }
+    }
+
+    if (!orchestrator.init()) {
+        fprintf(stderr, "Orchestrator initialization failed\n");
+        return false;
+    }
+
+    for (JsonObjectConst entry : fixture["components"].as<JsonArrayConst>()) {
+        String type = entry["type"] | "";
+        if (isNativeType(type)) continue;
+        FixtureComponent* component = new FixtureComponent(entry["id"] | "", type, entry["name"] | "", storage);
+        component->initialize(JsonDocument());
+        if (!orchestrator.registerComponent(component)) {
+            delete component;
+            continue;
+        }
+        standIns.push_back(component);
+    }
+    return true;
+}
+
+/**
+ * @brief Time an operation for at least minMs, then measure one run's peak
+ */
+template <typename Op>
+BenchResult runBench(const char* name, double minMs, Op op) {
+    // Warm up (first-use allocations, caches)
+    for (int i = 0; i < 10; i++) op();
+
+    BenchResult result;
+    result.name = name;
+
+    uint64_t iterations = 0;
+    uint64_t batch = 16;
+    double elapsedNs = 0;
+    g_alloc = AllocCounters();
+    g_alloc.enabled = true;
+    HostClock::time_point start = HostClock::now();
+    while (elapsedNs < minMs * 1e6) {
+        for (uint64_t i = 0; i < batch; i++) op();
+        iterations += batch;
+        elapsedNs = std::chrono::duration<double, std::nano>(HostClock::now() - start).count();
+        if (batch < 4096) batch *= 2;
+    }
+    g_alloc.enabled = false;
+
+    result.nsPerOp = elapsedNs / iterations;
+    result.allocsPerOp = (double)g_alloc.allocations / iterations;
+    result.bytesPerOp = (double)g_alloc.bytes / iterations;
+
+    g_alloc = AllocCounters();
+    g_alloc.enabled = true;
+    op();
+    g_alloc.enabled = false;
+    result.peakBytes = g_alloc.peak;
+    return result;
+}
+
+void printResult(const BenchResult& r) {
+    if (BENCH_TRACK_ALLOCATIONS) {
+        printf("  %-34s %12.0f %10.1f %12.0f %10lld\n",
+               r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.bytesPerOp, (long long)r.peakBytes);
+    } else {
+        printf("  %-34s %12.0f %10s %12s %10s\n", r.name.c_str(), r.nsPerOp, "n/a", "n/a", "n/a");
+    }
+}
+
+bool saveResults(const char* path, const BenchOptions& options, const std::vector<BenchResult>& results) {
+    JsonDocument doc;
+    doc["fixture"] = options.fixture.c_str();
+    JsonObject benches = doc["benchmarks"].to<JsonObject>();
+    for (const BenchResult& r : results) {
+        JsonObject entry = benches[r.name].to<JsonObject>();
+        entry["ns_per_op"] = (uint32_t)r.nsPerOp;
+        entry["allocs_per_op"] = r.allocsPerOp;
+        entry["bytes_per_op"] = (uint32_t)r.bytesPerOp;
+        entry["peak_bytes"] = (uint32_t)r.peakBytes;
+    }
+    String json;
+    serializeJsonPretty(doc, json);
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    fwrite(json.c_str(), 1, json.length(), file);
+    fputc('\n', file);
+    fclose(file);
+    return true;
+}
+
+/**
+ * @brief Print deltas against saved results
+ * @return false if any benchmark now allocates more per operation
+ */
+bool compareResults(const char* path, const std::vector<BenchResult>& results) {
+    std::string content;
+    JsonDocument saved;
+    if (!readFile(path, content) || deserializeJson(saved, content)) {
+        fprintf(stderr, "Cannot read baseline %s\n", path);
+        return false;
+    }
+
+    bool ok = true;
+    printf("\n== Compared with %s ==\n", path);
+    printf("  %-34s %12s %10s %12s %10s\n", "benchmark", "ns/op", "allocs/op", "bytes/op", "peak");
+    for (const BenchResult& r : results) {
+        JsonObjectConst base = saved["benchmarks"][r.name];
+        if (base.isNull()) {
+            printf("  %-34s (new)\n", r.name.c_str());
+            continue;
+        }
+        double baseNs = base["ns_per_op"] | 0.0;
+        double baseAllocs = base["allocs_per_op"] | 0.0;
+        double baseBytes = base["bytes_per_op"] | 0.0;
+        double basePeak = base["peak_bytes"] | 0.0;
+        printf("  %-34s %+11.1f%% %+10.1f %+12.0f %+10.0f\n", r.name.c_str(),
+               baseNs > 0 ? (r.nsPerOp - baseNs) * 100.0 / baseNs : 0.0,
+               r.allocsPerOp - baseAllocs, r.bytesPerOp - baseBytes, (double)r.peakBytes - basePeak);
+        if (BENCH_TRACK_ALLOCATIONS && r.allocsPerOp > baseAllocs + 0.05) {
+            printf("    REGRESSION: allocations/op grew from %.1f to %.1f\n", baseAllocs, r.allocsPerOp);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+    if (options.fixture.empty()) {
+        fprintf(stderr, "No fixture found; run from the project root or pass --fixture\n");
+        return 2;
+    }
+
+    NativeSim::setSerialOutput(false);
+    NativeSim::setFilesystemRoot(".pio/native_bench_fs");
+    LittleFS.format();
+
+    ConfigStorage storage;
+    storage.init();
+    Orchestrator orchestrator;
+    std::vector<FixtureComponent*> standIns;
+    if (!buildFixture(options, orchestrator, storage, standIns)) {
+        return 1;
+    }
+    Logger::setLevel(Logger::WARNING);
+
+    // One simulated minute so every component has executed and holds output data
+    const int64_t endUs = NativeSim::nowUs() + 60LL * 1000000;
+    while (NativeSim::nowUs() < endUs) {
+        orchestrator.loop();
+        NativeSim::advanceUs(10000);
+    }
+
+    const std::vector<BaseComponent*>& components = orchestrator.getComponents();
+    std::vector<JsonDocument> schemas;
+    std::vector<JsonDocument> configs;
+    for (BaseComponent* component : components) {
+        schemas.push_back(component->getDefaultSchema());
+        configs.push_back(component->getConfigurationAsJson());
+    }
+    std::vector<String> configTexts;
+    for (const JsonDocument& config : configs) {
+        configTexts.push_back(String());
+        serializeJson(config, configTexts.back());
+    }
+    FixtureComponent helper("bench-helper", "Bench", "Benchmark helper", storage);
+    std::vector<JsonDocument> defaults;
+    for (const JsonDocument& schema : schemas) {
+        defaults.push_back(helper.extractDefaultValues(schema));
+    }
+
+    JsonDocument allData = ComponentDataAggregator::collect(components);
+    String serialized;
+    serializeJson(allData, serialized);
+
+    printf("Fixture %s: %zu components (%zu native, %zu stand-ins), data view %u bytes\n",
+           options.fixture.c_str(), components.size(), components.size() - standIns.size(), standIns.size(),
+           serialized.length());
+    printf("\n== JSON hot paths (host, per operation) ==\n");
+    printf("  %-34s %12s %10s %12s %10s\n", "benchmark", "ns/op", "allocs/op", "bytes/op", "peak");
+
+    std::vector<BenchResult> results;
+    results.push_back(runBench("collect", options.minMs, [&]() {
+        JsonDocument data = ComponentDataAggregator::collect(components);
+    }));
+    results.push_back(runBench("collect+serialize", options.minMs, [&]() {
+        JsonDocument data = ComponentDataAggregator::collect(components);
+        String response;
+        serializeJson(data, response);
+    }));
+    results.push_back(runBench("filter core", options.minMs, [&]() {
+        JsonDocument filtered = ComponentDataAggregator::filter(allData, FILTER_CORE);
+    }));
+    results.push_back(runBench("filter diagnostics", options.minMs, [&]() {
+        JsonDocument filtered = ComponentDataAggregator::filter(allData, FILTER_DIAGNOSTICS);
+    }));
+    uint32_t lastSeq = orchestrator.getDataSeq();
+    results.push_back(runBench("delta since=0 +serialize", options.minMs, [&]() {
+        JsonDocument delta = ComponentDataAggregator::collectDelta(components, 0);
+        String response;
+        serializeJson(delta, response);
+    }));
+    results.push_back(runBench("delta unchanged +serialize", options.minMs, [&]() {
+        JsonDocument delta = ComponentDataAggregator::collectDelta(components, lastSeq);
+        String response;
+        serializeJson(delta, response);
+    }));
+    results.push_back(runBench("extractDefaultValues (all schemas)", options.minMs, [&]() {
+        for (const JsonDocument& schema : schemas) {
+            JsonDocument extracted = helper.extractDefaultValues(schema);
+        }
+    }));
+    results.push_back(runBench("mergeConfiguration (all configs)", options.minMs, [&]() {
+        for (size_t i = 0; i < configs.size(); i++) {
+            JsonDocument merged = helper.mergeConfiguration(defaults[i], configs[i]);
+        }
+    }));
+    // Compiled once per type on first use; the loop below must not allocate
+    size_t invalid = 0;
+    for (size_t i = 0; i < components.size(); i++) {
+        invalid += components[i]->validateConfiguration(configs[i]) ? 0 : 1;
+    }
+    if (invalid > 0) {
+        fprintf(stderr, "%zu live configurations fail their own schema\n", invalid);
+    }
+    results.push_back(runBench("validate (compiled schemas)", options.minMs, [&]() {
+        for (size_t i = 0; i < components.size(); i++) {
+            components[i]->validateConfiguration(configs[i]);
+        }
+    }));
+    results.push_back(runBench("getDefaultSchema (all types)", options.minMs, [&]() {
+        for (BaseComponent* component : components) {
+            JsonDocument schema = component->getDefaultSchema();
+        }
+    }));
+    results.push_back(runBench("parse+validate+apply (all configs)", options.minMs, [&]() {
+        for (size_t i = 0; i < components.size(); i++) {
+            JsonDocument update;
+            deserializeJson(update, configTexts[i]);
+            components[i]->applyConfigurationFromJson(update);
+        }
+    }));
+    for (const BenchResult& r : results) {
+        printResult(r);
+    }
+    if (!BENCH_TRACK_ALLOCATIONS) {
+        printf("  (allocation tracking needs glibc)\n");
+    }
+
+    bool ok = true;
+    if (options.savePath && !saveResults(options.savePath, options, results)) {
+        fprintf(stderr, "Cannot write %s\n", options.savePath);
+        ok = false;
+    }
+    if (options.comparePath && !compareResults(options.comparePath, results)) {
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
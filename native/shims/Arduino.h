@@ -0,0 +1,128 @@
+/**
+ * @file Arduino.h
+ * @brief Host shim of the ESP32 Arduino core (native simulation build)
+ *
+ * Only what the orchestrator core, storage and mock-mode components use.
+ * Timing functions run on the virtual clock from NativeSim.h; GPIO and ADC
+ * calls are accepted and return simulated values.
+ */
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <type_traits>
+
+#include "WString.h"
+#include "Stream.h"
+#include "NativeSim.h"
+
+// === Attributes / memory placement (no-ops on the host) ===
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define PROGMEM
+
+// === Math helpers ===
+// Mixed-type min/max: on the ESP32 size_t and uint32_t are the same type, on the host they are not
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type min(A a, B b) { return (b < a) ? b : a; }
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type max(A a, B b) { return (a < b) ? b : a; }
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// === Timing (virtual clock) ===
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+inline void yield() {}
+
+// === Random ===
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+uint32_t esp_random();
+
+// === GPIO / ADC ===
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+
+typedef enum {
+    ADC_0db,
+    ADC_2_5db,
+    ADC_6db,
+    ADC_11db
+} adc_attenuation_t;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+uint32_t analogReadMilliVolts(uint8_t pin);
+inline void analogReadResolution(uint8_t) {}
+inline void analogSetAttenuation(adc_attenuation_t) {}
+inline void analogSetPinAttenuation(uint8_t, adc_attenuation_t) {}
+
+// === FreeRTOS critical sections (single-threaded host) ===
+typedef struct { int owner; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+
+// === Serial ===
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    void flush() override;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// === ESP system object ===
+class EspClass {
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getHeapSize() { return 320 * 1024; }
+    uint32_t getFreePsram() { return 0; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getCycleCount();   // Host wall clock scaled to 240 MHz (not the virtual clock)
+    uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+    uint32_t getSketchSize() { return 0; }
+    uint32_t getFreeSketchSpace() { return 0; }
+    const char* getChipModel() { return "native"; }
+    uint8_t getChipRevision() { return 0; }
+    uint64_t getEfuseMac() { return 0x0000AABBCCDDEEFFULL; }
+    const char* getSdkVersion() { return "native"; }
+    void restart();
+};
+
+extern EspClass ESP;
+
+#endif // NATIVE_ARDUINO_H
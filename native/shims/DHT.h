@@ -0,0 +1,51 @@
+/**
+ * @file DHT.h
+ * @brief Host shim of the Adafruit DHT sensor library
+ *
+ * Produces a slow day/night temperature swing and matching humidity on the
+ * virtual clock, so DHT22 components run without hardware.
+ */
+
+#ifndef NATIVE_DHT_H
+#define NATIVE_DHT_H
+
+#include "Arduino.h"
+
+#define DHT11 11
+#define DHT12 12
+#define DHT21 21
+#define DHT22 22
+#define AM2301 21
+#define AM2302 22
+
+class DHT {
+public:
+    DHT(uint8_t pin, uint8_t type, uint8_t = 6) : m_pin(pin), m_type(type) {}
+    void begin(uint8_t = 55) {}
+
+    float readTemperature(bool fahrenheit = false, bool = false) {
+        float celsius = 22.0f + 3.0f * (float)sin(dayPhase()) + (float)random(-10, 11) / 100.0f;
+        return fahrenheit ? celsius * 1.8f + 32.0f : celsius;
+    }
+
+    float readHumidity(bool = false) {
+        return 55.0f - 10.0f * (float)sin(dayPhase()) + (float)random(-20, 21) / 100.0f;
+    }
+
+    float computeHeatIndex(float temperature, float humidity, bool isFahrenheit = true) {
+        // Simple Steadman approximation; good enough for simulated readings
+        float t = isFahrenheit ? temperature : temperature * 1.8f + 32.0f;
+        float hi = 0.5f * (t + 61.0f + ((t - 68.0f) * 1.2f) + (humidity * 0.094f));
+        return isFahrenheit ? hi : (hi - 32.0f) / 1.8f;
+    }
+
+private:
+    uint8_t m_pin;
+    uint8_t m_type;
+
+    static double dayPhase() {
+        return 2.0 * M_PI * (double)(NativeSim::nowUs() % 86400000000LL) / 86400000000.0;
+    }
+};
+
+#endif // NATIVE_DHT_H
@@ -0,0 +1,93 @@
+/**
+ * @file FS.h
+ * @brief Host shim of the Arduino-ESP32 filesystem API
+ *
+ * fs::FS maps absolute LittleFS paths onto a host directory; fs::File wraps
+ * a stdio stream or a directory listing. Files are shared handles like on
+ * the target, so copies refer to the same open file.
+ */
+
+#ifndef NATIVE_FS_H
+#define NATIVE_FS_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+namespace fs {
+
+class FileImpl;
+typedef std::shared_ptr<FileImpl> FileImplPtr;
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+class File : public Stream {
+public:
+    File() {}
+    explicit File(FileImplPtr impl) : m_impl(impl) {}
+
+    // Print / Stream
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    void flush() override;
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t readBytes(char* buffer, size_t length) override;
+    size_t read(uint8_t* buffer, size_t size);
+
+    bool seek(uint32_t pos, SeekMode mode);
+    bool seek(uint32_t pos) { return seek(pos, SeekSet); }
+    size_t position() const;
+    size_t size() const;
+    void close();
+    operator bool() const;
+
+    const char* name() const;
+    const char* path() const;
+    bool isDirectory() const;
+    File openNextFile(const char* mode = "r");
+    void rewindDirectory();
+
+private:
+    FileImplPtr m_impl;
+};
+
+class FS {
+public:
+    explicit FS(const char* label) : m_label(label) {}
+
+    File open(const char* path, const char* mode = "r", bool create = false);
+    File open(const String& path, const char* mode = "r", bool create = false) { return open(path.c_str(), mode, create); }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* from, const char* to);
+    bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+    bool mkdir(const char* path);
+    bool mkdir(const String& path) { return mkdir(path.c_str()); }
+    bool rmdir(const char* path);
+    bool rmdir(const String& path) { return rmdir(path.c_str()); }
+
+protected:
+    std::string hostPath(const char* path) const;
+    const char* m_label;
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif // NATIVE_FS_H
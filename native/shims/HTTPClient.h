@@ -0,0 +1,54 @@
+/**
+ * @file HTTPClient.h
+ * @brief Host shim of the Arduino-ESP32 HTTP client
+ *
+ * The simulation never talks to the network: every request fails with
+ * HTTPC_ERROR_CONNECTION_REFUSED after the simulated connect timeout, so
+ * retry/backoff paths are exercised without real I/O.
+ */
+
+#ifndef NATIVE_HTTP_CLIENT_H
+#define NATIVE_HTTP_CLIENT_H
+
+#include "Arduino.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+typedef enum {
+    HTTP_CODE_OK = 200,
+    HTTP_CODE_CREATED = 201,
+    HTTP_CODE_NO_CONTENT = 204,
+    HTTP_CODE_BAD_REQUEST = 400,
+    HTTP_CODE_NOT_FOUND = 404,
+    HTTP_CODE_INTERNAL_SERVER_ERROR = 500,
+    HTTP_CODE_SERVICE_UNAVAILABLE = 503
+} t_http_codes;
+
+class HTTPClient {
+public:
+    bool begin(const String& url) { m_url = url; return true; }
+    void end() {}
+    void setTimeout(uint16_t timeoutMs) { m_timeoutMs = timeoutMs; }
+    void setConnectTimeout(int32_t timeoutMs) { m_connectTimeoutMs = timeoutMs; }
+    void setReuse(bool) {}
+    void addHeader(const String&, const String&) {}
+    int GET() { return fail(); }
+    int POST(const String&) { return fail(); }
+    int POST(uint8_t*, size_t) { return fail(); }
+    String getString() { return String(); }
+    int getSize() { return 0; }
+    static String errorToString(int error) { return String("native: no network (") + error + ")"; }
+
+private:
+    String m_url;
+    uint16_t m_timeoutMs = 5000;
+    int32_t m_connectTimeoutMs = 5000;
+
+    int fail() {
+        delay(m_connectTimeoutMs > 0 ? (uint32_t)m_connectTimeoutMs : 0);
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+};
+
+#endif // NATIVE_HTTP_CLIENT_H
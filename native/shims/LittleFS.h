@@ -0,0 +1,35 @@
+/**
+ * @file LittleFS.h
+ * @brief Host shim of the LittleFS filesystem, backed by a directory
+ *
+ * The root directory is chosen with NativeSim::setFilesystemRoot(). The
+ * reported capacity matches the 0x160000-byte partition in partitions.csv;
+ * usedBytes() is the sum of the file sizes below the root.
+ */
+
+#ifndef NATIVE_LITTLEFS_H
+#define NATIVE_LITTLEFS_H
+
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS : public FS {
+public:
+    static const size_t PARTITION_BYTES = 0x160000;
+
+    LittleFSFS() : FS("littlefs") {}
+
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+               uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs");
+    bool format();
+    void end() {}
+    size_t totalBytes() { return PARTITION_BYTES; }
+    size_t usedBytes();
+};
+
+} // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+#endif // NATIVE_LITTLEFS_H
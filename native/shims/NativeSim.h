@@ -0,0 +1,74 @@
+/**
+ * @file NativeSim.h
+ * @brief Controls for the native (host) simulation build
+ *
+ * The shims replace the ESP32 clock with a virtual one: millis(), micros(),
+ * esp_timer_get_time() and delay() all read or advance it. A simulation
+ * loop advances the clock explicitly, so a day of scheduler activity runs
+ * in seconds. LittleFS is backed by a host directory.
+ */
+
+#ifndef NATIVE_SIM_H
+#define NATIVE_SIM_H
+
+#include <stdint.h>
+
+namespace NativeSim {
+
+/**
+ * @brief Get virtual time
+ * @return Microseconds since simulated boot
+ */
+int64_t nowUs();
+
+/**
+ * @brief Advance virtual time
+ * @param us Microseconds to add (negative values are ignored)
+ */
+void advanceUs(int64_t us);
+
+/**
+ * @brief Set virtual time, e.g. just before the 32-bit millis() wrap
+ * @param us Microseconds since simulated boot
+ */
+void setNowUs(int64_t us);
+
+/**
+ * @brief Route Serial output to stdout or discard it
+ * @param enabled true to print (default), false for benchmarks
+ */
+void setSerialOutput(bool enabled);
+
+/**
+ * @brief Count of bytes written to Serial (printed or discarded)
+ */
+uint64_t serialBytes();
+
+/**
+ * @brief Set the host directory backing LittleFS
+ * @param path Directory, created on LittleFS.begin() (default ".pio/native_fs")
+ */
+void setFilesystemRoot(const char* path);
+
+/**
+ * @brief Simulate the WiFi link (no network traffic is ever sent)
+ * @param connected true to report WL_CONNECTED
+ */
+void setWiFiConnected(bool connected);
+
+/**
+ * @brief Set the raw value returned by analogRead() for a pin
+ * @param pin GPIO number
+ * @param value 12-bit ADC value (default 2048)
+ */
+void setAnalogValue(uint8_t pin, int value);
+
+/**
+ * @brief Set the simulated free heap reported by ESP.getFreeHeap()
+ * @param bytes Free heap in bytes (default 200000)
+ */
+void setFreeHeap(uint32_t bytes);
+
+} // namespace NativeSim
+
+#endif // NATIVE_SIM_H
@@ -0,0 +1,66 @@
+/**
+ * @file Stream.h
+ * @brief Host shims of the Arduino Print and Stream interfaces
+ *
+ * ArduinoJson serializes to ::Print and parses from ::Stream, so File and
+ * Serial derive from these exactly as on the target.
+ */
+
+#ifndef NATIVE_STREAM_H
+#define NATIVE_STREAM_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "WString.h"
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) { return str ? write(reinterpret_cast<const uint8_t*>(str), strlen_(str)) : 0; }
+    virtual void flush() {}
+
+    size_t print(const String& s) { return write(reinterpret_cast<const uint8_t*>(s.c_str()), s.length()); }
+    size_t print(const char* str) { return write(str); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(int value, int base = DEC) { return print(String((long)value, (unsigned char)base)); }
+    size_t print(unsigned int value, int base = DEC) { return print(String((unsigned long)value, (unsigned char)base)); }
+    size_t print(long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(long long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned long long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(double value, int digits = 2) { return print(String(value, (unsigned int)digits)); }
+
+    template <typename T>
+    size_t println(const T& value) { size_t n = print(value); return n + println(); }
+    template <typename T>
+    size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+    size_t println() { return write(reinterpret_cast<const uint8_t*>("\r\n"), 2); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+private:
+    static size_t strlen_(const char* str);
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeoutMs) { m_timeoutMs = timeoutMs; }
+
+    virtual size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes(reinterpret_cast<char*>(buffer), length); }
+    String readString();
+    String readStringUntil(char terminator);
+
+protected:
+    unsigned long m_timeoutMs = 1000;  // Kept for API compatibility; host reads never block
+};
+
+#endif // NATIVE_STREAM_H
@@ -0,0 +1,153 @@
+/**
+ * @file WString.h
+ * @brief Host shim of the Arduino String class (native simulation build)
+ *
+ * Backed by std::string. Implements the subset of the Arduino API used by
+ * the orchestrator core and components, with Arduino semantics for number
+ * formatting (integer bases, float decimals) and index-based helpers.
+ */
+
+#ifndef NATIVE_WSTRING_H
+#define NATIVE_WSTRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class String {
+public:
+    String() {}
+    String(const char* cstr) { if (cstr) m_buffer = cstr; }
+    String(const char* cstr, unsigned int length) { if (cstr) m_buffer.assign(cstr, length); }
+    explicit String(const std::string& str) : m_buffer(str) {}
+    explicit String(char c) : m_buffer(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimalPlaces = 2);
+    explicit String(double value, unsigned int decimalPlaces = 2);
+
+    String& operator=(const char* cstr) { if (cstr) m_buffer = cstr; else m_buffer.clear(); return *this; }
+
+    // Memory / size
+    bool reserve(unsigned int size) { m_buffer.reserve(size); return true; }
+    unsigned int length() const { return (unsigned int)m_buffer.size(); }
+    bool isEmpty() const { return m_buffer.empty(); }
+    const char* c_str() const { return m_buffer.c_str(); }
+    char* begin() { return &m_buffer[0]; }
+    char* end() { return &m_buffer[0] + m_buffer.size(); }
+    const char* begin() const { return m_buffer.c_str(); }
+    const char* end() const { return m_buffer.c_str() + m_buffer.size(); }
+
+    // Concatenation
+    bool concat(const String& str) { m_buffer += str.m_buffer; return true; }
+    bool concat(const char* cstr) { if (cstr) m_buffer += cstr; return cstr != nullptr; }
+    bool concat(const char* cstr, unsigned int length) { if (cstr) m_buffer.append(cstr, length); return cstr != nullptr; }
+    bool concat(char c) { m_buffer += c; return true; }
+    bool concat(unsigned char value) { return concat(String(value)); }
+    bool concat(int value) { return concat(String(value)); }
+    bool concat(unsigned int value) { return concat(String(value)); }
+    bool concat(long value) { return concat(String(value)); }
+    bool concat(unsigned long value) { return concat(String(value)); }
+    bool concat(long long value) { return concat(String(value)); }
+    bool concat(unsigned long long value) { return concat(String(value)); }
+    bool concat(float value) { return concat(String(value)); }
+    bool concat(double value) { return concat(String(value)); }
+
+    template <typename T>
+    String& operator+=(const T& value) { concat(value); return *this; }
+
+    // Comparison
+    int compareTo(const String& s) const { return m_buffer.compare(s.m_buffer); }
+    bool equals(const String& s) const { return m_buffer == s.m_buffer; }
+    bool equals(const char* cstr) const { return m_buffer == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String& s) const;
+    bool operator==(const String& rhs) const { return equals(rhs); }
+    bool operator==(const char* rhs) const { return equals(rhs); }
+    bool operator!=(const String& rhs) const { return !equals(rhs); }
+    bool operator!=(const char* rhs) const { return !equals(rhs); }
+    bool operator<(const String& rhs) const { return m_buffer < rhs.m_buffer; }
+    bool operator>(const String& rhs) const { return m_buffer > rhs.m_buffer; }
+    bool operator<=(const String& rhs) const { return m_buffer <= rhs.m_buffer; }
+    bool operator>=(const String& rhs) const { return m_buffer >= rhs.m_buffer; }
+    bool startsWith(const String& prefix) const { return startsWith(prefix, 0); }
+    bool startsWith(const String& prefix, unsigned int offset) const;
+    bool endsWith(const String& suffix) const;
+
+    // Character access
+    char charAt(unsigned int index) const { return index < m_buffer.size() ? m_buffer[index] : 0; }
+    void setCharAt(unsigned int index, char c) { if (index < m_buffer.size()) m_buffer[index] = c; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return m_buffer[index]; }
+
+    // Search
+    int indexOf(char c) const { return indexOf(c, 0); }
+    int indexOf(char c, unsigned int fromIndex) const;
+    int indexOf(const String& str) const { return indexOf(str, 0); }
+    int indexOf(const String& str, unsigned int fromIndex) const;
+    int lastIndexOf(char c) const;
+    int lastIndexOf(char c, unsigned int fromIndex) const;
+    int lastIndexOf(const String& str) const;
+    String substring(unsigned int beginIndex) const { return substring(beginIndex, length()); }
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    // Modification
+    void replace(char find, char replace);
+    void replace(const String& find, const String& replace);
+    void remove(unsigned int index) { remove(index, (unsigned int)-1); }
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+    void clear() { m_buffer.clear(); }
+
+    // Parsing
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+
+    const std::string& str() const { return m_buffer; }
+
+private:
+    std::string m_buffer;
+};
+
+// Distinct type like on the target, so ArduinoJson's String adapters specialize cleanly
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+    StringSumHelper(const char* p) : String(p) {}
+};
+
+template <typename T>
+inline String operator+(const String& lhs, const T& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+inline String operator+(const char* lhs, const String& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+inline String operator+(char lhs, const String& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+inline bool operator==(const char* lhs, const String& rhs) { return rhs.equals(lhs); }
+inline bool operator!=(const char* lhs, const String& rhs) { return !rhs.equals(lhs); }
+
+#endif // NATIVE_WSTRING_H
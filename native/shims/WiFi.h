@@ -0,0 +1,101 @@
+/**
+ * @file WiFi.h
+ * @brief Host shim of the Arduino-ESP32 WiFi station API
+ *
+ * No radio: the link state is set by the simulation with
+ * NativeSim::setWiFiConnected(), which also raises the GOT_IP /
+ * DISCONNECTED events that WiFiConnectionManager listens for.
+ */
+
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+#include <functional>
+#include <vector>
+#include "Arduino.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} wifi_mode_t;
+
+typedef enum {
+    ARDUINO_EVENT_WIFI_READY = 0,
+    ARDUINO_EVENT_WIFI_STA_START,
+    ARDUINO_EVENT_WIFI_STA_STOP,
+    ARDUINO_EVENT_WIFI_STA_CONNECTED,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP,
+    ARDUINO_EVENT_WIFI_STA_LOST_IP
+} arduino_event_id_t;
+
+typedef arduino_event_id_t WiFiEvent_t;
+
+typedef union {
+    struct {
+        uint8_t reason;
+    } wifi_sta_disconnected;
+} arduino_event_info_t;
+
+typedef arduino_event_info_t WiFiEventInfo_t;
+typedef std::function<void(WiFiEvent_t event, WiFiEventInfo_t info)> WiFiEventFuncCb;
+
+class IPAddress {
+public:
+    IPAddress() : m_address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : m_address((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+    explicit IPAddress(uint32_t address) : m_address(address) {}
+
+    bool fromString(const char* address);
+    bool fromString(const String& address) { return fromString(address.c_str()); }
+    String toString() const;
+    operator uint32_t() const { return m_address; }
+    uint8_t operator[](int index) const { return (uint8_t)(m_address >> (index * 8)); }
+
+private:
+    uint32_t m_address;  // Network byte order, like the target
+};
+
+class WiFiClass {
+public:
+    wl_status_t begin(const char* ssid, const char* password = nullptr);
+    bool disconnect(bool wifiOff = false);
+    wl_status_t status();
+    bool isConnected() { return status() == WL_CONNECTED; }
+    bool mode(wifi_mode_t) { return true; }
+    void persistent(bool) {}
+    bool setAutoReconnect(bool) { return true; }
+    void onEvent(WiFiEventFuncCb callback) { m_callbacks.push_back(callback); }
+    IPAddress localIP();
+    int8_t RSSI();
+    String macAddress() { return "AA:BB:CC:DD:EE:FF"; }
+    String SSID() { return m_ssid; }
+
+    // Simulation hooks (see NativeSim::setWiFiConnected)
+    void simulateLink(bool connected);
+
+private:
+    std::vector<WiFiEventFuncCb> m_callbacks;
+    String m_ssid;
+    bool m_linkAvailable = false;
+    bool m_associated = false;
+
+    void raise(WiFiEvent_t event, uint8_t reason);
+};
+
+extern WiFiClass WiFi;
+
+#endif // NATIVE_WIFI_H
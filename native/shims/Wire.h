@@ -0,0 +1,30 @@
+/**
+ * @file Wire.h
+ * @brief Host shim of the Arduino I2C bus
+ *
+ * The bus is empty: every transmission is NACKed (error 2), so I2C sensors
+ * report "not found" exactly as they would with nothing connected.
+ */
+
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire {
+public:
+    bool begin() { return true; }
+    bool begin(int, int, uint32_t = 0) { return true; }
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t) {}
+    uint8_t endTransmission(bool = true) { return 2; }
+    uint8_t requestFrom(uint8_t, uint8_t, bool = true) { return 0; }
+    size_t write(uint8_t) { return 1; }
+    size_t write(const uint8_t*, size_t size) { return size; }
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif // NATIVE_WIRE_H
@@ -0,0 +1,11 @@
+/**
+ * @file esp_attr.h
+ * @brief Host shim of the ESP-IDF placement attributes (all no-ops)
+ */
+
+#ifndef NATIVE_ESP_ATTR_H
+#define NATIVE_ESP_ATTR_H
+
+#include "Arduino.h"
+
+#endif // NATIVE_ESP_ATTR_H
@@ -0,0 +1,27 @@
+/**
+ * @file esp_sleep.h
+ * @brief Host shim of the ESP-IDF sleep API
+ *
+ * Deep sleep ends the simulation process, like a reset would on the target.
+ */
+
+#ifndef NATIVE_ESP_SLEEP_H
+#define NATIVE_ESP_SLEEP_H
+
+#include <stdint.h>
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER,
+    ESP_SLEEP_WAKEUP_TOUCHPAD,
+    ESP_SLEEP_WAKEUP_ULP
+} esp_sleep_wakeup_cause_t;
+
+inline esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() { return ESP_SLEEP_WAKEUP_UNDEFINED; }
+inline int esp_sleep_enable_timer_wakeup(uint64_t) { return 0; }
+void esp_deep_sleep_start() __attribute__((noreturn));
+
+#endif // NATIVE_ESP_SLEEP_H
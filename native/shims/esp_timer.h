@@ -0,0 +1,14 @@
+/**
+ * @file esp_timer.h
+ * @brief Host shim of the ESP-IDF high-resolution timer (virtual clock)
+ */
+
+#ifndef NATIVE_ESP_TIMER_H
+#define NATIVE_ESP_TIMER_H
+
+#include <stdint.h>
+#include "NativeSim.h"
+
+inline int64_t esp_timer_get_time() { return NativeSim::nowUs(); }
+
+#endif // NATIVE_ESP_TIMER_H
@@ -0,0 +1,679 @@
+/**
+ * @file native_arduino.cpp
+ * @brief Implementation of the host shims (virtual clock, String, Serial,
+ *        directory-backed LittleFS, WiFi link simulation)
+ */
+
+#include "Arduino.h"
+#include "FS.h"
+#include "LittleFS.h"
+#include "WiFi.h"
+#include "Wire.h"
+#include "esp_sleep.h"
+#include "rom/crc.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <map>
+#include <random>
+
+// ============================================================================
+// Simulation state
+// ============================================================================
+
+namespace {
+
+int64_t g_nowUs = 0;
+bool g_serialOutput = true;
+uint64_t g_serialBytes = 0;
+std::string g_fsRoot = ".pio/native_fs";
+uint32_t g_freeHeap = 200000;
+uint32_t g_minFreeHeap = 200000;
+std::map<uint8_t, int> g_analogValues;
+std::map<uint8_t, int> g_digitalValues;
+std::mt19937 g_random(12345);  // Fixed seed: runs are reproducible
+
+} // namespace
+
+namespace NativeSim {
+
+int64_t nowUs() { return g_nowUs; }
+
+void advanceUs(int64_t us) {
+    if (us > 0) g_nowUs += us;
+}
+
+void setNowUs(int64_t us) { g_nowUs = us; }
+
+void setSerialOutput(bool enabled) { g_serialOutput = enabled; }
+
+uint64_t serialBytes() { return g_serialBytes; }
+
+void setFilesystemRoot(const char* path) { g_fsRoot = path ? path : ""; }
+
+void setWiFiConnected(bool connected) { WiFi.simulateLink(connected); }
+
+void setAnalogValue(uint8_t pin, int value) { g_analogValues[pin] = value; }
+
+void setFreeHeap(uint32_t bytes) {
+    g_freeHeap = bytes;
+    if (bytes < g_minFreeHeap) g_minFreeHeap = bytes;
+}
+
+} // namespace NativeSim
+
+// ============================================================================
+// Timing / random / GPIO
+// ============================================================================
+
+uint32_t millis() { return (uint32_t)(g_nowUs / 1000); }
+uint32_t micros() { return (uint32_t)g_nowUs; }
+void delay(uint32_t ms) { g_nowUs += (int64_t)ms * 1000; }
+void delayMicroseconds(uint32_t us) { g_nowUs += us; }
+
+long random(long howBig) {
+    if (howBig <= 0) return 0;
+    return (long)(g_random() % (uint32_t)howBig);
+}
+
+long random(long howSmall, long howBig) {
+    if (howSmall >= howBig) return howSmall;
+    return howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) { g_random.seed((uint32_t)seed); }
+
+uint32_t esp_random() { return g_random(); }
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t pin, uint8_t value) { g_digitalValues[pin] = value; }
+
+int digitalRead(uint8_t pin) {
+    auto it = g_digitalValues.find(pin);
+    return it != g_digitalValues.end() ? it->second : LOW;
+}
+
+uint16_t analogRead(uint8_t pin) {
+    auto it = g_analogValues.find(pin);
+    int base = it != g_analogValues.end() ? it->second : 2048;
+    int value = base + (int)random(-8, 9);  // A little ADC noise
+    return (uint16_t)constrain(value, 0, 4095);
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin) {
+    return (uint32_t)analogRead(pin) * 3300 / 4095;
+}
+
+void esp_deep_sleep_start() {
+    fflush(stdout);
+    printf("\n[native] esp_deep_sleep_start() - ending simulation\n");
+    exit(0);
+}
+
+uint32_t crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+// ============================================================================
+// String
+// ============================================================================
+
+namespace {
+
+std::string formatUnsigned(unsigned long long value, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    if (value == 0) return "0";
+    std::string digits;
+    while (value > 0) {
+        unsigned digit = (unsigned)(value % base);
+        digits.insert(digits.begin(), (char)(digit < 10 ? '0' + digit : 'a' + digit - 10));
+        value /= base;
+    }
+    return digits;
+}
+
+std::string formatSigned(long long value, unsigned char base) {
+    if (value < 0 && base == 10) {
+        return "-" + formatUnsigned((unsigned long long)(-(value + 1)) + 1, base);
+    }
+    return formatUnsigned((unsigned long long)value, base);
+}
+
+std::string formatFloat(double value, unsigned int decimalPlaces) {
+    if (isnan(value)) return "nan";
+    if (isinf(value)) return value > 0 ? "inf" : "-inf";
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimalPlaces, value);
+    return buffer;
+}
+
+} // namespace
+
+String::String(unsigned char value, unsigned char base) : m_buffer(formatUnsigned(value, base)) {}
+String::String(int value, unsigned char base) : m_buffer(formatSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base) : m_buffer(formatUnsigned(value, base)) {}
+String::String(long value, unsigned char base) : m_buffer(formatSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base) : m_buffer(formatUnsigned(value, base)) {}
+String::String(long long value, unsigned char base) : m_buffer(formatSigned(value, base)) {}
+String::String(unsigned long long value, unsigned char base) : m_buffer(formatUnsigned(value, base)) {}
+String::String(float value, unsigned int decimalPlaces) : m_buffer(formatFloat(value, decimalPlaces)) {}
+String::String(double value, unsigned int decimalPlaces) : m_buffer(formatFloat(value, decimalPlaces)) {}
+
+bool String::equalsIgnoreCase(const String& s) const {
+    if (m_buffer.size() != s.m_buffer.size()) return false;
+    for (size_t i = 0; i < m_buffer.size(); i++) {
+        if (tolower((unsigned char)m_buffer[i]) != tolower((unsigned char)s.m_buffer[i])) return false;
+    }
+    return true;
+}
+
+bool String::startsWith(const String& prefix, unsigned int offset) const {
+    if (offset > m_buffer.size() || prefix.m_buffer.size() > m_buffer.size() - offset) return false;
+    return m_buffer.compare(offset, prefix.m_buffer.size(), prefix.m_buffer) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    if (suffix.m_buffer.size() > m_buffer.size()) return false;
+    return m_buffer.compare(m_buffer.size() - suffix.m_buffer.size(), suffix.m_buffer.size(), suffix.m_buffer) == 0;
+}
+
+int String::indexOf(char c, unsigned int fromIndex) const {
+    size_t pos = m_buffer.find(c, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+    size_t pos = m_buffer.find(str.m_buffer, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t pos = m_buffer.rfind(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c, unsigned int fromIndex) const {
+    size_t pos = m_buffer.rfind(c, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(const String& str) const {
+    size_t pos = m_buffer.rfind(str.m_buffer);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) std::swap(beginIndex, endIndex);
+    if (beginIndex >= m_buffer.size()) return String();
+    if (endIndex > m_buffer.size()) endIndex = (unsigned int)m_buffer.size();
+    return String(m_buffer.substr(beginIndex, endIndex - beginIndex));
+}
+
+void String::replace(char find, char replace) {
+    for (char& c : m_buffer) {
+        if (c == find) c = replace;
+    }
+}
+
+void String::replace(const String& find, const String& replace) {
+    if (find.m_buffer.empty()) return;
+    size_t pos = 0;
+    while ((pos = m_buffer.find(find.m_buffer, pos)) != std::string::npos) {
+        m_buffer.replace(pos, find.m_buffer.size(), replace.m_buffer);
+        pos += replace.m_buffer.size();
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index >= m_buffer.size()) return;
+    m_buffer.erase(index, count);
+}
+
+void String::toLowerCase() {
+    for (char& c : m_buffer) c = (char)tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+    for (char& c : m_buffer) c = (char)toupper((unsigned char)c);
+}
+
+void String::trim() {
+    size_t first = m_buffer.find_first_not_of(" \t\r\n\f\v");
+    if (first == std::string::npos) {
+        m_buffer.clear();
+        return;
+    }
+    size_t last = m_buffer.find_last_not_of(" \t\r\n\f\v");
+    m_buffer = m_buffer.substr(first, last - first + 1);
+}
+
+long String::toInt() const { return strtol(m_buffer.c_str(), nullptr, 10); }
+float String::toFloat() const { return (float)toDouble(); }
+double String::toDouble() const { return strtod(m_buffer.c_str(), nullptr); }
+
+// ============================================================================
+// Print / Stream / Serial
+// ============================================================================
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (write(*buffer++) == 0) break;
+        n++;
+    }
+    return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char stackBuffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    if ((size_t)length < sizeof(stackBuffer)) {
+        return write(reinterpret_cast<const uint8_t*>(stackBuffer), (size_t)length);
+    }
+
+    std::string heapBuffer((size_t)length + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&heapBuffer[0], heapBuffer.size(), format, args);
+    va_end(args);
+    return write(reinterpret_cast<const uint8_t*>(heapBuffer.data()), (size_t)length);
+}
+
+size_t Print::strlen_(const char* str) { return strlen(str); }
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = read();
+        if (c < 0) break;
+        *buffer++ = (char)c;
+        count++;
+    }
+    return count;
+}
+
+String Stream::readString() {
+    String result;
+    int c;
+    while ((c = read()) >= 0) result += (char)c;
+    return result;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String result;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) result += (char)c;
+    return result;
+}
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    g_serialBytes += size;
+    if (g_serialOutput) {
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+void HardwareSerial::flush() {
+    if (g_serialOutput) fflush(stdout);
+}
+
+// ============================================================================
+// ESP
+// ============================================================================
+
+EspClass ESP;
+
+uint32_t EspClass::getFreeHeap() { return g_freeHeap; }
+uint32_t EspClass::getMinFreeHeap() { return g_minFreeHeap; }
+uint32_t EspClass::getMaxAllocHeap() { return g_freeHeap * 3 / 4; }
+
+uint32_t EspClass::getCycleCount() {
+    // Measures host CPU time for cost reporting, so it follows the real clock
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return (uint32_t)(ns * 240 / 1000);
+}
+
+void EspClass::restart() {
+    fflush(stdout);
+    printf("\n[native] ESP.restart() - ending simulation\n");
+    exit(0);
+}
+
+// ============================================================================
+// Filesystem
+// ============================================================================
+
+namespace fs {
+
+class FileImpl {
+public:
+    FILE* stream = nullptr;
+    bool directory = false;
+    std::string fsPath;      // Path as seen by the firmware ("/config/x.json")
+    std::string hostPath;    // Backing path on the host
+    std::string baseName;
+    std::vector<std::string> entries;
+    size_t nextEntry = 0;
+
+    ~FileImpl() {
+        if (stream) fclose(stream);
+    }
+};
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+    if (!m_impl || !m_impl->stream) return 0;
+    return fwrite(buffer, 1, size, m_impl->stream);
+}
+
+void File::flush() {
+    if (m_impl && m_impl->stream) fflush(m_impl->stream);
+}
+
+int File::available() {
+    if (!m_impl || !m_impl->stream) return 0;
+    long remaining = (long)size() - (long)position();
+    return remaining > 0 ? (int)remaining : 0;
+}
+
+int File::read() {
+    if (!m_impl || !m_impl->stream) return -1;
+    int c = fgetc(m_impl->stream);
+    return c == EOF ? -1 : c;
+}
+
+int File::peek() {
+    if (!m_impl || !m_impl->stream) return -1;
+    int c = fgetc(m_impl->stream);
+    if (c == EOF) return -1;
+    ungetc(c, m_impl->stream);
+    return c;
+}
+
+size_t File::readBytes(char* buffer, size_t length) {
+    if (!m_impl || !m_impl->stream) return 0;
+    return fread(buffer, 1, length, m_impl->stream);
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    return readBytes(reinterpret_cast<char*>(buffer), size);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!m_impl || !m_impl->stream) return false;
+    int whence = mode == SeekCur ? SEEK_CUR : (mode == SeekEnd ? SEEK_END : SEEK_SET);
+    return fseek(m_impl->stream, (long)pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if (!m_impl || !m_impl->stream) return 0;
+    long pos = ftell(m_impl->stream);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!m_impl) return 0;
+    if (m_impl->stream) fflush(m_impl->stream);
+    struct stat info;
+    if (stat(m_impl->hostPath.c_str(), &info) != 0) return 0;
+    return (size_t)info.st_size;
+}
+
+void File::close() {
+    m_impl.reset();
+}
+
+File::operator bool() const {
+    return m_impl && (m_impl->stream || m_impl->directory);
+}
+
+const char* File::name() const {
+    return m_impl ? m_impl->baseName.c_str() : "";
+}
+
+const char* File::path() const {
+    return m_impl ? m_impl->fsPath.c_str() : "";
+}
+
+bool File::isDirectory() const {
+    return m_impl && m_impl->directory;
+}
+
+File File::openNextFile(const char* mode) {
+    if (!m_impl || !m_impl->directory || m_impl->nextEntry >= m_impl->entries.size()) {
+        return File();
+    }
+    std::string child = m_impl->fsPath;
+    if (child.empty() || child[child.size() - 1] != '/') child += "/";
+    child += m_impl->entries[m_impl->nextEntry++];
+    return LittleFS.open(child.c_str(), mode);
+}
+
+void File::rewindDirectory() {
+    if (m_impl) m_impl->nextEntry = 0;
+}
+
+std::string FS::hostPath(const char* path) const {
+    std::string result = g_fsRoot;
+    if (!path || path[0] != '/') result += "/";
+    if (path) result += path;
+    return result;
+}
+
+File FS::open(const char* path, const char* mode, bool) {
+    std::string host = hostPath(path);
+    struct stat info;
+    bool exists = stat(host.c_str(), &info) == 0;
+
+    FileImplPtr impl = std::make_shared<FileImpl>();
+    impl->fsPath = path ? path : "/";
+    impl->hostPath = host;
+    size_t slash = impl->fsPath.find_last_of('/');
+    impl->baseName = slash == std::string::npos ? impl->fsPath : impl->fsPath.substr(slash + 1);
+
+    if (exists && S_ISDIR(info.st_mode)) {
+        DIR* dir = opendir(host.c_str());
+        if (!dir) return File();
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+            impl->entries.push_back(entry->d_name);
+        }
+        closedir(dir);
+        impl->directory = true;
+        return File(impl);
+    }
+
+    const char* stdioMode;
+    if (!mode || strcmp(mode, "r") == 0) {
+        if (!exists) return File();
+        stdioMode = "rb";
+    } else if (strcmp(mode, "w") == 0) {
+        stdioMode = "w+b";
+    } else if (strcmp(mode, "a") == 0) {
+        stdioMode = "a+b";
+    } else {
+        stdioMode = mode;
+    }
+
+    impl->stream = fopen(host.c_str(), stdioMode);
+    if (!impl->stream) return File();
+    return File(impl);
+}
+
+bool FS::exists(const char* path) {
+    struct stat info;
+    return stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char* path) {
+    return unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* from, const char* to) {
+    return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    return ::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool FS::rmdir(const char* path) {
+    return ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+namespace {
+
+bool makeDirectories(const std::string& path) {
+    for (size_t pos = 1; pos <= path.size(); pos++) {
+        if (pos == path.size() || path[pos] == '/') {
+            std::string prefix = path.substr(0, pos);
+            if (::mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) return false;
+        }
+    }
+    return true;
+}
+
+void removeTree(const std::string& path) {
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        std::string child = path + "/" + entry->d_name;
+        struct stat info;
+        if (stat(child.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+            removeTree(child);
+            ::rmdir(child.c_str());
+        } else {
+            unlink(child.c_str());
+        }
+    }
+    closedir(dir);
+}
+
+size_t treeBytes(const std::string& path) {
+    size_t total = 0;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        std::string child = path + "/" + entry->d_name;
+        struct stat info;
+        if (stat(child.c_str(), &info) != 0) continue;
+        total += S_ISDIR(info.st_mode) ? treeBytes(child) : (size_t)info.st_size;
+    }
+    closedir(dir);
+    return total;
+}
+
+} // namespace
+
+bool LittleFSFS::begin(bool, const char*, uint8_t, const char*) {
+    return !g_fsRoot.empty() && makeDirectories(g_fsRoot);
+}
+
+bool LittleFSFS::format() {
+    removeTree(g_fsRoot);
+    return true;
+}
+
+size_t LittleFSFS::usedBytes() {
+    return treeBytes(g_fsRoot);
+}
+
+} // namespace fs
+
+fs::LittleFSFS LittleFS;
+
+// ============================================================================
+// WiFi / I2C
+// ============================================================================
+
+WiFiClass WiFi;
+TwoWire Wire;
+
+bool IPAddress::fromString(const char* address) {
+    unsigned a, b, c, d;
+    if (!address || sscanf(address, "%u.%u.%u.%u", &a, &b, &c, &d) != 4 || a > 255 || b > 255 || c > 255 || d > 255) {
+        return false;
+    }
+    *this = IPAddress((uint8_t)a, (uint8_t)b, (uint8_t)c, (uint8_t)d);
+    return true;
+}
+
+String IPAddress::toString() const {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(buffer);
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char*) {
+    m_ssid = ssid;
+    m_associated = true;
+    if (m_linkAvailable) raise(ARDUINO_EVENT_WIFI_STA_GOT_IP, 0);
+    return status();
+}
+
+bool WiFiClass::disconnect(bool) {
+    bool wasConnected = status() == WL_CONNECTED;
+    m_associated = false;
+    if (wasConnected) raise(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, 8);  // ASSOC_LEAVE
+    return true;
+}
+
+wl_status_t WiFiClass::status() {
+    return (m_associated && m_linkAvailable) ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+IPAddress WiFiClass::localIP() {
+    return status() == WL_CONNECTED ? IPAddress(192, 168, 1, 50) : IPAddress();
+}
+
+int8_t WiFiClass::RSSI() {
+    return status() == WL_CONNECTED ? -55 : 0;
+}
+
+void WiFiClass::simulateLink(bool connected) {
+    if (connected == m_linkAvailable) return;
+    bool wasConnected = status() == WL_CONNECTED;
+    m_linkAvailable = connected;
+    if (connected && m_associated) {
+        raise(ARDUINO_EVENT_WIFI_STA_GOT_IP, 0);
+    } else if (!connected && wasConnected) {
+        raise(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, 200);  // BEACON_TIMEOUT
+    }
+}
+
+void WiFiClass::raise(WiFiEvent_t event, uint8_t reason) {
+    WiFiEventInfo_t info;
+    memset(&info, 0, sizeof(info));
+    info.wifi_sta_disconnected.reason = reason;
+    for (WiFiEventFuncCb& callback : m_callbacks) {
+        callback(event, info);
+    }
+}
@@ -0,0 +1,16 @@
+/**
+ * @file crc.h
+ * @brief Host shim of the ESP32 ROM CRC32 routine
+ */
+
+#ifndef NATIVE_ROM_CRC_H
+#define NATIVE_ROM_CRC_H
+
+#include <stdint.h>
+
+/**
+ * @brief CRC32 (little-endian, IEEE polynomial), same results as the ROM version
+ */
+uint32_t crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
+
+#endif // NATIVE_ROM_CRC_H
@@ -0,0 +1,972 @@
+/**
+ * @file sim_main.cpp
+ * @brief Native simulation and benchmark driver (PlatformIO env:native)
+ *
+ * Runs the orchestrator core with mock-mode components on the virtual
+ * clock, fast-forwarding through idle time, then reports host-side costs
+ * of the scheduler, the rules engine, logging and configuration storage.
+ * Small scenario checks (rule hysteresis, ...) run after the simulation
+ * and set the exit code like the millis() wrap check.
+ *
+ * Usage:
+ *   pio run -e native && .pio/build/native/program [options]
+ *     --hours N       Simulated time to run (default 24)
+ *     --tick-ms N     Main-loop cadence, like delay(10) in main.cpp (default 10)
+ *     --near-wrap     Start 30 minutes before the 32-bit millis() wrap
+ *     --fs DIR        Directory backing LittleFS (default .pio/native_fs)
+ *     --verbose       Print firmware log output
+ *     --no-bench      Skip the micro-benchmarks
+ *     --soak          Run the resource pressure scenario instead (heap ramp,
+ *                     hold, recovery, noise) and check the governor's levels
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <chrono>
+#include <stdio.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <string.h>
+#include <vector>
+#include "../../src/core/ComponentRegistry.h"
+#include "../../src/core/Orchestrator.h"
+#include "../../src/core/ResourceGovernor.h"
+#include "../../src/core/WiFiConnectionManager.h"
+#include "../../src/storage/ConfigStorage.h"
+#include "../../src/storage/FlashQueue.h"
+#include "../../src/utils/Logger.h"
+
+namespace {
+
+typedef std::chrono::steady_clock HostClock;
+
+struct SimOptions {
+    double hours = 24.0;
+    uint32_t tickMs = 10;
+    bool nearWrap = false;
+    const char* fsRoot = ".pio/native_fs";
+    bool verbose = false;
+    bool bench = true;
+    bool soak = false;
+};
+
+// Longest idle jump; keeps periodic system checks and the WiFi state machine ticking
+const int64_t MAX_IDLE_STEP_US = 1000000;
+const int64_t WRAP_US = 4294967296LL * 1000;
+
+double elapsedUs(HostClock::time_point start) {
+    return std::chrono::duration<double, std::micro>(HostClock::now() - start).count();
+}
+
+bool parseOptions(int argc, char** argv, SimOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hours") == 0 && i + 1 < argc) {
+            options.hours = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--tick-ms") == 0 && i + 1 < argc) {
+            options.tickMs = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--near-wrap") == 0) {
+            options.nearWrap = true;
+        } else if (strcmp(argv[i], "--fs") == 0 && i + 1 < argc) {
+            options.fsRoot = argv[++i];
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            options.verbose = true;
+        } else if (strcmp(argv[i], "--no-bench") == 0) {
+            options.bench = false;
+        } else if (strcmp(argv[i], "--soak") == 0) {
+            options.soak = true;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return false;
+        }
+    }
+    if (options.tickMs == 0) options.tickMs = 1;
+    return true;
+}
+
+/**
+ * @brief Component set used by the simulation: every sensor in mock mode
+ */
+JsonDocument componentConfig(const char* type, const char* id) {
+    JsonDocument config;
+    config["component_type"] = type;
+    config["component_id"] = id;
+
+    if (strcmp(type, "DHT22") == 0) {
+        config["pin"] = 15;
+        config["sensorType"] = 22;
+        config["samplingIntervalMs"] = 5000;
+    } else if (strcmp(type, "PHSensor") == 0 || strcmp(type, "ECProbe") == 0) {
+        config["gpio_pin"] = 0;  // Mock mode
+        config["temperature_source_id"] = "dht22-1";
+    } else if (strcmp(type, "PeristalticPump") == 0) {
+        config["pin_no"] = strcmp(id, "pump-1") == 0 ? 26 : 27;
+        config["liquid_name"] = "Nutrient";
+    }
+    return config;
+}
+
+void prepareFilesystem(const SimOptions& options) {
+    NativeSim::setFilesystemRoot(options.fsRoot);
+    LittleFS.format();
+
+    ConfigStorage storage;
+    storage.init();
+
+    const char* components[][2] = {
+        {"DHT22", "dht22-1"},
+        {"PHSensor", "ph-sensor-1"},
+        {"ECProbe", "ec-probe-1"},
+        {"PeristalticPump", "pump-1"},
+        {"PeristalticPump", "pump-2"},
+    };
+    for (auto& component : components) {
+        storage.saveComponentConfig(component[1], componentConfig(component[0], component[1]));
+    }
+}
+
+void printComponentTable(const Orchestrator& orchestrator) {
+    printf("  %-14s %-16s %8s %7s %12s %12s\n", "component", "type", "execs", "errors", "max_dur_us", "max_lag_us");
+    for (BaseComponent* component : orchestrator.getComponents()) {
+        JsonDocument stats = component->getStatistics();
+        printf("  %-14s %-16s %8u %7u %12u %12u\n",
+               component->getId().c_str(), component->getType().c_str(),
+               stats["execution_count"].as<uint32_t>(), stats["error_count"].as<uint32_t>(),
+               stats["max_duration_us"].as<uint32_t>(), stats["max_lag_us"].as<uint32_t>());
+    }
+}
+
+/**
+ * @brief Run the orchestrator loop for the configured simulated time
+ * @return false if a wrap-crossing run left a component unscheduled
+ */
+bool runSimulation(Orchestrator& orchestrator, const SimOptions& options) {
+    const int64_t tickUs = (int64_t)options.tickMs * 1000;
+    const int64_t startUs = NativeSim::nowUs();
+    const int64_t endUs = startUs + (int64_t)(options.hours * 3600.0 * 1e6);
+
+    std::vector<uint32_t> countsAtWrap;
+    bool wrapCrossed = false;
+
+    uint64_t loops = 0;
+    double loopHostUs = 0;
+    HostClock::time_point wallStart = HostClock::now();
+
+    while (NativeSim::nowUs() < endUs) {
+        WiFiConnectionManager::loop();
+
+        HostClock::time_point loopStart = HostClock::now();
+        orchestrator.loop();
+        loopHostUs += elapsedUs(loopStart);
+        loops++;
+
+        if (options.nearWrap && !wrapCrossed && NativeSim::nowUs() >= WRAP_US) {
+            wrapCrossed = true;
+            for (BaseComponent* component : orchestrator.getComponents()) {
+                countsAtWrap.push_back(component->getExecutionCount());
+            }
+        }
+
+        // Fast-forward: skip straight to the next due component (at least one tick)
+        int64_t now = NativeSim::nowUs();
+        int64_t step = MAX_IDLE_STEP_US;
+        for (BaseComponent* component : orchestrator.getComponents()) {
+            if (component->getState() != ComponentState::READY) continue;
+            int64_t untilDue = component->getNextExecutionUs() - now;
+            if (untilDue < step) step = untilDue;
+        }
+        NativeSim::advanceUs(step > tickUs ? step : tickUs);
+    }
+
+    double wallUs = elapsedUs(wallStart);
+    double simulatedS = (double)(NativeSim::nowUs() - startUs) / 1e6;
+    JsonDocument stats = orchestrator.getSystemStats();
+    uint32_t executions = stats["totalExecutions"] | 0;
+
+    printf("\n== Simulation ==\n");
+    printf("  simulated        %.1f h (%.0f s)\n", simulatedS / 3600.0, simulatedS);
+    printf("  host time        %.2f s (%.0fx real time)\n", wallUs / 1e6, simulatedS * 1e6 / wallUs);
+    printf("  loop passes      %llu (%.2f us host per pass)\n", (unsigned long long)loops, loopHostUs / loops);
+    printf("  executions       %u (%u errors), %.2f us host per execution incl. scheduling\n",
+           executions, stats["totalErrors"].as<uint32_t>(), executions ? loopHostUs / executions : 0.0);
+    printf("  serial output    %llu bytes\n", (unsigned long long)NativeSim::serialBytes());
+    printComponentTable(orchestrator);
+
+    if (!options.nearWrap) return true;
+
+    // Every component must keep executing after millis() wrapped
+    bool ok = wrapCrossed;
+    size_t index = 0;
+    for (BaseComponent* component : orchestrator.getComponents()) {
+        if (index < countsAtWrap.size() && component->getExecutionCount() <= countsAtWrap[index]) {
+            printf("  WRAP FAIL: %s stopped executing after the millis() wrap\n", component->getId().c_str());
+            ok = false;
+        }
+        index++;
+    }
+    printf("  millis() wrap    %s\n", ok ? "crossed, all components still scheduled" : "FAILED");
+    return ok;
+}
+
+/**
+ * @brief One stretch of the pressure scenario: free heap moves linearly, plus noise
+ */
+struct SoakPhase {
+    const char* name;
+    uint32_t seconds;
+    uint32_t heapFrom;
+    uint32_t heapTo;
+    uint32_t noise;           // +/- bytes, changed every simulated second
+};
+
+struct LevelChange {
+    size_t phase;
+    int64_t atUs;
+    uint8_t from;
+    uint8_t to;
+};
+
+/**
+ * @brief Run one phase, recording level changes and per-component executions
+ */
+void runSoakPhase(Orchestrator& orchestrator, size_t index, const SoakPhase& phase,
+                  std::vector<LevelChange>& changes, std::vector<uint32_t>& executions) {
+    const int64_t startUs = NativeSim::nowUs();
+    const int64_t lengthUs = (int64_t)phase.seconds * 1000000;
+    uint32_t noiseState = 0x9E3779B9u ^ (uint32_t)index;
+    int64_t noiseSecond = -1;
+    int32_t noise = 0;
+
+    std::vector<BaseComponent*> components = orchestrator.getComponents();
+    executions.clear();
+    for (BaseComponent* component : components) {
+        executions.push_back(component->getExecutionCount());
+    }
+
+    while (NativeSim::nowUs() - startUs < lengthUs) {
+        int64_t elapsedUs = NativeSim::nowUs() - startUs;
+        if (phase.noise > 0 && elapsedUs / 1000000 != noiseSecond) {
+            noiseSecond = elapsedUs / 1000000;
+            noiseState = noiseState * 1664525u + 1013904223u;   // Deterministic across runs
+            noise = (int32_t)((noiseState >> 8) % (2 * phase.noise + 1)) - (int32_t)phase.noise;
+        }
+        int64_t heap = phase.heapFrom + ((int64_t)phase.heapTo - phase.heapFrom) * elapsedUs / lengthUs + noise;
+        NativeSim::setFreeHeap(heap > 0 ? (uint32_t)heap : 0);
+
+        uint8_t before = ResourceGovernor::getLevel();
+        WiFiConnectionManager::loop();
+        orchestrator.loop();
+        uint8_t after = ResourceGovernor::getLevel();
+        if (after != before) {
+            changes.push_back({index, NativeSim::nowUs(), before, after});
+        }
+
+        // Fast-forward, but never past a governor sample
+        int64_t now = NativeSim::nowUs();
+        int64_t step = ResourceGovernor::UPDATE_INTERVAL_MS * 1000LL;
+        for (BaseComponent* component : orchestrator.getComponents()) {
+            if (component->getState() != ComponentState::READY) continue;
+            int64_t untilDue = component->getNextExecutionUs() - now;
+            if (untilDue < step) step = untilDue;
+        }
+        NativeSim::advanceUs(step > 10000 ? step : 10000);
+    }
+
+    for (size_t i = 0; i < components.size(); i++) {
+        executions[i] = components[i]->getExecutionCount() - executions[i];
+    }
+}
+
+bool pumpIsRunning(Orchestrator& orchestrator, const char* id) {
+    ActionResult status = orchestrator.executeComponentAction(id, "get_status", JsonDocument());
+    return status.data["is_pumping"] | false;
+}
+
+/**
+ * @brief Drive free heap through the governor's levels and check its behaviour
+ * @return false if any check failed
+ *
+ * Checks: levels are entered in order up to protect; sensors sample at least
+ * 2x less often while stretched; actuators stop and refuse to start at
+ * protect; recovery steps down one level per RELAX_HOLD_MS back to normal;
+ * heap noise around a threshold does not make the level flap; every
+ * component keeps executing throughout.
+ */
+bool runSoak(Orchestrator& orchestrator) {
+    enum { BASELINE, RAMP, HOLD, RECOVER, NOISE, SETTLE };
+    const SoakPhase phases[] = {
+        {"baseline", 120, 180000, 180000, 0},
+        {"ramp", 300, 180000, 8000, 0},
+        {"hold", 120, 8000, 8000, 0},
+        {"recover", 120, 180000, 180000, 0},
+        {"noise", 600, 29000, 29000, 4000},    // Around the stretch threshold, inside its margin
+        {"settle", 60, 180000, 180000, 0},
+    };
+    const size_t phaseCount = sizeof(phases) / sizeof(phases[0]);
+
+    std::vector<LevelChange> changes;
+    std::vector<std::vector<uint32_t>> executions(phaseCount);
+    std::vector<uint8_t> levelAtEnd(phaseCount);
+    bool ok = true;
+
+    auto fail = [&ok](const String& message) {
+        printf("  SOAK FAIL: %s\n", message.c_str());
+        ok = false;
+    };
+
+    bool pumpStarted = false;
+    bool pumpRunningAtProtect = false;
+    bool pumpStartedAtProtect = false;
+    bool pumpStartsAfter = false;
+
+    for (size_t i = 0; i < phaseCount; i++) {
+        if (i == RAMP) {
+            // A continuous run must be stopped once actuators are locked
+            pumpStarted = orchestrator.executeComponentAction("pump-2", "start_continuous", JsonDocument()).success;
+        }
+        runSoakPhase(orchestrator, i, phases[i], changes, executions[i]);
+        levelAtEnd[i] = ResourceGovernor::getLevel();
+
+        if (i == HOLD) {
+            pumpRunningAtProtect = pumpIsRunning(orchestrator, "pump-2");
+            pumpStartedAtProtect = orchestrator.executeComponentAction("pump-1", "start_continuous", JsonDocument()).success;
+            if (pumpStartedAtProtect) {
+                orchestrator.executeComponentAction("pump-1", "stop", JsonDocument());
+            }
+        } else if (i == RECOVER) {
+            pumpStartsAfter = orchestrator.executeComponentAction("pump-1", "start_continuous", JsonDocument()).success;
+            orchestrator.executeComponentAction("pump-1", "stop", JsonDocument());
+        }
+    }
+
+    printf("\n== Resource pressure soak ==\n");
+    for (size_t i = 0; i < phaseCount; i++) {
+        printf("  %-9s %4u s  heap %6u -> %6u (+/-%u)  level at end: %s\n", phases[i].name, phases[i].seconds,
+               phases[i].heapFrom, phases[i].heapTo, phases[i].noise, ResourceGovernor::levelName(levelAtEnd[i]));
+    }
+    printf("  level changes:\n");
+    for (const LevelChange& change : changes) {
+        printf("    %-9s t=%8.1f s  %s -> %s\n", phases[change.phase].name, change.atUs / 1e6,
+               ResourceGovernor::levelName(change.from), ResourceGovernor::levelName(change.to));
+    }
+
+    // Escalation in order, one level at a time on a slow ramp
+    uint8_t expected = RESOURCE_NORMAL;
+    for (const LevelChange& change : changes) {
+        if (change.phase == BASELINE) {
+            fail("level changed with plenty of heap");
+        } else if (change.phase == RAMP || change.phase == HOLD) {
+            if (change.from != expected || change.to != expected + 1) {
+                fail(String("ramp went ") + ResourceGovernor::levelName(change.from) + " -> " +
+                     ResourceGovernor::levelName(change.to));
+            }
+            expected = change.to;
+        }
+    }
+    if (levelAtEnd[HOLD] != RESOURCE_PROTECT) {
+        fail("protect not reached at 8 KB free");
+    }
+
+    // Recovery one level per hold period
+    int64_t lastStepUs = 0;
+    for (const LevelChange& change : changes) {
+        if (change.phase != RECOVER) continue;
+        if (change.to + 1 != change.from) {
+            fail("recovery skipped a level");
+        }
+        if (lastStepUs != 0 && change.atUs - lastStepUs < ResourceGovernor::RELAX_HOLD_MS * 1000LL) {
+            fail("recovery stepped down before the hold time");
+        }
+        lastStepUs = change.atUs;
+    }
+    if (levelAtEnd[RECOVER] != RESOURCE_NORMAL || levelAtEnd[SETTLE] != RESOURCE_NORMAL) {
+        fail("did not recover to normal");
+    }
+
+    // Noise inside the hysteresis band may only escalate, and only once per level
+    uint32_t noiseChanges = 0;
+    for (const LevelChange& change : changes) {
+        if (change.phase != NOISE) continue;
+        noiseChanges++;
+        if (change.to < change.from) {
+            fail("level flapped under heap noise");
+        }
+    }
+    if (noiseChanges > RESOURCE_STRETCH) {
+        fail(String(noiseChanges) + " level changes under heap noise");
+    }
+
+    // Sensors slow down, actuators lock
+    std::vector<BaseComponent*> components = orchestrator.getComponents();
+    for (size_t c = 0; c < components.size(); c++) {
+        BaseComponent* component = components[c];
+        for (size_t i = 0; i < phaseCount; i++) {
+            if (executions[i][c] == 0) {
+                fail(component->getId() + " did not execute during " + phases[i].name);
+            }
+        }
+        if (!component->isTimeCritical() && executions[HOLD][c] * 2 > executions[BASELINE][c]) {
+            fail(component->getId() + " was not stretched: " + executions[BASELINE][c] + " baseline vs " +
+                 executions[HOLD][c] + " under pressure");
+        }
+        printf("  %-14s executions baseline %5u  hold %5u  recover %5u\n", component->getId().c_str(),
+               executions[BASELINE][c], executions[HOLD][c], executions[RECOVER][c]);
+    }
+    if (!pumpStarted || pumpRunningAtProtect) {
+        fail("continuous pumping was not stopped at protect");
+    }
+    if (pumpStartedAtProtect) {
+        fail("pump started while actuators were locked");
+    }
+    if (!pumpStartsAfter) {
+        fail("pump did not start again after recovery");
+    }
+
+    JsonDocument status = ResourceGovernor::getStatus();
+    printf("  %-9s %8s %8s\n", "level", "entries", "time_s");
+    for (JsonPairConst level : status["levels"].as<JsonObjectConst>()) {
+        printf("  %-9s %8u %8u\n", level.key().c_str(), level.value()["entries"].as<uint32_t>(),
+               level.value()["time_s"].as<uint32_t>());
+    }
+    printf("  transitions %u, stretched executions %u, min free heap %u\n",
+           status["transitions"].as<uint32_t>(), status["stretched_executions"].as<uint32_t>(),
+           status["min_free_heap"].as<uint32_t>());
+    printf("  resource soak    %s\n", ok ? "passed" : "FAILED");
+    return ok;
+}
+
+void benchmarkScheduler(Orchestrator& orchestrator) {
+    // Idle passes: nothing due, measures the per-loop scheduling overhead only
+    for (BaseComponent* component : orchestrator.getComponents()) {
+        component->setNextExecutionUs(NativeSim::nowUs() + 3600LL * 1000000);
+    }
+    const int passes = 200000;
+    HostClock::time_point start = HostClock::now();
+    for (int i = 0; i < passes; i++) {
+        orchestrator.loop();
+    }
+    double us = elapsedUs(start);
+    printf("  scheduler idle pass (%zu components)   %8.3f us\n", orchestrator.getComponentCount(), us / passes);
+}
+
+/**
+ * @brief Minimal sensor used to load the scheduler with hundreds of instances
+ */
+class MockChannelComponent : public BaseComponent {
+public:
+    MockChannelComponent(const String& id, ConfigStorage& storage, Orchestrator* orchestrator)
+        : BaseComponent(id, "MockChannel", id, storage, orchestrator) {}
+
+    JsonDocument getDefaultSchema() const override {
+        JsonDocument schema;
+        schema["type"] = "object";
+        JsonObject interval = schema["properties"]["interval_ms"].to<JsonObject>();
+        interval["type"] = "integer";
+        interval["default"] = 1000;
+        return schema;
+    }
+
+    bool initialize(const JsonDocument& config) override {
+        setState(ComponentState::INITIALIZING);
+        if (!loadConfiguration(config) || !applyConfig(getConfiguration())) {
+            return false;
+        }
+        setNextExecutionMs(millis());
+        setState(ComponentState::READY);
+        return true;
+    }
+
+    ExecutionResult execute() override {
+        ExecutionResult result;
+        result.success = true;
+        if (m_held) {
+            result.data["value"] = m_heldValue;
+        } else {
+            result.data["value"] = ++m_value;
+        }
+        String dataStr;
+        serializeJson(result.data, dataStr);
+        storeExecutionDataString(dataStr);   // What consumers (e.g. the rules engine) read
+        setNextExecutionMs(millis() + m_intervalMs);
+        return result;
+    }
+
+    // Publish a fixed value instead of the counter (scenario checks)
+    void hold(float value) {
+        m_held = true;
+        m_heldValue = value;
+    }
+
+    void cleanup() override {}
+
+    JsonDocument getCurrentConfig() const override {
+        JsonDocument config;
+        config["interval_ms"] = m_intervalMs;
+        return config;
+    }
+
+    bool applyConfig(const JsonDocument& config) override {
+        m_intervalMs = config["interval_ms"] | 1000;
+        return true;
+    }
+
+    std::vector<ComponentAction> getSupportedActions() const override { return {}; }
+
+    ActionResult performAction(const String& actionName, const JsonDocument& /*parameters*/) override {
+        ActionResult result;
+        result.actionName = actionName;
+        result.message = "No actions";
+        return result;
+    }
+
+private:
+    uint32_t m_intervalMs = 1000;
+    uint32_t m_value = 0;
+    bool m_held = false;
+    float m_heldValue = 0.0f;
+};
+
+/**
+ * @brief Mock whose task waits for signal bit 0 with a 30 s timeout, counting wake-ups
+ */
+class MockWaiterComponent : public MockChannelComponent {
+public:
+    using MockChannelComponent::MockChannelComponent;
+
+    ExecutionResult execute() override {
+        waitTask();
+        ExecutionResult result;
+        result.success = true;
+        result.data["wakeups"] = m_wakeups;
+        return result;
+    }
+
+    uint32_t getWakeups() const { return m_wakeups; }
+
+private:
+    uint32_t m_wakeups = 0;
+
+    TaskStep waitTask() {
+        TASK_BEGIN();
+        while (true) {
+            AWAIT_SIGNAL(1, 30000);
+            if (!taskTimedOut()) m_wakeups++;
+        }
+        TASK_END();
+    }
+};
+
+size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+void benchmarkComponentScale(Orchestrator& orchestrator, int count) {
+    ConfigStorage& storage = orchestrator.getConfigStorage();
+    size_t existing = orchestrator.getComponentCount();
+    std::vector<String> ids;
+
+    size_t heapBefore = heapInUse();
+    for (int i = 0; i < count; i++) {
+        String id = String("mock-") + i;
+        MockChannelComponent* component = new MockChannelComponent(id, storage, &orchestrator);
+        if (!component->initialize(JsonDocument()) || !orchestrator.registerComponent(component)) {
+            delete component;
+            break;
+        }
+        ids.push_back(id);
+    }
+    size_t heapAfter = heapInUse();
+
+    printf("  sizeof(BaseComponent)                    %8zu bytes\n", sizeof(BaseComponent));
+    if (!ids.empty() && heapAfter > heapBefore) {
+        // Host heap; pointer-size and allocator overhead make this an upper bound for the ESP32
+        printf("  host heap per mock component             %8zu bytes\n", (heapAfter - heapBefore) / ids.size());
+    }
+
+    std::vector<BaseComponent*> components = orchestrator.getComponents();
+    for (BaseComponent* component : components) {
+        component->setNextExecutionUs(NativeSim::nowUs() + 3600LL * 1000000);
+    }
+    const int idlePasses = 20000;
+    HostClock::time_point start = HostClock::now();
+    for (int i = 0; i < idlePasses; i++) {
+        orchestrator.loop();
+    }
+    printf("  scheduler idle pass (%zu components)   %8.3f us\n", components.size(), elapsedUs(start) / idlePasses);
+
+    // Every component due: includes execute(), result handling and rescheduling
+    const int duePasses = 200;
+    double dueUs = 0;
+    for (int i = 0; i < duePasses; i++) {
+        for (BaseComponent* component : components) {
+            component->setNextExecutionUs(NativeSim::nowUs());
+        }
+        start = HostClock::now();
+        orchestrator.loop();
+        dueUs += elapsedUs(start);
+    }
+    printf("  scheduler all-due pass (%zu components) %8.3f us\n", components.size(), dueUs / duePasses);
+
+    for (const String& id : ids) {
+        orchestrator.unregisterComponent(id);
+        storage.deleteComponentConfig(id);
+    }
+    if (orchestrator.getComponentCount() != existing) {
+        printf("  warning: %zu components left after cleanup\n", orchestrator.getComponentCount());
+    }
+}
+
+void benchmarkRules(Orchestrator& orchestrator, int producers, int rules) {
+#if COMPONENT_RULES_ENGINE
+    ConfigStorage& storage = orchestrator.getConfigStorage();
+    std::vector<String> ids;
+    for (int i = 0; i < producers; i++) {
+        String id = String("mock-r") + i;
+        MockChannelComponent* component = new MockChannelComponent(id, storage, &orchestrator);
+        JsonDocument config;
+        config["interval_ms"] = 1000 + i * 250;   // Producers sample out of phase
+        if (!component->initialize(config) || !orchestrator.registerComponent(component)) {
+            delete component;
+            break;
+        }
+        ids.push_back(id);
+    }
+
+    // Thresholds, differences and boolean combinations over the mock counters
+    JsonDocument config;
+    JsonArray list = config["rules"].to<JsonArray>();
+    for (int i = 0; i < rules; i++) {
+        JsonObject rule = list.add<JsonObject>();
+        rule["name"] = String("r") + i;
+        String a = String("mock-r") + (i % producers) + "/value";
+        String b = String("mock-r") + ((i + 1) % producers) + "/value";
+        switch (i % 3) {
+            case 0: rule["when"] = a + " > " + (i * 5); break;
+            case 1: rule["when"] = a + " - " + b + " >= 0 and not " + b + " < 10"; break;
+            default: rule["when"] = "(" + a + " + " + b + ") / 2 > 100 || " + a + " == 42"; break;
+        }
+        rule["for_ms"] = 5000;
+        rule["hysteresis"] = 1;
+    }
+    BaseComponent* engine = ComponentRegistry::create("RulesEngine", "rules-bench", "Rules benchmark",
+                                                      storage, &orchestrator);
+    if (!engine || !engine->initialize(config) || !orchestrator.registerComponent(engine)) {
+        printf("  rules engine                             FAILED to start\n");
+        delete engine;
+        engine = nullptr;
+    }
+
+    if (engine) {
+        // Ten simulated minutes
+        const int64_t endUs = NativeSim::nowUs() + 600LL * 1000000;
+        while (NativeSim::nowUs() < endUs) {
+            orchestrator.loop();
+            NativeSim::advanceUs(10000);
+        }
+
+        JsonDocument none;
+        ActionResult status = engine->executeAction("status", none);
+        uint32_t passes = status.data["passes"] | 0;
+        uint64_t evaluations = 0;
+        uint64_t weightedNs = 0;
+        for (JsonObjectConst rule : status.data["rule_stats"].as<JsonArrayConst>()) {
+            uint32_t count = rule["evaluations"] | 0;
+            evaluations += count;
+            weightedNs += (uint64_t)count * (rule["avg_eval_ns"] | 0);
+        }
+        printf("  rules engine passes (%d rules, %d producers, 10 min) %8u\n", rules, producers, passes);
+        printf("  rule evaluations (all rules every pass: %u) %10llu\n", passes * rules,
+               (unsigned long long)evaluations);
+        if (evaluations > 0) {
+            printf("  rule evaluation (host, avg)              %8.1f ns\n", (double)weightedNs / evaluations);
+        }
+        orchestrator.unregisterComponent("rules-bench");
+        storage.deleteComponentConfig("rules-bench");
+    }
+
+    for (const String& id : ids) {
+        orchestrator.unregisterComponent(id);
+        storage.deleteComponentConfig(id);
+    }
+#else
+    (void)orchestrator;
+    (void)producers;
+    (void)rules;
+#endif
+}
+
+/**
+ * @brief Check that hysteresis delays a rule's release, also under not/!
+ */
+bool checkRuleHysteresis(Orchestrator& orchestrator) {
+#if COMPONENT_RULES_ENGINE
+    ConfigStorage& storage = orchestrator.getConfigStorage();
+    MockChannelComponent* producer = new MockChannelComponent("mock-h", storage, &orchestrator);
+    producer->hold(7.0f);
+    if (!producer->initialize(JsonDocument()) || !orchestrator.registerComponent(producer)) {
+        delete producer;
+        printf("  rule hysteresis  FAILED to start\n");
+        return false;
+    }
+
+    JsonDocument config;
+    JsonArray list = config["rules"].to<JsonArray>();
+    JsonObject above = list.add<JsonObject>();
+    above["name"] = "above";
+    above["when"] = "mock-h/value > 6.5";
+    above["hysteresis"] = 0.1;
+    JsonObject notAbove = list.add<JsonObject>();
+    notAbove["name"] = "not_above";
+    notAbove["when"] = "not (mock-h/value > 6.5)";
+    notAbove["hysteresis"] = 0.1;
+    BaseComponent* engine = ComponentRegistry::create("RulesEngine", "rules-check", "Rules check",
+                                                      storage, &orchestrator);
+    bool ok = engine && engine->initialize(config) && orchestrator.registerComponent(engine);
+    if (!ok) {
+        delete engine;
+        engine = nullptr;
+    }
+
+    // Value, then the expected state of "above" and "not_above". Each rule must stay
+    // active until the value is 0.1 past its threshold on the releasing side.
+    const struct { float value; bool above; bool notAbove; } steps[] = {
+        {7.0f, true, false},
+        {6.45f, true, true},
+        {6.3f, false, true},
+        {6.55f, true, true},      // not (6.55 > 6.5) is false, but inside the band
+        {6.7f, true, false},
+    };
+    for (const auto& step : steps) {
+        if (!ok) break;
+        producer->hold(step.value);
+        producer->setNextExecutionUs(NativeSim::nowUs());
+        for (int i = 0; i < 5; i++) {
+            orchestrator.loop();
+            NativeSim::advanceUs(10000);
+        }
+
+        ActionResult status = engine->executeAction("status", JsonDocument());
+        JsonArrayConst rules = status.data["rule_stats"].as<JsonArrayConst>();
+        bool aboveActive = rules[0]["active"] | false;
+        bool notAboveActive = rules[1]["active"] | false;
+        if (aboveActive != step.above || notAboveActive != step.notAbove) {
+            printf("  RULE FAIL: at %.2f above=%d not_above=%d, expected %d/%d\n", step.value,
+                   aboveActive, notAboveActive, step.above, step.notAbove);
+            ok = false;
+        }
+    }
+    printf("  rule hysteresis  %s\n", ok ? "passed (plain and negated)" : "FAILED");
+
+    if (engine) {
+        orchestrator.unregisterComponent("rules-check");
+        storage.deleteComponentConfig("rules-check");
+    }
+    orchestrator.unregisterComponent("mock-h");
+    storage.deleteComponentConfig("mock-h");
+    return ok;
+#else
+    (void)orchestrator;
+    return true;
+#endif
+}
+
+/**
+ * @brief Check that a signal is not lost when it lands just before the task stores its deadline
+ *
+ * On the device signal() may run from an ISR or another task between
+ * taskWaitOver() reading the pending bits and storing the wait deadline.
+ * The scenario replays that order: signal, then the deadline store.
+ */
+bool checkSignalWakeup(Orchestrator& orchestrator) {
+    ConfigStorage& storage = orchestrator.getConfigStorage();
+    MockWaiterComponent* waiter = new MockWaiterComponent("mock-wait", storage, &orchestrator);
+    if (!waiter->initialize(JsonDocument()) || !orchestrator.registerComponent(waiter)) {
+        delete waiter;
+        printf("  signal wake-up   FAILED to start\n");
+        return false;
+    }
+
+    // First execution enters the wait
+    for (int i = 0; i < 3; i++) {
+        orchestrator.loop();
+        NativeSim::advanceUs(10000);
+    }
+
+    bool ok = true;
+    for (uint32_t round = 1; round <= 3 && ok; round++) {
+        MonoTimeUs deadlineUs = waiter->getNextExecutionUs();
+        waiter->signal(1);
+        waiter->setNextExecutionUs(deadlineUs);   // The task's deadline store, landing after the signal
+        for (int i = 0; i < 10; i++) {
+            orchestrator.loop();
+            NativeSim::advanceUs(10000);
+        }
+        if (waiter->getWakeups() != round) {
+            printf("  SIGNAL FAIL: round %u, %u wake-ups within 100 ms\n", round, waiter->getWakeups());
+            ok = false;
+        }
+    }
+    printf("  signal wake-up   %s\n", ok ? "passed" : "FAILED");
+
+    orchestrator.unregisterComponent("mock-wait");
+    storage.deleteComponentConfig("mock-wait");
+    return ok;
+}
+
+/**
+ * @brief Check that a delivery confirmed after the queue dropped its record pops nothing
+ *
+ * Replays the MQTT drain: peek the head, let a full queue drop it while the
+ * batch is in flight, then confirm. The newer records must survive, and
+ * compaction must keep them across a reopen.
+ */
+bool checkFlashQueue() {
+    FlashQueue queue("/data/check_queue", 64);
+    bool ok = queue.begin();
+    queue.clear();
+
+    String head;
+    uint32_t headSeq = 0;
+    ok = ok && queue.push("record-0 ................") && queue.peek(head, &headSeq);
+    for (int i = 1; ok && i <= 3; i++) {
+        ok = queue.push(String("record-") + i + " ................");
+    }
+    if (ok && queue.popIfHead(headSeq)) {
+        printf("  QUEUE FAIL: confirmation popped a record that was already dropped\n");
+        ok = false;
+    }
+
+    String expected;
+    if (ok) {
+        queue.peek(expected);
+        FlashQueue reopened("/data/check_queue", 64);
+        String recovered;
+        ok = reopened.begin() && reopened.count() == queue.count() &&
+             reopened.peek(recovered) && recovered == expected;
+        if (!ok) {
+            printf("  QUEUE FAIL: %u records after reopen, expected %u\n",
+                   (unsigned)reopened.count(), (unsigned)queue.count());
+        }
+    }
+    printf("  flash queue      %s\n", ok ? "passed" : "FAILED");
+
+    queue.clear();
+    return ok;
+}
+
+/**
+ * @brief Behaviour checks on small scenarios, run after the simulation
+ * @return false if any check failed
+ */
+bool runChecks(Orchestrator& orchestrator) {
+    printf("\n== Checks ==\n");
+    bool ok = true;
+    ok = checkRuleHysteresis(orchestrator) && ok;
+    ok = checkSignalWakeup(orchestrator) && ok;
+    ok = checkFlashQueue() && ok;
+    return ok;
+}
+
+void benchmarkLogging() {
+    const int messages = 50000;
+    String message = "Benchmark message with a value of " + String(42.5f) + " and an id ph-sensor-1";
+
+    Logger::setLevel(Logger::INFO);
+    HostClock::time_point start = HostClock::now();
+    for (int i = 0; i < messages; i++) {
+        Logger::debug("Bench", message);  // Filtered by level
+    }
+    printf("  log call below level                     %8.3f us\n", elapsedUs(start) / messages);
+
+    start = HostClock::now();
+    for (int i = 0; i < messages; i++) {
+        Logger::info("Bench", message);
+    }
+    printf("  log call to serial                       %8.3f us\n", elapsedUs(start) / messages);
+
+    Logger::enableFileLogging(true, 50);
+    const int fileMessages = 5000;
+    start = HostClock::now();
+    for (int i = 0; i < fileMessages; i++) {
+        Logger::info("Bench", message);
+    }
+    printf("  log call to serial + LittleFS file       %8.3f us\n", elapsedUs(start) / fileMessages);
+    Logger::enableFileLogging(false);
+    Logger::setLevel(Logger::WARNING);
+}
+
+void benchmarkStorage(ConfigStorage& storage) {
+    JsonDocument config = componentConfig("PHSensor", "bench-ph");
+    for (int i = 0; i < 10; i++) {
+        config[String("calibration_point_") + i] = 4.0 + i * 0.5;
+    }
+
+    const int rounds = 500;
+    HostClock::time_point start = HostClock::now();
+    for (int i = 0; i < rounds; i++) {
+        storage.saveComponentConfig("bench-ph", config);
+    }
+    printf("  component config save                    %8.3f us\n", elapsedUs(start) / rounds);
+
+    JsonDocument loaded;
+    start = HostClock::now();
+    for (int i = 0; i < rounds; i++) {
+        storage.loadComponentConfig("bench-ph", loaded);
+    }
+    printf("  component config load                    %8.3f us\n", elapsedUs(start) / rounds);
+
+    start = HostClock::now();
+    for (int i = 0; i < rounds; i++) {
+        std::vector<String> ids = storage.listComponentConfigs();
+    }
+    printf("  list component configs                   %8.3f us\n", elapsedUs(start) / rounds);
+    storage.deleteComponentConfig("bench-ph");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SimOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+
+    NativeSim::setSerialOutput(options.verbose);
+    if (options.nearWrap) {
+        NativeSim::setNowUs(WRAP_US - 30LL * 60 * 1000000);
+    }
+
+    prepareFilesystem(options);
+    NativeSim::setWiFiConnected(true);
+    WiFiConnectionManager::begin("native-sim", "");
+
+    Orchestrator orchestrator;
+    if (!orchestrator.init()) {
+        fprintf(stderr, "Orchestrator initialization failed\n");
+        return 1;
+    }
+    Logger::setLevel(options.verbose ? Logger::INFO : Logger::WARNING);
+
+    if (options.soak) {
+        return runSoak(orchestrator) ? 0 : 1;
+    }
+
+    bool ok = runSimulation(orchestrator, options);
+    ok = runChecks(orchestrator) && ok;
+
+    if (options.bench) {
+        printf("\n== Benchmarks (host time per operation) ==\n");
+        NativeSim::setSerialOutput(false);
+        benchmarkScheduler(orchestrator);
+        benchmarkComponentScale(orchestrator, 200);
+        benchmarkRules(orchestrator, 8, 32);
+        benchmarkLogging();
+        benchmarkStorage(orchestrator.getConfigStorage());
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""
+ESP32 IoT Orchestrator - per-component flash/RAM size report
+
+Attributes the firmware ELF's symbols to the component types registered
+with REGISTER_COMPONENT_TYPE() in src/components, so the cost of each
+COMPONENT_<NAME> build flag is visible before deciding what to drop.
+
+    flash     code + read-only data of the class (methods, vtable, typeinfo,
+              registry entry); string literals merged into .rodata and
+              library template instances are not attributed
+    sram      static .data/.bss owned by the class
+    instance  sizeof(class) per instance, from GET /api/components/types
+              when --host is given (heap the instance allocates is extra)
+
+Runs after every esp32dev build (extra_scripts in platformio.ini) and
+writes .pio/build/<env>/component_sizes.txt. Standalone:
+
+    scripts/component_size_report.py                          # default ELF
+    scripts/component_size_report.py --host 192.168.1.50      # add instance bytes
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import urllib.request
+
+DEFAULT_ELF = ".pio/build/esp32dev/firmware.elf"
+NM = "xtensa-esp32-elf-nm"
+REGISTER_RE = re.compile(r'REGISTER_COMPONENT_TYPE\((\w+),\s*"(\w+)"')
+FLAG_RE = re.compile(r'^#endif // (COMPONENT_\w+)\s*\Z', re.M)
+FLASH_TYPES = set("tTwWrRvV")
+SRAM_TYPES = set("dDbBsS")
+
+
+def find_nm(explicit):
+    if explicit:
+        return explicit
+    found = shutil.which(NM)
+    if found:
+        return found
+    # PlatformIO keeps the toolchain out of PATH
+    pattern = os.path.expanduser("~/.platformio/packages/toolchain-xtensa-esp32*/bin/" + NM)
+    candidates = sorted(glob.glob(pattern))
+    if candidates:
+        return candidates[-1]
+    raise SystemExit("%s not found; pass --nm" % NM)
+
+
+def registered_types(src_dir):
+    """(class, type, flag) for every REGISTER_COMPONENT_TYPE() in the sources."""
+    types = []
+    for path in sorted(glob.glob(os.path.join(src_dir, "components", "*.cpp"))):
+        with open(path) as f:
+            text = f.read()
+        match = REGISTER_RE.search(text)
+        if not match:
+            continue
+        flag = FLAG_RE.search(text)
+        types.append((match.group(1), match.group(2), flag.group(1) if flag else "-"))
+    return types
+
+
+def owner(symbol, classes):
+    """Class a demangled symbol belongs to, or None."""
+    for prefix in ("vtable for ", "typeinfo for ", "typeinfo name for ",
+                   "construction vtable for ", "VTT for "):
+        if symbol.startswith(prefix):
+            symbol = symbol[len(prefix):]
+            break
+    for cls in classes:
+        if symbol == cls or symbol.startswith(cls + "::"):
+            return cls
+        # Factory and registry entry emitted by REGISTER_COMPONENT_TYPE()
+        if symbol.startswith("create" + cls + "(") or symbol in ("s_registryEntry" + cls, "s_registrar" + cls):
+            return cls
+    return None
+
+
+def measure(nm, elf, classes):
+    output = subprocess.run([nm, "-C", "-S", "--defined-only", elf],
+                            check=True, capture_output=True, text=True).stdout.splitlines()
+    sizes = {cls: {"flash": 0, "sram": 0, "symbols": 0} for cls in classes}
+    for line in output:
+        # address size type name; symbols without a size have three fields
+        parts = line.split(None, 3)
+        if len(parts) < 4:
+            continue
+        size, kind, name = parts[1], parts[2], parts[3]
+        cls = owner(name, classes)
+        if not cls:
+            continue
+        entry = sizes[cls]
+        entry["symbols"] += 1
+        if kind in FLASH_TYPES:
+            entry["flash"] += int(size, 16)
+        elif kind in SRAM_TYPES:
+            entry["sram"] += int(size, 16)
+    return sizes
+
+
+def instance_bytes(host):
+    if not host:
+        return {}
+    host = host if "://" in host else "http://" + host
+    with urllib.request.urlopen(host.rstrip("/") + "/api/components/types", timeout=10) as response:
+        body = json.loads(response.read().decode("utf-8"))
+    return {t["class"]: t["instance_bytes"] for t in body.get("types", [])}
+
+
+def report(nm, elf, src_dir, host=None):
+    types = registered_types(src_dir)
+    classes = [cls for cls, _, _ in types]
+    sizes = measure(nm, elf, classes)
+    instances = instance_bytes(host)
+
+    lines = ["# component size report: %s" % elf,
+             "%-18s %-28s %-30s %8s %6s %9s" % ("type", "class", "flag", "flash", "sram", "instance")]
+    total_flash = 0
+    not_linked = []
+    for cls, type_name, flag in sorted(types, key=lambda t: -sizes[t[0]]["flash"]):
+        size = sizes[cls]
+        if size["symbols"] == 0:
+            not_linked.append(type_name)
+            continue
+        total_flash += size["flash"]
+        instance = instances.get(cls)
+        lines.append("%-18s %-28s %-30s %8d %6d %9s" % (type_name, cls, flag, size["flash"], size["sram"],
+                                                       instance if instance is not None else "-"))
+    lines.append("# %d bytes of flash attributed to %d linked types" % (total_flash, len(types) - len(not_linked)))
+    if not_linked:
+        lines.append("# not linked: %s" % ", ".join(sorted(not_linked)))
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Per-component flash/RAM report for the firmware ELF")
+    parser.add_argument("--elf", default=DEFAULT_ELF, help="firmware ELF (default %s)" % DEFAULT_ELF)
+    parser.add_argument("--nm", help="nm binary (default: PATH, then ~/.platformio)")
+    parser.add_argument("--src", default="src", help="source tree with components/ (default src)")
+    parser.add_argument("--host", help="running node to read instance sizes from")
+    parser.add_argument("--out", help="also write the report to this file")
+    args = parser.parse_args()
+
+    if not os.path.exists(args.elf):
+        raise SystemExit("ELF not found: %s (build the firmware or pass --elf)" % args.elf)
+    text = report(find_nm(args.nm), args.elf, args.src, args.host)
+    sys.stdout.write(text)
+    if args.out:
+        with open(args.out, "w") as f:
+            f.write(text)
+
+
+def register_post_build(env):
+    """PlatformIO extra_scripts hook: write the report next to firmware.elf."""
+    def post_build(target, source, env):
+        elf = str(target[0])
+        nm = env.subst("$CC").replace("gcc", "nm")
+        out = os.path.join(env.subst("$BUILD_DIR"), "component_sizes.txt")
+        try:
+            text = report(nm, elf, env.subst("$PROJECT_SRC_DIR"))
+        except (OSError, subprocess.CalledProcessError) as error:
+            print("component size report skipped: %s" % error)
+            return
+        with open(out, "w") as f:
+            f.write(text)
+        print(text, end="")
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", post_build)
+
+
+if __name__ == "__main__":
+    main()
+else:
+    try:
+        Import("env")  # noqa: F821 - provided by PlatformIO's SCons environment
+        register_post_build(env)  # noqa: F821
+    except NameError:
+        pass
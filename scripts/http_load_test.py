@@ -0,0 +1,395 @@
+#!/usr/bin/env python3
+"""
+ESP32 IoT Orchestrator - HTTP load test
+
+Replays a weighted mix of the requests the dashboard and API clients make
+(dashboard polls, config reads, read-only actions, static assets) against a
+node with N concurrent keep-alive clients, while sampling the node's heap
+from /api/system/memory. Reports throughput, latency percentiles and status
+codes per endpoint plus the heap trajectory, as text or as JSON with stable
+key order so two runs can be diffed.
+
+Usage:
+    scripts/http_load_test.py 192.168.1.50                         # 4 clients, 60 s
+    scripts/http_load_test.py 192.168.1.50 -c 8 -d 300             # heavier, longer
+    scripts/http_load_test.py 192.168.1.50 --mix poll=10,static=0  # API only
+    scripts/http_load_test.py 192.168.1.50 --json > run-a.json     # diffable report
+    diff <(jq . run-a.json) <(jq . run-b.json)
+
+Mix categories (default weights):
+    poll=6     GET /api/components/data[?filter=core], /api/system/status
+    config=2   GET /api/components, /api/component/config?id=<id>
+    action=1   POST /api/components/<id>/actions/<action> (read-only actions only)
+    static=1   GET /, /style.css, /app.js
+
+Actions are discovered from GET /api/components/<id>/actions and limited to
+--actions (default: get_status, status, read_sensor, read_light) with no
+required parameters, so the test never doses, calibrates or restarts.
+"""
+
+import argparse
+import http.client
+import json
+import random
+import sys
+import threading
+import time
+from urllib.parse import urlsplit
+
+DEFAULT_MIX = {"poll": 6, "config": 2, "action": 1, "static": 1}
+DEFAULT_ACTIONS = "get_status,status,read_sensor,read_light"
+STATIC_PATHS = ["/", "/style.css", "/app.js"]
+MEMORY_PATH = "/api/system/memory"
+PERCENTILES = (50, 90, 99)
+
+
+class Target:
+    def __init__(self, base_url, timeout):
+        if "://" not in base_url:
+            base_url = "http://" + base_url
+        parts = urlsplit(base_url)
+        self.host = parts.hostname
+        self.port = parts.port or 80
+        self.timeout = timeout
+
+    def connect(self):
+        return http.client.HTTPConnection(self.host, self.port, timeout=self.timeout)
+
+
+class Client:
+    """One keep-alive connection; reconnects after any transport error."""
+
+    def __init__(self, target):
+        self.target = target
+        self.conn = None
+
+    def request(self, method, path):
+        """Returns (status or error name, latency seconds, body bytes)."""
+        start = time.perf_counter()
+        try:
+            if self.conn is None:
+                self.conn = self.target.connect()
+            headers = {"Content-Length": "0"} if method == "POST" else {}
+            self.conn.request(method, path, headers=headers)
+            response = self.conn.getresponse()
+            body = response.read()
+            status = response.status
+            if response.will_close:
+                self.close()
+        except (OSError, http.client.HTTPException) as exc:
+            self.close()
+            return type(exc).__name__, time.perf_counter() - start, b""
+        return status, time.perf_counter() - start, body
+
+    def close(self):
+        if self.conn is not None:
+            self.conn.close()
+            self.conn = None
+
+
+class EndpointStats:
+    def __init__(self):
+        self.latencies = []
+        self.codes = {}
+        self.bytes = 0
+
+    def add(self, status, latency, size):
+        self.latencies.append(latency)
+        key = str(status)
+        self.codes[key] = self.codes.get(key, 0) + 1
+        self.bytes += size
+
+    def errors(self):
+        return sum(n for code, n in self.codes.items() if not code.startswith("2"))
+
+
+def percentile(sorted_values, pct):
+    if not sorted_values:
+        return 0.0
+    index = min(len(sorted_values) - 1, int(round(pct / 100.0 * (len(sorted_values) - 1))))
+    return sorted_values[index]
+
+
+def parse_mix(text):
+    mix = dict(DEFAULT_MIX)
+    if text:
+        for item in text.split(","):
+            name, _, weight = item.partition("=")
+            if name not in DEFAULT_MIX or not weight.isdigit():
+                raise argparse.ArgumentTypeError("bad mix entry: " + item)
+            mix[name] = int(weight)
+    if sum(mix.values()) == 0:
+        raise argparse.ArgumentTypeError("mix weights are all zero")
+    return mix
+
+
+def fetch_json(client, path):
+    status, _, body = client.request("GET", path)
+    if status != 200:
+        return None
+    try:
+        return json.loads(body)
+    except ValueError:
+        return None
+
+
+def discover(target, allowed_actions):
+    """Component ids and their read-only, parameterless actions."""
+    client = Client(target)
+    listing = fetch_json(client, "/api/components")
+    if listing is None:
+        client.close()
+        raise SystemExit("cannot read /api/components from %s:%d" % (target.host, target.port))
+
+    component_ids = [c["id"] for c in listing.get("components", []) if c.get("id")]
+    actions = []
+    for component_id in component_ids:
+        info = fetch_json(client, "/api/components/%s/actions" % component_id) or {}
+        for action in info.get("actions", []):
+            required = [p for p in action.get("parameters", []) if p.get("required")]
+            if action.get("name") in allowed_actions and not required:
+                actions.append((component_id, action["name"]))
+    client.close()
+    return component_ids, actions
+
+
+def build_scenarios(mix, component_ids, actions):
+    """Weighted (weight, category, method, path) list."""
+    scenarios = []
+
+    def add(category, method, paths):
+        if mix[category] and paths:
+            weight = float(mix[category]) / len(paths)
+            for path in paths:
+                scenarios.append((weight, category, method, path))
+
+    add("poll", "GET", ["/api/components/data", "/api/components/data?filter=core", "/api/system/status"])
+    add("config", "GET", ["/api/components"] + ["/api/component/config?id=" + c for c in component_ids])
+    add("action", "POST", ["/api/components/%s/actions/%s" % a for a in actions])
+    add("static", "GET", STATIC_PATHS)
+    return scenarios
+
+
+def endpoint_key(method, path):
+    """Groups per-component requests so reports from different nodes line up."""
+    if path.startswith("/api/component/config?id="):
+        return "GET /api/component/config?id=*"
+    if path.startswith("/api/components/") and "/actions/" in path:
+        return "POST /api/components/*/actions/" + path.rsplit("/", 1)[1]
+    return method + " " + path
+
+
+def worker(target, scenarios, weights, deadline, max_requests, counter, lock, results, think_s, seed):
+    client = Client(target)
+    rng = random.Random(seed)
+    local = {}
+    while time.monotonic() < deadline:
+        with lock:
+            if max_requests and counter[0] >= max_requests:
+                break
+            counter[0] += 1
+        _, category, method, path = rng.choices(scenarios, weights)[0]
+        status, latency, body = client.request(method, path)
+        local.setdefault((category, endpoint_key(method, path)), EndpointStats()).add(status, latency, len(body))
+        if think_s:
+            time.sleep(think_s)
+    client.close()
+    with lock:
+        for key, stats in local.items():
+            merged = results.setdefault(key, EndpointStats())
+            merged.latencies.extend(stats.latencies)
+            merged.bytes += stats.bytes
+            for code, n in stats.codes.items():
+                merged.codes[code] = merged.codes.get(code, 0) + n
+
+
+def read_heap(client, start):
+    memory = fetch_json(client, MEMORY_PATH)
+    if memory is None:
+        return None
+    return {
+        "t_s": round(time.monotonic() - start, 1),
+        "free_heap": memory.get("free_heap", 0),
+        "min_free_heap": memory.get("min_free_heap", 0),
+        "max_alloc_heap": memory.get("max_alloc_heap", 0),
+    }
+
+
+def sample_heap(target, interval_s, stop, samples, start):
+    client = Client(target)
+    while not stop.is_set():
+        sample = read_heap(client, start)
+        if sample is not None:
+            samples.append(sample)
+        stop.wait(interval_s)
+    client.close()
+
+
+def build_report(args, mix, results, samples, elapsed_s, component_ids, actions):
+    endpoints = {}
+    total = EndpointStats()
+    for (category, key), stats in sorted(results.items(), key=lambda item: item[0][1]):
+        latencies = sorted(stats.latencies)
+        entry = {
+            "category": category,
+            "requests": len(latencies),
+            "rps": round(len(latencies) / elapsed_s, 2),
+            "errors": stats.errors(),
+            "codes": dict(sorted(stats.codes.items())),
+            "bytes": stats.bytes,
+            "latency_ms": {"p%d" % p: round(percentile(latencies, p) * 1000, 1) for p in PERCENTILES},
+        }
+        entry["latency_ms"]["max"] = round(latencies[-1] * 1000, 1) if latencies else 0.0
+        endpoints[key] = entry
+        total.latencies.extend(latencies)
+        total.bytes += stats.bytes
+        for code, n in stats.codes.items():
+            total.codes[code] = total.codes.get(code, 0) + n
+
+    latencies = sorted(total.latencies)
+    summary = {
+        "requests": len(latencies),
+        "rps": round(len(latencies) / elapsed_s, 2),
+        "errors": total.errors(),
+        "codes": dict(sorted(total.codes.items())),
+        "bytes": total.bytes,
+        "latency_ms": {"p%d" % p: round(percentile(latencies, p) * 1000, 1) for p in PERCENTILES},
+    }
+    summary["latency_ms"]["max"] = round(latencies[-1] * 1000, 1) if latencies else 0.0
+
+    heap = {"samples": samples}
+    if samples:
+        free = [s["free_heap"] for s in samples]
+        heap.update({
+            "start_free": free[0],
+            "end_free": free[-1],
+            "lowest_free": min(free),
+            "lowest_min_free": min(s["min_free_heap"] for s in samples),
+            "lowest_max_alloc": min(s["max_alloc_heap"] for s in samples),
+            "drift_bytes": free[-1] - free[0],
+        })
+
+    return {
+        "target": "%s:%d" % (args.target.host, args.target.port),
+        "config": {
+            "concurrency": args.concurrency,
+            "duration_s": args.duration,
+            "max_requests": args.requests,
+            "think_ms": args.think_ms,
+            "mix": mix,
+            "components": len(component_ids),
+            "actions": ["%s/%s" % a for a in actions],
+        },
+        "elapsed_s": round(elapsed_s, 1),
+        "summary": summary,
+        "endpoints": endpoints,
+        "heap": heap,
+    }
+
+
+def print_report(report):
+    config = report["config"]
+    summary = report["summary"]
+    print("Target      %s" % report["target"])
+    print("Clients     %d, mix %s, %d components, %d actions"
+          % (config["concurrency"], ",".join("%s=%d" % kv for kv in sorted(config["mix"].items())),
+             config["components"], len(config["actions"])))
+    print("Elapsed     %.1f s" % report["elapsed_s"])
+    print("Throughput  %d requests, %.2f req/s, %d errors, %d bytes"
+          % (summary["requests"], summary["rps"], summary["errors"], summary["bytes"]))
+    print("Latency ms  p50 %(p50).1f  p90 %(p90).1f  p99 %(p99).1f  max %(max).1f" % summary["latency_ms"])
+    print("Codes       %s" % "  ".join("%s:%d" % kv for kv in summary["codes"].items()))
+
+    print()
+    print("%-46s %7s %8s %7s %7s %7s %7s  %s" % ("endpoint", "reqs", "req/s", "p50", "p90", "p99", "max", "codes"))
+    for key, entry in report["endpoints"].items():
+        lat = entry["latency_ms"]
+        print("%-46s %7d %8.2f %7.1f %7.1f %7.1f %7.1f  %s"
+              % (key[:46], entry["requests"], entry["rps"], lat["p50"], lat["p90"], lat["p99"], lat["max"],
+                 " ".join("%s:%d" % kv for kv in entry["codes"].items())))
+
+    heap = report["heap"]
+    print()
+    if not heap["samples"]:
+        print("Heap        no samples (is %s reachable?)" % MEMORY_PATH)
+        return
+    print("Heap        free %d -> %d (drift %+d), lowest free %d, lowest min_free %d, lowest max_alloc %d"
+          % (heap["start_free"], heap["end_free"], heap["drift_bytes"], heap["lowest_free"],
+             heap["lowest_min_free"], heap["lowest_max_alloc"]))
+    for sample in heap["samples"]:
+        print("  %7.1fs  free %7d  min_free %7d  max_alloc %7d"
+              % (sample["t_s"], sample["free_heap"], sample["min_free_heap"], sample["max_alloc_heap"]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="HTTP load test for the ESP32 orchestrator web API")
+    parser.add_argument("target", help="node address, e.g. 192.168.1.50 or http://node.local:80")
+    parser.add_argument("-c", "--concurrency", type=int, default=4, help="concurrent clients (default 4)")
+    parser.add_argument("-d", "--duration", type=float, default=60, help="test length in seconds (default 60)")
+    parser.add_argument("-n", "--requests", type=int, default=0, help="stop after N requests (default: duration only)")
+    parser.add_argument("--mix", type=parse_mix, default=dict(DEFAULT_MIX),
+                        help="category weights, e.g. poll=6,config=2,action=1,static=1")
+    parser.add_argument("--actions", default=DEFAULT_ACTIONS, help="comma-separated read-only actions to invoke")
+    parser.add_argument("--think-ms", type=float, default=0, help="pause per client between requests")
+    parser.add_argument("--heap-interval", type=float, default=2.0, help="seconds between heap samples (default 2)")
+    parser.add_argument("--timeout", type=float, default=10.0, help="per-request timeout in seconds (default 10)")
+    parser.add_argument("--seed", type=int, help="seed the request mix for repeatable runs")
+    parser.add_argument("--json", action="store_true", help="print the report as JSON")
+    args = parser.parse_args()
+
+    args.target = Target(args.target, args.timeout)
+    component_ids, actions = discover(args.target, set(args.actions.split(",")))
+    scenarios = build_scenarios(args.mix, component_ids, actions)
+    if not scenarios:
+        raise SystemExit("no requests to make with mix %s" % args.mix)
+    weights = [s[0] for s in scenarios]
+
+    results = {}
+    samples = []
+    counter = [0]
+    lock = threading.Lock()
+    stop = threading.Event()
+    start = time.monotonic()
+    deadline = start + args.duration
+
+    sampler = threading.Thread(target=sample_heap, args=(args.target, args.heap_interval, stop, samples, start))
+    sampler.daemon = True
+    sampler.start()
+
+    workers = []
+    for index in range(max(1, args.concurrency)):
+        seed = None if args.seed is None else args.seed + index
+        thread = threading.Thread(target=worker, args=(args.target, scenarios, weights, deadline, args.requests,
+                                                       counter, lock, results, args.think_ms / 1000.0, seed))
+        thread.daemon = True
+        thread.start()
+        workers.append(thread)
+
+    try:
+        for thread in workers:
+            thread.join()
+    except KeyboardInterrupt:
+        print("interrupted, reporting partial results", file=sys.stderr)
+    elapsed_s = time.monotonic() - start
+
+    # One last sample after the load stops shows whether the heap recovers
+    stop.set()
+    sampler.join(args.timeout)
+    client = Client(args.target)
+    sample = read_heap(client, start)
+    client.close()
+    if sample is not None:
+        samples.append(sample)
+
+    with lock:
+        report = build_report(args, args.mix, dict(results), list(samples), max(elapsed_s, 0.001),
+                              component_ids, actions)
+    if args.json:
+        print(json.dumps(report, indent=2))
+    else:
+        print_report(report)
+    return 1 if report["summary"]["errors"] else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
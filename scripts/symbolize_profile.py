@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+ESP32 IoT Orchestrator - PC-sampling profile symbolizer
+
+Turns the raw "0x<pc> <count>" dump from GET /api/debug/profile into a
+flat profile by resolving each address against the firmware ELF with the
+toolchain's addr2line. The ELF must be the exact build that is running.
+
+Usage:
+    curl -X POST 'http://192.168.1.50/api/debug/profile/start?hz=2000'
+    sleep 30; curl -X POST http://192.168.1.50/api/debug/profile/stop
+    curl http://192.168.1.50/api/debug/profile -o profile.txt
+    scripts/symbolize_profile.py profile.txt                        # by function
+    scripts/symbolize_profile.py profile.txt --group file           # by source file
+    scripts/symbolize_profile.py profile.txt --group line --top 40  # hottest lines
+    scripts/symbolize_profile.py --host 192.168.1.50                # fetch and resolve
+
+Groups:
+    function   demangled function name (default)
+    file       source file, e.g. WebServerComponent.cpp vs ArduinoJson headers
+    line       file:line
+"""
+
+import argparse
+import glob
+import os
+import shutil
+import subprocess
+import sys
+import urllib.request
+from collections import defaultdict
+
+DEFAULT_ELF = ".pio/build/esp32dev/firmware.elf"
+ADDR2LINE = "xtensa-esp32-elf-addr2line"
+
+
+def find_addr2line(explicit):
+    if explicit:
+        return explicit
+    found = shutil.which(ADDR2LINE)
+    if found:
+        return found
+    # PlatformIO keeps the toolchain out of PATH
+    pattern = os.path.expanduser("~/.platformio/packages/toolchain-xtensa-esp32*/bin/" + ADDR2LINE)
+    candidates = sorted(glob.glob(pattern))
+    if candidates:
+        return candidates[-1]
+    raise SystemExit("%s not found; pass --addr2line" % ADDR2LINE)
+
+
+def read_dump(args):
+    if args.host:
+        host = args.host if "://" in args.host else "http://" + args.host
+        with urllib.request.urlopen(host.rstrip("/") + "/api/debug/profile", timeout=30) as response:
+            return response.read().decode("utf-8", "replace").splitlines()
+    if not args.dump or args.dump == "-":
+        return sys.stdin.read().splitlines()
+    with open(args.dump) as f:
+        return f.read().splitlines()
+
+
+def parse_dump(lines):
+    header = {}
+    counts = {}
+    for line in lines:
+        line = line.strip()
+        if not line:
+            continue
+        if line.startswith("#"):
+            for field in line[1:].split():
+                if "=" in field:
+                    key, value = field.split("=", 1)
+                    header[key] = value
+            continue
+        pc, count = line.split()
+        counts[int(pc, 16)] = counts.get(int(pc, 16), 0) + int(count)
+    return header, counts
+
+
+def symbolize(addr2line, elf, addresses):
+    """Map each address to (function, file, line) with one addr2line call."""
+    if not addresses:
+        return {}
+    cmd = [addr2line, "-e", elf, "-f", "-C", "-a"] + ["0x%08x" % a for a in addresses]
+    output = subprocess.run(cmd, check=True, capture_output=True, text=True).stdout.splitlines()
+
+    # -a prints the address before each function/location pair
+    symbols = {}
+    i = 0
+    while i + 2 < len(output):
+        address = int(output[i], 16)
+        function = output[i + 1]
+        location = output[i + 2]
+        path, _, line = location.rpartition(":")
+        line = line.split()[0] if line else "0"
+        symbols[address] = (function, path or "??", line)
+        i += 3
+    return symbols
+
+
+def group_key(symbol, group):
+    function, path, line = symbol
+    if group == "function":
+        return function
+    short = os.path.basename(path) if path != "??" else "??"
+    if group == "file":
+        return short
+    return "%s:%s" % (short, line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Symbolize an ESP32 PC-sampling profile")
+    parser.add_argument("dump", nargs="?", help="dump file from /api/debug/profile ('-' for stdin)")
+    parser.add_argument("--host", help="fetch the dump from this node instead of a file")
+    parser.add_argument("--elf", default=DEFAULT_ELF, help="firmware ELF (default %s)" % DEFAULT_ELF)
+    parser.add_argument("--addr2line", help="addr2line binary (default: PATH, then ~/.platformio)")
+    parser.add_argument("--group", choices=("function", "file", "line"), default="function")
+    parser.add_argument("--top", type=int, default=25, help="rows to print (0 = all, default 25)")
+    args = parser.parse_args()
+
+    if not args.dump and not args.host:
+        parser.error("give a dump file or --host")
+    if not os.path.exists(args.elf):
+        raise SystemExit("ELF not found: %s (build the firmware or pass --elf)" % args.elf)
+
+    header, counts = parse_dump(read_dump(args))
+    total = sum(counts.values())
+    if total == 0:
+        raise SystemExit("profile is empty (%s)" % " ".join("%s=%s" % kv for kv in sorted(header.items())))
+
+    symbols = symbolize(find_addr2line(args.addr2line), args.elf, sorted(counts))
+    flat = defaultdict(int)
+    for address, count in counts.items():
+        flat[group_key(symbols.get(address, ("??", "??", "0")), args.group)] += count
+
+    rows = sorted(flat.items(), key=lambda kv: (-kv[1], kv[0]))
+    if args.top:
+        rows = rows[:args.top]
+
+    print("# %s" % " ".join("%s=%s" % kv for kv in sorted(header.items())))
+    print("# %d samples in %d addresses, grouped by %s" % (total, len(counts), args.group))
+    print("%8s %7s %7s  %s" % ("samples", "self%", "cum%", args.group))
+    cumulative = 0
+    for key, count in rows:
+        cumulative += count
+        print("%8d %6.2f%% %6.2f%%  %s" % (count, 100.0 * count / total, 100.0 * cumulative / total, key))
+
+    dropped = int(header.get("dropped", "0"))
+    if dropped:
+        print("# %d samples dropped: histogram full, restart with more buckets" % dropped, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
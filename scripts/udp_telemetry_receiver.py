@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""
+ESP32 IoT Orchestrator - UDP telemetry receiver
+
+Reference collector for the UdpTelemetry component. Decodes report and
+dictionary datagrams, prints readings and tracks per-node sequence numbers
+to report loss, duplicates and reordering.
+
+Usage:
+    scripts/udp_telemetry_receiver.py                      # unicast, port 5005
+    scripts/udp_telemetry_receiver.py --group 239.10.0.1   # join multicast group
+    scripts/udp_telemetry_receiver.py --quiet --summary 10 # loss summary only
+
+Wire format (little-endian), see src/components/UdpTelemetryComponent.h:
+    header  <HBBIIIBB  magic 0x5445, version, type, node, seq, uptime_ms, count, flags
+    report  <HB + f/i/B channel, value type, value
+    dict    <HB + name  channel, name length, name
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import time
+
+MAGIC = 0x5445
+VERSION = 1
+PACKET_REPORT = 1
+PACKET_DICTIONARY = 2
+FLAG_FULL_REFRESH = 0x01
+HEADER = struct.Struct("<HBBIIIBB")
+UDP_IP_OVERHEAD = 28
+
+VALUE_FORMATS = {0: ("<f", 4), 1: ("<i", 4), 2: ("<B", 1)}
+
+
+class NodeStats:
+    def __init__(self, node_id):
+        self.node_id = node_id
+        self.channels = {}
+        self.values = {}
+        self.highest_seq = None
+        self.received = 0
+        self.lost = 0
+        self.duplicates = 0
+        self.reordered = 0
+        self.restarts = 0
+        self.bytes = 0
+        self.recent = set()
+        self.last_uptime = 0
+
+    def track_sequence(self, seq, uptime_ms):
+        self.received += 1
+
+        # Node rebooted: sequence starts over
+        if self.highest_seq is not None and uptime_ms < self.last_uptime and seq < self.highest_seq:
+            self.restarts += 1
+            self.highest_seq = None
+            self.recent.clear()
+        self.last_uptime = uptime_ms
+
+        if self.highest_seq is None:
+            self.highest_seq = seq
+        elif seq in self.recent:
+            self.duplicates += 1
+            self.received -= 1
+            return
+        elif seq > self.highest_seq:
+            self.lost += seq - self.highest_seq - 1
+            self.highest_seq = seq
+        else:
+            # Late arrival of something already counted as lost
+            self.reordered += 1
+            self.lost = max(0, self.lost - 1)
+
+        self.recent.add(seq)
+        if len(self.recent) > 1024:
+            self.recent = set(s for s in self.recent if s > self.highest_seq - 512)
+
+    def loss_percent(self):
+        expected = self.received + self.lost
+        return 100.0 * self.lost / expected if expected else 0.0
+
+
+def decode(data, nodes):
+    if len(data) < HEADER.size:
+        raise ValueError("short datagram (%d bytes)" % len(data))
+
+    magic, version, ptype, node_id, seq, uptime_ms, count, flags = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("bad magic 0x%04x" % magic)
+    if version != VERSION:
+        raise ValueError("unsupported version %d" % version)
+
+    node = nodes.get(node_id)
+    if node is None:
+        node = nodes[node_id] = NodeStats(node_id)
+    node.track_sequence(seq, uptime_ms)
+    node.bytes += len(data)
+
+    offset = HEADER.size
+    entries = []
+    for _ in range(count):
+        channel, kind = struct.unpack_from("<HB", data, offset)
+        offset += 3
+        if ptype == PACKET_DICTIONARY:
+            name = data[offset:offset + kind].decode("utf-8", errors="replace")
+            offset += kind
+            node.channels[channel] = name
+            entries.append((channel, name))
+        elif ptype == PACKET_REPORT:
+            fmt, size = VALUE_FORMATS.get(kind, (None, 0))
+            if fmt is None:
+                raise ValueError("unknown value type %d" % kind)
+            (value,) = struct.unpack_from(fmt, data, offset)
+            offset += size
+            if kind == 2:
+                value = bool(value)
+            node.values[channel] = value
+            entries.append((node.channels.get(channel, "#%04x" % channel), value))
+        else:
+            raise ValueError("unknown packet type %d" % ptype)
+
+    return node, ptype, seq, uptime_ms, flags, entries
+
+
+def print_summary(nodes, started):
+    elapsed = max(time.time() - started, 1e-6)
+    print("-" * 72)
+    print("%-10s %8s %6s %7s %5s %5s %5s %10s" %
+          ("node", "received", "lost", "loss%", "dup", "ooo", "rst", "bytes/s"))
+    for node in nodes.values():
+        on_air = node.bytes + node.received * UDP_IP_OVERHEAD
+        print("%08x   %8d %6d %6.2f%% %5d %5d %5d %10.1f" %
+              (node.node_id, node.received, node.lost, node.loss_percent(),
+               node.duplicates, node.reordered, node.restarts, on_air / elapsed))
+    print("-" * 72)
+    sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Receive and decode ESP32 UDP telemetry")
+    parser.add_argument("--port", type=int, default=5005, help="UDP port (default 5005)")
+    parser.add_argument("--bind", default="0.0.0.0", help="Local address to bind")
+    parser.add_argument("--group", help="Multicast group to join (e.g. 239.10.0.1)")
+    parser.add_argument("--summary", type=float, default=30.0, help="Loss summary interval in seconds")
+    parser.add_argument("--quiet", action="store_true", help="Only print summaries")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind((args.bind, args.port))
+    if args.group:
+        membership = struct.pack("4s4s", socket.inet_aton(args.group), socket.inet_aton("0.0.0.0"))
+        sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, membership)
+    sock.settimeout(1.0)
+
+    print("Listening on %s:%d%s" % (args.bind, args.port, " group " + args.group if args.group else ""))
+    nodes = {}
+    started = time.time()
+    next_summary = started + args.summary
+
+    try:
+        while True:
+            try:
+                data, sender = sock.recvfrom(2048)
+            except socket.timeout:
+                data = None
+
+            if data:
+                try:
+                    node, ptype, seq, uptime_ms, flags, entries = decode(data, nodes)
+                except (ValueError, struct.error) as exc:
+                    print("[%s] undecodable datagram from %s: %s" % (time.strftime("%H:%M:%S"), sender[0], exc))
+                    continue
+
+                if not args.quiet:
+                    stamp = time.strftime("%H:%M:%S")
+                    if ptype == PACKET_DICTIONARY:
+                        print("[%s] %08x #%d dictionary: %d channels" % (stamp, node.node_id, seq, len(entries)))
+                    else:
+                        kind = "full" if flags & FLAG_FULL_REFRESH else "delta"
+                        values = ", ".join("%s=%s" % (name, round(v, 3) if isinstance(v, float) else v)
+                                           for name, v in entries)
+                        print("[%s] %08x #%d %s (%dB): %s" % (stamp, node.node_id, seq, kind, len(data), values))
+
+            if time.time() >= next_summary:
+                print_summary(nodes, started)
+                next_summary = time.time() + args.summary
+    except KeyboardInterrupt:
+        print_summary(nodes, started)
+
+
+if __name__ == "__main__":
+    main()
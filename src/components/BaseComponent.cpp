@@ -5,12 +5,14 @@
 
 #include "BaseComponent.h"
 #include "../core/Orchestrator.h"
-#include <LittleFS.h>
+#include "../utils/SchemaValidator.h"
+#include "../utils/EventJournal.h"
 
 BaseComponent::BaseComponent(const String& id, const String& type, const String& name, ConfigStorage& storage, Orchestrator* orchestrator)
     : m_componentId(id)
     , m_componentType(type) 
     , m_componentName(name)
+    , m_traceName(Tracer::internName(id))
     , m_storage(storage)
     , m_orchestrator(orchestrator)
 {
@@ -18,168 +20,152 @@ BaseComponent::BaseComponent(const String& id, const String& type, const String&
 }
 
 bool BaseComponent::loadConfiguration(const JsonDocument& config) {
-    log(Logger::INFO, "🔥 [BOOT-TRACE] ==================== LOADING CONFIG FOR " + m_componentId + " ====================");
+    uint32_t startMs = millis();
     
-    // STEP 0: Check if LittleFS is ready and mounted
-    log(Logger::INFO, "🔥 [BOOT-TRACE] Checking LittleFS status...");
-    if (!LittleFS.begin()) {
-        log(Logger::ERROR, "🔥 [BOOT-TRACE] ❌ CRITICAL: LittleFS not mounted during component initialization!");
+    // Get default schema from derived class (regenerated on demand, not kept)
+    JsonDocument schema = getDefaultSchema();
+    JsonDocument configuration;
+    
+    if (schema.isNull() || schema.size() == 0) {
+        setError("Failed to get default schema from component");
         return false;
-    } else {
-        size_t totalBytes = LittleFS.totalBytes();
-        size_t usedBytes = LittleFS.usedBytes();
-        log(Logger::INFO, "🔥 [BOOT-TRACE] ✅ LittleFS is mounted and ready: " + String(usedBytes) + "/" + String(totalBytes) + " bytes used");
     }
     
-    // STEP 1: Check if config file already exists BEFORE we do anything
-    String configFilePath = "/config/components/" + m_componentId + ".json";
-    log(Logger::INFO, "🔥 [BOOT-TRACE] Checking for existing config file: " + configFilePath);
+    // Single hydration pass:
+    // 1. Start from the caller's document (the orchestrator has already read it
+    //    from storage) or, if none was given, read the stored file exactly once.
+    // 2. Fill any key the schema defines but the document lacks, in place.
+    // 3. Write back only when step 2 changed the document or no file exists yet.
+    const char* source = "incoming";
+    bool fromCaller = true;
+    bool persist = false;
     
-    File existingFile = LittleFS.open(configFilePath, "r");
-    if (existingFile) {
-        String existingContent = existingFile.readString();
-        existingFile.close();
-        log(Logger::INFO, "🔥 [BOOT-TRACE] ✅ EXISTING CONFIG FILE FOUND! Content: " + existingContent);
-        
-        // Parse and extract remoteHost if present
-        JsonDocument existingConfig;
-        if (deserializeJson(existingConfig, existingContent) == DeserializationError::Ok) {
-            if (existingConfig.containsKey("remoteHost")) {
-                String existingRemoteHost = existingConfig["remoteHost"].as<String>();
-                log(Logger::INFO, "🔥 [BOOT-TRACE] EXISTING FILE remoteHost: '" + existingRemoteHost + "'");
-            }
+    if (config.isNull() || config.size() == 0) {
+        fromCaller = false;
+        if (m_storage.loadComponentConfig(m_componentId, configuration)) {
+            source = "stored";
+        } else {
+            configuration.clear();
+            source = "defaults";
         }
     } else {
-        log(Logger::INFO, "🔥 [BOOT-TRACE] No existing config file found - this will be a fresh initialization");
+        configuration.set(config);
     }
     
-    // Log the incoming config parameter
-    String incomingConfigStr;
-    serializeJson(config, incomingConfigStr);
-    log(Logger::INFO, "🔥 [BOOT-TRACE] Incoming config parameter: " + incomingConfigStr);
-    
-    // Get default schema from derived class
-    m_schema = getDefaultSchema();
+    size_t defaultsApplied = applySchemaDefaults(schema, configuration);
     
-    if (m_schema.isNull() || m_schema.size() == 0) {
-        setError("Failed to get default schema from component");
+    if (configuration.isNull() || configuration.size() == 0) {
+        setError("Failed to extract default values from schema");
         return false;
     }
     
-    log(Logger::INFO, "🔥 [BOOT-TRACE] Schema loaded successfully");
-    
-    // Step 1: Extract defaults from schema
-    JsonDocument defaults = extractDefaultValues(m_schema);
-    
-    // Debug: log extracted defaults with remoteHost tracking
-    String defaultsStr;
-    serializeJson(defaults, defaultsStr);
-    log(Logger::INFO, "🔥 [BOOT-TRACE] Extracted defaults: " + defaultsStr);
-    
-    // Track remoteHost specifically
-    if (defaults.containsKey("remoteHost")) {
-        String remoteHostDefault = defaults["remoteHost"].as<String>();
-        log(Logger::INFO, "🔥 [BOOT-TRACE] Schema default remoteHost: '" + remoteHostDefault + "'");
-    }
-    
-    if (defaults.isNull() || defaults.size() == 0) {
-        setError("Failed to extract default values from schema");
+    // Validate before persisting so repaired values are written back too
+    size_t repaired = 0;
+    if (!repairConfiguration(configuration, schema, repaired)) {
         return false;
     }
     
-    // Step 2: *** CRITICAL FIX *** - Only save defaults if no config file exists
-    File checkFile = LittleFS.open(configFilePath, "r");
-    bool configFileExists = (bool)checkFile;
-    if (checkFile) checkFile.close();
+    if (defaultsApplied > 0 || repaired > 0) {
+        persist = true;
+    } else if (fromCaller) {
+        // Programmatic configs (not read from storage) still need a first save
+        persist = !m_storage.hasComponentConfig(m_componentId);
+    }
     
-    if (configFileExists) {
-        log(Logger::INFO, "🔥 [BOOT-TRACE] ✅ SKIPPING defaults save - existing config file found, preserving it!");
-    } else {
-        log(Logger::INFO, "🔥 [BOOT-TRACE] No existing config file - saving defaults for first-time setup");
-        if (!saveConfigurationToStorage(defaults)) {
-            log(Logger::WARNING, "🔥 [BOOT-TRACE] Failed to save defaults - continuing anyway");
-        } else {
-            log(Logger::INFO, "🔥 [BOOT-TRACE] ✅ Defaults saved to storage for first-time setup");
-        }
+    if (persist && !saveConfigurationToStorage(configuration)) {
+        log(Logger::WARNING, "Failed to persist hydrated configuration - continuing anyway");
     }
     
-    // Step 3: Attempt to reload from storage to validate save worked
-    log(Logger::INFO, "🔥 [BOOT-TRACE] Reloading configuration from storage...");
-    JsonDocument storedConfig = loadConfigurationFromStorage();
+    log(Logger::INFO, String("Configuration hydrated from ") + source + " (" + defaultsApplied +
+                      " defaults applied" + (repaired > 0 ? String(", ") + repaired + " invalid values reset" : String()) +
+                      (persist ? ", persisted" : "") + ") in " + (millis() - startMs) + "ms");
     
-    // Track remoteHost in stored config
-    if (!storedConfig.isNull() && storedConfig.containsKey("remoteHost")) {
-        String storedRemoteHost = storedConfig["remoteHost"].as<String>();
-        log(Logger::INFO, "🔥 [BOOT-TRACE] Stored config remoteHost: '" + storedRemoteHost + "'");
-    } else {
-        log(Logger::INFO, "🔥 [BOOT-TRACE] No remoteHost found in stored config or config is null");
+    packConfiguration(configuration);
+    
+    if (Logger::isEnabled(Logger::DEBUG)) {
+        String configStr;
+        serializeJson(configuration, configStr);
+        log(Logger::DEBUG, "Final configuration: " + configStr);
     }
     
-    // Step 4: Choose configuration source
-    if (config.isNull() || config.size() == 0) {
-        log(Logger::INFO, "🔥 [BOOT-TRACE] Incoming config is null/empty - choosing between stored and defaults");
-        if (storedConfig.isNull() || storedConfig.size() == 0) {
-            log(Logger::INFO, "🔥 [BOOT-TRACE] ❌ OVERRIDE DETECTED: Using schema defaults (stored config null/empty)");
-            m_configuration = defaults;
-        } else {
-            log(Logger::INFO, "🔥 [BOOT-TRACE] ✅ Using stored configuration from LittleFS");
-            m_configuration = storedConfig;
-        }
-    } else {
-        // Track remoteHost in incoming config
-        if (config.containsKey("remoteHost")) {
-            String incomingRemoteHost = config["remoteHost"].as<String>();
-            log(Logger::INFO, "🔥 [BOOT-TRACE] Incoming config remoteHost: '" + incomingRemoteHost + "'");
+    return true;
+}
+
+void BaseComponent::packConfiguration(const JsonDocument& configuration) {
+    m_packedConfiguration.resize(measureMsgPack(configuration));
+    serializeMsgPack(configuration, m_packedConfiguration.data(), m_packedConfiguration.size());
+    m_packedConfiguration.shrink_to_fit();
+}
+
+JsonDocument BaseComponent::getConfiguration() const {
+    JsonDocument configuration;
+    if (!m_packedConfiguration.empty()) {
+        deserializeMsgPack(configuration, m_packedConfiguration.data(), m_packedConfiguration.size());
+    }
+    return configuration;
+}
+
+bool BaseComponent::validateConfiguration(const JsonDocument& config, bool partial, SchemaError* error) {
+    const SchemaValidator* validator = SchemaValidator::find(m_componentType);
+    if (!validator) {
+        validator = SchemaValidator::compile(m_componentType, getDefaultSchema());
+        if (!validator) {
+            // Out of memory: applyConfig() still clamps what it reads
+            return true;
         }
-        
-        // Merge provided config with defaults
-        log(Logger::INFO, "🔥 [BOOT-TRACE] ❌ OVERRIDE DETECTED: Merging incoming config with defaults (ignoring stored)");
-        m_configuration = mergeConfiguration(defaults, config);
-        
-        // Save the merged config
-        log(Logger::INFO, "🔥 [BOOT-TRACE] Saving merged configuration to storage");
-        saveConfigurationToStorage(m_configuration);
     }
     
-    // Step 5: Validate final configuration
-    if (!validateConfiguration(m_configuration)) {
-        setError("Final configuration validation failed");
+    SchemaError localError;
+    SchemaError* report = error ? error : &localError;
+    if (!validator->validate(config.as<JsonVariantConst>(), partial, report)) {
+        log(Logger::WARNING, String("Configuration rejected: ") + report->field + " " + report->message);
         return false;
     }
-    
-    // Step 6: Log successful configuration with values
-    String configStr;
-    serializeJson(m_configuration, configStr);
-    log(Logger::INFO, "🔥 [BOOT-TRACE] Final configuration: " + configStr);
-    
-    // Track final remoteHost value
-    if (m_configuration.containsKey("remoteHost")) {
-        String finalRemoteHost = m_configuration["remoteHost"].as<String>();
-        log(Logger::INFO, "🔥 [BOOT-TRACE] FINAL remoteHost value: '" + finalRemoteHost + "'");
-    }
-    
     return true;
 }
 
-bool BaseComponent::validateConfiguration(const JsonDocument& config) {
-    // With default hydration architecture, no fields are truly "required"
-    // since applyConfig() provides defaults for all missing values
-    // 
-    // Future validation logic could include:
-    // - Range validation (e.g., port numbers 1-65535)
-    // - Format validation (e.g., valid IP addresses)
-    // - Logical validation (e.g., start_time < end_time)
+bool BaseComponent::repairConfiguration(JsonDocument& configuration, const JsonDocument& schema, size_t& repaired) {
+    repaired = 0;
+    const SchemaValidator* validator = SchemaValidator::compile(m_componentType, schema);
+    if (!validator) {
+        return true;
+    }
     
-    log(Logger::DEBUG, "Configuration validation passed (using default hydration)");
+    SchemaError error;
+    while (!validator->validate(configuration.as<JsonVariantConst>(), false, &error)) {
+        JsonVariantConst fallback = schema["properties"][(const char*)error.field]["default"];
+        // A default that is itself invalid would fail again: give up after one pass per rule
+        if (error.field[0] == '\0' || fallback.isNull() || repaired >= validator->getRuleCount()) {
+            setError(String("Invalid configuration: ") + error.field + " " + error.message);
+            return false;
+        }
+        log(Logger::WARNING, String("Invalid configuration value reset to default: ") + error.field + " " + error.message);
+        configuration[(const char*)error.field].set(fallback);
+        repaired++;
+    }
     return true;
 }
 
+bool BaseComponent::applyConfigurationFromJson(const JsonDocument& config, SchemaError* error) {
+    // Updates carry only the changed keys; missing ones keep their current value
+    if (!validateConfiguration(config, true, error)) {
+        return false;
+    }
+    return applyConfig(config);
+}
+
 void BaseComponent::setState(ComponentState newState) {
     if (m_state != newState) {
         ComponentState oldState = m_state;
         m_state = newState;
         
         log(Logger::INFO, "State changed: " + getStateString(oldState) + " -> " + getStateString());
+        
+        // Per-execution READY <-> EXECUTING flips would flood the journal
+        if (oldState != ComponentState::EXECUTING && newState != ComponentState::EXECUTING) {
+            EventJournal::record(EVENT_STATE, Logger::INFO, m_componentId,
+                                 getStateString(oldState) + "->" + getStateString(), (int32_t)newState);
+        }
     }
 }
 
@@ -199,20 +185,6 @@ String BaseComponent::getStateString(ComponentState state) const {
     }
 }
 
-bool BaseComponent::isReadyToExecute() const {
-    uint32_t currentTime = millis();
-    bool stateReady = (m_state == ComponentState::READY);
-    bool timeReady = (currentTime >= m_nextExecutionMs);
-    bool neverExecuted = (m_executionCount == 0);
-    
-    // Force execution if never executed and component is ready
-    if (stateReady && neverExecuted) {
-        return true;
-    }
-    
-    return stateReady && timeReady;
-}
-
 void BaseComponent::clearError() {
     m_lastError = "";
     if (m_state == ComponentState::ERROR) {
@@ -229,8 +201,61 @@ JsonDocument BaseComponent::getStatistics() const {
     stats["execution_count"] = m_executionCount;
     stats["error_count"] = m_errorCount;
     stats["last_execution_ms"] = m_lastExecutionMs;
-    stats["nextExecutionMs"] = m_nextExecutionMs;
+    stats["nextExecutionMs"] = getNextExecutionMs();
     stats["uptime"] = millis();
+    stats["next_execution_in_ms"] = (int32_t)((m_nextExecutionUs - TimeUtils::monoNowUs()) / 1000);
+    if (TimeUtils::hasEpochMapping()) {
+        if (m_lastExecutionUs > 0) {
+            stats["last_execution_epoch_ms"] = TimeUtils::monoToEpochMs(m_lastExecutionUs);
+        }
+        stats["next_execution_epoch_ms"] = TimeUtils::monoToEpochMs(m_nextExecutionUs);
+    }
+    stats["last_duration_us"] = m_lastDurationUs;
+    stats["max_duration_us"] = m_maxDurationUs;
+    stats["last_lag_us"] = m_lastLagUs;
+    stats["max_lag_us"] = m_maxLagUs;
+    stats["total_execution_ms"] = (uint32_t)(m_totalExecutionUs / 1000);
+    if (m_lastSampleUs > 0) {
+        stats["data_age_ms"] = getDataAgeMs();
+    }
+    
+    JsonObject health = stats["health"].to<JsonObject>();
+    health["score"] = m_health.score;
+    health["consecutive_failures"] = m_health.consecutiveFailures;
+    health["backoff_count"] = m_health.backoffCount;
+    health["recoveries"] = m_health.recoveries;
+    if (m_health.backoffMs > 0) {
+        health["backoff_ms"] = m_health.backoffMs;
+        health["next_probe_in_ms"] = (int32_t)((m_holdUntilUs - TimeUtils::monoNowUs()) / 1000);
+    }
+    
+    // Where a resumable task is suspended and what it waits for
+    if (m_task.resumeLine != 0) {
+        JsonObject task = stats["task"].to<JsonObject>();
+        task["resume_line"] = m_task.resumeLine;
+        task["awaited_signals"] = m_task.awaitedSignals;
+        task["pending_signals"] = m_task.pendingSignals.load();
+        if (m_task.wakeUs != 0) {
+            task["wake_in_ms"] = (int32_t)((m_task.wakeUs - TimeUtils::monoNowUs()) / 1000);
+        }
+    }
+    
+    // Age of consumed producer data
+    if (!m_dependencies.empty()) {
+        JsonArray dependencies = stats["dependencies"].to<JsonArray>();
+        for (const auto& dependency : m_dependencies) {
+            JsonObject entry = dependencies.add<JsonObject>();
+            entry["producer"] = dependency.producerId;
+            entry["max_age_ms"] = dependency.maxAgeMs;
+            entry["follow"] = dependency.followProducer;
+            entry["consumed"] = dependency.consumed;
+            entry["refreshed"] = dependency.refreshed;
+            entry["stale"] = dependency.stale;
+            entry["last_age_ms"] = dependency.lastAgeMs;
+            entry["max_age_seen_ms"] = dependency.maxAgeSeenMs;
+            entry["avg_age_ms"] = dependency.consumed ? (uint32_t)(dependency.totalAgeMs / dependency.consumed) : 0;
+        }
+    }
     
     return stats;
 }
@@ -238,10 +263,22 @@ JsonDocument BaseComponent::getStatistics() const {
 JsonDocument BaseComponent::getCoreData() const {
     // Default implementation returns last execution data
     // Derived classes should override this to return only essential sensor values
-    return m_lastData;
+    return getLastExecutionData();
+}
+
+JsonDocument BaseComponent::getLastExecutionData() const {
+    JsonDocument data;
+    if (!m_lastDataString.isEmpty()) {
+        deserializeJson(data, m_lastDataString);
+    }
+    return data;
 }
 
 void BaseComponent::setError(const String& error) {
+    // A component failing the same way on every execution is one event, not one per attempt
+    if (m_state != ComponentState::ERROR || error != m_lastError) {
+        EventJournal::record(EVENT_ERROR, Logger::ERROR, m_componentId, error, (int32_t)(m_errorCount + 1));
+    }
     m_lastError = error;
     m_errorCount++;
     setState(ComponentState::ERROR);
@@ -275,15 +312,10 @@ JsonDocument BaseComponent::mergeConfiguration(const JsonDocument& defaults, con
     // Start with defaults
     merged.set(defaults);
     
-    // Apply overrides - create a temporary writable copy
-    JsonDocument overridesCopy;
-    overridesCopy.set(overrides);
-    
-    if (overridesCopy.is<JsonObject>()) {
-        JsonObject overridesObj = overridesCopy.as<JsonObject>();
-        for (JsonPair pair : overridesObj) {
-            merged[pair.key()] = pair.value();
-        }
+    // Apply overrides straight from the read-only view (no intermediate copy)
+    JsonObjectConst overridesObj = overrides.as<JsonObjectConst>();
+    for (JsonPairConst pair : overridesObj) {
+        merged[pair.key()] = pair.value();
     }
     
     return merged;
@@ -292,49 +324,37 @@ JsonDocument BaseComponent::mergeConfiguration(const JsonDocument& defaults, con
 JsonDocument BaseComponent::extractDefaultValues(const JsonDocument& schema) {
     JsonDocument defaults;
     
-    // Create a writable copy to work with
-    JsonDocument schemaCopy;
-    schemaCopy.set(schema);
-    
-    // Check if schema has properties
-    if (!schemaCopy["properties"].is<JsonObject>()) {
+    if (!schema["properties"].is<JsonObjectConst>()) {
         log(Logger::WARNING, "Schema has no properties section");
         return defaults;
     }
     
-    JsonObject properties = schemaCopy["properties"].as<JsonObject>();
-    
-    log(Logger::DEBUG, String("Schema has ") + properties.size() + " properties");
-    
-    // Extract default value from each property
-    for (JsonPair prop : properties) {
-        String propName = prop.key().c_str();
-        JsonObject propDef = prop.value().as<JsonObject>();
-        
-        // Check if this property has a default value
-        if (!propDef["default"].isNull()) {
-            defaults[propName] = propDef["default"];
-            log(Logger::DEBUG, String("Extracted default: ") + propName + " = " + propDef["default"].as<String>());
+    applySchemaDefaults(schema, defaults);
+    return defaults;
+}
+
+size_t BaseComponent::applySchemaDefaults(const JsonDocument& schema, JsonDocument& target) {
+    JsonObjectConst properties = schema["properties"].as<JsonObjectConst>();
+    size_t applied = 0;
+    
+    for (JsonPairConst prop : properties) {
+        JsonVariantConst defaultValue = prop.value()["default"];
+        if (defaultValue.isNull() || !target[prop.key()].isNull()) {
+            continue;
         }
+        
+        target[prop.key()] = defaultValue;
+        applied++;
     }
     
-    return defaults;
+    return applied;
 }
 
 bool BaseComponent::saveConfigurationToStorage(const JsonDocument& config) {
-    log(Logger::INFO, "🔵 [SAVE] Saving configuration to storage for: " + m_componentId);
-    
-    // Log what we're saving
-    String configStr;
-    serializeJson(config, configStr);
-    log(Logger::INFO, "🔵 [SAVE] Configuration content: " + configStr);
-    
     // Use ConfigStorage to save component configuration
     bool success = m_storage.saveComponentConfig(m_componentId, config);
     
-    if (success) {
-        log(Logger::INFO, "✅ [SAVE] Successfully saved configuration to storage: " + m_componentId);
-    } else {
+    if (!success) {
         log(Logger::ERROR, "❌ [SAVE] Failed to save configuration to storage: " + m_componentId);
     }
     
@@ -344,32 +364,254 @@ bool BaseComponent::saveConfigurationToStorage(const JsonDocument& config) {
 JsonDocument BaseComponent::loadConfigurationFromStorage() {
     JsonDocument config;
     
-    log(Logger::INFO, "🔷 [LOAD] Loading configuration from storage for: " + m_componentId);
+    // Use ConfigStorage to load component configuration (one existence check + one parse)
+    if (!m_storage.loadComponentConfig(m_componentId, config)) {
+        log(Logger::DEBUG, "No stored configuration for: " + m_componentId);
+        config.clear();
+    }
     
-    // Check if config exists first
-    if (m_storage.hasComponentConfig(m_componentId)) {
-        log(Logger::INFO, "🔷 [LOAD] Found stored config file for: " + m_componentId);
-    } else {
-        log(Logger::WARNING, "⚠️ [LOAD] No stored config file exists for: " + m_componentId);
+    return config;
+}
+
+void BaseComponent::updateExecutionStats() {
+    m_lastExecutionUs = TimeUtils::monoNowUs();
+    m_lastExecutionMs = (uint32_t)(m_lastExecutionUs / 1000);
+    m_executionCount++;
+}
+
+void BaseComponent::recordExecutionTiming(uint32_t durationUs, uint32_t lagUs) {
+    m_lastDurationUs = durationUs;
+    m_totalExecutionUs += durationUs;
+    if (durationUs > m_maxDurationUs) m_maxDurationUs = durationUs;
+    m_lastLagUs = lagUs;
+    if (lagUs > m_maxLagUs) m_maxLagUs = lagUs;
+}
+
+void BaseComponent::recordExecutionOutcome(bool success, uint32_t latencyBudgetUs) {
+    const float alpha = 0.2f;   // ~5 executions of memory
+    
+    m_health.errorEwma += alpha * ((success ? 0.0f : 1.0f) - m_health.errorEwma);
+    m_health.latencyEwmaUs += alpha * ((float)m_lastDurationUs - m_health.latencyEwmaUs);
+    m_health.consecutiveFailures = success ? 0 : m_health.consecutiveFailures + 1;
+    
+    float score = 100.0f * (1.0f - m_health.errorEwma);
+    if (latencyBudgetUs > 0 && m_health.latencyEwmaUs > latencyBudgetUs) {
+        float over = (m_health.latencyEwmaUs - latencyBudgetUs) / (4.0f * latencyBudgetUs);
+        score -= 25.0f * (over < 1.0f ? over : 1.0f);
+    }
+    m_health.score = score <= 0.0f ? 0 : (uint8_t)(score + 0.5f);
+}
+
+void BaseComponent::enterBackoff(uint32_t backoffMs) {
+    if (m_health.backoffMs == 0) {
+        m_health.backoffCount++;
+    }
+    m_health.backoffMs = backoffMs;
+    m_holdUntilUs = TimeUtils::monoNowUs() + (MonoTimeUs)backoffMs * 1000;
+    if (m_nextExecutionUs < m_holdUntilUs) {
+        m_nextExecutionUs = m_holdUntilUs;
+    }
+}
+
+void BaseComponent::clearBackoff() {
+    if (m_health.backoffMs == 0) {
+        return;
+    }
+    m_health.backoffMs = 0;
+    m_holdUntilUs = 0;
+    m_health.recoveries++;
+}
+
+void BaseComponent::restoreRuntimeSnapshot(const JsonDocument& lastData, uint32_t nextDueInMs, uint32_t executionCount) {
+    if (!lastData.isNull() && lastData.size() > 0) {
+        JsonDocument data;
+        data.set(lastData);
+        data["restored"] = true;  // Lets consumers tell pre-restart readings apart
+        m_lastDataString = "";
+        serializeJson(data, m_lastDataString);
     }
     
-    // Use ConfigStorage to load component configuration
-    bool success = m_storage.loadComponentConfig(m_componentId, config);
+    // Keep the previous run's phase; a non-zero count also suppresses the forced first execution
+    m_executionCount = executionCount;
+    m_nextExecutionUs = TimeUtils::monoNowUs() + (MonoTimeUs)nextDueInMs * 1000;
     
-    if (success) {
-        String loadedStr;
-        serializeJson(config, loadedStr);
-        log(Logger::INFO, "✅ [LOAD] Successfully loaded config: " + loadedStr);
-    } else {
-        log(Logger::WARNING, "⚠️ [LOAD] Failed to load config or file doesn't exist for: " + m_componentId);
+    log(Logger::DEBUG, String("Warm state restored: next execution in ") + nextDueInMs + "ms, " +
+                       executionCount + " previous executions");
+}
+
+// In IRAM so flash-safe ISRs (FlashSafeTimer) can wake a task while the cache is off
+void IRAM_ATTR BaseComponent::signal(uint32_t bits) {
+    m_task.pendingSignals.fetch_or(bits);
+    if (m_task.awaitedSignals & bits) {
+        m_signalled = true;  // Resume on the next loop pass, whatever the schedule says
+    }
+}
+
+void BaseComponent::taskAwait(uint32_t timeoutMs, uint32_t signals) {
+    MonoTimeUs now = TimeUtils::monoNowUs();
+    m_task.awaitedSignals = signals;
+    m_task.receivedSignals = 0;
+    m_task.timedOut = false;
+    
+    // A zero delay is already over; a signal wait without timeout has no deadline
+    m_task.wakeUs = timeoutMs > 0 ? now + (MonoTimeUs)timeoutMs * 1000 : (signals ? 0 : now);
+}
+
+bool BaseComponent::taskWaitOver() {
+    MonoTimeUs now = TimeUtils::monoNowUs();
+    
+    // Clear the wake-up before reading the bits: a signal raised from here on sets it
+    // again, even if it lands between the check below and the deadline store
+    m_signalled = false;
+    
+    // Signals raised before the wait started count too, so none are lost
+    uint32_t hit = m_task.pendingSignals.load() & m_task.awaitedSignals;
+    if (hit) {
+        m_task.pendingSignals.fetch_and(~hit);
+        m_task.receivedSignals = hit;
+        m_task.awaitedSignals = 0;
+        m_task.wakeUs = 0;
+        return true;
     }
     
-    return config;
+    if (m_task.wakeUs != 0 && now >= m_task.wakeUs) {
+        m_task.timedOut = (m_task.awaitedSignals != 0);
+        m_task.awaitedSignals = 0;
+        m_task.wakeUs = 0;
+        return true;
+    }
+    
+    // Sleep until the deadline; an untimed signal wait still re-checks hourly
+    m_nextExecutionUs = m_task.wakeUs != 0 ? m_task.wakeUs : now + 3600000000LL;
+    return false;
 }
 
-void BaseComponent::updateExecutionStats() {
-    m_lastExecutionMs = millis();
-    m_executionCount++;
+bool BaseComponent::taskIoReady(bool condition, uint32_t pollMs) {
+    MonoTimeUs now = TimeUtils::monoNowUs();
+    m_signalled = false;  // As in taskWaitOver(): a later signal re-arms it
+    
+    if (condition || (m_task.wakeUs != 0 && now >= m_task.wakeUs)) {
+        m_task.timedOut = !condition;
+        m_task.pendingSignals.fetch_and(~TASK_SIGNAL_IO);
+        m_task.awaitedSignals = 0;
+        m_task.wakeUs = 0;
+        return true;
+    }
+    
+    m_task.pendingSignals.fetch_and(~TASK_SIGNAL_IO);
+    MonoTimeUs pollUs = now + (MonoTimeUs)pollMs * 1000;
+    m_nextExecutionUs = (m_task.wakeUs != 0 && m_task.wakeUs < pollUs) ? m_task.wakeUs : pollUs;
+    return false;
+}
+
+void BaseComponent::taskReset() {
+    m_task.resumeLine = 0;
+    m_task.wakeUs = 0;
+    m_task.awaitedSignals = 0;
+    m_task.receivedSignals = 0;
+    m_task.timedOut = false;
+    m_signalled = false;
+}
+
+uint32_t BaseComponent::msUntil(uint32_t deadlineMs) {
+    int32_t remaining = (int32_t)(deadlineMs - millis());
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+// === Data Dependencies ===
+
+void BaseComponent::declareDependency(const String& producerId, uint32_t maxAgeMs, bool followProducer) {
+    if (producerId.length() == 0 || producerId == m_componentId) {
+        return;
+    }
+    
+    for (auto& dependency : m_dependencies) {
+        if (dependency.producerId == producerId) {
+            dependency.maxAgeMs = maxAgeMs;
+            dependency.followProducer = followProducer;
+            return;
+        }
+    }
+    
+    DataDependency dependency;
+    dependency.producerId = producerId;
+    dependency.maxAgeMs = maxAgeMs;
+    dependency.followProducer = followProducer;
+    m_dependencies.push_back(dependency);
+    
+    log(Logger::DEBUG, "Depends on " + producerId + " (max age " + maxAgeMs + "ms)");
+    if (m_orchestrator) {
+        m_orchestrator->invalidateExecutionOrder();
+    }
+}
+
+void BaseComponent::clearDependencies() {
+    if (m_dependencies.empty()) {
+        return;
+    }
+    m_dependencies.clear();
+    if (m_orchestrator) {
+        m_orchestrator->invalidateExecutionOrder();
+    }
+}
+
+bool BaseComponent::followsProducer(const String& producerId) const {
+    for (const auto& dependency : m_dependencies) {
+        if (dependency.followProducer && dependency.producerId == producerId) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t BaseComponent::getDataAgeMs() const {
+    if (m_lastSampleUs == 0) {
+        return UINT32_MAX;
+    }
+    MonoTimeUs ageMs = (TimeUtils::monoNowUs() - m_lastSampleUs) / 1000;
+    return ageMs < UINT32_MAX ? (uint32_t)ageMs : UINT32_MAX;
+}
+
+BaseComponent* BaseComponent::consumeDependency(const String& producerId) {
+    if (!m_orchestrator || producerId.length() == 0) {
+        return nullptr;
+    }
+    
+    DataDependency* dependency = nullptr;
+    for (auto& candidate : m_dependencies) {
+        if (candidate.producerId == producerId) {
+            dependency = &candidate;
+            break;
+        }
+    }
+    
+    BaseComponent* producer = m_orchestrator->findComponent(producerId);
+    if (!dependency) {
+        return producer;
+    }
+    if (!producer) {
+        dependency->stale++;
+        return nullptr;
+    }
+    
+    // Too old for this consumer: read the producer now instead of waiting for its timer
+    uint32_t ageMs = producer->getDataAgeMs();
+    if (dependency->maxAgeMs > 0 && ageMs > dependency->maxAgeMs &&
+        m_orchestrator->refreshComponent(producer)) {
+        dependency->refreshed++;
+        ageMs = producer->getDataAgeMs();
+    }
+    
+    dependency->consumed++;
+    if (dependency->maxAgeMs > 0 && ageMs > dependency->maxAgeMs) {
+        dependency->stale++;
+    }
+    if (ageMs != UINT32_MAX) {
+        dependency->lastAgeMs = ageMs;
+        dependency->totalAgeMs += ageMs;
+        if (ageMs > dependency->maxAgeSeenMs) dependency->maxAgeSeenMs = ageMs;
+    }
+    return producer;
 }
 
 bool BaseComponent::requestScheduleUpdate(const String& componentId, uint32_t timeToWakeUp) {
@@ -385,21 +627,12 @@ bool BaseComponent::requestScheduleUpdate(const String& componentId, uint32_t ti
 // === Enhanced Configuration Persistence Implementation ===
 
 bool BaseComponent::saveCurrentConfiguration() {
-    log(Logger::INFO, "🔥 [SAVE-TRACE] Starting saveCurrentConfiguration for: " + m_componentId);
+    log(Logger::DEBUG, "Saving current configuration");
     
     try {
         // Ask child class for its complete current state
-        log(Logger::INFO, "🔥 [SAVE-TRACE] Calling getCurrentConfig()...");
         JsonDocument currentConfig = getCurrentConfig();
         
-        // Track remoteHost in current config before saving
-        if (currentConfig.containsKey("remoteHost")) {
-            String currentRemoteHost = currentConfig["remoteHost"].as<String>();
-            log(Logger::INFO, "🔥 [SAVE-TRACE] getCurrentConfig() returned remoteHost: '" + currentRemoteHost + "'");
-        } else {
-            log(Logger::INFO, "🔥 [SAVE-TRACE] getCurrentConfig() returned NO remoteHost field");
-        }
-        
         if (currentConfig.isNull() || currentConfig.size() == 0) {
             log(Logger::WARNING, "⚠️ Child class returned empty configuration");
             return false;
@@ -409,19 +642,17 @@ bool BaseComponent::saveCurrentConfiguration() {
         currentConfig["component_type"] = m_componentType;
         currentConfig["component_name"] = m_componentName;
         
-        // Enhanced logging of the configuration being saved
-        String configStr;
-        serializeJson(currentConfig, configStr);
-        log(Logger::INFO, "📝 Saving config to storage: " + configStr);
+        if (Logger::isEnabled(Logger::DEBUG)) {
+            String configStr;
+            serializeJson(currentConfig, configStr);
+            log(Logger::DEBUG, "📝 Saving config to storage: " + configStr);
+        }
         
         // Base class handles the storage operation
-        log(Logger::INFO, "🔥 [SAVE-TRACE] Calling m_storage.saveComponentConfig()...");
         bool success = m_storage.saveComponentConfig(m_componentId, currentConfig);
         
-        if (success) {
-            log(Logger::INFO, "🔥 [SAVE-TRACE] ✅ Configuration saved successfully to LittleFS");
-        } else {
-            log(Logger::ERROR, "🔥 [SAVE-TRACE] ❌ Failed to save configuration to LittleFS");
+        if (!success) {
+            log(Logger::ERROR, "❌ Failed to save configuration to LittleFS");
         }
         
         return success;
@@ -442,10 +673,11 @@ bool BaseComponent::loadStoredConfiguration() {
         bool hasStoredConfig = m_storage.loadComponentConfig(m_componentId, storedConfig);
         
         if (hasStoredConfig) {
-            // Debug log what was loaded
-            String configStr;
-            serializeJson(storedConfig, configStr);
-            log(Logger::INFO, "🔄 Loaded stored config from persistence: " + configStr);
+            if (Logger::isEnabled(Logger::DEBUG)) {
+                String configStr;
+                serializeJson(storedConfig, configStr);
+                log(Logger::DEBUG, "🔄 Loaded stored config from persistence: " + configStr);
+            }
             
             // Ask child class to apply the loaded configuration
             bool applied = applyConfig(storedConfig);
@@ -455,9 +687,11 @@ bool BaseComponent::loadStoredConfiguration() {
                 
                 // Get current config to verify what was actually applied
                 JsonDocument appliedConfig = getCurrentConfig();
-                String appliedStr;
-                serializeJson(appliedConfig, appliedStr);
-                log(Logger::INFO, "🔍 Applied config verification: " + appliedStr);
+                if (Logger::isEnabled(Logger::DEBUG)) {
+                    String appliedStr;
+                    serializeJson(appliedConfig, appliedStr);
+                    log(Logger::DEBUG, "🔍 Applied config verification: " + appliedStr);
+                }
                 
                 // Only save if the applied config is significantly different from stored
                 // This prevents overriding stored configs with defaults
@@ -507,6 +741,7 @@ bool BaseComponent::loadStoredConfiguration() {
 // === Component Action System Implementation ===
 
 ActionResult BaseComponent::executeAction(const String& actionName, const JsonDocument& parameters) {
+    TRACE_SCOPE(TRACE_ACTION, m_traceName);
     ActionResult result;
     result.actionName = actionName;
     uint32_t startTime = millis();
@@ -13,16 +13,21 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <atomic>
+#include <vector>
 #include "../utils/Logger.h"
+#include "../utils/TimeUtils.h"
+#include "../utils/Tracer.h"
 #include "../storage/ConfigStorage.h"
 
 // Forward declaration
 class Orchestrator;
+struct SchemaError;
 
 /**
  * @brief Component execution states
  */
-enum class ComponentState {
+enum class ComponentState : uint8_t {
     UNINITIALIZED = 0,
     INITIALIZING = 1,
     READY = 2,
@@ -89,6 +94,59 @@ struct ActionResult {
     String actionName = "";
 };
 
+/**
+ * @brief Outcome of one resumption of a component task
+ */
+enum class TaskStep {
+    WAITING,    // Suspended in an AWAIT_*; the schedule is set to its wake time
+    FINISHED    // Ran into TASK_END(); the next resumption starts from the top
+};
+
+/**
+ * @brief Resume point and wait condition of a component task (see TASK_BEGIN)
+ */
+struct ComponentTask {
+    uint16_t resumeLine = 0;                     // Line of the pending AWAIT_*, 0 = top
+    MonoTimeUs wakeUs = 0;                       // Deadline of the wait, 0 = none
+    uint32_t awaitedSignals = 0;                 // Bits that end the wait early
+    std::atomic<uint32_t> pendingSignals{0};     // Raised by signal(), kept until awaited
+    uint32_t receivedSignals = 0;                // Bits that ended the last wait
+    bool timedOut = false;                       // Last signal/IO wait ended on its deadline
+};
+
+/**
+ * @brief Readings a component consumes from another component (see declareDependency)
+ */
+struct DataDependency {
+    String producerId;
+    uint32_t maxAgeMs = 0;                       // Freshness bound, 0 = any age
+    bool followProducer = false;                 // Run the consumer right after each producer sample
+    
+    // Data age at consumption time
+    uint32_t consumed = 0;
+    uint32_t refreshed = 0;                      // On-demand producer reads
+    uint32_t stale = 0;                          // Consumed past the bound (or producer missing)
+    uint32_t lastAgeMs = 0;
+    uint32_t maxAgeSeenMs = 0;
+    uint64_t totalAgeMs = 0;
+};
+
+/**
+ * @brief Smoothed execution health and failure backoff (maintained by the orchestrator)
+ */
+struct ComponentHealth {
+    float errorEwma = 0.0f;                      // Smoothed failure rate, 0..1
+    float latencyEwmaUs = 0.0f;                  // Smoothed execute() duration
+    uint8_t score = 100;                         // 0 (failing) .. 100 (healthy)
+    uint16_t consecutiveFailures = 0;
+    uint32_t backoffMs = 0;                      // Current backoff step, 0 = not backing off
+    uint32_t backoffCount = 0;                   // Times the component entered backoff
+    uint32_t recoveries = 0;                     // Probes that succeeded
+};
+
+// Signal bit reserved for AWAIT_IO; signal(TASK_SIGNAL_IO) re-checks the condition at once
+#define TASK_SIGNAL_IO (1U << 31)
+
 /**
  * @brief Base class for all IoT components
  * 
@@ -97,22 +155,47 @@ struct ActionResult {
  */
 class BaseComponent {
 protected:
+    // === Scheduler-hot fields: everything isReadyToExecute() reads, packed together ===
+    MonoTimeUs m_nextExecutionUs = 0;    // Monotonic schedule, wrap-free
+    MonoTimeUs m_holdUntilUs = 0;        // Failure backoff: no execution before the recovery probe
+    uint32_t m_executionCount = 0;
+    ComponentState m_state = ComponentState::UNINITIALIZED;
+    volatile bool m_signalled = false;   // An awaited signal was raised: run on the next pass
+    
+    // === Cold fields: identity, configuration, diagnostics ===
     String m_componentId;
     String m_componentType;
     String m_componentName;
-    ComponentState m_state = ComponentState::UNINITIALIZED;
+    const char* m_traceName;             // Interned id, stable for trace events
     
-    JsonDocument m_configuration;
-    JsonDocument m_schema;
-    JsonDocument m_lastData;
-    String m_lastDataString;  // Alternative storage for debugging
+    // Configuration as MessagePack: only needed while (re)initializing, so it is not kept
+    // as a JsonDocument; the schema is regenerated by getDefaultSchema() when asked for
+    std::vector<uint8_t> m_packedConfiguration;
+    String m_lastDataString;             // Last execution output, serialized (the only copy)
     String m_lastError;
     
-    uint32_t m_nextExecutionMs = 0;
-    uint32_t m_lastExecutionMs = 0;
-    uint32_t m_executionCount = 0;
+    MonoTimeUs m_lastExecutionUs = 0;
+    MonoTimeUs m_lastSampleUs = 0;       // Last successful execution that produced data
+    uint32_t m_dataSeq = 0;              // Orchestrator-wide sequence number of that sample
+    uint32_t m_lastExecutionMs = 0;      // millis() of the last execution (API compatibility)
     uint32_t m_errorCount = 0;
     
+    // Latency metrics, recorded by the orchestrator around execute()
+    uint32_t m_lastDurationUs = 0;
+    uint32_t m_maxDurationUs = 0;
+    uint32_t m_lastLagUs = 0;            // How late execute() started vs. its schedule
+    uint32_t m_maxLagUs = 0;
+    uint64_t m_totalExecutionUs = 0;     // Cumulative execute() time, for CPU accounting
+    
+    // Resumable task state (TASK_BEGIN / AWAIT_* / TASK_END)
+    ComponentTask m_task;
+    
+    // Error-rate/latency score and failure backoff
+    ComponentHealth m_health;
+    
+    // Producers this component reads from, ordered before it by the scheduler
+    std::vector<DataDependency> m_dependencies;
+    
     // Storage reference
     ConfigStorage& m_storage;
     
@@ -169,29 +252,40 @@ public:
     
     /**
      * @brief Load configuration from schema (with fallback to defaults)
+     * 
+     * Hydrates in a single pass: uses config if given (otherwise one storage
+     * read), fills missing schema defaults in place and only writes back when
+     * something was added or no stored file exists.
+     * 
      * @param config Optional configuration override
      * @return true if configuration loaded successfully
      */
     bool loadConfiguration(const JsonDocument& config = JsonDocument());
     
     /**
-     * @brief Get current configuration
-     * @return Current configuration document
+     * @brief Get the configuration hydrated by loadConfiguration()
+     * @return Configuration document, unpacked from compact storage on each call
      */
-    const JsonDocument& getConfiguration() const { return m_configuration; }
+    JsonDocument getConfiguration() const;
     
     /**
      * @brief Get component schema
-     * @return Schema document
+     * @return Schema document, generated on demand
      */
-    const JsonDocument& getSchema() const { return m_schema; }
+    JsonDocument getSchema() const { return getDefaultSchema(); }
     
     /**
-     * @brief Validate configuration against schema
+     * @brief Validate configuration against the compiled schema of this type
+     * 
+     * The schema is compiled on first use and shared by every instance of
+     * the type, so validation does not allocate (see SchemaValidator).
+     * 
      * @param config Configuration to validate
+     * @param partial Update containing only changed keys: skip the "required" check
+     * @param error Receives the offending field and reason (optional)
      * @return true if valid
      */
-    bool validateConfiguration(const JsonDocument& config);
+    bool validateConfiguration(const JsonDocument& config, bool partial = false, SchemaError* error = nullptr);
 
     // === State Management ===
     
@@ -232,26 +326,94 @@ public:
      * @return Component name
      */
     const String& getName() const { return m_componentName; }
+    
+    /**
+     * @brief Get the id as a stable C string for trace spans
+     * @return Interned component id
+     */
+    const char* getTraceName() const { return m_traceName; }
 
     // === Execution Management ===
     
     /**
      * @brief Get next scheduled execution time
-     * @return Timestamp in milliseconds
+     * @return Timestamp in the millis() domain (wraps after 49.7 days)
      */
-    uint32_t getNextExecutionMs() const { return m_nextExecutionMs; }
+    uint32_t getNextExecutionMs() const { return (uint32_t)(m_nextExecutionUs / 1000); }
     
     /**
      * @brief Set next execution time
-     * @param ms Timestamp in milliseconds
+     * @param ms Timestamp from millis() + delay; extended to 64 bits relative to now
      */
-    void setNextExecutionMs(uint32_t ms) { m_nextExecutionMs = ms; }
+    void setNextExecutionMs(uint32_t ms) { m_nextExecutionUs = TimeUtils::monoFromMillis(ms); }
+    
+    /**
+     * @brief Get next scheduled execution time on the monotonic clock
+     * @return Microseconds since boot
+     */
+    MonoTimeUs getNextExecutionUs() const { return m_nextExecutionUs; }
+    
+    /**
+     * @brief Set next execution time on the monotonic clock
+     * @param us Microseconds since boot
+     */
+    void setNextExecutionUs(MonoTimeUs us) { m_nextExecutionUs = us; }
+    
+    /**
+     * @brief Record execution latency (called by the orchestrator)
+     * @param durationUs Time spent in execute()
+     * @param lagUs Delay between the scheduled and the actual start
+     */
+    void recordExecutionTiming(uint32_t durationUs, uint32_t lagUs);
+    
+    /**
+     * @brief Fold an execution result into the health score (called by the orchestrator)
+     * 
+     * Uses the duration from the preceding recordExecutionTiming(). The score is
+     * 100 x (1 - smoothed error rate), minus up to 25 points while the smoothed
+     * duration exceeds latencyBudgetUs.
+     * 
+     * @param success Execution result
+     * @param latencyBudgetUs Duration above which the score is penalized
+     */
+    void recordExecutionOutcome(bool success, uint32_t latencyBudgetUs);
+    
+    /**
+     * @brief Suspend execution until a recovery probe in backoffMs (called by the orchestrator)
+     */
+    void enterBackoff(uint32_t backoffMs);
+    
+    /**
+     * @brief Resume the normal schedule after a successful probe
+     */
+    void clearBackoff();
+    
+    /**
+     * @brief Check if execution is suspended by failure backoff
+     */
+    bool isBackingOff() const { return m_health.backoffMs > 0; }
+    
+    /**
+     * @brief Get the time of the next recovery probe (meaningful while backing off)
+     */
+    MonoTimeUs getBackoffUntilUs() const { return m_holdUntilUs; }
+    
+    /**
+     * @brief Get health score and backoff state
+     */
+    const ComponentHealth& getHealth() const { return m_health; }
     
     /**
      * @brief Check if component is ready to execute
+     * @param nowUs Current monotonic time, read once per loop pass by the orchestrator
      * @return true if ready to execute
      */
-    bool isReadyToExecute() const;
+    bool isReadyToExecute(MonoTimeUs nowUs) const {
+        // Never-executed and signalled components run at once; backoff holds even those
+        return m_state == ComponentState::READY && nowUs >= m_holdUntilUs &&
+               (nowUs >= m_nextExecutionUs || m_executionCount == 0 || m_signalled);
+    }
+    bool isReadyToExecute() const { return isReadyToExecute(TimeUtils::monoNowUs()); }
     
     /**
      * @brief Request orchestrator to update another component's schedule
@@ -260,6 +422,61 @@ public:
      * @return true if request was successful
      */
     bool requestScheduleUpdate(const String& componentId, uint32_t timeToWakeUp);
+    
+    /**
+     * @brief Raise signal bits for this component's task (safe from any task)
+     * 
+     * Bits the task is awaiting resume it on the next loop pass; other bits
+     * stay pending until an AWAIT_SIGNAL asks for them.
+     * 
+     * Also callable from an IRAM interrupt handler: it only touches this object.
+     * The wake-up is a flag the scheduler checks, not a schedule change, so it
+     * cannot be overwritten by the task storing its own wait deadline.
+     * 
+     * @param bits Signal bits (TASK_SIGNAL_IO is reserved for AWAIT_IO)
+     */
+    void signal(uint32_t bits);
+
+    // === Data Dependencies ===
+    
+    /**
+     * @brief Get the producers this component consumes, with data-age metrics
+     */
+    const std::vector<DataDependency>& getDependencies() const { return m_dependencies; }
+    
+    /**
+     * @brief Check if this component runs right after each sample of the producer
+     */
+    bool followsProducer(const String& producerId) const;
+    
+    /**
+     * @brief Mark the last execution data as a fresh sample (called by the orchestrator)
+     * @param seq Orchestrator-wide data sequence number assigned to the sample
+     */
+    void markSampled(uint32_t seq) {
+        m_lastSampleUs = TimeUtils::monoNowUs();
+        m_dataSeq = seq;
+    }
+    
+    /**
+     * @brief Get the monotonic time of the last sample, 0 if there is none
+     */
+    MonoTimeUs getLastSampleUs() const { return m_lastSampleUs; }
+    
+    /**
+     * @brief Get the data sequence number of the last sample, 0 if there is none
+     * 
+     * Sequence numbers grow across all components of the node, so "every
+     * component with getDataSeq() > n" is exactly what changed since a
+     * reader last saw sequence number n (see GET /api/components/delta).
+     */
+    uint32_t getDataSeq() const { return m_dataSeq; }
+    
+    /**
+     * @brief Get the age of the last execution data
+     * @return Milliseconds since the last sample, UINT32_MAX if there is none
+     */
+    uint32_t getDataAgeMs() const;
 
     // === Error Management ===
     
@@ -279,6 +496,13 @@ public:
      * @return Number of errors encountered
      */
     uint32_t getErrorCount() const { return m_errorCount; }
+    
+    /**
+     * @brief Get number of completed executions
+     * @return Execution counter
+     */
+    uint32_t getExecutionCount() const { return m_executionCount; }
+    uint64_t getTotalExecutionUs() const { return m_totalExecutionUs; }
 
     // === Statistics ===
     
@@ -289,10 +513,10 @@ public:
     JsonDocument getStatistics() const;
     
     /**
-     * @brief Get last execution data
-     * @return Last execution data as JSON document
+     * @brief Get last execution data, parsed from the stored string
+     * @return Last execution data as JSON document (empty if there is none)
      */
-    const JsonDocument& getLastExecutionData() const { return m_lastData; }
+    JsonDocument getLastExecutionData() const;
     
     /**
      * @brief Get core sensor data (for lightweight dashboard display)
@@ -313,7 +537,7 @@ public:
     virtual JsonDocument getCoreData() const;
     
     /**
-     * @brief Store execution data as string (for debugging)
+     * @brief Store the last execution output (serialized JSON; what all readers use)
      * @param data JSON string to store
      */
     void storeExecutionDataString(const String& data) { m_lastDataString = data; }
@@ -332,6 +556,75 @@ public:
      */
     JsonDocument fetchRemoteData(const String& url, uint32_t timeoutMs = 5000);
     
+    // === Warm-Restart State (RTC snapshot) ===
+    
+    /**
+     * @brief Export component-specific runtime state worth keeping across resets
+     * 
+     * Called periodically by RtcStateStore. Keep it tiny (a few counters);
+     * the serialized form must fit RtcStateStore::STATE_BYTES.
+     * 
+     * @param state Object to populate (left empty by default)
+     */
+    virtual void getWarmState(JsonObject /*state*/) const {}
+    
+    /**
+     * @brief Re-apply state exported by getWarmState() after a warm restart
+     * @param state Previously exported state
+     */
+    virtual void restoreWarmState(JsonObjectConst /*state*/) {}
+    
+    /**
+     * @brief Restore last data, schedule phase and counters after a warm restart
+     * @param lastData Last execution data from the snapshot (may be empty)
+     * @param nextDueInMs Time remaining until the next execution when the snapshot was taken
+     * @param executionCount Execution counter from the previous run
+     */
+    void restoreRuntimeSnapshot(const JsonDocument& lastData, uint32_t nextDueInMs, uint32_t executionCount);
+    
+    // === Network Link ===
+    
+    /**
+     * @brief Notification of a WiFi link change (called from the main loop)
+     * 
+     * Network users should pause on link loss and resume on link up rather
+     * than letting requests time out. Default does nothing.
+     * 
+     * @param connected true when the station got an IP address, false when it was lost
+     */
+    virtual void onNetworkChange(bool /*connected*/) {}
+    
+    // === Resource Pressure ===
+    
+    /**
+     * @brief Whether the component's schedule must be kept under resource pressure
+     * 
+     * The resource governor stretches the execution interval of other
+     * components (sensors sample less often). Components that drive outputs
+     * or fire control actions return true.
+     */
+    virtual bool isTimeCritical() const { return false; }
+    
+    /**
+     * @brief Check if a resumable task is paused inside an AWAIT_*
+     * 
+     * Its next execution is a settle or sampling delay that belongs to the
+     * measurement, so the resource governor leaves it unstretched.
+     */
+    bool isTaskSuspended() const { return m_task.resumeLine != 0; }
+    
+    /**
+     * @brief Notification of a resource governor level change (called from the main loop)
+     * 
+     * From RESOURCE_SHED on, components drop data they can rebuild (remote
+     * mirrors keep their values only in the last output string); at
+     * RESOURCE_PROTECT, actuators go to a safe state and refuse new runs
+     * until the level drops again. Default does nothing.
+     * 
+     * @param level New ResourceLevel
+     */
+    virtual void onResourceLevel(uint8_t /*level*/) {}
+    
     // === Enhanced Configuration Persistence ===
     
     /**
@@ -355,11 +648,12 @@ public:
     JsonDocument getConfigurationAsJson() const { return getCurrentConfig(); }
     
     /**
-     * @brief Apply configuration to component variables (public accessor)
-     * @param config Configuration to apply (may be empty for defaults)
-     * @return true if configuration applied successfully
+     * @brief Validate and apply configuration to component variables (public accessor)
+     * @param config Configuration to apply (may be empty for defaults, or only the changed keys)
+     * @param error Receives the offending field when validation fails (optional)
+     * @return true if configuration validated and applied successfully
      */
-    bool applyConfigurationFromJson(const JsonDocument& config) { return applyConfig(config); }
+    bool applyConfigurationFromJson(const JsonDocument& config, SchemaError* error = nullptr);
 
     // === Component Action System ===
     
@@ -386,6 +680,74 @@ public:
     bool validateActionParameters(const ComponentAction& action, const JsonDocument& parameters);
 
 protected:
+    // === Resumable Task Support (used by the TASK_* / AWAIT_* macros) ===
+    
+    /**
+     * @brief Arm a wait: deadline in timeoutMs (0 = none) and/or any of the signal bits
+     */
+    void taskAwait(uint32_t timeoutMs, uint32_t signals);
+    
+    /**
+     * @brief Check the armed wait; if it is not over, schedule the exact wake time
+     * @return true when a signal arrived or the deadline passed
+     */
+    bool taskWaitOver();
+    
+    /**
+     * @brief AWAIT_IO check: condition met, deadline passed, or re-poll in pollMs
+     * @return true when the wait is over
+     */
+    bool taskIoReady(bool condition, uint32_t pollMs);
+    
+    /**
+     * @brief Restart the task from the top on the next execution (e.g. after reconfiguration)
+     */
+    void taskReset();
+    
+    /**
+     * @brief Check if the last AWAIT_SIGNAL / AWAIT_IO ended on its deadline
+     */
+    bool taskTimedOut() const { return m_task.timedOut; }
+    
+    /**
+     * @brief Get the signal bits that ended the last AWAIT_SIGNAL
+     */
+    uint32_t taskSignals() const { return m_task.receivedSignals; }
+    
+    /**
+     * @brief Milliseconds until a millis() deadline, 0 if it has passed (wrap-safe)
+     */
+    static uint32_t msUntil(uint32_t deadlineMs);
+    
+    // === Data Dependencies ===
+    
+    /**
+     * @brief Declare that this component consumes another component's readings
+     * 
+     * The scheduler runs producers before their consumers in each loop pass.
+     * Redeclaring a producer updates its bound and keeps its metrics.
+     * 
+     * @param producerId Producer component ID (ignored if empty)
+     * @param maxAgeMs Oldest acceptable data; older data triggers an on-demand producer read
+     * @param followProducer Schedule this component immediately after each producer sample
+     */
+    void declareDependency(const String& producerId, uint32_t maxAgeMs, bool followProducer = false);
+    
+    /**
+     * @brief Drop all declared dependencies (e.g. before re-declaring from a new config)
+     */
+    void clearDependencies();
+    
+    /**
+     * @brief Get a producer for reading its data, refreshing it if the data is too old
+     * 
+     * Records the data age at consumption in the dependency metrics.
+     * 
+     * @param producerId Declared producer component ID
+     * @return Producer (read getLastExecutionData()) or nullptr if not registered
+     */
+    BaseComponent* consumeDependency(const String& producerId);
+    
     // === Configuration Management (Child classes MUST implement) ===
     
     /**
@@ -449,6 +811,37 @@ protected:
      */
     JsonDocument extractDefaultValues(const JsonDocument& schema);
     
+    /**
+     * @brief Fill schema defaults into a configuration in place
+     * 
+     * Only keys missing from target are written; existing values are kept.
+     * 
+     * @param schema JSON schema containing properties with default values
+     * @param target Configuration to hydrate
+     * @return Number of default values applied
+     */
+    static size_t applySchemaDefaults(const JsonDocument& schema, JsonDocument& target);
+    
+    /**
+     * @brief Validate a loaded configuration, resetting invalid values to their defaults
+     * 
+     * A stored file written by an older firmware (or edited by hand) should
+     * not keep a component from starting: each invalid field that has a
+     * schema default is logged and replaced. Fails only when a field has no
+     * default to fall back to.
+     * 
+     * @param configuration Hydrated configuration, repaired in place
+     * @param schema Schema of this component (already generated by the caller)
+     * @param repaired Receives the number of fields reset
+     * @return true if the configuration is valid after repair
+     */
+    bool repairConfiguration(JsonDocument& configuration, const JsonDocument& schema, size_t& repaired);
+    
+    /**
+     * @brief Keep a hydrated configuration for getConfiguration() in compact form
+     */
+    void packConfiguration(const JsonDocument& configuration);
+    
     /**
      * @brief Save configuration to persistent storage
      * @param config Configuration to save
@@ -483,4 +876,51 @@ protected:
     bool validateParameterValue(const ActionParameter& param, JsonVariantConst value);
 };
 
+// === Resumable Component Tasks ===
+//
+// Protothread-style sequential logic for multi-step components. The task is
+// a member function returning TaskStep, called from execute(), with its body
+// between TASK_BEGIN() and TASK_END(). Each AWAIT_* records where it stopped,
+// sets the component's next execution to the exact time its condition can be
+// met and returns WAITING; the next execute() jumps straight back to it.
+//
+//     TaskStep MySensor::samplingTask() {
+//         TASK_BEGIN();
+//         while (true) {
+//             powerOn();
+//             AWAIT_DELAY(m_warmupMs);
+//             AWAIT_IO(dataReady(), 20, 1000);       // poll every 20ms, give up after 1s
+//             if (!taskTimedOut()) readSample();
+//             AWAIT_SIGNAL(SIGNAL_TRIGGER, 60000);   // next trigger or once a minute
+//         }
+//         TASK_END();
+//     }
+//
+// Rules: locals do not survive an await, so keep state in members and put
+// locals declared between awaits in their own braces; at most one AWAIT_* per
+// source line; no AWAIT_* inside a nested switch.
+
+#define TASK_BEGIN() switch (m_task.resumeLine) { case 0:
+
+#define TASK_END() } m_task.resumeLine = 0; return TaskStep::FINISHED
+
+#define TASK_AWAIT_(arm, over) \
+    do { \
+        arm; \
+        m_task.resumeLine = __LINE__; \
+        __attribute__((fallthrough)); \
+        case __LINE__: \
+        if (!(over)) return TaskStep::WAITING; \
+    } while (0)
+
+// Resume after ms milliseconds (0 = no wait)
+#define AWAIT_DELAY(ms) TASK_AWAIT_(taskAwait((ms), 0), taskWaitOver())
+
+// Resume when any of the bits is signalled, or after timeoutMs (0 = no timeout)
+#define AWAIT_SIGNAL(bits, timeoutMs) TASK_AWAIT_(taskAwait((timeoutMs), (bits)), taskWaitOver())
+
+// Resume when condition holds, re-checking every pollMs or on TASK_SIGNAL_IO, or after timeoutMs
+#define AWAIT_IO(condition, pollMs, timeoutMs) \
+    TASK_AWAIT_(taskAwait((timeoutMs), TASK_SIGNAL_IO), taskIoReady((condition), (pollMs)))
+
 #endif // BASE_COMPONENT_H
\ No newline at end of file
@@ -4,6 +4,9 @@
  */
 
 #include "DHT22Component.h"
+#include "../core/ComponentRegistry.h"
+
+#if COMPONENT_DHT22
 
 DHT22Component::DHT22Component(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator)
     : BaseComponent(id, "DHT22", name, storage, orchestrator)
@@ -144,12 +147,9 @@ ExecutionResult DHT22Component::execute() {
     result.data = data;
     
     // Store last execution data for API/dashboard access
-    // Deep copy the data using serialize/deserialize to ensure it persists
     String dataStr;
     serializeJson(data, dataStr);
-    storeExecutionDataString(dataStr);  // Store as string for API access
-    m_lastData.clear();
-    deserializeJson(m_lastData, dataStr);
+    storeExecutionDataString(dataStr);
     
     // Schedule next execution
     setNextExecutionMs(millis() + m_samplingIntervalMs);
@@ -429,27 +429,28 @@ ActionResult DHT22Component::performAction(const String& actionName, const JsonD
 
 JsonDocument DHT22Component::getCoreData() const {
     JsonDocument coreData;
+    JsonDocument lastData = getLastExecutionData();
     
     // For DHT22 sensors, core data is temperature, humidity, and success status
-    if (!m_lastData.isNull() && m_lastData.size() > 0) {
+    if (!lastData.isNull() && lastData.size() > 0) {
         // Extract only the essential sensor values
-        if (!m_lastData["temperature"].isNull()) {
-            coreData["temperature"] = m_lastData["temperature"];
+        if (!lastData["temperature"].isNull()) {
+            coreData["temperature"] = lastData["temperature"];
         }
-        if (!m_lastData["humidity"].isNull()) {
-            coreData["humidity"] = m_lastData["humidity"];
+        if (!lastData["humidity"].isNull()) {
+            coreData["humidity"] = lastData["humidity"];
         }
-        if (!m_lastData["heatIndex"].isNull()) {
-            coreData["heat_index"] = m_lastData["heatIndex"];
+        if (!lastData["heatIndex"].isNull()) {
+            coreData["heat_index"] = lastData["heatIndex"];
         }
-        if (!m_lastData["unit"].isNull()) {
-            coreData["unit"] = m_lastData["unit"];
+        if (!lastData["unit"].isNull()) {
+            coreData["unit"] = lastData["unit"];
         }
-        if (!m_lastData["success"].isNull()) {
-            coreData["success"] = m_lastData["success"];
+        if (!lastData["success"].isNull()) {
+            coreData["success"] = lastData["success"];
         }
-        if (!m_lastData["timestamp"].isNull()) {
-            coreData["timestamp"] = m_lastData["timestamp"];
+        if (!lastData["timestamp"].isNull()) {
+            coreData["timestamp"] = lastData["timestamp"];
         }
         
         log(Logger::DEBUG, String("[CORE-DATA] DHT22 ") + m_componentId + " returning " + 
@@ -461,4 +462,8 @@ JsonDocument DHT22Component::getCoreData() const {
     }
     
     return coreData;
-}
\ No newline at end of file
+}
+
+REGISTER_COMPONENT_TYPE(DHT22Component, "DHT22", "TemperatureSensor")
+
+#endif // COMPONENT_DHT22
@@ -1,8 +1,11 @@
 #include "ECProbeComponent.h"
+#include "../core/ComponentRegistry.h"
 #include "../utils/Logger.h"
 #include "../core/Orchestrator.h"
 #include <Arduino.h>
 
+#if COMPONENT_EC_PROBE
+
 ECProbeComponent::ECProbeComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator)
     : BaseComponent(id, "ECProbe", name, storage, orchestrator) {
     
@@ -39,22 +42,102 @@ JsonDocument ECProbeComponent::getDefaultSchema() const {
     schema["description"] = "Electrical Conductivity probe with 3-point calibration and temperature compensation";
     
     // Configuration parameters
-    JsonObject config = schema["config"].to<JsonObject>();
-    config["gpio_pin"] = 35;
-    config["temp_coefficient"] = 2.0f;
-    config["sample_size"] = 15;
-    config["adc_voltage_ref"] = 3.3f;
-    config["adc_resolution"] = 4096;
-    config["reading_interval_ms"] = 800;
-    config["time_period_for_sampling"] = 15000;
-    config["outlier_threshold"] = 2.5f;
-    config["tds_conversion_factor"] = 0.64f;
-    config["temperature_source_id"] = "";
-    config["excite_voltage_component_id"] = "";
-    config["excite_stabilize_ms"] = 1000;
+    JsonObject properties = schema["properties"].to<JsonObject>();
+    
+    JsonObject gpioPin = properties["gpio_pin"].to<JsonObject>();
+    gpioPin["type"] = "integer";
+    gpioPin["minimum"] = 0;
+    gpioPin["maximum"] = 39;
+    gpioPin["default"] = 35;
+    gpioPin["description"] = "ADC GPIO pin (0 = mock mode)";
+    
+    JsonObject tempCoefficient = properties["temp_coefficient"].to<JsonObject>();
+    tempCoefficient["type"] = "number";
+    tempCoefficient["minimum"] = 0;
+    tempCoefficient["maximum"] = 10;
+    tempCoefficient["default"] = 2.0f;
+    tempCoefficient["description"] = "Temperature compensation coefficient";
+    
+    JsonObject sampleSize = properties["sample_size"].to<JsonObject>();
+    sampleSize["type"] = "integer";
+    sampleSize["minimum"] = 1;
+    sampleSize["maximum"] = 100;
+    sampleSize["default"] = 15;
+    sampleSize["description"] = "Readings averaged per sampling window";
+    
+    JsonObject adcVoltageRef = properties["adc_voltage_ref"].to<JsonObject>();
+    adcVoltageRef["type"] = "number";
+    adcVoltageRef["exclusiveMinimum"] = 0;
+    adcVoltageRef["maximum"] = 5.0;
+    adcVoltageRef["default"] = 3.3f;
+    adcVoltageRef["description"] = "ADC reference voltage";
+    
+    JsonObject adcResolution = properties["adc_resolution"].to<JsonObject>();
+    adcResolution["type"] = "integer";
+    adcResolution["minimum"] = 2;
+    adcResolution["maximum"] = 65535;
+    adcResolution["default"] = 4096;
+    adcResolution["description"] = "ADC full-scale count";
+    
+    JsonObject readingInterval = properties["reading_interval_ms"].to<JsonObject>();
+    readingInterval["type"] = "integer";
+    readingInterval["minimum"] = 10;
+    readingInterval["maximum"] = 60000;
+    readingInterval["default"] = 800;
+    readingInterval["description"] = "Interval between readings in ms";
+    
+    JsonObject samplingPeriod = properties["time_period_for_sampling"].to<JsonObject>();
+    samplingPeriod["type"] = "integer";
+    samplingPeriod["minimum"] = 100;
+    samplingPeriod["maximum"] = 3600000;
+    samplingPeriod["default"] = 15000;
+    samplingPeriod["description"] = "Sampling window in ms";
+    
+    JsonObject outlierThreshold = properties["outlier_threshold"].to<JsonObject>();
+    outlierThreshold["type"] = "number";
+    outlierThreshold["exclusiveMinimum"] = 0;
+    outlierThreshold["maximum"] = 10.0;
+    outlierThreshold["default"] = 2.5f;
+    outlierThreshold["description"] = "Outlier rejection threshold in standard deviations";
+    
+    JsonObject tdsFactor = properties["tds_conversion_factor"].to<JsonObject>();
+    tdsFactor["type"] = "number";
+    tdsFactor["exclusiveMinimum"] = 0;
+    tdsFactor["maximum"] = 1.0;
+    tdsFactor["default"] = 0.64f;
+    tdsFactor["description"] = "EC to TDS conversion factor";
+    
+    JsonObject temperatureSource = properties["temperature_source_id"].to<JsonObject>();
+    temperatureSource["type"] = "string";
+    temperatureSource["maxLength"] = 64;
+    temperatureSource["default"] = "";
+    temperatureSource["description"] = "Component providing temperature for compensation";
+    
+    JsonObject temperatureMaxAge = properties["temperature_max_age_ms"].to<JsonObject>();
+    temperatureMaxAge["type"] = "integer";
+    temperatureMaxAge["minimum"] = 0;
+    temperatureMaxAge["maximum"] = 3600000;
+    temperatureMaxAge["default"] = 30000;
+    temperatureMaxAge["description"] = "Maximum age of the temperature reading in ms";
+    
+    JsonObject exciteComponent = properties["excite_voltage_component_id"].to<JsonObject>();
+    exciteComponent["type"] = "string";
+    exciteComponent["maxLength"] = 64;
+    exciteComponent["default"] = "";
+    exciteComponent["description"] = "Component switching the probe excitation voltage";
+    
+    JsonObject exciteStabilize = properties["excite_stabilize_ms"].to<JsonObject>();
+    exciteStabilize["type"] = "integer";
+    exciteStabilize["minimum"] = 0;
+    exciteStabilize["maximum"] = 60000;
+    exciteStabilize["default"] = 1000;
+    exciteStabilize["description"] = "Settling time after excitation in ms";
     
     // Calibration points
-    JsonArray calibration = config["calibration_points"].to<JsonArray>();
+    JsonObject calibrationPoints = properties["calibration_points"].to<JsonObject>();
+    calibrationPoints["type"] = "array";
+    calibrationPoints["description"] = "3-point calibration (0, 84, 1413 uS/cm)";
+    JsonArray calibration = calibrationPoints["default"].to<JsonArray>();
     for (int i = 0; i < 3; i++) {
         JsonObject point = calibration.add<JsonObject>();
         point["ec_us_cm"] = (i == 0) ? 0.0f : (i == 1) ? 84.0f : 1413.0f;
@@ -69,7 +152,16 @@ JsonDocument ECProbeComponent::getDefaultSchema() const {
 bool ECProbeComponent::initialize(const JsonDocument& config) {
     log(Logger::INFO, "Initializing EC Probe Component: " + m_componentName);
     
-    if (!applyConfig(config)) {
+    // Out-of-range stored values fall back to their defaults instead of reaching the ADC code
+    JsonDocument configuration;
+    configuration.set(config);
+    size_t repaired = 0;
+    if (!repairConfiguration(configuration, getDefaultSchema(), repaired)) {
+        log(Logger::ERROR, "Invalid EC probe configuration: " + m_lastError);
+        return false;
+    }
+    
+    if (!applyConfig(configuration)) {
         log(Logger::ERROR, "Failed to apply EC probe configuration");
         return false;
     }
@@ -96,87 +188,10 @@ ExecutionResult ECProbeComponent::execute() {
     
     setState(ComponentState::EXECUTING);
     
-    // Update sensor mode based on current state
+    // Advance the sampling cycle; it reschedules this component for its next step
+    samplingTask();
     updateSensorMode();
     
-    // For mock mode, use simplified direct reading
-    if (m_currentMode == ECProbeMode::MOCK) {
-        // Take a direct reading for mock mode
-        float rawVoltage = readRawVoltage();
-        if (rawVoltage >= 0) {
-            m_currentVolts = rawVoltage;
-            m_currentTemp = getTemperatureReading();
-            m_currentEC = convertVoltageToEC(m_currentVolts, m_currentTemp);
-            m_currentTDS = convertECtoTDS(m_currentEC);
-            m_totalReadings++;
-            
-            log(Logger::DEBUG, "EC Mock reading: " + String(rawVoltage, 4) + "V -> " + 
-                String(m_currentEC, 1) + " µS/cm, " + String(m_currentTDS, 1) + " ppm");
-        }
-    } else {
-        // Initialize sampling window if not active
-        if (!m_samplingActive) {
-            startSamplingWindow();
-        }
-    }
-    
-    // Take readings during the sampling window (only for non-mock mode)
-    if (m_currentMode != ECProbeMode::MOCK && m_samplingActive && !isSamplingWindowComplete()) {
-        // Ensure excitation voltage is stabilized before taking readings
-        if (isExcitationStabilized()) {
-            // Check if it's time for a new reading
-            if (currentTime - m_lastReadingMs >= m_readingIntervalMs) {
-                // Take raw voltage reading
-                float rawVoltage = readRawVoltage();
-            
-            if (rawVoltage >= 0) {
-                // Add to sample buffer
-                addReading(rawVoltage);
-                m_totalReadings++;
-                m_lastReadingMs = currentTime;
-                
-                log(Logger::DEBUG, "EC Sample " + String(m_lastReads.size()) + "/" + String(m_sampleSize) + 
-                    ": " + String(rawVoltage, 4) + "V");
-            } else {
-                m_errorCount++;
-                log(Logger::WARNING, "Failed to read EC probe voltage");
-            }
-        } else {
-            log(Logger::DEBUG, "Waiting for EC excitation voltage to stabilize...");
-        }
-    }
-    
-    // Process samples when window is complete (only for non-mock mode)
-    if (m_currentMode != ECProbeMode::MOCK && m_samplingActive && isSamplingWindowComplete()) {
-        endSamplingWindow();
-        
-        // Remove outliers from sample set
-        removeOutliers();
-        
-        // Calculate final averaged voltage with outlier removal
-        m_currentVolts = calculateWeightedAverageWithOutlierRemoval();
-        
-        // Get temperature for compensation
-        m_currentTemp = getTemperatureReading();
-        
-        // Calculate EC with temperature compensation
-        m_currentEC = convertVoltageToEC(m_currentVolts, m_currentTemp);
-        
-        // Calculate TDS from EC
-        m_currentTDS = convertECtoTDS(m_currentEC);
-        
-        // Update statistics
-        if (m_currentEC >= 0) {
-            m_minRecordedEC = min(m_minRecordedEC, m_currentEC);
-            m_maxRecordedEC = max(m_maxRecordedEC, m_currentEC);
-        }
-        
-        log(Logger::INFO, "EC sampling complete: " + String(m_lastReads.size()) + " samples, " + 
-            String(m_outliersRemoved) + " outliers removed, EC = " + String(m_currentEC, 1) + " µS/cm, TDS = " + 
-            String(m_currentTDS, 1) + " ppm");
-    }
-    }
-    
     // Prepare output data
     JsonDocument data;
     data["timestamp"] = currentTime;
@@ -223,10 +238,6 @@ ExecutionResult ECProbeComponent::execute() {
     
     data["success"] = true;
     
-    // Calculate next execution time based on sampling window state
-    uint32_t nextExecutionTime = calculateNextExecutionTime();
-    setNextExecutionMs(nextExecutionTime);
-    
     // CRITICAL: Update execution statistics
     updateExecutionStats();
     
@@ -262,6 +273,7 @@ JsonDocument ECProbeComponent::getCurrentConfig() const {
     config["outlier_threshold"] = m_outlierThreshold;
     config["tds_conversion_factor"] = m_tdsConversionFactor;
     config["temperature_source_id"] = m_temperatureSourceId;
+    config["temperature_max_age_ms"] = m_temperatureMaxAgeMs;
     config["excite_voltage_component_id"] = m_exciteVoltageComponentId;
     config["excite_stabilize_ms"] = m_exciteStabilizeMs;
     
@@ -290,9 +302,14 @@ bool ECProbeComponent::applyConfig(const JsonDocument& config) {
     m_outlierThreshold = config["outlier_threshold"] | m_outlierThreshold;
     m_tdsConversionFactor = config["tds_conversion_factor"] | m_tdsConversionFactor;
     m_temperatureSourceId = config["temperature_source_id"] | m_temperatureSourceId;
+    m_temperatureMaxAgeMs = config["temperature_max_age_ms"] | m_temperatureMaxAgeMs;
     m_exciteVoltageComponentId = config["excite_voltage_component_id"] | m_exciteVoltageComponentId;
     m_exciteStabilizeMs = config["excite_stabilize_ms"] | m_exciteStabilizeMs;
     
+    // Temperature compensation reads the source at the end of each sampling window
+    clearDependencies();
+    declareDependency(m_temperatureSourceId, m_temperatureMaxAgeMs);
+    
     // Validate sample size
     if (m_sampleSize < 1) m_sampleSize = 1;
     if (m_sampleSize > 100) m_sampleSize = 100;
@@ -761,26 +778,103 @@ bool ECProbeComponent::isSamplingWindowComplete() const {
     return timeExpired || bufferFull;
 }
 
-uint32_t ECProbeComponent::calculateNextExecutionTime() const {
-    uint32_t currentTime = millis();
-    
-    if (m_samplingActive) {
-        // During sampling: check frequently for new readings
-        return currentTime + min(m_readingIntervalMs, 500U);  // At least every 500ms
-    } else {
-        // After sampling window completes: wait for end window + 100ms resource allocation
-        // Then start next sampling cycle
-        uint32_t nextSamplingStart = m_samplingEndMs + 100;  // 100ms resource allocation buffer
+TaskStep ECProbeComponent::samplingTask() {
+    TASK_BEGIN();
+    
+    while (true) {
+        // Mock mode has no window: one direct reading per interval
+        if (m_gpioPin == 0) {
+            takeMockReading();
+            AWAIT_DELAY(m_readingIntervalMs);
+            continue;
+        }
         
-        // If we're past the buffer time, start immediately
-        if (currentTime >= nextSamplingStart) {
-            return currentTime + 100;  // Small delay to prevent tight loop
-        } else {
-            return nextSamplingStart;
+        startSamplingWindow();
+        
+        // Excitation settles on a timer, so sleep through it instead of polling
+        if (m_exciteVoltageComponentId.length() > 0) {
+            AWAIT_DELAY(m_exciteStabilizeMs);
+        }
+        
+        while (!isSamplingWindowComplete()) {
+            if (isExcitationStabilized()) {
+                takeSample();
+            } else {
+                log(Logger::DEBUG, "EC excitation voltage not available - skipping sample");
+            }
+            
+            // Next reading, but never past the end of the window
+            AWAIT_DELAY(min(m_readingIntervalMs, msUntil(m_samplingEndMs)));
         }
+        
+        completeSamplingWindow();
+        
+        // Next window after the planned end plus a 100ms resource allocation buffer
+        AWAIT_DELAY(msUntil(m_samplingEndMs + 100));
+    }
+    
+    TASK_END();
+}
+
+void ECProbeComponent::takeMockReading() {
+    float rawVoltage = readRawVoltage();
+    if (rawVoltage >= 0) {
+        m_currentVolts = rawVoltage;
+        m_currentTemp = getTemperatureReading();
+        m_currentEC = convertVoltageToEC(m_currentVolts, m_currentTemp);
+        m_currentTDS = convertECtoTDS(m_currentEC);
+        m_totalReadings++;
+        
+        log(Logger::DEBUG, "EC Mock reading: " + String(rawVoltage, 4) + "V -> " + 
+            String(m_currentEC, 1) + " µS/cm, " + String(m_currentTDS, 1) + " ppm");
     }
 }
 
+void ECProbeComponent::takeSample() {
+    float rawVoltage = readRawVoltage();
+    
+    if (rawVoltage >= 0) {
+        addReading(rawVoltage);
+        m_totalReadings++;
+        m_lastReadingMs = millis();
+        
+        log(Logger::DEBUG, "EC Sample " + String(m_lastReads.size()) + "/" + String(m_sampleSize) + 
+            ": " + String(rawVoltage, 4) + "V");
+    } else {
+        m_errorCount++;
+        log(Logger::WARNING, "Failed to read EC probe voltage");
+    }
+}
+
+void ECProbeComponent::completeSamplingWindow() {
+    endSamplingWindow();
+    
+    // Remove outliers from sample set
+    removeOutliers();
+    
+    // Calculate final averaged voltage with outlier removal
+    m_currentVolts = calculateWeightedAverageWithOutlierRemoval();
+    
+    // Get temperature for compensation
+    m_currentTemp = getTemperatureReading();
+    
+    // Calculate EC with temperature compensation
+    m_currentEC = convertVoltageToEC(m_currentVolts, m_currentTemp);
+    
+    // Calculate TDS from EC
+    m_currentTDS = convertECtoTDS(m_currentEC);
+    
+    // Update statistics
+    if (m_currentEC >= 0) {
+        m_minRecordedEC = min(m_minRecordedEC, m_currentEC);
+        m_maxRecordedEC = max(m_maxRecordedEC, m_currentEC);
+    }
+    
+    log(Logger::INFO, "EC sampling complete: " + String(m_lastReads.size()) + " samples, " + 
+        String(m_outliersRemoved) + " outliers removed, EC = " + String(m_currentEC, 1) + " µS/cm, TDS = " + 
+        String(m_currentTDS, 1) + " ppm");
+}
+
 float ECProbeComponent::convertVoltageToEC(float voltage, float temperature_c) const {
     // In mock mode, provide simulated EC values without calibration
     if (m_currentMode == ECProbeMode::MOCK) {
@@ -829,10 +923,11 @@ float ECProbeComponent::getTemperatureReading() {
     if (m_temperatureSourceId.length() > 0 && m_orchestrator) {
         BaseComponent* tempComponent = getTemperatureComponent();
         if (tempComponent) {
-            // Try to get temperature from component
-            JsonDocument tempData;
-            // This would need to be implemented based on your temperature component's interface
-            // For now, return default
+            JsonDocument tempData = tempComponent->getLastExecutionData();
+            JsonVariantConst temperature = tempData["temperature"];
+            if (temperature.is<float>()) {
+                return temperature.as<float>();
+            }
         }
     }
     
@@ -932,11 +1027,7 @@ float ECProbeComponent::interpolateEC(float voltage) const {
 }
 
 BaseComponent* ECProbeComponent::getTemperatureComponent() {
-    if (m_orchestrator && m_temperatureSourceId.length() > 0) {
-        // Implementation would depend on your orchestrator's component lookup method
-        // return m_orchestrator->getComponent(m_temperatureSourceId);
-    }
-    return nullptr;
+    return consumeDependency(m_temperatureSourceId);
 }
 
 bool ECProbeComponent::controlExcitationVoltage(bool enable) {
@@ -1014,4 +1105,8 @@ BaseComponent* ECProbeComponent::getExciteVoltageComponent() {
         // return m_orchestrator->getComponent(m_exciteVoltageComponentId);
     }
     return nullptr;
-}
\ No newline at end of file
+}
+
+REGISTER_COMPONENT_TYPE(ECProbeComponent, "ECProbe", nullptr)
+
+#endif // COMPONENT_EC_PROBE
@@ -194,6 +194,7 @@ private:
     float m_outlierThreshold = 2.5f;            // Standard deviations for outlier detection (more conservative)
     float m_tdsConversionFactor = 0.64f;        // TDS conversion factor (EC µS/cm * factor = TDS ppm)
     String m_temperatureSourceId = "";          // Component ID for temperature readings
+    uint32_t m_temperatureMaxAgeMs = 30000;     // Older temperature data triggers an on-demand read
     String m_exciteVoltageComponentId = "";     // Component ID for excitation voltage control
     uint32_t m_exciteStabilizeMs = 1000;        // Time to wait after excitation on (1000ms for EC)
     
@@ -240,7 +241,10 @@ private:
     void startSamplingWindow();
     void endSamplingWindow();
     bool isSamplingWindowComplete() const;
-    uint32_t calculateNextExecutionTime() const;
+    TaskStep samplingTask();
+    void takeMockReading();
+    void takeSample();
+    void completeSamplingWindow();
     bool controlExcitationVoltage(bool enable);
     bool isExcitationStabilized() const;
     void updateSensorMode();
@@ -252,6 +256,6 @@ private:
     void logCalibrationStatus();
     bool validateCalibrationPoints() const;
     float interpolateEC(float voltage) const;
-    BaseComponent* getTemperatureComponent();
+    BaseComponent* getTemperatureComponent();   // Temperature producer, refreshed if stale
     BaseComponent* getExciteVoltageComponent();
 };
\ No newline at end of file
@@ -1,3 +1,8 @@
+#include "../core/ComponentRegistry.h"
+
+// Flag first: the HTTP client headers have no native (host) shim
+#if COMPONENT_LIGHT_ORCHESTRATOR
+
 #include "LightOrchestrator.h"
 #include "../core/Orchestrator.h"
 #include "ServoDimmerComponent.h"
@@ -102,7 +107,7 @@ bool LightOrchestrator::initialize(const JsonDocument& config) {
         return false;
     }
     
-    if (!applyConfiguration(m_configuration)) {
+    if (!applyConfiguration(getConfiguration())) {
         setError("Failed to apply configuration");
         return false;
     }
@@ -220,11 +225,9 @@ ExecutionResult LightOrchestrator::execute() {
     }
     
     // Store last execution data for API/dashboard access
-    // Deep copy the data using serialize/deserialize to ensure it persists  
     String dataStr;
     serializeJson(result.data, dataStr);
-    m_lastData.clear();
-    deserializeJson(m_lastData, dataStr);
+    storeExecutionDataString(dataStr);
     
     // Schedule next execution
     setNextExecutionMs(millis() + m_adjustmentIntervalMs);
@@ -688,16 +691,8 @@ JsonDocument LightOrchestrator::getSensorData(const String& componentId) {
         return JsonDocument();
     }
     
-    try {
-        ExecutionResult result = component->execute();
-        if (result.success) {
-            return result.data;
-        }
-    } catch (...) {
-        // Ignore execution errors
-    }
-    
-    return JsonDocument();
+    // Latest scheduled sample; calling execute() here would bypass the orchestrator
+    return component->getLastExecutionData();
 }
 
 bool LightOrchestrator::startSweepTest() {
@@ -793,4 +788,8 @@ void LightOrchestrator::updateSweepTest() {
     } else {
         log(Logger::WARNING, "Sweep test servo command failed at " + String(m_sweepCurrentPosition) + "%");
     }
-}
\ No newline at end of file
+}
+
+REGISTER_COMPONENT_TYPE(LightOrchestrator, "LightOrchestrator", nullptr)
+
+#endif // COMPONENT_LIGHT_ORCHESTRATOR
@@ -0,0 +1,826 @@
+#include "MqttBroadcastComponent.h"
+#include "../core/ComponentRegistry.h"
+#include "../core/Orchestrator.h"
+#include "../storage/RtcStateStore.h"
+#include "../utils/TimeUtils.h"
+
+#if COMPONENT_MQTT_BROADCAST
+
+namespace {
+const size_t MAX_BATCH_BYTES = 3072;       // Must fit the client's outgoing buffer
+const char* OFFLINE_QUEUE_PATH = "/data/mqtt_queue";
+}
+
+MqttBroadcastComponent::MqttBroadcastComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator)
+    : BaseComponent(id, "MqttBroadcast", name, storage, orchestrator), m_offlineQueue(OFFLINE_QUEUE_PATH, 32768) {
+    log(Logger::DEBUG, "MqttBroadcastComponent created");
+}
+
+MqttBroadcastComponent::~MqttBroadcastComponent() {
+    cleanup();
+    if (m_eventQueue) {
+        vQueueDelete(m_eventQueue);
+        m_eventQueue = nullptr;
+    }
+}
+
+JsonDocument MqttBroadcastComponent::getDefaultSchema() const {
+    JsonDocument schema;
+    schema["type"] = "object";
+    schema["title"] = "MQTT Broadcast Configuration";
+    schema["required"].add("mqttServer");
+
+    JsonObject properties = schema["properties"].to<JsonObject>();
+
+    // MQTT Server (required)
+    JsonObject serverProp = properties["mqttServer"].to<JsonObject>();
+    serverProp["type"] = "string";
+    serverProp["default"] = "192.168.1.80";
+    serverProp["description"] = "MQTT server IP address or hostname";
+
+    // MQTT Port (optional)
+    JsonObject portProp = properties["mqttPort"].to<JsonObject>();
+    portProp["type"] = "integer";
+    portProp["minimum"] = 1;
+    portProp["maximum"] = 65535;
+    portProp["default"] = 1883;
+    portProp["description"] = "MQTT server port number";
+
+    // Publish Cycle (optional)
+    JsonObject cycleProp = properties["publishCycleSec"].to<JsonObject>();
+    cycleProp["type"] = "integer";
+    cycleProp["minimum"] = 1;
+    cycleProp["maximum"] = 3600;
+    cycleProp["default"] = 15;
+    cycleProp["description"] = "Publish interval in seconds";
+
+    // MQTT Root Topic (optional)
+    JsonObject rootProp = properties["mqttRoot"].to<JsonObject>();
+    rootProp["type"] = "string";
+    rootProp["default"] = "/EspOrch";
+    rootProp["maxLength"] = 100;
+    rootProp["description"] = "Base MQTT topic root";
+
+    // MQTT Username (optional)
+    JsonObject userProp = properties["mqttUsername"].to<JsonObject>();
+    userProp["type"] = "string";
+    userProp["default"] = "";
+    userProp["maxLength"] = 50;
+    userProp["description"] = "MQTT username (leave empty if not needed)";
+
+    // MQTT Password (optional)
+    JsonObject passProp = properties["mqttPassword"].to<JsonObject>();
+    passProp["type"] = "string";
+    passProp["default"] = "";
+    passProp["maxLength"] = 50;
+    passProp["description"] = "MQTT password (leave empty if not needed)";
+
+    // QoS (optional)
+    JsonObject qosProp = properties["qos"].to<JsonObject>();
+    qosProp["type"] = "integer";
+    qosProp["minimum"] = 0;
+    qosProp["maximum"] = 1;
+    qosProp["default"] = 1;
+    qosProp["description"] = "Publish QoS (1 = broker acknowledges every batch)";
+
+    // Full refresh (optional)
+    JsonObject refreshProp = properties["fullRefreshSec"].to<JsonObject>();
+    refreshProp["type"] = "integer";
+    refreshProp["minimum"] = 0;
+    refreshProp["maximum"] = 86400;
+    refreshProp["default"] = 300;
+    refreshProp["description"] = "Republish unchanged readings at least this often (0 = only on change)";
+
+    // Offline queue budget (optional)
+    JsonObject queueProp = properties["queueMaxBytes"].to<JsonObject>();
+    queueProp["type"] = "integer";
+    queueProp["minimum"] = 4096;
+    queueProp["maximum"] = 262144;
+    queueProp["default"] = 32768;
+    queueProp["description"] = "Flash bytes for batches buffered while the broker is unreachable";
+
+    // Drain rate (optional)
+    JsonObject drainProp = properties["drainIntervalMs"].to<JsonObject>();
+    drainProp["type"] = "integer";
+    drainProp["minimum"] = 100;
+    drainProp["maximum"] = 60000;
+    drainProp["default"] = 1000;
+    drainProp["description"] = "Minimum gap between buffered batches when draining after reconnect";
+
+    // Reconnect backoff (optional)
+    JsonObject backoffMinProp = properties["reconnectMinMs"].to<JsonObject>();
+    backoffMinProp["type"] = "integer";
+    backoffMinProp["minimum"] = 500;
+    backoffMinProp["maximum"] = 60000;
+    backoffMinProp["default"] = 2000;
+    backoffMinProp["description"] = "First reconnect delay (doubles on every failure)";
+
+    JsonObject backoffMaxProp = properties["reconnectMaxMs"].to<JsonObject>();
+    backoffMaxProp["type"] = "integer";
+    backoffMaxProp["minimum"] = 1000;
+    backoffMaxProp["maximum"] = 3600000;
+    backoffMaxProp["default"] = 300000;
+    backoffMaxProp["description"] = "Maximum reconnect delay";
+
+    return schema;
+}
+
+bool MqttBroadcastComponent::initialize(const JsonDocument& config) {
+    log(Logger::INFO, "Initializing MQTT broadcast component...");
+    setState(ComponentState::INITIALIZING);
+
+    // Load configuration (will use defaults if config is empty)
+    if (!loadConfiguration(config)) {
+        setError("Failed to load configuration");
+        return false;
+    }
+
+    // Apply the configuration
+    if (!applyConfiguration(getConfiguration())) {
+        setError("Failed to apply configuration");
+        return false;
+    }
+
+    if (!m_eventQueue) {
+        m_eventQueue = xQueueCreate(EVENT_QUEUE_DEPTH, sizeof(MqttEvent));
+        if (!m_eventQueue) {
+            setError("Failed to create MQTT event queue");
+            return false;
+        }
+    }
+
+    // Create unique client ID
+    m_clientId = "EspOrch-" + WiFi.macAddress();
+    m_clientId.replace(":", "");
+
+    // Pick up batches left over from before the reboot
+    m_offlineQueue.begin();
+
+    // The client is started from execute() once WiFi is up
+    setNextExecutionMs(millis() + 5000);
+
+    setState(ComponentState::READY);
+    log(Logger::INFO, String("MQTT broadcast initialized - server: ") + m_mqttServer +
+                      ":" + m_mqttPort + ", cycle: " + m_publishCycleSec + "s, qos: " + m_qos +
+                      ", queued: " + m_offlineQueue.count());
+
+    return true;
+}
+
+JsonDocument MqttBroadcastComponent::getCurrentConfig() const {
+    JsonDocument config;
+
+    config["mqttServer"] = m_mqttServer;
+    config["mqttPort"] = m_mqttPort;
+    config["publishCycleSec"] = m_publishCycleSec;
+    config["mqttRoot"] = m_mqttRoot;
+    config["mqttUsername"] = m_mqttUsername;
+    config["mqttPassword"] = m_mqttPassword;
+    config["qos"] = m_qos;
+    config["fullRefreshSec"] = m_fullRefreshSec;
+    config["queueMaxBytes"] = m_queueMaxBytes;
+    config["drainIntervalMs"] = m_drainIntervalMs;
+    config["reconnectMinMs"] = m_reconnectMinMs;
+    config["reconnectMaxMs"] = m_reconnectMaxMs;
+    config["config_version"] = 2;
+
+    return config;
+}
+
+bool MqttBroadcastComponent::applyConfig(const JsonDocument& config) {
+    log(Logger::DEBUG, "Applying MQTT broadcast configuration with default hydration");
+
+    String previousServer = m_mqttServer;
+    uint16_t previousPort = m_mqttPort;
+    String previousUsername = m_mqttUsername;
+    String previousPassword = m_mqttPassword;
+
+    // Apply configuration with default hydration
+    m_mqttServer = config["mqttServer"] | "192.168.1.80";
+    m_mqttPort = config["mqttPort"] | 1883;
+    m_publishCycleSec = config["publishCycleSec"] | 15;
+    m_mqttRoot = config["mqttRoot"] | "/EspOrch";
+    m_mqttUsername = config["mqttUsername"] | "";
+    m_mqttPassword = config["mqttPassword"] | "";
+    m_qos = config["qos"] | 1;
+    m_fullRefreshSec = config["fullRefreshSec"] | 300;
+    m_queueMaxBytes = config["queueMaxBytes"] | 32768;
+    m_drainIntervalMs = config["drainIntervalMs"] | 1000;
+    m_reconnectMinMs = config["reconnectMinMs"] | 2000;
+    m_reconnectMaxMs = config["reconnectMaxMs"] | 300000;
+
+    if (m_qos > 1) m_qos = 1;
+    if (m_publishCycleSec == 0) m_publishCycleSec = 1;
+    if (m_reconnectMaxMs < m_reconnectMinMs) m_reconnectMaxMs = m_reconnectMinMs;
+    m_offlineQueue.setMaxBytes(m_queueMaxBytes);
+
+    // Handle version migration if needed
+    uint16_t configVersion = config["config_version"] | 1;
+    if (configVersion < 2) {
+        log(Logger::INFO, "Migrating MQTT configuration to version 2 (batching, QoS, offline queue)");
+    }
+
+    // Connection settings changed - restart the client on the next execution
+    if (m_client && (m_mqttServer != previousServer || m_mqttPort != previousPort ||
+                     m_mqttUsername != previousUsername || m_mqttPassword != previousPassword)) {
+        log(Logger::INFO, "Broker settings changed - reconnecting");
+        stopClient();
+    }
+
+    log(Logger::DEBUG, String("Config applied: server=") + m_mqttServer +
+                       ":" + m_mqttPort + ", cycle=" + m_publishCycleSec + "s" +
+                       ", root=" + m_mqttRoot + ", qos=" + m_qos +
+                       ", queue=" + m_queueMaxBytes + "B");
+
+    return true;
+}
+
+bool MqttBroadcastComponent::applyConfiguration(const JsonDocument& config) {
+    // Legacy method - now delegates to new architecture
+    return applyConfig(config);
+}
+
+ExecutionResult MqttBroadcastComponent::execute() {
+    ExecutionResult result;
+    uint32_t startTime = millis();
+
+    setState(ComponentState::EXECUTING);
+
+    processClientEvents();
+    checkAckTimeouts();
+    ensureMqttConnection();
+
+    // Check if it's time to publish
+    uint32_t now = millis();
+    uint32_t cycleMs = m_publishCycleSec * 1000;
+    if (m_lastPublish == 0 || now - m_lastPublish >= cycleMs) {
+        bool fullRefresh = m_lastFullRefresh == 0 ||
+                           (m_fullRefreshSec > 0 && now - m_lastFullRefresh >= m_fullRefreshSec * 1000);
+        m_lastPublish = now;  // buildBatch() resets this if readings had to be deferred
+        if (fullRefresh) {
+            m_lastFullRefresh = now;
+        }
+        String payload;
+        if (buildBatch(payload, fullRefresh)) {
+            publishBatch(payload);
+        }
+    }
+
+    drainOfflineQueue();
+
+    // Prepare output data
+    JsonDocument data;
+    data["timestamp"] = millis();
+    data["mqtt_server"] = m_mqttServer;
+    data["mqtt_port"] = m_mqttPort;
+    data["mqtt_connected"] = m_mqttConnected;
+    data["publish_cycle_sec"] = m_publishCycleSec;
+    data["mqtt_root"] = m_mqttRoot;
+    data["last_publish"] = m_lastPublish;
+    data["batches_published"] = m_batchesPublished;
+    data["batches_queued"] = m_batchesQueued;
+    data["queue_records"] = m_offlineQueue.count();
+    data["queue_bytes"] = m_offlineQueue.pendingBytes();
+    data["inflight"] = m_inflight.size();
+    data["success"] = true;
+
+    // Next run: publish cycle, or sooner while the client needs servicing
+    now = millis();
+    uint32_t waitMs = cycleMs - (now - m_lastPublish);
+    if (waitMs > cycleMs) waitMs = 0;
+    if ((m_clientStarted || !m_inflight.empty()) && waitMs > 1000) {
+        waitMs = 1000;
+    }
+    if (m_mqttConnected && !m_offlineQueue.isEmpty() && waitMs > m_drainIntervalMs) {
+        waitMs = m_drainIntervalMs;
+    }
+    setNextExecutionMs(now + waitMs);
+
+    result.success = true;
+    result.data = data;
+    result.executionTimeMs = millis() - startTime;
+
+    setState(ComponentState::READY);
+    return result;
+}
+
+void MqttBroadcastComponent::onMqttEvent(void* handlerArgs, esp_event_base_t base, int32_t eventId, void* eventData) {
+    MqttBroadcastComponent* self = static_cast<MqttBroadcastComponent*>(handlerArgs);
+    if (!self || !self->m_eventQueue) return;
+
+    switch (eventId) {
+        case MQTT_EVENT_CONNECTED:
+        case MQTT_EVENT_DISCONNECTED:
+        case MQTT_EVENT_PUBLISHED:
+        case MQTT_EVENT_ERROR: {
+            esp_mqtt_event_handle_t event = static_cast<esp_mqtt_event_handle_t>(eventData);
+            MqttEvent forwarded;
+            forwarded.id = eventId;
+            forwarded.msgId = event ? event->msg_id : 0;
+            // Never block the client task; a lost PUBLISHED event ends up as an ack timeout
+            xQueueSend(self->m_eventQueue, &forwarded, 0);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void MqttBroadcastComponent::processClientEvents() {
+    if (!m_eventQueue) return;
+
+    MqttEvent event;
+    while (xQueueReceive(m_eventQueue, &event, 0) == pdTRUE) {
+        switch (event.id) {
+            case MQTT_EVENT_CONNECTED:
+                m_mqttConnected = true;
+                m_connectCount++;
+                m_reconnectDelayMs = 0;
+                m_nextReconnectMs = 0;
+                m_lastDrainMs = millis() - m_drainIntervalMs;
+                log(Logger::INFO, String("MQTT connected as ") + m_clientId +
+                    (m_offlineQueue.isEmpty() ? String("") :
+                     String(" - draining ") + m_offlineQueue.count() + " buffered batches"));
+                break;
+
+            case MQTT_EVENT_DISCONNECTED:
+                if (m_mqttConnected) {
+                    m_disconnectCount++;
+                    log(Logger::WARNING, "MQTT connection lost - buffering batches to flash");
+                }
+                m_mqttConnected = false;
+                scheduleReconnect();
+                break;
+
+            case MQTT_EVENT_PUBLISHED:
+                for (size_t i = 0; i < m_inflight.size(); i++) {
+                    if (m_inflight[i].msgId != event.msgId) continue;
+                    if (m_inflight[i].fromQueue) {
+                        // The record may have been dropped by a full queue meanwhile
+                        m_offlineQueue.popIfHead(m_inflight[i].queueSeq);
+                        m_batchesDrained++;
+                        if (m_offlineQueue.isEmpty()) {
+                            log(Logger::INFO, String("Offline queue drained (") + m_batchesDrained + " batches delivered)");
+                        }
+                    } else {
+                        m_batchesPublished++;
+                    }
+                    m_lastAckMs = millis();
+                    m_inflight.erase(m_inflight.begin() + i);
+                    break;
+                }
+                break;
+
+            case MQTT_EVENT_ERROR:
+                log(Logger::DEBUG, "MQTT client reported an error");
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+void MqttBroadcastComponent::ensureMqttConnection() {
+    // Check WiFi first
+    if (WiFi.status() != WL_CONNECTED) {
+        if (m_mqttConnected) {
+            log(Logger::WARNING, "WiFi disconnected - MQTT connection lost");
+            m_mqttConnected = false;
+            m_disconnectCount++;
+        }
+        return;
+    }
+
+    if (m_mqttConnected) {
+        return;
+    }
+
+    if (!m_clientStarted) {
+        startClient();
+        return;
+    }
+
+    uint32_t now = millis();
+    if (m_nextReconnectMs == 0) {
+        // Attempt in progress; a dropped DISCONNECTED event must not stall us forever
+        if (now - m_lastReconnectAttempt > m_reconnectMaxMs) {
+            scheduleReconnect();
+        }
+        return;
+    }
+
+    if ((int32_t)(now - m_nextReconnectMs) >= 0) {
+        m_nextReconnectMs = 0;
+        m_lastReconnectAttempt = now;
+        log(Logger::DEBUG, String("Attempting MQTT reconnect to ") + m_mqttServer + ":" + m_mqttPort);
+        if (esp_mqtt_client_reconnect(m_client) != ESP_OK) {
+            scheduleReconnect();
+        }
+    }
+}
+
+void MqttBroadcastComponent::onNetworkChange(bool connected) {
+    if (!connected) {
+        if (m_mqttConnected) {
+            log(Logger::WARNING, "WiFi down - MQTT paused, batches go to flash");
+            m_mqttConnected = false;
+            m_disconnectCount++;
+        }
+        m_nextReconnectMs = 0;
+        return;
+    }
+
+    // Backoff was about the broker being unreachable, not this outage
+    m_reconnectDelayMs = 0;
+    if (m_clientStarted) {
+        m_nextReconnectMs = millis();
+    }
+    setNextExecutionMs(millis());
+}
+
+void MqttBroadcastComponent::scheduleReconnect() {
+    if (m_nextReconnectMs != 0) return;  // Already scheduled
+
+    // Exponential backoff with up to 25% jitter so a fleet does not reconnect in lockstep
+    if (m_reconnectDelayMs == 0) {
+        m_reconnectDelayMs = m_reconnectMinMs;
+    } else {
+        m_reconnectDelayMs = min(m_reconnectDelayMs * 2, m_reconnectMaxMs);
+    }
+    uint32_t delayMs = m_reconnectDelayMs + random(0, m_reconnectDelayMs / 4 + 1);
+
+    m_nextReconnectMs = millis() + delayMs;
+    if (m_nextReconnectMs == 0) m_nextReconnectMs = 1;
+
+    log(Logger::DEBUG, String("MQTT reconnect in ") + delayMs + "ms");
+}
+
+bool MqttBroadcastComponent::startClient() {
+    log(Logger::DEBUG, String("Attempting MQTT connection to ") + m_mqttServer + ":" + m_mqttPort);
+
+    esp_mqtt_client_config_t cfg = {};
+    cfg.host = m_mqttServer.c_str();
+    cfg.port = m_mqttPort;
+    cfg.transport = MQTT_TRANSPORT_OVER_TCP;
+    cfg.client_id = m_clientId.c_str();
+    if (m_mqttUsername.length() > 0) {
+        cfg.username = m_mqttUsername.c_str();
+        cfg.password = m_mqttPassword.c_str();
+    }
+    cfg.keepalive = 30;
+    cfg.disable_auto_reconnect = true;      // Backoff is driven from execute()
+    cfg.out_buffer_size = MAX_BATCH_BYTES + 256;
+
+    m_client = esp_mqtt_client_init(&cfg);
+    if (!m_client) {
+        log(Logger::ERROR, "Failed to create MQTT client");
+        return false;
+    }
+
+    esp_mqtt_client_register_event(m_client, (esp_mqtt_event_id_t)ESP_EVENT_ANY_ID,
+                                   &MqttBroadcastComponent::onMqttEvent, this);
+
+    if (esp_mqtt_client_start(m_client) != ESP_OK) {
+        log(Logger::ERROR, "Failed to start MQTT client");
+        esp_mqtt_client_destroy(m_client);
+        m_client = nullptr;
+        return false;
+    }
+
+    m_clientStarted = true;
+    m_lastReconnectAttempt = millis();
+    return true;
+}
+
+void MqttBroadcastComponent::stopClient() {
+    if (m_client) {
+        esp_mqtt_client_stop(m_client);
+        esp_mqtt_client_destroy(m_client);
+        m_client = nullptr;
+    }
+
+    // The client's outbox went with it
+    requeueInflight("client stopped");
+
+    m_clientStarted = false;
+    m_mqttConnected = false;
+    m_nextReconnectMs = 0;
+    m_reconnectDelayMs = 0;
+
+    if (m_eventQueue) {
+        xQueueReset(m_eventQueue);
+    }
+}
+
+bool MqttBroadcastComponent::buildBatch(String& payload, bool fullRefresh) {
+    if (!m_orchestrator) {
+        log(Logger::WARNING, "No orchestrator reference - cannot publish component data");
+        return false;
+    }
+
+    uint32_t now = millis();
+    JsonDocument batch;
+    batch["node"] = m_clientId;
+    batch["ts"] = (long)TimeUtils::getEpochTime();
+    batch["uptime_ms"] = now;
+    JsonObject readings = batch["readings"].to<JsonObject>();
+
+    size_t skipped = 0;
+    size_t deferred = 0;
+    for (BaseComponent* component : m_orchestrator->getComponents()) {
+        if (!component || component == this) continue;  // Don't publish our own data
+        if (component->getExecutionCount() == 0) continue;
+
+        // Readings come from the last execution; never execute components from here
+        JsonDocument reading = component->getCoreData();
+        if (reading.size() == 0) {
+            const String& lastData = component->getLastExecutionDataString();
+            if (lastData.isEmpty() || deserializeJson(reading, lastData) != DeserializationError::Ok) {
+                continue;
+            }
+        }
+        reading.remove("timestamp");  // Changes every run; not part of the reading
+
+        String readingJson;
+        serializeJson(reading, readingJson);
+        uint32_t readingHash = RtcStateStore::hash(readingJson);
+
+        MqttPublishInfo& info = getOrCreatePublishInfo(component->getId());
+        if (!fullRefresh && info.publishCount > 0 && info.dataHash == readingHash) {
+            skipped++;
+            continue;
+        }
+
+        readings[component->getId()] = reading;
+        if (measureJson(batch) > MAX_BATCH_BYTES) {
+            // Leave the rest for the next cycle (their hashes are unchanged)
+            readings.remove(component->getId());
+            deferred++;
+            continue;
+        }
+
+        info.dataHash = readingHash;
+        info.lastPublishMs = now;
+        info.lastDataSize = readingJson.length();
+        info.publishCount++;
+    }
+
+    m_readingsSkipped += skipped;
+    if (deferred > 0) {
+        log(Logger::WARNING, String("Batch size limit reached - ") + deferred + " readings deferred");
+        m_lastPublish = 0;
+    }
+
+    if (readings.size() == 0) {
+        log(Logger::DEBUG, String("No changed readings this cycle (") + skipped + " unchanged)");
+        return false;
+    }
+
+    batch["seq"] = ++m_batchSeq;
+    serializeJson(batch, payload);
+    m_lastBatchBytes = payload.length();
+
+    log(Logger::DEBUG, String("Batch #") + m_batchSeq + ": " + readings.size() + " readings, " +
+                       skipped + " unchanged, " + payload.length() + " bytes");
+    return true;
+}
+
+void MqttBroadcastComponent::publishBatch(const String& payload) {
+    // Keep ordering: while a backlog exists, new batches go behind it
+    if (m_mqttConnected && m_offlineQueue.isEmpty() && m_inflight.size() < MAX_INFLIGHT) {
+        if (sendBatch(payload, false)) {
+            return;
+        }
+    }
+
+    if (m_offlineQueue.push(payload)) {
+        m_batchesQueued++;
+        log(Logger::DEBUG, String("Batch buffered to flash (") + m_offlineQueue.count() + " queued, " +
+                           m_offlineQueue.pendingBytes() + " bytes)");
+    } else {
+        log(Logger::WARNING, "Failed to buffer batch - reading data lost");
+    }
+}
+
+bool MqttBroadcastComponent::sendBatch(const String& payload, bool fromQueue, uint32_t queueSeq) {
+    if (!m_client) return false;
+
+    String topic = getBatchTopic();
+
+    // Non-blocking: the client task transmits from its outbox
+    int msgId = esp_mqtt_client_enqueue(m_client, topic.c_str(), payload.c_str(), payload.length(),
+                                        m_qos, 0, true);
+    if (msgId < 0) {
+        log(Logger::WARNING, String("Failed to publish batch to ") + topic);
+        return false;
+    }
+
+    if (m_qos == 0) {
+        // No acknowledgement to wait for
+        if (fromQueue) {
+            m_offlineQueue.popIfHead(queueSeq);
+            m_batchesDrained++;
+        } else {
+            m_batchesPublished++;
+        }
+        return true;
+    }
+
+    InflightBatch inflight;
+    inflight.msgId = msgId;
+    inflight.sentMs = millis();
+    inflight.fromQueue = fromQueue;
+    inflight.queueSeq = queueSeq;
+    if (!fromQueue) {
+        inflight.payload = payload;  // Queued batches stay on flash until acknowledged
+    }
+    m_inflight.push_back(inflight);
+    return true;
+}
+
+void MqttBroadcastComponent::drainOfflineQueue() {
+    if (!m_mqttConnected || m_offlineQueue.isEmpty()) return;
+    if (m_inflight.size() >= MAX_INFLIGHT) return;
+
+    // One buffered batch at a time, in order, at most every m_drainIntervalMs
+    for (const InflightBatch& inflight : m_inflight) {
+        if (inflight.fromQueue) return;
+    }
+    if (millis() - m_lastDrainMs < m_drainIntervalMs) return;
+
+    String payload;
+    uint32_t seq = 0;
+    if (!m_offlineQueue.peek(payload, &seq)) return;
+
+    m_lastDrainMs = millis();
+    sendBatch(payload, true, seq);
+}
+
+void MqttBroadcastComponent::checkAckTimeouts() {
+    uint32_t now = millis();
+    for (size_t i = 0; i < m_inflight.size();) {
+        if (now - m_inflight[i].sentMs < m_ackTimeoutMs) {
+            i++;
+            continue;
+        }
+
+        // At-least-once: the batch may still arrive late, consumers dedupe on (node, seq)
+        if (!m_inflight[i].fromQueue && m_offlineQueue.push(m_inflight[i].payload)) {
+            m_batchesQueued++;
+        }
+        m_batchesRequeued++;
+        m_inflight.erase(m_inflight.begin() + i);
+        log(Logger::WARNING, "No PUBACK within timeout - batch requeued");
+    }
+}
+
+void MqttBroadcastComponent::requeueInflight(const char* reason) {
+    if (m_inflight.empty()) return;
+
+    size_t requeued = 0;
+    for (const InflightBatch& inflight : m_inflight) {
+        if (!inflight.fromQueue && m_offlineQueue.push(inflight.payload)) {
+            m_batchesQueued++;
+        }
+        requeued++;
+    }
+    m_batchesRequeued += requeued;
+    m_inflight.clear();
+
+    log(Logger::INFO, String("Requeued ") + requeued + " unacknowledged batches (" + reason + ")");
+}
+
+MqttPublishInfo& MqttBroadcastComponent::getOrCreatePublishInfo(const String& componentId) {
+    for (MqttPublishInfo& info : m_publishInfo) {
+        if (info.componentId == componentId) return info;
+    }
+    MqttPublishInfo info;
+    info.componentId = componentId;
+    m_publishInfo.push_back(info);
+    return m_publishInfo.back();
+}
+
+const MqttPublishInfo* MqttBroadcastComponent::getPublishInfo(const String& componentId) const {
+    for (const MqttPublishInfo& info : m_publishInfo) {
+        if (info.componentId == componentId && info.publishCount > 0) return &info;
+    }
+    return nullptr;
+}
+
+JsonDocument MqttBroadcastComponent::getPublisherStats() const {
+    JsonDocument stats;
+
+    stats["connected"] = m_mqttConnected;
+    stats["broker"] = m_mqttServer + ":" + m_mqttPort;
+    stats["client_id"] = m_clientId;
+    stats["topic"] = getBatchTopic();
+    stats["qos"] = m_qos;
+    stats["batch_seq"] = m_batchSeq;
+    stats["batches_published"] = m_batchesPublished;
+    stats["batches_queued"] = m_batchesQueued;
+    stats["batches_drained"] = m_batchesDrained;
+    stats["batches_requeued"] = m_batchesRequeued;
+    stats["readings_skipped"] = m_readingsSkipped;
+    stats["last_batch_bytes"] = m_lastBatchBytes;
+    stats["last_publish_ms"] = m_lastPublish;
+    stats["last_ack_ms"] = m_lastAckMs;
+    stats["inflight"] = m_inflight.size();
+    stats["connects"] = m_connectCount;
+    stats["disconnects"] = m_disconnectCount;
+    stats["reconnect_delay_ms"] = m_reconnectDelayMs;
+
+    JsonObject queue = stats["offline_queue"].to<JsonObject>();
+    queue["records"] = m_offlineQueue.count();
+    queue["bytes"] = m_offlineQueue.pendingBytes();
+    queue["max_bytes"] = m_offlineQueue.maxBytes();
+    queue["dropped"] = m_offlineQueue.droppedCount();
+
+    return stats;
+}
+
+void MqttBroadcastComponent::cleanup() {
+    log(Logger::DEBUG, "Cleaning up MQTT broadcast component");
+    stopClient();
+}
+
+std::vector<ComponentAction> MqttBroadcastComponent::getSupportedActions() const {
+    std::vector<ComponentAction> actions;
+
+    ComponentAction statusAction;
+    statusAction.name = "status";
+    statusAction.description = "Get connection, queue and publish statistics";
+    statusAction.timeoutMs = 1000;
+    statusAction.requiresReady = false;
+    actions.push_back(statusAction);
+
+    ComponentAction publishAction;
+    publishAction.name = "publish_now";
+    publishAction.description = "Publish a full batch of all readings immediately";
+    publishAction.timeoutMs = 5000;
+    actions.push_back(publishAction);
+
+    ComponentAction reconnectAction;
+    reconnectAction.name = "reconnect";
+    reconnectAction.description = "Reset backoff and reconnect to the broker now";
+    reconnectAction.timeoutMs = 1000;
+    reconnectAction.requiresReady = false;
+    actions.push_back(reconnectAction);
+
+    ComponentAction clearAction;
+    clearAction.name = "clear_queue";
+    clearAction.description = "Discard all batches buffered on flash";
+    clearAction.timeoutMs = 2000;
+    actions.push_back(clearAction);
+
+    return actions;
+}
+
+ActionResult MqttBroadcastComponent::performAction(const String& actionName, const JsonDocument& parameters) {
+    ActionResult result;
+    result.actionName = actionName;
+    result.success = false;
+
+    if (actionName == "status") {
+        result.success = true;
+        result.message = m_mqttConnected ? "Connected" : "Disconnected";
+        result.data = getPublisherStats();
+    } else if (actionName == "publish_now") {
+        String payload;
+        m_lastPublish = millis();
+        m_lastFullRefresh = m_lastPublish;
+        if (buildBatch(payload, true)) {
+            publishBatch(payload);
+            result.success = true;
+            result.message = String("Batch #") + m_batchSeq + " " +
+                             (m_offlineQueue.isEmpty() ? "published" : "queued");
+            result.data["bytes"] = payload.length();
+        } else {
+            result.message = "No readings available";
+        }
+    } else if (actionName == "reconnect") {
+        stopClient();
+        result.success = true;
+        result.message = "MQTT client restarted";
+    } else if (actionName == "clear_queue") {
+        size_t discarded = m_offlineQueue.count();
+        for (size_t i = 0; i < m_inflight.size();) {
+            if (m_inflight[i].fromQueue) {
+                m_inflight.erase(m_inflight.begin() + i);
+            } else {
+                i++;
+            }
+        }
+        m_offlineQueue.clear();
+        result.success = true;
+        result.message = String("Discarded ") + discarded + " buffered batches";
+    } else {
+        result.message = "Unknown action: " + actionName;
+    }
+
+    return result;
+}
+
+REGISTER_COMPONENT_TYPE(MqttBroadcastComponent, "MqttBroadcast", "Mqtt")
+
+#endif // COMPONENT_MQTT_BROADCAST
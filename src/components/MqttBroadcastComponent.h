@@ -1,17 +1,38 @@
 #pragma once
 
 #include "BaseComponent.h"
-#include <PubSubClient.h>
+#include "../storage/FlashQueue.h"
 #include <WiFi.h>
+#include <mqtt_client.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 
 // Forward declaration
 class Orchestrator;
 
+/**
+ * @brief Per-component publish bookkeeping
+ */
+struct MqttPublishInfo {
+    String componentId;
+    uint32_t dataHash = 0;          // Hash of the last published reading (timestamps excluded)
+    uint32_t lastPublishMs = 0;     // millis() when last included in a batch
+    uint16_t lastDataSize = 0;      // JSON bytes of the reading in that batch
+    uint32_t publishCount = 0;
+};
+
 /**
  * @brief MQTT broadcast component for publishing component data
- * 
- * Publishes all registered component output data to MQTT topics
- * using configurable server settings and topic structure.
+ *
+ * Every publish cycle the readings that changed since the previous cycle
+ * are collected into one batch message on <mqttRoot>/batch and published
+ * with QoS1. While the broker is unreachable, batches are written to a
+ * bounded LittleFS queue and drained at a fixed rate once the connection
+ * is back, oldest first.
+ *
+ * Uses the ESP-IDF MQTT client bundled with the Arduino core, which runs
+ * its own task; client events are handed to execute() through a FreeRTOS
+ * queue so all state is only touched from the orchestrator loop.
  */
 class MqttBroadcastComponent : public BaseComponent {
 public:
@@ -23,7 +44,7 @@ public:
      * @param orchestrator Reference to orchestrator for component access
      */
     MqttBroadcastComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator);
-    
+
     /**
      * @brief Destructor
      */
@@ -35,15 +56,46 @@ public:
     ExecutionResult execute() override;
     void cleanup() override;
 
+    /**
+     * @brief Get publish bookkeeping for a component
+     * @param componentId Component identifier
+     * @return Pointer to info, nullptr if the component was never published
+     */
+    const MqttPublishInfo* getPublishInfo(const String& componentId) const;
+
+    /**
+     * @brief Get topic that batches are published to
+     * @return Batch topic
+     */
+    String getBatchTopic() const { return m_mqttRoot + "/batch"; }
+
+    /**
+     * @brief Check if the broker connection is up
+     * @return true if connected
+     */
+    bool isMqttConnected() const { return m_mqttConnected; }
+
+    /**
+     * @brief Get publisher statistics (connection, queue, counters)
+     * @return Statistics as JSON document
+     */
+    JsonDocument getPublisherStats() const;
+
+    /**
+     * @brief Pause reconnects while WiFi is down, reconnect immediately when it is back
+     * @param connected New link state
+     */
+    void onNetworkChange(bool connected) override;
+
 protected:
     // === Configuration Management (BaseComponent virtual methods) ===
-    
+
     /**
      * @brief Get current component configuration as JSON
      * @return JsonDocument containing all current settings
      */
     JsonDocument getCurrentConfig() const override;
-    
+
     /**
      * @brief Apply configuration to component variables
      * @param config Configuration to apply (may be empty for defaults)
@@ -52,6 +104,28 @@ protected:
     bool applyConfig(const JsonDocument& config) override;
 
 private:
+    /**
+     * @brief Client event forwarded from the MQTT task
+     */
+    struct MqttEvent {
+        int32_t id;
+        int msgId;
+    };
+
+    /**
+     * @brief Batch handed to the client and waiting for PUBACK
+     */
+    struct InflightBatch {
+        int msgId;
+        uint32_t sentMs;
+        bool fromQueue;             // Read from the flash queue (pop on PUBACK)
+        uint32_t queueSeq;          // Flash queue sequence number, if fromQueue
+        String payload;             // Kept to requeue if never acknowledged
+    };
+
+    static const size_t MAX_INFLIGHT = 4;
+    static const size_t EVENT_QUEUE_DEPTH = 16;
+
     // Configuration parameters
     String m_mqttServer = "192.168.1.80";    // MQTT server IP/hostname
     uint16_t m_mqttPort = 1883;              // MQTT server port
@@ -59,28 +133,65 @@ private:
     String m_mqttRoot = "/EspOrch";          // Base MQTT topic root
     String m_mqttUsername = "";              // MQTT username (optional)
     String m_mqttPassword = "";              // MQTT password (optional)
-    
+    uint8_t m_qos = 1;                       // Publish QoS (0 or 1)
+    uint32_t m_fullRefreshSec = 300;         // Republish unchanged readings at least this often
+    uint32_t m_queueMaxBytes = 32768;        // Flash budget for offline batches
+    uint32_t m_drainIntervalMs = 1000;       // Minimum gap between queued batches on reconnect
+    uint32_t m_ackTimeoutMs = 30000;         // Requeue a batch if no PUBACK arrives in time
+    uint32_t m_reconnectMinMs = 2000;        // First reconnect delay
+    uint32_t m_reconnectMaxMs = 300000;      // Backoff ceiling (5 minutes)
+
     // MQTT client
-    WiFiClient m_wifiClient;
-    PubSubClient m_mqttClient;
-    
+    esp_mqtt_client_handle_t m_client = nullptr;
+    QueueHandle_t m_eventQueue = nullptr;
+    String m_clientId;
+
     // Connection state
     bool m_mqttConnected = false;
+    bool m_clientStarted = false;
+    uint32_t m_reconnectDelayMs = 0;         // Current backoff step
+    uint32_t m_nextReconnectMs = 0;
     uint32_t m_lastReconnectAttempt = 0;
-    uint32_t m_reconnectInterval = 5000;     // 5 seconds between reconnect attempts
-    
+    uint32_t m_connectCount = 0;
+    uint32_t m_disconnectCount = 0;
+
     // Publishing state
+    FlashQueue m_offlineQueue;
+    std::vector<InflightBatch> m_inflight;
+    std::vector<MqttPublishInfo> m_publishInfo;
     uint32_t m_lastPublish = 0;
-    
+    uint32_t m_lastFullRefresh = 0;
+    uint32_t m_lastDrainMs = 0;
+    uint32_t m_batchSeq = 0;
+    uint32_t m_batchesPublished = 0;         // Acknowledged (or sent, for QoS0)
+    uint32_t m_batchesQueued = 0;            // Written to flash while offline
+    uint32_t m_batchesDrained = 0;           // Delivered from flash
+    uint32_t m_batchesRequeued = 0;          // Ack timeouts / lost connection
+    uint32_t m_readingsSkipped = 0;          // Unchanged readings left out of batches
+    uint32_t m_lastBatchBytes = 0;
+    uint32_t m_lastAckMs = 0;
+
     // Private methods
     bool applyConfiguration(const JsonDocument& config);
-    bool connectToMqtt();
-    void publishComponentData();
-    void publishSingleComponent(BaseComponent* component);
-    String getComponentTopic(const String& componentId) const;
-    bool ensureMqttConnection();
+    bool startClient();
+    void stopClient();
+    void processClientEvents();
+    void ensureMqttConnection();
+    void scheduleReconnect();
+    bool buildBatch(String& payload, bool fullRefresh);
+    void publishBatch(const String& payload);
+    bool sendBatch(const String& payload, bool fromQueue, uint32_t queueSeq = 0);
+    void drainOfflineQueue();
+    void checkAckTimeouts();
+    void requeueInflight(const char* reason);
+    MqttPublishInfo& getOrCreatePublishInfo(const String& componentId);
+
+    /**
+     * @brief ESP-IDF event handler (runs in the MQTT client task)
+     */
+    static void onMqttEvent(void* handlerArgs, esp_event_base_t base, int32_t eventId, void* eventData);
 
     // === Action System (BaseComponent virtual methods) ===
     std::vector<ComponentAction> getSupportedActions() const override;
     ActionResult performAction(const String& actionName, const JsonDocument& parameters) override;
-};
\ No newline at end of file
+};
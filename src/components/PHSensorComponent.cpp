@@ -1,8 +1,11 @@
 #include "PHSensorComponent.h"
+#include "../core/ComponentRegistry.h"
 #include "../utils/Logger.h"
 #include "../core/Orchestrator.h"
 #include <Arduino.h>
 
+#if COMPONENT_PH_SENSOR
+
 PHSensorComponent::PHSensorComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator)
     : BaseComponent(id, "PHSensor", name, storage, orchestrator) {
     
@@ -39,21 +42,95 @@ JsonDocument PHSensorComponent::getDefaultSchema() const {
     schema["description"] = "pH sensor with 3-point calibration and temperature compensation";
     
     // Configuration parameters
-    JsonObject config = schema["config"].to<JsonObject>();
-    config["gpio_pin"] = 36;
-    config["temp_coefficient"] = -0.0198f;
-    config["sample_size"] = 10;
-    config["adc_voltage_ref"] = 3.3f;
-    config["adc_resolution"] = 4096;
-    config["reading_interval_ms"] = 1000;
-    config["time_period_for_sampling"] = 10000;
-    config["outlier_threshold"] = 2.0f;
-    config["temperature_source_id"] = "";
-    config["excite_voltage_component_id"] = "";
-    config["excite_stabilize_ms"] = 500;
+    JsonObject properties = schema["properties"].to<JsonObject>();
+    
+    JsonObject gpioPin = properties["gpio_pin"].to<JsonObject>();
+    gpioPin["type"] = "integer";
+    gpioPin["minimum"] = 0;
+    gpioPin["maximum"] = 39;
+    gpioPin["default"] = 36;
+    gpioPin["description"] = "ADC GPIO pin (0 = mock mode)";
+    
+    JsonObject tempCoefficient = properties["temp_coefficient"].to<JsonObject>();
+    tempCoefficient["type"] = "number";
+    tempCoefficient["minimum"] = -1;
+    tempCoefficient["maximum"] = 1;
+    tempCoefficient["default"] = -0.0198f;
+    tempCoefficient["description"] = "Temperature compensation coefficient";
+    
+    JsonObject sampleSize = properties["sample_size"].to<JsonObject>();
+    sampleSize["type"] = "integer";
+    sampleSize["minimum"] = 1;
+    sampleSize["maximum"] = 100;
+    sampleSize["default"] = 10;
+    sampleSize["description"] = "Readings averaged per sampling window";
+    
+    JsonObject adcVoltageRef = properties["adc_voltage_ref"].to<JsonObject>();
+    adcVoltageRef["type"] = "number";
+    adcVoltageRef["exclusiveMinimum"] = 0;
+    adcVoltageRef["maximum"] = 5.0;
+    adcVoltageRef["default"] = 3.3f;
+    adcVoltageRef["description"] = "ADC reference voltage";
+    
+    JsonObject adcResolution = properties["adc_resolution"].to<JsonObject>();
+    adcResolution["type"] = "integer";
+    adcResolution["minimum"] = 2;
+    adcResolution["maximum"] = 65535;
+    adcResolution["default"] = 4096;
+    adcResolution["description"] = "ADC full-scale count";
+    
+    JsonObject readingInterval = properties["reading_interval_ms"].to<JsonObject>();
+    readingInterval["type"] = "integer";
+    readingInterval["minimum"] = 10;
+    readingInterval["maximum"] = 60000;
+    readingInterval["default"] = 1000;
+    readingInterval["description"] = "Interval between readings in ms";
+    
+    JsonObject samplingPeriod = properties["time_period_for_sampling"].to<JsonObject>();
+    samplingPeriod["type"] = "integer";
+    samplingPeriod["minimum"] = 100;
+    samplingPeriod["maximum"] = 3600000;
+    samplingPeriod["default"] = 10000;
+    samplingPeriod["description"] = "Sampling window in ms";
+    
+    JsonObject outlierThreshold = properties["outlier_threshold"].to<JsonObject>();
+    outlierThreshold["type"] = "number";
+    outlierThreshold["exclusiveMinimum"] = 0;
+    outlierThreshold["maximum"] = 10.0;
+    outlierThreshold["default"] = 2.0f;
+    outlierThreshold["description"] = "Outlier rejection threshold in standard deviations";
+    
+    JsonObject temperatureSource = properties["temperature_source_id"].to<JsonObject>();
+    temperatureSource["type"] = "string";
+    temperatureSource["maxLength"] = 64;
+    temperatureSource["default"] = "";
+    temperatureSource["description"] = "Component providing temperature for compensation";
+    
+    JsonObject temperatureMaxAge = properties["temperature_max_age_ms"].to<JsonObject>();
+    temperatureMaxAge["type"] = "integer";
+    temperatureMaxAge["minimum"] = 0;
+    temperatureMaxAge["maximum"] = 3600000;
+    temperatureMaxAge["default"] = 30000;
+    temperatureMaxAge["description"] = "Maximum age of the temperature reading in ms";
+    
+    JsonObject exciteComponent = properties["excite_voltage_component_id"].to<JsonObject>();
+    exciteComponent["type"] = "string";
+    exciteComponent["maxLength"] = 64;
+    exciteComponent["default"] = "";
+    exciteComponent["description"] = "Component switching the probe excitation voltage";
+    
+    JsonObject exciteStabilize = properties["excite_stabilize_ms"].to<JsonObject>();
+    exciteStabilize["type"] = "integer";
+    exciteStabilize["minimum"] = 0;
+    exciteStabilize["maximum"] = 60000;
+    exciteStabilize["default"] = 500;
+    exciteStabilize["description"] = "Settling time after excitation in ms";
     
     // Calibration points
-    JsonArray calibration = config["calibration_points"].to<JsonArray>();
+    JsonObject calibrationPoints = properties["calibration_points"].to<JsonObject>();
+    calibrationPoints["type"] = "array";
+    calibrationPoints["description"] = "3-point calibration (pH 4, 7, 10)";
+    JsonArray calibration = calibrationPoints["default"].to<JsonArray>();
     for (int i = 0; i < 3; i++) {
         JsonObject point = calibration.add<JsonObject>();
         point["ph"] = (i == 0) ? 4.0f : (i == 1) ? 7.0f : 10.0f;
@@ -68,7 +145,16 @@ JsonDocument PHSensorComponent::getDefaultSchema() const {
 bool PHSensorComponent::initialize(const JsonDocument& config) {
     log(Logger::INFO, "Initializing pH Sensor Component: " + m_componentName);
     
-    if (!applyConfig(config)) {
+    // Out-of-range stored values fall back to their defaults instead of reaching the ADC code
+    JsonDocument configuration;
+    configuration.set(config);
+    size_t repaired = 0;
+    if (!repairConfiguration(configuration, getDefaultSchema(), repaired)) {
+        log(Logger::ERROR, "Invalid pH sensor configuration: " + m_lastError);
+        return false;
+    }
+    
+    if (!applyConfig(configuration)) {
         log(Logger::ERROR, "Failed to apply pH sensor configuration");
         return false;
     }
@@ -95,67 +181,10 @@ ExecutionResult PHSensorComponent::execute() {
     
     setState(ComponentState::EXECUTING);
     
-    // Update sensor mode based on current state
+    // Advance the sampling cycle; it reschedules this component for its next step
+    samplingTask();
     updateSensorMode();
     
-    // Initialize sampling window if not active
-    if (!m_samplingActive) {
-        startSamplingWindow();
-    }
-    
-    // Take readings during the sampling window
-    if (m_samplingActive && !isSamplingWindowComplete()) {
-        // Ensure excitation voltage is stabilized before taking readings
-        if (isExcitationStabilized()) {
-            // Check if it's time for a new reading
-            if (currentTime - m_lastReadingMs >= m_readingIntervalMs) {
-                // Take raw voltage reading
-                float rawVoltage = readRawVoltage();
-                
-                if (rawVoltage >= 0) {
-                    // Add to sample buffer
-                    addReading(rawVoltage);
-                    m_totalReadings++;
-                    m_lastReadingMs = currentTime;
-                    
-                    log(Logger::DEBUG, "pH Sample " + String(m_lastReads.size()) + "/" + String(m_sampleSize) + 
-                        ": " + String(rawVoltage, 4) + "V");
-                } else {
-                    m_errorCount++;
-                    log(Logger::WARNING, "Failed to read pH sensor voltage");
-                }
-            }
-        } else {
-            log(Logger::DEBUG, "Waiting for excitation voltage to stabilize...");
-        }
-    }
-    
-    // Process samples when window is complete
-    if (m_samplingActive && isSamplingWindowComplete()) {
-        endSamplingWindow();
-        
-        // Remove outliers from sample set
-        removeOutliers();
-        
-        // Calculate final averaged voltage with outlier removal
-        m_currentVolts = calculateWeightedAverageWithOutlierRemoval();
-        
-        // Get temperature for compensation
-        m_currentTemp = getTemperatureReading();
-        
-        // Calculate pH with temperature compensation
-        m_currentPH = convertVoltageToPH(m_currentVolts, m_currentTemp);
-        
-        // Update statistics
-        if (m_currentPH >= 0) {
-            m_minRecordedPH = min(m_minRecordedPH, m_currentPH);
-            m_maxRecordedPH = max(m_maxRecordedPH, m_currentPH);
-        }
-        
-        log(Logger::INFO, "Sampling window complete: " + String(m_lastReads.size()) + " samples, " + 
-            String(m_outliersRemoved) + " outliers removed, pH = " + String(m_currentPH, 2));
-    }
-    
     // Prepare output data
     JsonDocument data;
     data["timestamp"] = currentTime;
@@ -200,10 +229,6 @@ ExecutionResult PHSensorComponent::execute() {
     
     data["success"] = true;
     
-    // Calculate next execution time based on sampling window state
-    uint32_t nextExecutionTime = calculateNextExecutionTime();
-    setNextExecutionMs(nextExecutionTime);
-    
     // CRITICAL: Update execution statistics
     updateExecutionStats();
     
@@ -238,6 +263,7 @@ JsonDocument PHSensorComponent::getCurrentConfig() const {
     config["time_period_for_sampling"] = m_timePeriodForSampling;
     config["outlier_threshold"] = m_outlierThreshold;
     config["temperature_source_id"] = m_temperatureSourceId;
+    config["temperature_max_age_ms"] = m_temperatureMaxAgeMs;
     config["excite_voltage_component_id"] = m_exciteVoltageComponentId;
     config["excite_stabilize_ms"] = m_exciteStabilizeMs;
     
@@ -265,9 +291,14 @@ bool PHSensorComponent::applyConfig(const JsonDocument& config) {
     m_timePeriodForSampling = config["time_period_for_sampling"] | m_timePeriodForSampling;
     m_outlierThreshold = config["outlier_threshold"] | m_outlierThreshold;
     m_temperatureSourceId = config["temperature_source_id"] | m_temperatureSourceId;
+    m_temperatureMaxAgeMs = config["temperature_max_age_ms"] | m_temperatureMaxAgeMs;
     m_exciteVoltageComponentId = config["excite_voltage_component_id"] | m_exciteVoltageComponentId;
     m_exciteStabilizeMs = config["excite_stabilize_ms"] | m_exciteStabilizeMs;
     
+    // Temperature compensation reads the source at the end of each sampling window
+    clearDependencies();
+    declareDependency(m_temperatureSourceId, m_temperatureMaxAgeMs);
+    
     // Validate sample size
     if (m_sampleSize < 1) m_sampleSize = 1;
     if (m_sampleSize > 100) m_sampleSize = 100;
@@ -395,27 +426,28 @@ ActionResult PHSensorComponent::performAction(const String& actionName, const Js
 
 JsonDocument PHSensorComponent::getCoreData() const {
     JsonDocument coreData;
+    JsonDocument lastData = getLastExecutionData();
     
     // For pH sensors, core data is pH value, temperature, and success status
-    if (!m_lastData.isNull() && m_lastData.size() > 0) {
+    if (!lastData.isNull() && lastData.size() > 0) {
         // Extract only the essential sensor values
-        if (!m_lastData["current ph"].isNull()) {
-            coreData["ph"] = m_lastData["current ph"];
+        if (!lastData["current ph"].isNull()) {
+            coreData["ph"] = lastData["current ph"];
         }
-        if (!m_lastData["current temp"].isNull()) {
-            coreData["temperature"] = m_lastData["current temp"];
+        if (!lastData["current temp"].isNull()) {
+            coreData["temperature"] = lastData["current temp"];
         }
-        if (!m_lastData["current volts"].isNull()) {
-            coreData["voltage"] = m_lastData["current volts"];
+        if (!lastData["current volts"].isNull()) {
+            coreData["voltage"] = lastData["current volts"];
         }
-        if (!m_lastData["success"].isNull()) {
-            coreData["success"] = m_lastData["success"];
+        if (!lastData["success"].isNull()) {
+            coreData["success"] = lastData["success"];
         }
-        if (!m_lastData["timestamp"].isNull()) {
-            coreData["timestamp"] = m_lastData["timestamp"];
+        if (!lastData["timestamp"].isNull()) {
+            coreData["timestamp"] = lastData["timestamp"];
         }
-        if (!m_lastData["is calibrated"].isNull()) {
-            coreData["calibrated"] = m_lastData["is calibrated"];
+        if (!lastData["is calibrated"].isNull()) {
+            coreData["calibrated"] = lastData["is calibrated"];
         }
         
         log(Logger::DEBUG, String("[CORE-DATA] PHSensor ") + m_componentId + " returning " + 
@@ -627,10 +659,11 @@ float PHSensorComponent::getTemperatureReading() {
     if (m_temperatureSourceId.length() > 0 && m_orchestrator) {
         BaseComponent* tempComponent = getTemperatureComponent();
         if (tempComponent) {
-            // Try to get temperature from component
-            JsonDocument tempData;
-            // This would need to be implemented based on your temperature component's interface
-            // For now, return default
+            JsonDocument tempData = tempComponent->getLastExecutionData();
+            JsonVariantConst temperature = tempData["temperature"];
+            if (temperature.is<float>()) {
+                return temperature.as<float>();
+            }
         }
     }
     
@@ -726,11 +759,7 @@ float PHSensorComponent::interpolatePH(float voltage) const {
 }
 
 BaseComponent* PHSensorComponent::getTemperatureComponent() {
-    if (m_orchestrator && m_temperatureSourceId.length() > 0) {
-        // Implementation would depend on your orchestrator's component lookup method
-        // return m_orchestrator->getComponent(m_temperatureSourceId);
-    }
-    return nullptr;
+    return consumeDependency(m_temperatureSourceId);
 }
 
 bool PHSensorComponent::controlExcitationVoltage(bool enable) {
@@ -960,22 +989,78 @@ bool PHSensorComponent::isSamplingWindowComplete() const {
     return timeExpired || bufferFull;
 }
 
-uint32_t PHSensorComponent::calculateNextExecutionTime() const {
-    uint32_t currentTime = millis();
+TaskStep PHSensorComponent::samplingTask() {
+    TASK_BEGIN();
     
-    if (m_samplingActive) {
-        // During sampling: check frequently for new readings
-        return currentTime + min(m_readingIntervalMs, 500U);  // At least every 500ms
-    } else {
-        // After sampling window completes: wait for end window + 100ms resource allocation
-        // Then start next sampling cycle
-        uint32_t nextSamplingStart = m_samplingEndMs + 100;  // 100ms resource allocation buffer
+    while (true) {
+        startSamplingWindow();
         
-        // If we're past the buffer time, start immediately
-        if (currentTime >= nextSamplingStart) {
-            return currentTime + 100;  // Small delay to prevent tight loop
-        } else {
-            return nextSamplingStart;
+        // Excitation settles on a timer, so sleep through it instead of polling
+        if (m_exciteVoltageComponentId.length() > 0) {
+            AWAIT_DELAY(m_exciteStabilizeMs);
+        }
+        
+        while (!isSamplingWindowComplete()) {
+            if (isExcitationStabilized()) {
+                takeSample();
+            } else {
+                log(Logger::DEBUG, "pH excitation voltage not available - skipping sample");
+            }
+            
+            // Next reading, but never past the end of the window
+            AWAIT_DELAY(min(m_readingIntervalMs, msUntil(m_samplingEndMs)));
         }
+        
+        completeSamplingWindow();
+        
+        // Next window after the planned end plus a 100ms resource allocation buffer
+        AWAIT_DELAY(msUntil(m_samplingEndMs + 100));
     }
-}
\ No newline at end of file
+    
+    TASK_END();
+}
+
+void PHSensorComponent::takeSample() {
+    float rawVoltage = readRawVoltage();
+    
+    if (rawVoltage >= 0) {
+        addReading(rawVoltage);
+        m_totalReadings++;
+        m_lastReadingMs = millis();
+        
+        log(Logger::DEBUG, "pH Sample " + String(m_lastReads.size()) + "/" + String(m_sampleSize) + 
+            ": " + String(rawVoltage, 4) + "V");
+    } else {
+        m_errorCount++;
+        log(Logger::WARNING, "Failed to read pH sensor voltage");
+    }
+}
+
+void PHSensorComponent::completeSamplingWindow() {
+    endSamplingWindow();
+    
+    // Remove outliers from sample set
+    removeOutliers();
+    
+    // Calculate final averaged voltage with outlier removal
+    m_currentVolts = calculateWeightedAverageWithOutlierRemoval();
+    
+    // Get temperature for compensation
+    m_currentTemp = getTemperatureReading();
+    
+    // Calculate pH with temperature compensation
+    m_currentPH = convertVoltageToPH(m_currentVolts, m_currentTemp);
+    
+    // Update statistics
+    if (m_currentPH >= 0) {
+        m_minRecordedPH = min(m_minRecordedPH, m_currentPH);
+        m_maxRecordedPH = max(m_maxRecordedPH, m_currentPH);
+    }
+    
+    log(Logger::INFO, "Sampling window complete: " + String(m_lastReads.size()) + " samples, " + 
+        String(m_outliersRemoved) + " outliers removed, pH = " + String(m_currentPH, 2));
+}
+
+REGISTER_COMPONENT_TYPE(PHSensorComponent, "PHSensor", nullptr)
+
+#endif // COMPONENT_PH_SENSOR
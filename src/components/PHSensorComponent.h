@@ -179,6 +179,7 @@ private:
     uint32_t m_timePeriodForSampling = 10000;   // Sampling window duration (10 seconds default)
     float m_outlierThreshold = 2.0f;            // Standard deviations for outlier detection
     String m_temperatureSourceId = "";          // Component ID for temperature readings
+    uint32_t m_temperatureMaxAgeMs = 30000;     // Older temperature data triggers an on-demand read
     String m_exciteVoltageComponentId = "";     // Component ID for excitation voltage control
     uint32_t m_exciteStabilizeMs = 500;         // Time to wait after excitation on (500ms)
     
@@ -224,7 +225,9 @@ private:
     void startSamplingWindow();
     void endSamplingWindow();
     bool isSamplingWindowComplete() const;
-    uint32_t calculateNextExecutionTime() const;
+    TaskStep samplingTask();
+    void takeSample();
+    void completeSamplingWindow();
     bool controlExcitationVoltage(bool enable);
     bool isExcitationStabilized() const;
     void updateSensorMode();
@@ -235,6 +238,6 @@ private:
     void logCalibrationStatus();
     bool validateCalibrationPoints() const;
     float interpolatePH(float voltage) const;
-    BaseComponent* getTemperatureComponent();
+    BaseComponent* getTemperatureComponent();   // Temperature producer, refreshed if stale
     BaseComponent* getExciteVoltageComponent();
 };
\ No newline at end of file
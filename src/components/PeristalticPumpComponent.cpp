@@ -1,4 +1,15 @@
 #include "PeristalticPumpComponent.h"
+#include "../core/ComponentRegistry.h"
+#include "../utils/FlashSafeTimer.h"
+#include "../utils/EventJournal.h"
+#include "../core/ResourceGovernor.h"
+
+#if COMPONENT_PERISTALTIC_PUMP
+
+// Out-of-line definitions for ODR-used constants
+const uint32_t PeristalticPumpComponent::SIGNAL_PUMP_CHANGED;
+const uint32_t PeristalticPumpComponent::IDLE_REFRESH_MS;
+const uint32_t PeristalticPumpComponent::PUMPING_REFRESH_MS;
 
 PeristalticPumpComponent::PeristalticPumpComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator)
     : BaseComponent(id, "PeristalticPump", name, storage, orchestrator) {
@@ -229,8 +240,8 @@ ExecutionResult PeristalticPumpComponent::execute() {
     
     setState(ComponentState::EXECUTING);
     
-    // Update pump state (check timeouts, stop if needed)
-    updatePumpState();
+    // Advance the pump task (stops a finished dose, reschedules for the next event)
+    pumpTask();
     
     // Prepare output data
     JsonDocument data;
@@ -243,6 +254,7 @@ ExecutionResult PeristalticPumpComponent::execute() {
     data["total_runtime_ms"] = m_totalPumpTimeMs;
     data["dose_count"] = m_doseCount;
     data["flow_rate_ml_s"] = m_mlsPerSec;
+    data["actuation_locked"] = m_actuationLocked;
     
     // State machine output fields
     data["dispense_mode"] = static_cast<int>(m_dispenseMode);
@@ -274,13 +286,6 @@ ExecutionResult PeristalticPumpComponent::execute() {
         data["dose_progress"] = 0;
     }
     
-    // Update execution interval based on pump state
-    if (m_isPumping) {
-        setNextExecutionMs(millis() + 1000);  // Check every second when pumping
-    } else {
-        setNextExecutionMs(millis() + 30000); // Check every 30 seconds when idle
-    }
-    
     result.success = true;
     result.data = data;
     result.executionTimeMs = millis() - startTime;
@@ -289,11 +294,78 @@ ExecutionResult PeristalticPumpComponent::execute() {
     return result;
 }
 
+void PeristalticPumpComponent::getWarmState(JsonObject state) const {
+    state["v"] = m_totalVolumePumped;
+    state["t"] = m_totalPumpTimeMs;
+    state["n"] = m_doseCount;
+    
+    if (m_isPumping) {
+        // Volume delivered so far in the running operation (not yet in the totals)
+        state["r"] = ((millis() - m_pumpStartTime) / 1000.0) * m_mlsPerSec;
+    }
+}
+
+void PeristalticPumpComponent::restoreWarmState(JsonObjectConst state) {
+    m_totalVolumePumped = state["v"] | m_totalVolumePumped;
+    m_totalPumpTimeMs = state["t"] | m_totalPumpTimeMs;
+    m_doseCount = state["n"] | m_doseCount;
+    
+    // Never resume pumping after a reset - the relay was forced off in initializePump()
+    if (!state["r"].isNull()) {
+        float partialMl = state["r"];
+        m_totalVolumePumped += partialMl;
+        log(Logger::WARNING, String("Pump operation interrupted by restart after ~") + partialMl +
+                             "ml - relay left off");
+    }
+    
+    log(Logger::INFO, String("Restored pump counters: ") + m_totalVolumePumped + "ml total, " +
+                      m_doseCount + " doses");
+}
+
+TaskStep PeristalticPumpComponent::pumpTask() {
+    TASK_BEGIN();
+    
+    while (true) {
+        if (!m_isPumping) {
+            // Idle until an action starts the pump
+            AWAIT_SIGNAL(SIGNAL_PUMP_CHANGED, IDLE_REFRESH_MS);
+            continue;
+        }
+        
+        // Wake exactly when the dose or the safety limit ends; stop() wakes it early
+        AWAIT_SIGNAL(SIGNAL_PUMP_CHANGED, min(pumpRemainingMs(), PUMPING_REFRESH_MS));
+        updatePumpState();
+    }
+    
+    TASK_END();
+}
+
+uint32_t PeristalticPumpComponent::pumpRemainingMs() const {
+    if (!m_isPumping) return 0;
+    
+    uint32_t elapsed = millis() - m_pumpStartTime;
+    uint32_t limit = m_maxRuntimeMs;
+    if (m_dispenseMode == DispenseMode::DOSE && m_targetDurationMs > 0 && m_targetDurationMs < limit) {
+        limit = m_targetDurationMs;
+    }
+    return elapsed < limit ? limit - elapsed : 0;
+}
+
+uint32_t PeristalticPumpComponent::relayOnMs() const {
+    uint32_t elapsed = millis() - m_pumpStartTime;
+    
+    // The hardware cut-off opened the relay on time even if this task ran late
+    if (m_relayDeadline >= 0 && elapsed > m_relayLimitMs) {
+        return m_relayLimitMs;
+    }
+    return elapsed;
+}
+
 void PeristalticPumpComponent::updatePumpState() {
     if (!m_isPumping) return;
     
     uint32_t currentTime = millis();
-    uint32_t elapsed = currentTime - m_pumpStartTime;
+    uint32_t elapsed = relayOnMs();
     
     // Update current volume in real-time
     m_currentVolume = (elapsed / 1000.0) * m_mlsPerSec;
@@ -320,11 +392,17 @@ void PeristalticPumpComponent::updatePumpState() {
         m_dispenseEndMs = currentTime;
         
         log(Logger::INFO, String("Dose complete: ") + m_currentVolume + "ml of " + m_liquidName + " dispensed");
+        EventJournal::record(EVENT_DOSE, Logger::INFO, m_componentId, m_liquidName, 0, m_currentVolume);
         stopPump();
     }
 }
 
 bool PeristalticPumpComponent::dose(float volume_ml, float flow_rate) {
+    if (m_actuationLocked) {
+        log(Logger::WARNING, "Cannot dose - actuators locked by resource pressure");
+        return false;
+    }
+    
     if (m_isPumping) {
         log(Logger::WARNING, "Cannot dose - pump already running");
         return false;
@@ -355,12 +433,18 @@ bool PeristalticPumpComponent::dose(float volume_ml, float flow_rate) {
     m_continuousMode = false;
     
     startPump();
+    signal(SIGNAL_PUMP_CHANGED);
     
     log(Logger::INFO, String("Dosing ") + volume_ml + "ml of " + m_liquidName + " at " + rate + "ml/s (" + m_targetDurationMs + "ms)");
     return true;
 }
 
 bool PeristalticPumpComponent::startContinuous() {
+    if (m_actuationLocked) {
+        log(Logger::WARNING, "Cannot start - actuators locked by resource pressure");
+        return false;
+    }
+    
     if (m_isPumping) {
         log(Logger::WARNING, "Pump already running");
         return false;
@@ -379,6 +463,7 @@ bool PeristalticPumpComponent::startContinuous() {
     m_currentDoseVolume = 0;
     
     startPump();
+    signal(SIGNAL_PUMP_CHANGED);
     
     log(Logger::INFO, "Starting continuous pumping of " + m_liquidName);
     return true;
@@ -391,7 +476,7 @@ bool PeristalticPumpComponent::stop() {
     }
     
     // Calculate final volume and update state machine
-    uint32_t elapsed = millis() - m_pumpStartTime;
+    uint32_t elapsed = relayOnMs();
     float actualVolume = (elapsed / 1000.0) * m_mlsPerSec;
     
     // Update current volume in state machine
@@ -413,26 +498,58 @@ bool PeristalticPumpComponent::stop() {
     m_currentDoseVolume = 0;
     
     stopPump();
+    signal(SIGNAL_PUMP_CHANGED);
     log(Logger::INFO, "Pump stopped - dispensed " + String(actualVolume, 2) + "ml of " + m_liquidName);
     return true;
 }
 
+void PeristalticPumpComponent::onResourceLevel(uint8_t level) {
+    bool locked = level >= RESOURCE_PROTECT;
+    if (locked == m_actuationLocked) {
+        return;
+    }
+    m_actuationLocked = locked;
+    
+    if (locked && m_isPumping && m_dispenseMode != DispenseMode::DOSE) {
+        // Open-ended runs have no dose end to wait for
+        log(Logger::WARNING, "Resource pressure - stopping continuous pumping");
+        stop();
+    }
+    log(locked ? Logger::WARNING : Logger::INFO,
+        locked ? "Actuation locked by resource pressure" : "Actuation unlocked");
+}
+
 void PeristalticPumpComponent::startPump() {
     setPumpRelay(true);
     m_isPumping = true;
     m_pumpStartTime = millis();
     
+    // Open the relay from a timer interrupt so a flash write stalling this task cannot
+    // stretch the dose; the task still wakes at the same time to do the bookkeeping
+    m_relayLimitMs = m_maxRuntimeMs;
+    if (m_dispenseMode == DispenseMode::DOSE && m_targetDurationMs > 0 && m_targetDurationMs < m_relayLimitMs) {
+        m_relayLimitMs = m_targetDurationMs;
+    }
+    m_relayDeadline = -1;
+    if (m_relayLimitMs <= UINT32_MAX / 1000) {
+        m_relayDeadline = FlashSafeTimer::armGpio(m_pumpPin, m_relayInverted, m_relayLimitMs * 1000,
+                                                  this, SIGNAL_PUMP_CHANGED);
+    }
+    
     log(Logger::DEBUG, "Pump started");
 }
 
 void PeristalticPumpComponent::stopPump() {
+    uint32_t runtimeMs = relayOnMs();
     setPumpRelay(false);
+    FlashSafeTimer::cancel(m_relayDeadline);
+    m_relayDeadline = -1;
     m_isPumping = false;
     m_continuousMode = false;
     
     // Update runtime statistics
     if (m_pumpStartTime > 0) {
-        m_totalPumpTimeMs += millis() - m_pumpStartTime;
+        m_totalPumpTimeMs += runtimeMs;
     }
     
     m_pumpStartTime = 0;
@@ -510,6 +627,13 @@ std::vector<ComponentAction> PeristalticPumpComponent::getSupportedActions() con
     timeoutParam.description = "Maximum time to wait for completion (seconds)";
     doseAction.parameters.push_back(timeoutParam);
     
+    ActionParameter waitParam;
+    waitParam.name = "wait";
+    waitParam.type = ActionParameterType::BOOLEAN;
+    waitParam.required = false;
+    waitParam.description = "Wait for the dose to finish (default true); false returns once it started";
+    doseAction.parameters.push_back(waitParam);
+    
     actions.push_back(doseAction);
     
     // Start Continuous Action
@@ -550,20 +674,31 @@ ActionResult PeristalticPumpComponent::performAction(const String& actionName, c
         float volume = parameters["volume_ml"].as<float>();
         float flowRate = parameters["flow_rate"] | 0.0f;  // Use default if not provided
         uint32_t timeoutS = parameters["timeout_s"] | 60;
+        bool wait = parameters["wait"] | true;
         
         log(Logger::INFO, String("Starting dose: ") + volume + "ml" +
                          (flowRate > 0 ? String(", flow: ") + flowRate + "ml/s" : "") +
                          ", timeout: " + timeoutS + "s");
         
         bool started = dose(volume, flowRate);
-        if (started) {
+        if (started && !wait) {
+            // The relay cut-off ends the dose; completion is recorded as a "dose" event
+            result.success = true;
+            result.message = String("Dose started: ") + volume + "ml";
+            result.data["volume_ml"] = volume;
+            result.data["expected_duration_ms"] = m_targetDurationMs;
+        } else if (started) {
             // Wait for dose completion or timeout
             uint32_t startTime = millis();
             uint32_t timeoutMs = timeoutS * 1000;
             
+            // The pump task stops the dose on time; only step in if the scheduler
+            // is not running it (execution loop paused)
             while (m_isPumping && (millis() - startTime) < timeoutMs) {
                 delay(100);  // Check every 100ms
-                updatePumpState();  // Update internal state
+                if (m_isPumping && (int32_t)(millis() - m_dispenseEndMs) > 200) {
+                    updatePumpState();
+                }
             }
             
             if (m_isPumping) {
@@ -632,4 +767,8 @@ ActionResult PeristalticPumpComponent::performAction(const String& actionName, c
     }
     
     return result;
-}
\ No newline at end of file
+}
+
+REGISTER_COMPONENT_TYPE(PeristalticPumpComponent, "PeristalticPump", "Pump")
+
+#endif // COMPONENT_PERISTALTIC_PUMP
@@ -40,6 +40,15 @@ public:
     bool initialize(const JsonDocument& config) override;
     ExecutionResult execute() override;
     void cleanup() override;
+    
+    // Warm-restart state: lifetime counters and any operation cut short by a reset
+    void getWarmState(JsonObject state) const override;
+    void restoreWarmState(JsonObjectConst state) override;
+    
+    // Resource pressure: keeps its schedule; at the protect level continuous runs
+    // stop and new runs are refused (a dose in progress ends on its relay cut-off)
+    bool isTimeCritical() const override { return true; }
+    void onResourceLevel(uint8_t level) override;
 
 protected:
     // === Configuration Management (BaseComponent virtual methods) ===
@@ -152,6 +161,11 @@ public:
     float getLiquidConcentration() const { return m_liquidConcentration; }
 
 private:
+    // Task signal raised by dose(), startContinuous() and stop()
+    static const uint32_t SIGNAL_PUMP_CHANGED = 1UL << 0;
+    static const uint32_t IDLE_REFRESH_MS = 30000;     // Published state refresh while idle
+    static const uint32_t PUMPING_REFRESH_MS = 1000;   // Progress refresh while pumping
+    
     // === Persisted Configuration Parameters ===
     uint8_t m_pinNo = 26;                    // GPIO pin number for pump control
     float m_mlsPerSec = 40.0;                // Flow rate in milliliters per second
@@ -170,8 +184,11 @@ private:
     
     // === Runtime State Tracking ===
     bool m_isPumping = false;                // Pump actively running
+    bool m_actuationLocked = false;          // Resource governor at protect level
     uint32_t m_pumpStartTime = 0;            // Current pump cycle start
     uint32_t m_targetDurationMs = 0;         // Target duration for current operation
+    int32_t m_relayDeadline = -1;            // FlashSafeTimer handle of the hardware relay cut-off
+    uint32_t m_relayLimitMs = 0;             // Run time after which the cut-off opens the relay
     float m_currentDoseVolume = 0;           // Current dose target volume
     
     // === Lifetime Statistics ===
@@ -189,6 +206,9 @@ private:
     bool applyConfiguration(const JsonDocument& config);
     bool initializePump();
     void updatePumpState();
+    TaskStep pumpTask();
+    uint32_t pumpRemainingMs() const;
+    uint32_t relayOnMs() const;
     uint32_t calculatePumpTime(float volume_ml, float flow_rate);
     void startPump();
     void stopPump();
@@ -0,0 +1,666 @@
+#include "RemoteProxyComponent.h"
+#include "../core/ComponentRegistry.h"
+#include "../core/Orchestrator.h"
+#include "../core/ResourceGovernor.h"
+#include <algorithm>
+#include <new>
+
+#if COMPONENT_REMOTE_PROXY
+
+namespace {
+const char* const MIRROR_TYPE = "RemoteMirror";
+const uint32_t STALE_REPUBLISH_MS = 3600000;   // A stale mirror still reports its growing age hourly
+}
+
+// Out-of-line definitions for ODR-used constants
+const size_t RemoteProxyComponent::MAX_MIRRORS;
+
+// === RemoteMirrorComponent ===
+
+RemoteMirrorComponent::RemoteMirrorComponent(const String& id, const String& name, ConfigStorage& storage,
+                                             Orchestrator* orchestrator, const String& proxyId,
+                                             const String& remoteId, const String& remoteType)
+    : BaseComponent(id, MIRROR_TYPE, name, storage, orchestrator)
+    , m_proxyId(proxyId)
+    , m_remoteId(remoteId)
+    , m_remoteType(remoteType) {
+}
+
+JsonDocument RemoteMirrorComponent::getDefaultSchema() const {
+    JsonDocument schema;
+    schema["type"] = "object";
+    schema["title"] = "Remote Mirror (configured through its RemoteProxy)";
+    schema["properties"].to<JsonObject>();
+    return schema;
+}
+
+bool RemoteMirrorComponent::initialize(const JsonDocument& config) {
+    // Nothing to load or persist: the proxy recreates mirrors after a reboot
+    setState(ComponentState::INITIALIZING);
+
+    // Ordered after the proxy, so a delivery is published in the same loop pass
+    declareDependency(m_proxyId, 0);
+    setNextExecutionMs(millis() + STALE_REPUBLISH_MS);
+
+    setState(ComponentState::READY);
+    log(Logger::INFO, "Mirroring " + m_remoteType + " " + m_remoteId + " via " + m_proxyId);
+    return true;
+}
+
+JsonDocument RemoteMirrorComponent::getCurrentConfig() const {
+    JsonDocument config;
+    config["proxy"] = m_proxyId;
+    config["remote_id"] = m_remoteId;
+    config["remote_type"] = m_remoteType;
+    return config;
+}
+
+bool RemoteMirrorComponent::applyConfig(const JsonDocument& config) {
+    log(Logger::WARNING, "Mirrors are configured through their proxy " + m_proxyId);
+    return false;
+}
+
+bool RemoteMirrorComponent::deliver(JsonVariantConst data, uint32_t remoteSeq, uint32_t remoteAgeMs) {
+    // The peer's timestamp is its own millis(); the mirror stamps its samples locally
+    JsonDocument incoming;
+    JsonObject values = incoming.to<JsonObject>();
+    for (JsonPairConst field : data.as<JsonObjectConst>()) {
+        if (strcmp(field.key().c_str(), "timestamp") != 0) {
+            values[field.key().c_str()] = field.value();
+        }
+    }
+
+    bool changed = m_stale || m_receivedUs == 0;
+    if (!changed) {
+        if (m_values.isNull() && m_compactValues) {
+            changed = incoming.as<JsonVariantConst>() != publishedValues().as<JsonVariantConst>();
+        } else {
+            changed = incoming.as<JsonVariantConst>() != m_values.as<JsonVariantConst>();
+        }
+    }
+    MonoTimeUs nowUs = TimeUtils::monoNowUs();
+    m_remoteSeq = remoteSeq;
+    m_remoteAgeMs = remoteAgeMs;
+    m_receivedUs = nowUs;
+    m_stale = false;
+    m_updates++;
+
+    if (changed) {
+        m_values = incoming;
+        m_valuesPending = true;
+        setNextExecutionUs(nowUs);
+    } else {
+        // Same values: only the stale deadline moves
+        setNextExecutionUs(nowUs + (MonoTimeUs)m_staleAfterMs * 1000);
+    }
+    return changed;
+}
+
+void RemoteMirrorComponent::onResourceLevel(uint8_t level) {
+    m_compactValues = level >= RESOURCE_SHED;
+    if (m_compactValues && !m_valuesPending) {
+        m_values.clear();
+    } else if (!m_compactValues && m_values.isNull() && m_receivedUs != 0) {
+        m_values = publishedValues();
+    }
+}
+
+JsonDocument RemoteMirrorComponent::publishedValues() const {
+    JsonDocument values = getLastExecutionData();
+    values.remove("timestamp");
+    values.remove("remote_seq");
+    values.remove("remote_age_ms");
+    values.remove("stale");
+    return values;
+}
+
+void RemoteMirrorComponent::detach() {
+    m_staleAfterMs = 0;
+    setNextExecutionUs(TimeUtils::monoNowUs());
+}
+
+uint32_t RemoteMirrorComponent::getRemoteAgeMs(MonoTimeUs nowUs) const {
+    uint64_t ageMs = (uint64_t)m_remoteAgeMs + (uint64_t)(nowUs - m_receivedUs) / 1000;
+    return ageMs > UINT32_MAX ? UINT32_MAX : (uint32_t)ageMs;
+}
+
+JsonDocument RemoteMirrorComponent::getFreshness() const {
+    MonoTimeUs nowUs = TimeUtils::monoNowUs();
+    JsonDocument freshness;
+    freshness["remote_id"] = m_remoteId;
+    freshness["remote_type"] = m_remoteType;
+    freshness["remote_seq"] = m_remoteSeq;
+    freshness["remote_age_ms"] = getRemoteAgeMs(nowUs);
+    freshness["stale"] = m_stale;
+    freshness["updates"] = m_updates;
+    return freshness;
+}
+
+ExecutionResult RemoteMirrorComponent::execute() {
+    ExecutionResult result;
+    uint32_t startTime = millis();
+
+    setState(ComponentState::EXECUTING);
+
+    MonoTimeUs nowUs = TimeUtils::monoNowUs();
+    MonoTimeUs staleAtUs = m_receivedUs + (MonoTimeUs)m_staleAfterMs * 1000;
+    if (!m_stale && nowUs >= staleAtUs) {
+        m_stale = true;
+        log(Logger::WARNING, "No update from " + m_proxyId + " for " + (uint32_t)((nowUs - m_receivedUs) / 1000) +
+                             "ms - data is stale");
+    }
+
+    JsonDocument data;
+    if (m_values.isNull() && m_compactValues) {
+        data = publishedValues();
+    } else {
+        data.set(m_values);
+    }
+    data["timestamp"] = millis();
+    data["remote_seq"] = m_remoteSeq;
+    data["remote_age_ms"] = getRemoteAgeMs(nowUs);
+    data["stale"] = m_stale;
+
+    updateExecutionStats();
+
+    String dataStr;
+    serializeJson(data, dataStr);
+    storeExecutionDataString(dataStr);
+    m_valuesPending = false;
+    if (m_compactValues) {
+        m_values.clear();
+    }
+
+    setNextExecutionUs(m_stale ? nowUs + (MonoTimeUs)STALE_REPUBLISH_MS * 1000 : staleAtUs);
+
+    result.success = true;
+    result.data = data;
+    result.executionTimeMs = millis() - startTime;
+
+    setState(ComponentState::READY);
+    return result;
+}
+
+void RemoteMirrorComponent::cleanup() {
+}
+
+std::vector<ComponentAction> RemoteMirrorComponent::getSupportedActions() const {
+    std::vector<ComponentAction> actions;
+
+    ComponentAction statusAction;
+    statusAction.name = "status";
+    statusAction.description = "Get the freshness of the mirrored values";
+    statusAction.timeoutMs = 1000;
+    statusAction.requiresReady = false;
+    actions.push_back(statusAction);
+
+    return actions;
+}
+
+ActionResult RemoteMirrorComponent::performAction(const String& actionName, const JsonDocument& /*parameters*/) {
+    ActionResult result;
+    result.actionName = actionName;
+    result.success = false;
+
+    if (actionName == "status") {
+        result.success = true;
+        result.message = "Mirror of " + m_remoteId + " via " + m_proxyId;
+        result.data = getFreshness();
+    } else {
+        // Actions of the remote component run on its own node
+        result.message = "Unknown action: " + actionName;
+    }
+
+    return result;
+}
+
+// === RemoteProxyComponent ===
+
+RemoteProxyComponent::RemoteProxyComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator)
+    : BaseComponent(id, "RemoteProxy", name, storage, orchestrator) {
+    log(Logger::DEBUG, "RemoteProxyComponent created");
+}
+
+RemoteProxyComponent::~RemoteProxyComponent() {
+    cleanup();
+}
+
+JsonDocument RemoteProxyComponent::getDefaultSchema() const {
+    JsonDocument schema;
+    schema["type"] = "object";
+    schema["title"] = "Remote Proxy Configuration";
+
+    JsonObject properties = schema["properties"].to<JsonObject>();
+
+    JsonObject hostProp = properties["peer_host"].to<JsonObject>();
+    hostProp["type"] = "string";
+    hostProp["default"] = "";
+    hostProp["maxLength"] = 64;
+    hostProp["description"] = "IP address or hostname of the node to mirror";
+
+    JsonObject portProp = properties["peer_port"].to<JsonObject>();
+    portProp["type"] = "integer";
+    portProp["minimum"] = 1;
+    portProp["maximum"] = 65535;
+    portProp["default"] = 80;
+    portProp["description"] = "HTTP port of the peer's web server";
+
+    JsonObject componentsProp = properties["components"].to<JsonObject>();
+    componentsProp["type"] = "array";
+    componentsProp["default"].to<JsonArray>();
+    componentsProp["description"] = "Remote component ids to mirror (empty = every component with data)";
+
+    JsonObject fieldsProp = properties["fields"].to<JsonObject>();
+    fieldsProp["type"] = "array";
+    fieldsProp["default"].to<JsonArray>();
+    fieldsProp["description"] = "Output fields to mirror from each component (empty = all)";
+
+    JsonObject prefixProp = properties["id_prefix"].to<JsonObject>();
+    prefixProp["type"] = "string";
+    prefixProp["default"] = "";
+    prefixProp["maxLength"] = 32;
+    prefixProp["description"] = "Prefix of local mirror ids (empty = \"<proxy id>.\")";
+
+    JsonObject pollProp = properties["poll_interval_ms"].to<JsonObject>();
+    pollProp["type"] = "integer";
+    pollProp["minimum"] = 500;
+    pollProp["maximum"] = 3600000;
+    pollProp["default"] = 5000;
+    pollProp["description"] = "Delta poll interval in milliseconds";
+
+    JsonObject timeoutProp = properties["timeout_ms"].to<JsonObject>();
+    timeoutProp["type"] = "integer";
+    timeoutProp["minimum"] = 200;
+    timeoutProp["maximum"] = 30000;
+    timeoutProp["default"] = 3000;
+    timeoutProp["description"] = "HTTP timeout per poll in milliseconds";
+
+    JsonObject staleProp = properties["stale_after_ms"].to<JsonObject>();
+    staleProp["type"] = "integer";
+    staleProp["minimum"] = 0;
+    staleProp["maximum"] = 86400000;
+    staleProp["default"] = 0;
+    staleProp["description"] = "Mark a mirror stale after this long without an update (0 = three poll intervals)";
+
+    JsonObject maxProp = properties["max_mirrors"].to<JsonObject>();
+    maxProp["type"] = "integer";
+    maxProp["minimum"] = 1;
+    maxProp["maximum"] = MAX_MIRRORS;
+    maxProp["default"] = 64;
+    maxProp["description"] = "Most remote components this proxy creates mirrors for";
+
+    return schema;
+}
+
+bool RemoteProxyComponent::initialize(const JsonDocument& config) {
+    log(Logger::INFO, "Initializing remote proxy component...");
+    setState(ComponentState::INITIALIZING);
+
+    if (!loadConfiguration(config)) {
+        setError("Failed to load configuration");
+        return false;
+    }
+
+    if (!applyConfig(getConfiguration())) {
+        setError("Failed to apply configuration");
+        return false;
+    }
+
+    // Full sync on the first pass
+    setNextExecutionMs(millis());
+
+    setState(ComponentState::READY);
+    log(Logger::INFO, "Remote proxy initialized - peer " + m_peerHost + ":" + m_peerPort + ", components [" +
+                      (m_componentList.isEmpty() ? String("all") : m_componentList) + "] every " +
+                      m_pollIntervalMs + "ms");
+    return true;
+}
+
+JsonDocument RemoteProxyComponent::getCurrentConfig() const {
+    JsonDocument config;
+
+    config["peer_host"] = m_peerHost;
+    config["peer_port"] = m_peerPort;
+    splitList(m_componentList, config["components"].to<JsonArray>());
+    splitList(m_fieldList, config["fields"].to<JsonArray>());
+    config["id_prefix"] = m_idPrefix == getId() + "." ? String() : m_idPrefix;
+    config["poll_interval_ms"] = m_pollIntervalMs;
+    config["timeout_ms"] = m_timeoutMs;
+    config["stale_after_ms"] = m_staleAfterMs;
+    config["max_mirrors"] = m_maxMirrors;
+
+    return config;
+}
+
+bool RemoteProxyComponent::applyConfig(const JsonDocument& config) {
+    // Partial updates keep the current value of missing keys
+    String peerHost = config["peer_host"] | m_peerHost.c_str();
+    uint16_t peerPort = config["peer_port"] | m_peerPort;
+    String componentList = config["components"].isNull() ? m_componentList : joinList(config["components"]);
+    String fieldList = config["fields"].isNull() ? m_fieldList : joinList(config["fields"]);
+    String idPrefix = config["id_prefix"].isNull() ? m_idPrefix : String(config["id_prefix"] | "");
+    if (idPrefix.isEmpty()) {
+        idPrefix = getId() + ".";
+    }
+
+    m_pollIntervalMs = config["poll_interval_ms"] | m_pollIntervalMs;
+    m_timeoutMs = config["timeout_ms"] | m_timeoutMs;
+    m_staleAfterMs = config["stale_after_ms"] | m_staleAfterMs;
+    m_maxMirrors = config["max_mirrors"] | m_maxMirrors;
+
+    if (m_pollIntervalMs < 500) m_pollIntervalMs = 500;
+    if (m_maxMirrors == 0 || m_maxMirrors > MAX_MIRRORS) m_maxMirrors = MAX_MIRRORS;
+
+    // A different peer or naming invalidates the mirrors and the sync position
+    if (peerHost != m_peerHost || peerPort != m_peerPort || idPrefix != m_idPrefix) {
+        detachMirrors();
+        m_since = 0;
+        m_peerBoot = 0;
+        m_peerNode = "";
+        m_connected = false;
+    } else if (componentList != m_componentList || fieldList != m_fieldList) {
+        // Same mirrors, new selection: fetch it in full
+        m_since = 0;
+    }
+    m_peerHost = peerHost;
+    m_peerPort = peerPort;
+    m_componentList = componentList;
+    m_fieldList = fieldList;
+    m_idPrefix = idPrefix;
+
+    for (const String& mirrorId : m_mirrorIds) {
+        RemoteMirrorComponent* mirror = findMirror(mirrorId);
+        if (mirror) mirror->setStaleAfterMs(getStaleAfterMs());
+    }
+    return true;
+}
+
+String RemoteProxyComponent::joinList(JsonVariantConst list) {
+    String joined;
+    for (JsonVariantConst item : list.as<JsonArrayConst>()) {
+        const char* value = item.as<const char*>();
+        if (!value || !*value) continue;
+        if (!joined.isEmpty()) joined += ",";
+        joined += value;
+    }
+    return joined;
+}
+
+void RemoteProxyComponent::splitList(const String& list, JsonArray out) {
+    int start = 0;
+    while (start < (int)list.length()) {
+        int end = list.indexOf(',', start);
+        if (end < 0) end = list.length();
+        out.add(list.substring(start, end));
+        start = end + 1;
+    }
+}
+
+uint32_t RemoteProxyComponent::getStaleAfterMs() const {
+    return m_staleAfterMs > 0 ? m_staleAfterMs : m_pollIntervalMs * 3;
+}
+
+String RemoteProxyComponent::buildUrl() const {
+    String url = "http://" + m_peerHost;
+    if (m_peerPort != 80) {
+        url += ":" + String(m_peerPort);
+    }
+    url += "/api/components/delta?since=" + String(m_since);
+    if (!m_componentList.isEmpty()) {
+        url += "&ids=" + m_componentList;
+    }
+    if (!m_fieldList.isEmpty()) {
+        url += "&fields=" + m_fieldList;
+    }
+    return url;
+}
+
+ExecutionResult RemoteProxyComponent::execute() {
+    ExecutionResult result;
+    uint32_t startTime = millis();
+
+    setState(ComponentState::EXECUTING);
+
+    uint32_t nextPollMs = millis() + m_pollIntervalMs;
+    bool ok = poll(nextPollMs);
+
+    JsonDocument data;
+    data["timestamp"] = millis();
+    data["peer"] = m_peerHost;
+    data["peer_node"] = m_peerNode;
+    data["connected"] = m_connected;
+    data["seq"] = m_since;
+    data["mirrors"] = m_mirrorIds.size();
+    data["changes"] = m_lastChanges;
+    data["response_bytes"] = m_lastResponseBytes;
+    data["poll_failures"] = m_pollFailures;
+    data["success"] = ok;
+
+    updateExecutionStats();
+
+    String dataStr;
+    serializeJson(data, dataStr);
+    storeExecutionDataString(dataStr);
+
+    if (m_resync) {
+        m_resync = false;
+        setNextExecutionMs(millis());
+    } else {
+        setNextExecutionMs(nextPollMs);
+    }
+
+    result.success = ok;
+    result.data = data;
+    result.executionTimeMs = millis() - startTime;
+
+    setState(ComponentState::READY);
+    return result;
+}
+
+bool RemoteProxyComponent::poll(uint32_t& nextPollMs) {
+    if (m_peerHost.isEmpty()) {
+        log(Logger::DEBUG, "No peer_host configured");
+        return false;
+    }
+
+    m_polls++;
+    JsonDocument response = fetchRemoteData(buildUrl(), m_timeoutMs);
+
+    if (!(response["success"] | false)) {
+        m_pollFailures++;
+        m_connected = false;
+        // Backoff or link down: wait for the shared HTTP client's retry time
+        if (response["shouldDefer"] | false) {
+            uint32_t nextRetryMs = response["nextRetryMs"] | 0;
+            if (nextRetryMs > nextPollMs) nextPollMs = nextRetryMs;
+        }
+        log(Logger::WARNING, String("Delta poll of ") + m_peerHost + " failed: " + (response["error"] | "unknown error"));
+        return false;
+    }
+
+    m_lastResponseBytes = measureJson(response);
+    m_bytesReceived += m_lastResponseBytes;
+    m_lastContactMs = millis();
+    m_connected = true;
+    m_peerNode = response["node"] | "";
+
+    uint32_t boot = response["boot"] | 0;
+    uint32_t seq = response["seq"] | 0;
+    if (m_since > 0 && (boot != m_peerBoot || seq < m_since)) {
+        // The peer restarted: its sequence numbers no longer relate to ours
+        log(Logger::INFO, "Peer " + m_peerHost + " restarted (boot " + String(boot, HEX) + ") - full resync");
+        m_since = 0;
+        m_peerBoot = boot;
+        m_resync = true;
+        m_resyncs++;
+        return true;
+    }
+    m_peerBoot = boot;
+
+    uint32_t changes = 0;
+    for (JsonPairConst entry : response["components"].as<JsonObjectConst>()) {
+        JsonObjectConst component = entry.value().as<JsonObjectConst>();
+        m_samplesReceived++;
+        RemoteMirrorComponent* mirror = findOrCreateMirror(entry.key().c_str(), component["type"] | "");
+        if (mirror && mirror->deliver(component["data"], component["seq"] | 0, component["age_ms"] | 0)) {
+            changes++;
+        }
+    }
+    m_lastChanges = changes;
+    m_changesPublished += changes;
+    m_since = seq;
+    return true;
+}
+
+RemoteMirrorComponent* RemoteProxyComponent::findMirror(const String& localId) const {
+    BaseComponent* component = m_orchestrator ? m_orchestrator->findComponent(localId) : nullptr;
+    if (!component || component->getType() != MIRROR_TYPE) {
+        return nullptr;
+    }
+    RemoteMirrorComponent* mirror = static_cast<RemoteMirrorComponent*>(component);
+    return mirror->getProxyId() == getId() ? mirror : nullptr;
+}
+
+RemoteMirrorComponent* RemoteProxyComponent::findOrCreateMirror(const String& remoteId, const String& remoteType) {
+    if (!m_orchestrator) {
+        return nullptr;
+    }
+
+    String localId = m_idPrefix + remoteId;
+    RemoteMirrorComponent* mirror = findMirror(localId);
+    if (mirror) {
+        // Detached by a reconfiguration that kept the id: adopt it again
+        if (std::find(m_mirrorIds.begin(), m_mirrorIds.end(), localId) == m_mirrorIds.end()) {
+            mirror->setStaleAfterMs(getStaleAfterMs());
+            m_mirrorIds.push_back(localId);
+        }
+        return mirror;
+    }
+    if (m_orchestrator->findComponent(localId)) {
+        m_mirrorsRefused++;
+        log(Logger::WARNING, "Cannot mirror " + remoteId + ": id " + localId + " is taken");
+        return nullptr;
+    }
+
+    // Forget mirrors deleted through the API before counting
+    m_mirrorIds.erase(std::remove_if(m_mirrorIds.begin(), m_mirrorIds.end(),
+        [this](const String& id) { return findMirror(id) == nullptr; }), m_mirrorIds.end());
+    if (m_mirrorIds.size() >= m_maxMirrors) {
+        m_mirrorsRefused++;
+        log(Logger::WARNING, "Cannot mirror " + remoteId + ": max_mirrors (" + m_maxMirrors + ") reached");
+        return nullptr;
+    }
+
+    mirror = new (std::nothrow) RemoteMirrorComponent(localId, remoteId + " @ " + m_peerHost, m_storage,
+                                                      m_orchestrator, getId(), remoteId, remoteType);
+    if (!mirror) {
+        return nullptr;
+    }
+    mirror->setStaleAfterMs(getStaleAfterMs());
+    if (!mirror->initialize(JsonDocument()) || !m_orchestrator->registerComponent(mirror)) {
+        delete mirror;
+        m_mirrorsRefused++;
+        return nullptr;
+    }
+    m_mirrorIds.push_back(localId);
+    return mirror;
+}
+
+void RemoteProxyComponent::detachMirrors() {
+    // Mirrors are not unregistered here: this can run inside the orchestrator's
+    // own unregistration of the proxy. They stay, marked stale, until reboot.
+    for (const String& mirrorId : m_mirrorIds) {
+        RemoteMirrorComponent* mirror = findMirror(mirrorId);
+        if (mirror) mirror->detach();
+    }
+    m_mirrorIds.clear();
+}
+
+void RemoteProxyComponent::cleanup() {
+    detachMirrors();
+}
+
+JsonDocument RemoteProxyComponent::getProxyStats() const {
+    JsonDocument stats;
+
+    stats["peer"] = m_peerHost + ":" + m_peerPort;
+    stats["peer_node"] = m_peerNode;
+    stats["peer_boot"] = m_peerBoot;
+    stats["connected"] = m_connected;
+    stats["seq"] = m_since;
+    stats["last_contact_ms"] = m_lastContactMs;
+    stats["polls"] = m_polls;
+    stats["poll_failures"] = m_pollFailures;
+    stats["resyncs"] = m_resyncs;
+    stats["samples_received"] = m_samplesReceived;
+    stats["changes_published"] = m_changesPublished;
+    stats["mirrors_refused"] = m_mirrorsRefused;
+    stats["bytes_received"] = m_bytesReceived;
+    stats["last_response_bytes"] = m_lastResponseBytes;
+    if (m_polls > m_pollFailures) {
+        stats["avg_response_bytes"] = (uint32_t)(m_bytesReceived / (m_polls - m_pollFailures));
+    }
+    stats["stale_after_ms"] = getStaleAfterMs();
+
+    JsonObject mirrors = stats["mirrors"].to<JsonObject>();
+    for (const String& mirrorId : m_mirrorIds) {
+        RemoteMirrorComponent* mirror = findMirror(mirrorId);
+        if (mirror) {
+            mirrors[mirrorId] = mirror->getFreshness();
+        }
+    }
+    return stats;
+}
+
+std::vector<ComponentAction> RemoteProxyComponent::getSupportedActions() const {
+    std::vector<ComponentAction> actions;
+
+    ComponentAction statusAction;
+    statusAction.name = "status";
+    statusAction.description = "Get sync counters and the freshness of every mirror";
+    statusAction.timeoutMs = 1000;
+    statusAction.requiresReady = false;
+    actions.push_back(statusAction);
+
+    ComponentAction syncAction;
+    syncAction.name = "sync_now";
+    syncAction.description = "Poll the peer now";
+    syncAction.timeoutMs = 1000;
+    ActionParameter fullParam;
+    fullParam.name = "full";
+    fullParam.type = ActionParameterType::BOOLEAN;
+    fullParam.required = false;
+    fullParam.description = "Request every component, not only changes (default false)";
+    syncAction.parameters.push_back(fullParam);
+    actions.push_back(syncAction);
+
+    return actions;
+}
+
+ActionResult RemoteProxyComponent::performAction(const String& actionName, const JsonDocument& parameters) {
+    ActionResult result;
+    result.actionName = actionName;
+    result.success = false;
+
+    if (actionName == "status") {
+        result.success = true;
+        result.message = "Remote proxy statistics";
+        result.data = getProxyStats();
+    } else if (actionName == "sync_now") {
+        // The poll itself runs on the orchestrator's next pass, not in the caller's context
+        if (parameters["full"] | false) {
+            m_since = 0;
+        }
+        setNextExecutionMs(millis());
+        result.success = true;
+        result.message = m_since == 0 ? "Full sync scheduled" : "Delta sync scheduled";
+    } else {
+        result.message = "Unknown action: " + actionName;
+    }
+
+    return result;
+}
+
+REGISTER_COMPONENT_TYPE(RemoteProxyComponent, "RemoteProxy", nullptr)
+
+#endif // COMPONENT_REMOTE_PROXY
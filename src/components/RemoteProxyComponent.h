@@ -0,0 +1,186 @@
+#pragma once
+
+#include "BaseComponent.h"
+
+// Forward declaration
+class Orchestrator;
+
+/**
+ * @brief Local stand-in for one component of another node
+ *
+ * Created and fed by a RemoteProxyComponent; never configured or stored on
+ * its own, so mirrors disappear on reboot and come back with the proxy's
+ * first full sync. A mirror executes only when the proxy delivers changed
+ * values, or when its data goes stale, so followers (rules engine,
+ * telemetry) see its samples exactly like a local sensor's. The output is
+ * the remote component's data plus freshness fields:
+ *
+ *   remote_seq     Peer sequence number of the sample
+ *   remote_age_ms  Age of the sample, measured from the peer's execution
+ *   stale          No update within the proxy's stale_after_ms
+ */
+class RemoteMirrorComponent : public BaseComponent {
+public:
+    RemoteMirrorComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator,
+                          const String& proxyId, const String& remoteId, const String& remoteType);
+
+    // Required BaseComponent implementations
+    JsonDocument getDefaultSchema() const override;
+    bool initialize(const JsonDocument& config) override;
+    ExecutionResult execute() override;
+    void cleanup() override;
+
+    /**
+     * @brief Take a sample received from the peer
+     * @param data Remote output data
+     * @param remoteSeq Peer sequence number of the sample
+     * @param remoteAgeMs Age of the sample on the peer when it was sent
+     * @return true if the values changed (the mirror publishes a new sample)
+     */
+    bool deliver(JsonVariantConst data, uint32_t remoteSeq, uint32_t remoteAgeMs);
+
+    /**
+     * @brief Publish the held values as stale now (proxy removed or reconfigured)
+     */
+    void detach();
+
+    void setStaleAfterMs(uint32_t staleAfterMs) { m_staleAfterMs = staleAfterMs; }
+    const String& getProxyId() const { return m_proxyId; }
+    const String& getRemoteId() const { return m_remoteId; }
+
+    /**
+     * @brief Freshness of the held values, computed now
+     */
+    JsonDocument getFreshness() const;
+
+    // Resource pressure: from the shed level on, the held values live only in
+    // the last output string instead of a second document
+    void onResourceLevel(uint8_t level) override;
+
+protected:
+    // === Configuration Management (BaseComponent virtual methods) ===
+    JsonDocument getCurrentConfig() const override;
+    bool applyConfig(const JsonDocument& config) override;
+
+    // === Action System (BaseComponent virtual methods) ===
+    std::vector<ComponentAction> getSupportedActions() const override;
+    ActionResult performAction(const String& actionName, const JsonDocument& parameters) override;
+
+private:
+    String m_proxyId;
+    String m_remoteId;
+    String m_remoteType;
+    JsonDocument m_values;                    // Remote data without its "timestamp" (empty when compact)
+    bool m_compactValues = false;             // Shed level: m_values released once published
+    bool m_valuesPending = false;             // Delivered values not yet published
+    uint32_t m_remoteSeq = 0;
+    uint32_t m_remoteAgeMs = 0;               // Age on the peer at delivery
+    MonoTimeUs m_receivedUs = 0;
+    uint32_t m_staleAfterMs = 15000;
+    uint32_t m_updates = 0;
+    bool m_stale = false;
+
+    uint32_t getRemoteAgeMs(MonoTimeUs nowUs) const;
+    JsonDocument publishedValues() const;
+};
+
+/**
+ * @brief Mirrors another node's components with sequence-numbered delta sync
+ *
+ * Every poll_interval_ms the proxy asks the peer for
+ *
+ *   GET /api/components/delta?since=<seq>&ids=<components>&fields=<fields>
+ *
+ * and receives only the components that produced a sample since the last
+ * response, each with its sequence number (see API_SPECIFICATION.md). An
+ * idle peer answers with an empty "components" object, so the cost of a
+ * poll does not grow with the number of mirrored channels; the "fields"
+ * list trims each component to the values actually used.
+ *
+ * Each remote component appears locally as a RemoteMirrorComponent named
+ * "<id_prefix><remote id>" (the prefix defaults to "<proxy id>.") and can
+ * be read, followed and used in rules like any local component. Values
+ * equal to the held ones only refresh the mirror's freshness; changed
+ * values are published as a new sample.
+ *
+ * The peer's "boot" id and sequence number detect restarts: a new boot id
+ * or a sequence number below the last one seen triggers a full resync
+ * (since=0) on the next execution. HTTP failures use the shared client's
+ * backoff; mirrors that hear nothing for stale_after_ms publish stale=true.
+ */
+class RemoteProxyComponent : public BaseComponent {
+public:
+    static const size_t MAX_MIRRORS = 128;
+
+    /**
+     * @brief Constructor
+     * @param id Unique component identifier
+     * @param name Human-readable component name
+     * @param storage Reference to ConfigStorage instance
+     * @param orchestrator Reference to orchestrator for component access
+     */
+    RemoteProxyComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator);
+
+    /**
+     * @brief Destructor
+     */
+    ~RemoteProxyComponent() override;
+
+    // Required BaseComponent implementations
+    JsonDocument getDefaultSchema() const override;
+    bool initialize(const JsonDocument& config) override;
+    ExecutionResult execute() override;
+    void cleanup() override;
+
+protected:
+    // === Configuration Management (BaseComponent virtual methods) ===
+    JsonDocument getCurrentConfig() const override;
+    bool applyConfig(const JsonDocument& config) override;
+
+    // === Action System (BaseComponent virtual methods) ===
+    std::vector<ComponentAction> getSupportedActions() const override;
+    ActionResult performAction(const String& actionName, const JsonDocument& parameters) override;
+
+private:
+    // Configuration parameters
+    String m_peerHost;
+    uint16_t m_peerPort = 80;
+    String m_componentList;                   // Comma-separated remote ids, empty = all
+    String m_fieldList;                       // Comma-separated output fields, empty = all
+    String m_idPrefix;                        // Local id = prefix + remote id
+    uint32_t m_pollIntervalMs = 5000;
+    uint32_t m_timeoutMs = 3000;
+    uint32_t m_staleAfterMs = 0;              // 0 = three poll intervals
+    uint16_t m_maxMirrors = 64;
+
+    // Sync state
+    uint32_t m_since = 0;                     // Peer sequence number of the last response
+    uint32_t m_peerBoot = 0;
+    String m_peerNode;
+    bool m_connected = false;
+    bool m_resync = false;                    // Poll again immediately with since=0
+    uint32_t m_lastContactMs = 0;
+    std::vector<String> m_mirrorIds;          // Looked up by id: mirrors can be deleted via the API
+
+    // Statistics
+    uint32_t m_polls = 0;
+    uint32_t m_pollFailures = 0;
+    uint32_t m_resyncs = 0;
+    uint32_t m_samplesReceived = 0;           // Components in responses
+    uint32_t m_changesPublished = 0;          // Of those, with changed values
+    uint32_t m_mirrorsRefused = 0;            // Over max_mirrors or id taken
+    uint32_t m_lastResponseBytes = 0;
+    uint32_t m_lastChanges = 0;
+    uint64_t m_bytesReceived = 0;             // JSON bodies, without HTTP headers
+
+    bool poll(uint32_t& nextPollMs);
+    String buildUrl() const;
+    RemoteMirrorComponent* findOrCreateMirror(const String& remoteId, const String& remoteType);
+    RemoteMirrorComponent* findMirror(const String& localId) const;
+    void detachMirrors();
+    uint32_t getStaleAfterMs() const;
+    JsonDocument getProxyStats() const;
+
+    static String joinList(JsonVariantConst list);
+    static void splitList(const String& list, JsonArray out);
+};
@@ -0,0 +1,919 @@
+#include "RulesEngineComponent.h"
+#include "../core/ComponentRegistry.h"
+#include "../core/Orchestrator.h"
+#include "../utils/EventJournal.h"
+
+#if COMPONENT_RULES_ENGINE
+
+// Out-of-line definitions for ODR-used constants
+const size_t RulesEngineComponent::MAX_RULES;
+const size_t RulesEngineComponent::MAX_SIGNALS;
+const size_t RulesEngineComponent::MAX_STACK;
+const size_t RulesEngineComponent::MAX_CODE_BYTES;
+
+RulesEngineComponent::RulesEngineComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator)
+    : BaseComponent(id, "RulesEngine", name, storage, orchestrator) {
+    log(Logger::DEBUG, "RulesEngineComponent created");
+}
+
+RulesEngineComponent::~RulesEngineComponent() {
+    cleanup();
+}
+
+JsonDocument RulesEngineComponent::getDefaultSchema() const {
+    JsonDocument schema;
+    schema["type"] = "object";
+    schema["title"] = "Rules Engine Configuration";
+
+    JsonObject properties = schema["properties"].to<JsonObject>();
+
+    JsonObject intervalProp = properties["interval_ms"].to<JsonObject>();
+    intervalProp["type"] = "integer";
+    intervalProp["minimum"] = 1000;
+    intervalProp["maximum"] = 3600000;
+    intervalProp["default"] = 60000;
+    intervalProp["description"] = "Idle wake-up in milliseconds; producer samples wake the engine immediately";
+
+    JsonObject rulesProp = properties["rules"].to<JsonObject>();
+    rulesProp["type"] = "array";
+    rulesProp["default"].to<JsonArray>();
+    rulesProp["description"] = "Rules: name, when, for_ms, hysteresis, action (component/action), params, "
+                               "cooldown_ms, max_per_hour, repeat, enabled";
+
+    return schema;
+}
+
+bool RulesEngineComponent::initialize(const JsonDocument& config) {
+    log(Logger::INFO, "Initializing rules engine component...");
+    setState(ComponentState::INITIALIZING);
+
+    if (!loadConfiguration(config)) {
+        setError("Failed to load configuration");
+        return false;
+    }
+
+    if (!applyConfig(getConfiguration())) {
+        setError("Failed to apply configuration");
+        return false;
+    }
+
+    // First pass reads whatever the producers already hold
+    setNextExecutionMs(millis());
+
+    setState(ComponentState::READY);
+    log(Logger::INFO, String("Rules engine initialized - ") + m_rules.size() + " rules over " +
+                      m_signals.size() + " signals from " + m_producers.size() + " components");
+    return true;
+}
+
+JsonDocument RulesEngineComponent::getCurrentConfig() const {
+    JsonDocument config;
+
+    config["interval_ms"] = m_intervalMs;
+    config["rules"] = m_rulesConfig;
+
+    return config;
+}
+
+bool RulesEngineComponent::applyConfig(const JsonDocument& config) {
+    m_intervalMs = config["interval_ms"] | m_intervalMs;
+    if (m_intervalMs < 1000) m_intervalMs = 1000;
+
+    // Partial updates without "rules" keep the compiled rules and their state
+    if (!config["rules"].isNull()) {
+        m_rulesConfig.set(config["rules"]);
+        compileRules(m_rulesConfig.as<JsonArrayConst>());
+        setNextExecutionUs(TimeUtils::monoNowUs());
+    }
+    return true;
+}
+
+// === Compilation ===
+
+void RulesEngineComponent::compileRules(JsonArrayConst rules) {
+    m_rules.clear();
+    m_signals.clear();
+    m_producers.clear();
+    m_rules.reserve(rules.size() < MAX_RULES ? rules.size() : MAX_RULES);
+
+    size_t failed = 0;
+    for (JsonObjectConst definition : rules) {
+        if (m_rules.size() >= MAX_RULES) {
+            log(Logger::WARNING, String("More than ") + MAX_RULES + " rules - the rest are ignored");
+            break;
+        }
+        m_rules.push_back(Rule());
+        Rule& rule = m_rules.back();
+        if (!compileRule(definition, rule)) {
+            failed++;
+            log(Logger::WARNING, "Rule " + rule.name + " not compiled: " + rule.error);
+        }
+    }
+    m_rules.shrink_to_fit();
+
+    // Run right after every producer a rule reads
+    clearDependencies();
+    for (const Producer& producer : m_producers) {
+        declareDependency(producer.componentId, 0, true);
+    }
+
+    log(Logger::INFO, String("Compiled ") + (m_rules.size() - failed) + "/" + m_rules.size() + " rules, " +
+                      m_signals.size() + " signals");
+}
+
+bool RulesEngineComponent::compileRule(JsonObjectConst definition, Rule& rule) {
+    uint8_t index = (uint8_t)(&rule - &m_rules[0]);
+    rule.name = definition["name"] | (String("rule") + (int)index);
+    rule.when = definition["when"] | "";
+    rule.forMs = definition["for_ms"] | 0;
+    rule.hysteresis = fabsf(definition["hysteresis"] | 0.0f);
+    rule.cooldownMs = definition["cooldown_ms"] | 0;
+    rule.maxPerHour = definition["max_per_hour"] | 0;
+    rule.repeat = definition["repeat"] | false;
+    rule.enabled = definition["enabled"] | true;
+    rule.params.set(definition["params"]);
+
+    // Actions run inside execute(): ask for the non-blocking variant (e.g. a dose that
+    // returns once started); actions without a "wait" parameter ignore it
+    if (rule.params["wait"].isNull()) {
+        rule.params["wait"] = false;
+    }
+
+    // A repeating rule needs a period
+    if (rule.repeat && rule.cooldownMs < 1000) rule.cooldownMs = 1000;
+
+    String action = definition["action"] | "";
+    if (action.length() > 0) {
+        int slash = action.indexOf('/');
+        if (slash <= 0 || slash == (int)action.length() - 1) {
+            rule.error = "action must be component/action";
+            return false;
+        }
+        rule.targetId = action.substring(0, slash);
+        rule.actionName = action.substring(slash + 1);
+    }
+
+    if (rule.when.length() == 0) {
+        rule.error = "missing \"when\"";
+        return false;
+    }
+
+    Parser p;
+    p.start = rule.when.c_str();
+    p.pos = p.start;
+    p.rule = &rule;
+    p.ruleIndex = index;
+    p.depth = 0;
+
+    bool ok = parseOr(p);
+    if (ok) {
+        skipSpace(p);
+        if (*p.pos != '\0') {
+            ok = fail(p, "unexpected input");
+        }
+    }
+    if (!ok) {
+        rule.error = p.error;
+        rule.code.clear();
+        return false;
+    }
+    rule.code.shrink_to_fit();
+    return true;
+}
+
+int RulesEngineComponent::addSignal(const String& componentId, const String& field) {
+    int producerIndex = -1;
+    for (size_t i = 0; i < m_producers.size(); i++) {
+        if (m_producers[i].componentId == componentId) {
+            producerIndex = (int)i;
+            break;
+        }
+    }
+    if (producerIndex >= 0) {
+        for (uint32_t bits = m_producers[producerIndex].signals; bits; bits &= bits - 1) {
+            int signal = __builtin_ctz(bits);
+            if (m_signals[signal].field == field) {
+                return signal;
+            }
+        }
+    }
+    if (m_signals.size() >= MAX_SIGNALS) {
+        return -1;
+    }
+
+    if (producerIndex < 0) {
+        m_producers.push_back(Producer());
+        m_producers.back().componentId = componentId;
+        producerIndex = (int)m_producers.size() - 1;
+    }
+    Producer& producer = m_producers[producerIndex];
+    producer.signals |= 1UL << m_signals.size();
+    producer.filter[field] = true;
+
+    Signal signal;
+    signal.field = field;
+    signal.producer = (uint8_t)producerIndex;
+    m_signals.push_back(signal);
+    return (int)m_signals.size() - 1;
+}
+
+bool RulesEngineComponent::fail(Parser& p, const char* message) {
+    if (p.error.length() == 0) {
+        p.error = String(message) + " at column " + (int)(p.pos - p.start + 1);
+    }
+    return false;
+}
+
+bool RulesEngineComponent::emit(Parser& p, uint8_t op, int stackChange, const void* operand, size_t operandBytes) {
+    std::vector<uint8_t>& code = p.rule->code;
+    if (code.size() + 1 + operandBytes > MAX_CODE_BYTES) {
+        return fail(p, "expression too long");
+    }
+    code.push_back(op);
+    if (operandBytes > 0) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(operand);
+        code.insert(code.end(), bytes, bytes + operandBytes);
+    }
+
+    p.depth += stackChange;
+    if (p.depth > MAX_STACK) {
+        return fail(p, "expression too deep");
+    }
+    if (p.depth > p.rule->stackDepth) {
+        p.rule->stackDepth = p.depth;
+    }
+    return true;
+}
+
+void RulesEngineComponent::skipSpace(Parser& p) {
+    while (*p.pos == ' ' || *p.pos == '\t' || *p.pos == '\n' || *p.pos == '\r') {
+        p.pos++;
+    }
+}
+
+bool RulesEngineComponent::matchSymbol(Parser& p, const char* symbol) {
+    skipSpace(p);
+    size_t length = strlen(symbol);
+    if (strncmp(p.pos, symbol, length) != 0) {
+        return false;
+    }
+    p.pos += length;
+    return true;
+}
+
+bool RulesEngineComponent::matchWord(Parser& p, const char* word) {
+    skipSpace(p);
+    size_t length = strlen(word);
+    char next = p.pos[length];
+    if (strncmp(p.pos, word, length) != 0 || isalnum((unsigned char)next) || next == '_' ||
+        next == '-' || next == '/') {
+        return false;
+    }
+    p.pos += length;
+    return true;
+}
+
+bool RulesEngineComponent::parseOr(Parser& p) {
+    if (!parseAnd(p)) return false;
+    while (matchSymbol(p, "||") || matchWord(p, "or")) {
+        if (!parseAnd(p) || !emit(p, OP_OR, -1)) return false;
+    }
+    return true;
+}
+
+bool RulesEngineComponent::parseAnd(Parser& p) {
+    if (!parseNot(p)) return false;
+    while (matchSymbol(p, "&&") || matchWord(p, "and")) {
+        if (!parseNot(p) || !emit(p, OP_AND, -1)) return false;
+    }
+    return true;
+}
+
+bool RulesEngineComponent::parseNot(Parser& p) {
+    skipSpace(p);
+    bool negate = false;
+    if (p.pos[0] == '!' && p.pos[1] != '=') {
+        p.pos++;
+        negate = true;
+    } else if (matchWord(p, "not")) {
+        negate = true;
+    }
+    if (!negate) {
+        return parseComparison(p);
+    }
+
+    size_t operandStart = p.rule->code.size();
+    if (!parseNot(p)) return false;
+    invertBands(p.rule->code, operandStart);
+    return emit(p, OP_NOT, 0);
+}
+
+void RulesEngineComponent::invertBands(std::vector<uint8_t>& code, size_t from) {
+    // Under a negation the held side of a comparison is its false side, so the band
+    // must tighten it: "not (x > 6.5)" then releases at x > 6.6, not at x > 6.4
+    size_t pc = from;
+    while (pc < code.size()) {
+        switch (code[pc++]) {
+            case OP_CONST: pc += sizeof(float); break;
+            case OP_SIGNAL: pc++; break;
+            case OP_GT: case OP_GE: case OP_LT: case OP_LE: code[pc++] ^= 1; break;
+            default: break;
+        }
+    }
+}
+
+bool RulesEngineComponent::parseComparison(Parser& p) {
+    if (!parseSum(p)) return false;
+
+    // Two-character operators first so ">=" is not read as ">"
+    static const struct { const char* symbol; uint8_t op; } operators[] = {
+        {">=", OP_GE}, {"<=", OP_LE}, {"==", OP_EQ}, {"!=", OP_NE}, {">", OP_GT}, {"<", OP_LT}
+    };
+    for (const auto& candidate : operators) {
+        if (matchSymbol(p, candidate.symbol)) {
+            if (candidate.op == OP_EQ || candidate.op == OP_NE) {
+                return parseSum(p) && emit(p, candidate.op, -1);
+            }
+            uint8_t inverted = 0;  // Band direction, flipped by each enclosing negation
+            return parseSum(p) && emit(p, candidate.op, -1, &inverted, 1);
+        }
+    }
+    return true;
+}
+
+bool RulesEngineComponent::parseSum(Parser& p) {
+    if (!parseProduct(p)) return false;
+    for (;;) {
+        if (matchSymbol(p, "+")) {
+            if (!parseProduct(p) || !emit(p, OP_ADD, -1)) return false;
+        } else if (matchSymbol(p, "-")) {
+            if (!parseProduct(p) || !emit(p, OP_SUB, -1)) return false;
+        } else {
+            return true;
+        }
+    }
+}
+
+bool RulesEngineComponent::parseProduct(Parser& p) {
+    if (!parseUnary(p)) return false;
+    for (;;) {
+        if (matchSymbol(p, "*")) {
+            if (!parseUnary(p) || !emit(p, OP_MUL, -1)) return false;
+        } else if (matchSymbol(p, "/")) {
+            if (!parseUnary(p) || !emit(p, OP_DIV, -1)) return false;
+        } else {
+            return true;
+        }
+    }
+}
+
+bool RulesEngineComponent::parseUnary(Parser& p) {
+    if (matchSymbol(p, "-")) {
+        return parseUnary(p) && emit(p, OP_NEG, 0);
+    }
+    return parsePrimary(p);
+}
+
+bool RulesEngineComponent::parsePrimary(Parser& p) {
+    skipSpace(p);
+    const char* begin = p.pos;
+
+    if (*begin == '(') {
+        p.pos++;
+        if (!parseOr(p)) return false;
+        return matchSymbol(p, ")") || fail(p, "expected ')'");
+    }
+
+    if (isdigit((unsigned char)*begin) || (*begin == '.' && isdigit((unsigned char)begin[1]))) {
+        char* end = nullptr;
+        float value = strtof(begin, &end);
+        p.pos = end;
+        return emit(p, OP_CONST, 1, &value, sizeof(value));
+    }
+
+    if (matchWord(p, "true") || matchWord(p, "false")) {
+        float value = (*begin == 't') ? 1.0f : 0.0f;
+        return emit(p, OP_CONST, 1, &value, sizeof(value));
+    }
+
+    // Signal: `component/field`, or bare component/field (component may contain '-' and '.')
+    String reference;
+    if (*begin == '`') {
+        const char* close = strchr(begin + 1, '`');
+        if (!close) {
+            return fail(p, "unterminated `");
+        }
+        reference = String(begin + 1, (unsigned int)(close - begin - 1));
+        p.pos = close + 1;
+    } else if (isalpha((unsigned char)*begin) || *begin == '_') {
+        const char* end = begin;
+        while (isalnum((unsigned char)*end) || *end == '_' || *end == '-' || *end == '.') end++;
+        if (*end != '/') {
+            return fail(p, "expected component/field");
+        }
+        end++;
+        while (isalnum((unsigned char)*end) || *end == '_' || *end == '.') end++;
+        reference = String(begin, (unsigned int)(end - begin));
+        p.pos = end;
+    } else {
+        return fail(p, *begin ? "unexpected character" : "unexpected end");
+    }
+
+    int slash = reference.indexOf('/');
+    if (slash <= 0 || slash == (int)reference.length() - 1) {
+        p.pos = begin;
+        return fail(p, "expected component/field");
+    }
+    String componentId = reference.substring(0, slash);
+    if (componentId == m_componentId) {
+        p.pos = begin;
+        return fail(p, "a rule cannot read the rules engine");
+    }
+
+    int signal = addSignal(componentId, reference.substring(slash + 1));
+    if (signal < 0) {
+        p.pos = begin;
+        return fail(p, "too many signals");
+    }
+    m_signals[signal].rules |= 1UL << p.ruleIndex;
+    p.rule->signals |= 1UL << signal;
+
+    uint8_t operand = (uint8_t)signal;
+    return emit(p, OP_SIGNAL, 1, &operand, 1);
+}
+
+// === Evaluation ===
+
+bool RulesEngineComponent::evaluate(const Rule& rule, float band) const {
+    float stack[MAX_STACK];
+    uint8_t sp = 0;
+    const uint8_t* pc = rule.code.data();
+    const uint8_t* end = pc + rule.code.size();
+
+    // Comparisons are relaxed by the band: it makes a held condition easier to keep.
+    // Their operand byte is 1 under an odd number of negations, where the band tightens.
+    while (pc < end) {
+        switch (*pc++) {
+            case OP_CONST:
+                memcpy(&stack[sp++], pc, sizeof(float));
+                pc += sizeof(float);
+                break;
+            case OP_SIGNAL: {
+                const Signal& signal = m_signals[*pc++];
+                if (!signal.valid) {
+                    return false;  // No reading yet, or the field disappeared
+                }
+                stack[sp++] = signal.value;
+                break;
+            }
+            case OP_ADD: sp--; stack[sp - 1] += stack[sp]; break;
+            case OP_SUB: sp--; stack[sp - 1] -= stack[sp]; break;
+            case OP_MUL: sp--; stack[sp - 1] *= stack[sp]; break;
+            case OP_DIV: sp--; stack[sp - 1] = stack[sp] != 0.0f ? stack[sp - 1] / stack[sp] : 0.0f; break;
+            case OP_NEG: stack[sp - 1] = -stack[sp - 1]; break;
+            case OP_GT: sp--; stack[sp - 1] = stack[sp - 1] > stack[sp] - (*pc++ ? -band : band); break;
+            case OP_GE: sp--; stack[sp - 1] = stack[sp - 1] >= stack[sp] - (*pc++ ? -band : band); break;
+            case OP_LT: sp--; stack[sp - 1] = stack[sp - 1] < stack[sp] + (*pc++ ? -band : band); break;
+            case OP_LE: sp--; stack[sp - 1] = stack[sp - 1] <= stack[sp] + (*pc++ ? -band : band); break;
+            case OP_EQ: sp--; stack[sp - 1] = stack[sp - 1] == stack[sp]; break;
+            case OP_NE: sp--; stack[sp - 1] = stack[sp - 1] != stack[sp]; break;
+            case OP_AND: sp--; stack[sp - 1] = (stack[sp - 1] != 0.0f) && (stack[sp] != 0.0f); break;
+            case OP_OR: sp--; stack[sp - 1] = (stack[sp - 1] != 0.0f) || (stack[sp] != 0.0f); break;
+            case OP_NOT: stack[sp - 1] = stack[sp - 1] == 0.0f; break;
+            default: return false;
+        }
+    }
+    return sp > 0 && stack[sp - 1] != 0.0f;
+}
+
+bool RulesEngineComponent::evaluateTimed(Rule& rule, float band) {
+    uint32_t startCycles = ESP.getCycleCount();
+    bool holds = evaluate(rule, band);
+    uint32_t cycles = ESP.getCycleCount() - startCycles;
+
+    rule.evaluations++;
+    rule.evalCycles += cycles;
+    if (cycles > rule.maxEvalCycles) rule.maxEvalCycles = cycles;
+    return holds;
+}
+
+uint32_t RulesEngineComponent::pollSignals() {
+    uint32_t dirtyRules = 0;
+    if (!m_orchestrator) return 0;
+
+    for (Producer& producer : m_producers) {
+        BaseComponent* component = m_orchestrator->findComponent(producer.componentId);
+        MonoTimeUs sampleUs = component ? component->getLastSampleUs() : 0;
+        if (sampleUs == producer.lastSampleUs) {
+            continue;
+        }
+        producer.lastSampleUs = sampleUs;
+
+        if (component) {
+            consumeDependency(producer.componentId);  // Data-age metrics
+            readSignals(producer, component);
+            m_samplesRead++;
+        } else {
+            // Producer removed: its signals no longer hold
+            for (uint32_t bits = producer.signals; bits; bits &= bits - 1) {
+                m_signals[__builtin_ctz(bits)].valid = false;
+            }
+        }
+        for (uint32_t bits = producer.signals; bits; bits &= bits - 1) {
+            dirtyRules |= m_signals[__builtin_ctz(bits)].rules;
+        }
+    }
+    return dirtyRules;
+}
+
+bool RulesEngineComponent::readSignals(Producer& producer, BaseComponent* component) {
+    // Components keep only the serialized output; parse just the fields the rules read
+    JsonDocument parsed;
+    const String& text = component->getLastExecutionDataString();
+    bool ok = text.length() > 0 &&
+              deserializeJson(parsed, text, DeserializationOption::Filter(producer.filter)) == DeserializationError::Ok;
+    JsonVariantConst data = parsed.as<JsonVariantConst>();
+
+    for (uint32_t bits = producer.signals; bits; bits &= bits - 1) {
+        Signal& signal = m_signals[__builtin_ctz(bits)];
+        JsonVariantConst value = data[signal.field];
+        if (ok && value.is<bool>()) {
+            signal.value = value.as<bool>() ? 1.0f : 0.0f;
+            signal.valid = true;
+        } else if (ok && value.is<float>()) {
+            signal.value = value.as<float>();
+            signal.valid = true;
+        } else {
+            signal.valid = false;
+        }
+    }
+    return ok;
+}
+
+MonoTimeUs RulesEngineComponent::updateRule(Rule& rule, bool holds, MonoTimeUs nowUs) {
+    if (holds != rule.active) {
+        rule.active = holds;
+        rule.fired = false;
+        rule.deferred = false;
+        if (holds) {
+            rule.activeSinceUs = nowUs;
+            rule.activations++;
+        }
+        log(Logger::DEBUG, "Rule " + rule.name + (holds ? " active" : " released"));
+    }
+    if (!rule.active || rule.actionName.length() == 0 || (rule.fired && !rule.repeat)) {
+        return 0;
+    }
+
+    // Due once held for for_ms, and no sooner than one cooldown after the last firing
+    MonoTimeUs dueUs = rule.activeSinceUs + (MonoTimeUs)rule.forMs * 1000;
+    if (rule.lastFiredUs != 0) {
+        MonoTimeUs readyUs = rule.lastFiredUs + (MonoTimeUs)rule.cooldownMs * 1000;
+        if (readyUs > dueUs) dueUs = readyUs;
+    }
+    if (dueUs > nowUs) {
+        return dueUs;
+    }
+
+    MonoTimeUs refillUs = 0;
+    if (!takeToken(rule, nowUs, refillUs)) {
+        if (!rule.deferred) {
+            rule.deferred = true;
+            rule.rateLimited++;
+            log(Logger::WARNING, "Rule " + rule.name + " held back: " + rule.maxPerHour + " firings per hour reached");
+        }
+        return refillUs;
+    }
+    rule.deferred = false;
+
+    fire(rule, nowUs);
+    return rule.repeat ? nowUs + (MonoTimeUs)rule.cooldownMs * 1000 : 0;
+}
+
+bool RulesEngineComponent::takeToken(Rule& rule, MonoTimeUs nowUs, MonoTimeUs& refillUs) {
+    if (rule.maxPerHour == 0) {
+        return true;
+    }
+
+    // Token bucket: max_per_hour tokens, refilled continuously
+    const double tokensPerUs = rule.maxPerHour / 3600000000.0;
+    if (rule.tokensUs == 0) {
+        rule.tokens = rule.maxPerHour;
+    } else {
+        double tokens = rule.tokens + (nowUs - rule.tokensUs) * tokensPerUs;
+        rule.tokens = tokens < rule.maxPerHour ? (float)tokens : (float)rule.maxPerHour;
+    }
+    rule.tokensUs = nowUs;
+
+    if (rule.tokens >= 1.0f) {
+        rule.tokens -= 1.0f;
+        return true;
+    }
+    refillUs = nowUs + (MonoTimeUs)((1.0f - rule.tokens) / tokensPerUs) + 1;
+    return false;
+}
+
+bool RulesEngineComponent::fire(Rule& rule, MonoTimeUs nowUs) {
+    rule.fired = true;
+    rule.lastFiredUs = nowUs;
+    rule.firings++;
+
+    BaseComponent* target = m_orchestrator ? m_orchestrator->findComponent(rule.targetId) : nullptr;
+    if (!target) {
+        rule.failures++;
+        rule.lastResult = "Component not found: " + rule.targetId;
+        log(Logger::WARNING, "Rule " + rule.name + " fired, but " + rule.lastResult);
+        EventJournal::record(EVENT_RULE, Logger::WARNING, m_componentId, rule.name, 0);
+        return false;
+    }
+
+    ActionResult result = target->executeAction(rule.actionName, rule.params);
+    rule.lastResult = result.message;
+    if (!result.success) {
+        rule.failures++;
+        log(Logger::WARNING, "Rule " + rule.name + ": " + rule.targetId + "/" + rule.actionName +
+                             " failed - " + result.message);
+        EventJournal::record(EVENT_RULE, Logger::WARNING, m_componentId, rule.name, 0);
+        return false;
+    }
+    // Completion of longer actions (doses) is recorded by the target itself
+    log(Logger::INFO, "Rule " + rule.name + " fired: " + rule.targetId + "/" + rule.actionName);
+    EventJournal::record(EVENT_RULE, Logger::INFO, m_componentId, rule.name, 1);
+    return true;
+}
+
+ExecutionResult RulesEngineComponent::execute() {
+    ExecutionResult result;
+    uint32_t startTime = millis();
+    uint32_t startCycles = ESP.getCycleCount();
+
+    setState(ComponentState::EXECUTING);
+
+    MonoTimeUs nowUs = TimeUtils::monoNowUs();
+    uint32_t dirtyRules = pollSignals();
+    MonoTimeUs wakeUs = nowUs + (MonoTimeUs)m_intervalMs * 1000;
+    uint32_t evaluated = 0;
+    uint32_t active = 0;
+    uint32_t firings = 0;
+
+    for (size_t i = 0; i < m_rules.size(); i++) {
+        Rule& rule = m_rules[i];
+        if (!rule.enabled || rule.code.empty()) {
+            continue;
+        }
+        bool holds = rule.active;
+        if (dirtyRules & (1UL << i)) {
+            holds = evaluateTimed(rule, rule.active ? rule.hysteresis : 0.0f);
+            evaluated++;
+        }
+        MonoTimeUs dueUs = updateRule(rule, holds, nowUs);
+        if (dueUs != 0 && dueUs < wakeUs) {
+            wakeUs = dueUs;
+        }
+        active += rule.active ? 1 : 0;
+        firings += rule.firings;
+    }
+
+    m_passes++;
+    m_lastPassRules = evaluated;
+    m_lastPassUs = cyclesToNs(ESP.getCycleCount() - startCycles) / 1000;
+
+    JsonDocument data;
+    data["timestamp"] = millis();
+    data["rules"] = m_rules.size();
+    data["active_rules"] = active;
+    data["evaluated"] = evaluated;
+    data["firings"] = firings;
+    data["pass_us"] = m_lastPassUs;
+    JsonObject states = data["state"].to<JsonObject>();
+    for (const Rule& rule : m_rules) {
+        states[rule.name] = rule.active;
+    }
+    data["success"] = true;
+
+    updateExecutionStats();
+
+    String dataStr;
+    serializeJson(data, dataStr);
+    storeExecutionDataString(dataStr);
+
+    setNextExecutionUs(wakeUs);
+
+    result.success = true;
+    result.data = data;
+    result.executionTimeMs = millis() - startTime;
+
+    setState(ComponentState::READY);
+    return result;
+}
+
+// === Reporting ===
+
+uint32_t RulesEngineComponent::cyclesToNs(uint64_t cycles) {
+    uint64_t ns = cycles * 1000 / ESP.getCpuFreqMHz();
+    return ns < UINT32_MAX ? (uint32_t)ns : UINT32_MAX;
+}
+
+JsonDocument RulesEngineComponent::getRuleStats() const {
+    JsonDocument stats;
+    MonoTimeUs nowUs = TimeUtils::monoNowUs();
+
+    stats["rules"] = m_rules.size();
+    stats["signals"] = m_signals.size();
+    stats["producers"] = m_producers.size();
+    stats["passes"] = m_passes;
+    stats["samples_read"] = m_samplesRead;
+    stats["last_pass_rules"] = m_lastPassRules;
+    stats["last_pass_us"] = m_lastPassUs;
+
+    JsonArray rules = stats["rule_stats"].to<JsonArray>();
+    for (const Rule& rule : m_rules) {
+        JsonObject entry = rules.add<JsonObject>();
+        entry["name"] = rule.name;
+        entry["when"] = rule.when;
+        if (rule.actionName.length() > 0) {
+            entry["action"] = rule.targetId + "/" + rule.actionName;
+        }
+        entry["enabled"] = rule.enabled;
+        if (rule.error.length() > 0) {
+            entry["error"] = rule.error;
+            continue;
+        }
+        entry["active"] = rule.active;
+        if (rule.active) {
+            entry["active_ms"] = (uint32_t)((nowUs - rule.activeSinceUs) / 1000);
+        }
+        entry["code_bytes"] = rule.code.size();
+        entry["stack_depth"] = rule.stackDepth;
+        entry["signals"] = __builtin_popcount(rule.signals);
+        entry["evaluations"] = rule.evaluations;
+        entry["avg_eval_ns"] = rule.evaluations > 0 ? cyclesToNs(rule.evalCycles / rule.evaluations) : 0;
+        entry["max_eval_ns"] = cyclesToNs(rule.maxEvalCycles);
+        entry["activations"] = rule.activations;
+        entry["firings"] = rule.firings;
+        entry["failures"] = rule.failures;
+        entry["rate_limited"] = rule.rateLimited;
+        if (rule.lastResult.length() > 0) {
+            entry["last_result"] = rule.lastResult;
+        }
+    }
+    return stats;
+}
+
+JsonDocument RulesEngineComponent::runBenchmark(uint32_t iterations) {
+    JsonDocument report;
+    if (iterations == 0) iterations = 1;
+    report["iterations"] = iterations;
+
+    // Bytecode evaluation per rule, on the current signal values
+    JsonArray rules = report["rules"].to<JsonArray>();
+    volatile bool sink = false;
+    for (const Rule& rule : m_rules) {
+        if (rule.code.empty()) continue;
+        uint32_t startCycles = ESP.getCycleCount();
+        for (uint32_t n = 0; n < iterations; n++) {
+            sink = evaluate(rule, 0.0f);
+        }
+        uint32_t cycles = ESP.getCycleCount() - startCycles;
+        JsonObject entry = rules.add<JsonObject>();
+        entry["name"] = rule.name;
+        entry["code_bytes"] = rule.code.size();
+        entry["eval_ns"] = cyclesToNs(cycles) / iterations;
+    }
+    (void)sink;
+
+    // Reading a producer's sample: usually the filtered parse dominates a pass
+    JsonArray producers = report["producers"].to<JsonArray>();
+    for (Producer& producer : m_producers) {
+        BaseComponent* component = m_orchestrator ? m_orchestrator->findComponent(producer.componentId) : nullptr;
+        if (!component) continue;
+        uint32_t reads = iterations < 100 ? iterations : 100;
+        uint32_t startCycles = ESP.getCycleCount();
+        for (uint32_t n = 0; n < reads; n++) {
+            readSignals(producer, component);
+        }
+        uint32_t cycles = ESP.getCycleCount() - startCycles;
+        JsonObject entry = producers.add<JsonObject>();
+        entry["component"] = producer.componentId;
+        entry["signals"] = __builtin_popcount(producer.signals);
+        entry["read_ns"] = cyclesToNs(cycles) / reads;
+    }
+    return report;
+}
+
+void RulesEngineComponent::cleanup() {
+    // Nothing held outside the rule tables
+}
+
+std::vector<ComponentAction> RulesEngineComponent::getSupportedActions() const {
+    std::vector<ComponentAction> actions;
+
+    ComponentAction statusAction;
+    statusAction.name = "status";
+    statusAction.description = "Get rule state, compile errors and per-rule evaluation cost";
+    statusAction.timeoutMs = 1000;
+    statusAction.requiresReady = false;
+    actions.push_back(statusAction);
+
+    ComponentAction enableAction;
+    enableAction.name = "set_enabled";
+    enableAction.description = "Enable or disable a rule until the next reconfiguration";
+    enableAction.timeoutMs = 1000;
+
+    ActionParameter nameParam;
+    nameParam.name = "name";
+    nameParam.type = ActionParameterType::STRING;
+    nameParam.required = true;
+    nameParam.maxLength = 64;
+    nameParam.description = "Rule name";
+    enableAction.parameters.push_back(nameParam);
+
+    ActionParameter enabledParam;
+    enabledParam.name = "enabled";
+    enabledParam.type = ActionParameterType::BOOLEAN;
+    enabledParam.required = true;
+    enabledParam.description = "New state";
+    enableAction.parameters.push_back(enabledParam);
+    actions.push_back(enableAction);
+
+    ComponentAction benchAction;
+    benchAction.name = "benchmark";
+    benchAction.description = "Measure bytecode evaluation per rule and sample reading per producer";
+    benchAction.timeoutMs = 10000;
+
+    ActionParameter iterationsParam;
+    iterationsParam.name = "iterations";
+    iterationsParam.type = ActionParameterType::INTEGER;
+    iterationsParam.required = false;
+    iterationsParam.minValue = 1;
+    iterationsParam.maxValue = 100000;
+    iterationsParam.description = "Evaluations per rule to average over (default 1000)";
+    benchAction.parameters.push_back(iterationsParam);
+    actions.push_back(benchAction);
+
+    ComponentAction resetAction;
+    resetAction.name = "reset_stats";
+    resetAction.description = "Clear evaluation and firing counters";
+    resetAction.timeoutMs = 1000;
+    resetAction.requiresReady = false;
+    actions.push_back(resetAction);
+
+    return actions;
+}
+
+ActionResult RulesEngineComponent::performAction(const String& actionName, const JsonDocument& parameters) {
+    ActionResult result;
+    result.actionName = actionName;
+    result.success = false;
+
+    if (actionName == "status") {
+        result.success = true;
+        result.message = "Rules engine statistics";
+        result.data = getRuleStats();
+    } else if (actionName == "set_enabled") {
+        String name = parameters["name"] | "";
+        bool enabled = parameters["enabled"] | true;
+        for (Rule& rule : m_rules) {
+            if (rule.name != name) continue;
+            rule.enabled = enabled;
+            if (!enabled) {
+                rule.active = false;
+                rule.fired = false;
+            } else {
+                // Re-evaluate on the next pass with the values already read
+                for (uint32_t bits = rule.signals; bits; bits &= bits - 1) {
+                    m_producers[m_signals[__builtin_ctz(bits)].producer].lastSampleUs = 0;
+                }
+                setNextExecutionUs(TimeUtils::monoNowUs());
+            }
+            result.success = true;
+            result.message = "Rule " + name + (enabled ? " enabled" : " disabled");
+            break;
+        }
+        if (!result.success) {
+            result.message = "Unknown rule: " + name;
+        }
+    } else if (actionName == "benchmark") {
+        uint32_t iterations = parameters["iterations"] | 1000;
+        result.data = runBenchmark(iterations);
+        result.success = true;
+        result.message = "Benchmark complete";
+    } else if (actionName == "reset_stats") {
+        for (Rule& rule : m_rules) {
+            rule.evaluations = rule.activations = rule.firings = rule.failures = rule.rateLimited = 0;
+            rule.evalCycles = 0;
+            rule.maxEvalCycles = 0;
+        }
+        m_passes = m_samplesRead = 0;
+        result.success = true;
+        result.message = "Statistics cleared";
+    } else {
+        result.message = "Unknown action: " + actionName;
+    }
+
+    return result;
+}
+
+REGISTER_COMPONENT_TYPE(RulesEngineComponent, "RulesEngine", nullptr)
+
+#endif // COMPONENT_RULES_ENGINE
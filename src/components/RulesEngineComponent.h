@@ -0,0 +1,209 @@
+#pragma once
+
+#include "BaseComponent.h"
+
+// Forward declaration
+class Orchestrator;
+
+/**
+ * @brief On-device automation: "if <condition> holds for N ms then run an action"
+ *
+ * Rules are part of the component configuration:
+ *
+ *   {"name": "ph_high", "when": "`ph-1/current_ph` > 6.5", "for_ms": 60000,
+ *    "hysteresis": 0.1, "action": "pump-3/dose", "params": {"volume_ml": 2},
+ *    "cooldown_ms": 600000, "max_per_hour": 4, "repeat": true}
+ *
+ * "when" reads signals - one numeric or boolean field of another
+ * component's last execution data, written component/field (in backticks
+ * when the id contains spaces or operators) - and combines them with
+ * numbers, true/false, + - * /, comparisons and and/or/not (&& || !).
+ * Each rule is compiled once, when the configuration is applied, into
+ * postfix bytecode that runs on a fixed-size float stack.
+ *
+ * Evaluation is incremental. The engine declares every producer it reads
+ * as a followed dependency, so the scheduler runs it right after a
+ * producer samples; only the rules reading a signal of a producer that
+ * sampled are re-evaluated. Between samples the engine wakes only for
+ * "for_ms" deadlines, cooldowns and rate-limit refills.
+ *
+ * While a rule is active every comparison is relaxed by its hysteresis, so
+ * "x > 6.5" with hysteresis 0.1 releases at x <= 6.4, and "not (x > 6.5)"
+ * at x > 6.6: under not/! the band applies the other way. A rule fires once per
+ * activation; with "repeat" it fires again every cooldown while it holds.
+ * "cooldown_ms" spaces firings, "max_per_hour" caps them (token bucket).
+ * A rule without an action only reports its state in the output data.
+ * Actions run on the loop task and get "wait": false unless the rule sets
+ * it, so a dose starts and returns instead of blocking the scheduler; its
+ * completion is journaled as a "dose" event.
+ */
+class RulesEngineComponent : public BaseComponent {
+public:
+    static const size_t MAX_RULES = 32;        // Rule and signal sets are 32-bit masks
+    static const size_t MAX_SIGNALS = 32;
+    static const size_t MAX_STACK = 16;
+    static const size_t MAX_CODE_BYTES = 255;
+
+    /**
+     * @brief Constructor
+     * @param id Unique component identifier
+     * @param name Human-readable component name
+     * @param storage Reference to ConfigStorage instance
+     * @param orchestrator Reference to orchestrator for component access
+     */
+    RulesEngineComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator);
+
+    /**
+     * @brief Destructor
+     */
+    ~RulesEngineComponent() override;
+
+    // Required BaseComponent implementations
+    JsonDocument getDefaultSchema() const override;
+    bool initialize(const JsonDocument& config) override;
+    ExecutionResult execute() override;
+    void cleanup() override;
+
+    // Rule deadlines (for_ms, cooldown) fire actions on time, also under resource pressure
+    bool isTimeCritical() const override { return true; }
+
+protected:
+    // === Configuration Management (BaseComponent virtual methods) ===
+    JsonDocument getCurrentConfig() const override;
+    bool applyConfig(const JsonDocument& config) override;
+
+    // === Action System (BaseComponent virtual methods) ===
+    std::vector<ComponentAction> getSupportedActions() const override;
+    ActionResult performAction(const String& actionName, const JsonDocument& parameters) override;
+
+private:
+    enum OpCode : uint8_t {
+        OP_CONST,       // Followed by a 4-byte float
+        OP_SIGNAL,      // Followed by a 1-byte signal index
+        OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_NEG,
+        OP_GT, OP_GE, OP_LT, OP_LE,     // Followed by a 1-byte band direction (1 = under negation)
+        OP_EQ, OP_NE,
+        OP_AND, OP_OR, OP_NOT
+    };
+
+    /**
+     * @brief Producer component whose samples feed one or more signals
+     */
+    struct Producer {
+        String componentId;
+        MonoTimeUs lastSampleUs = 0;
+        uint32_t signals = 0;                 // Bit per signal read from this producer
+        JsonDocument filter;                  // Fields the rules read, for filtered parsing
+    };
+
+    /**
+     * @brief One field of a producer's output, as the rules see it
+     */
+    struct Signal {
+        String field;
+        float value = 0.0f;
+        bool valid = false;                   // Field present and numeric in the last sample
+        uint8_t producer = 0;
+        uint32_t rules = 0;                   // Bit per rule reading this signal
+    };
+
+    /**
+     * @brief Compiled rule with its runtime state and cost counters
+     */
+    struct Rule {
+        // Definition
+        String name;
+        String when;
+        String targetId;
+        String actionName;
+        JsonDocument params;
+        std::vector<uint8_t> code;
+        String error;                         // Compile error; the rule is inactive when set
+        float hysteresis = 0.0f;
+        uint32_t forMs = 0;
+        uint32_t cooldownMs = 0;
+        uint16_t maxPerHour = 0;              // 0 = no cap
+        uint32_t signals = 0;                 // Bit per signal the expression reads
+        uint8_t stackDepth = 0;
+        bool enabled = true;
+        bool repeat = false;
+
+        // State
+        bool active = false;                  // Condition holds (with hysteresis)
+        bool fired = false;                   // Fired during the current activation
+        bool deferred = false;                // Due, but held back by the rate limit
+        MonoTimeUs activeSinceUs = 0;
+        MonoTimeUs lastFiredUs = 0;
+        MonoTimeUs tokensUs = 0;
+        float tokens = 0.0f;
+
+        // Counters
+        uint32_t evaluations = 0;
+        uint32_t activations = 0;
+        uint32_t firings = 0;
+        uint32_t failures = 0;
+        uint32_t rateLimited = 0;
+        uint64_t evalCycles = 0;
+        uint32_t maxEvalCycles = 0;
+        String lastResult;
+    };
+
+    /**
+     * @brief Recursive-descent compiler state for one "when" expression
+     */
+    struct Parser {
+        const char* start;
+        const char* pos;
+        Rule* rule;
+        uint8_t ruleIndex;
+        uint8_t depth;
+        String error;
+    };
+
+    // Configuration parameters
+    uint32_t m_intervalMs = 60000;            // Idle wake-up when no producer samples
+    JsonDocument m_rulesConfig;               // "rules" as configured, for getCurrentConfig()
+
+    // Compiled rules and signal table
+    std::vector<Rule> m_rules;
+    std::vector<Signal> m_signals;
+    std::vector<Producer> m_producers;
+
+    // Statistics
+    uint32_t m_passes = 0;
+    uint32_t m_samplesRead = 0;
+    uint32_t m_lastPassRules = 0;
+    uint32_t m_lastPassUs = 0;
+
+    void compileRules(JsonArrayConst rules);
+    bool compileRule(JsonObjectConst definition, Rule& rule);
+    int addSignal(const String& componentId, const String& field);
+
+    // Expression grammar, lowest precedence first
+    bool parseOr(Parser& p);
+    bool parseAnd(Parser& p);
+    bool parseNot(Parser& p);
+    bool parseComparison(Parser& p);
+    bool parseSum(Parser& p);
+    bool parseProduct(Parser& p);
+    bool parseUnary(Parser& p);
+    bool parsePrimary(Parser& p);
+    bool emit(Parser& p, uint8_t op, int stackChange, const void* operand = nullptr, size_t operandBytes = 0);
+    static void invertBands(std::vector<uint8_t>& code, size_t from);
+    bool fail(Parser& p, const char* message);
+    static void skipSpace(Parser& p);
+    static bool matchWord(Parser& p, const char* word);
+    static bool matchSymbol(Parser& p, const char* symbol);
+
+    uint32_t pollSignals();
+    bool readSignals(Producer& producer, BaseComponent* component);
+    bool evaluate(const Rule& rule, float band) const;
+    bool evaluateTimed(Rule& rule, float band);
+    MonoTimeUs updateRule(Rule& rule, bool holds, MonoTimeUs nowUs);
+    bool fire(Rule& rule, MonoTimeUs nowUs);
+    bool takeToken(Rule& rule, MonoTimeUs nowUs, MonoTimeUs& refillUs);
+
+    JsonDocument getRuleStats() const;
+    JsonDocument runBenchmark(uint32_t iterations);
+    static uint32_t cyclesToNs(uint64_t cycles);
+};
@@ -1,3 +1,8 @@
+#include "../core/ComponentRegistry.h"
+
+// Flag first: the HTTP client headers have no native (host) shim
+#if COMPONENT_SERVO_DIMMER
+
 #include "ServoDimmerComponent.h"
 #include "../core/Orchestrator.h"
 #include <ArduinoJson.h>
@@ -64,7 +69,8 @@ bool ServoDimmerComponent::initialize(const JsonDocument& config) {
         return false;
     }
     
-    if (!applyConfiguration(m_configuration)) {
+    JsonDocument configuration = getConfiguration();
+    if (!applyConfiguration(configuration)) {
         setError("Failed to apply configuration");
         return false;
     }
@@ -77,7 +83,7 @@ bool ServoDimmerComponent::initialize(const JsonDocument& config) {
     }
     
     // Set initial position if configured
-    int initialPosition = m_configuration["initial_position"] | 0;
+    int initialPosition = configuration["initial_position"] | 0;
     if (initialPosition > 0 && m_enableMovement) {
         m_targetPosition = initialPosition;
         log(Logger::INFO, "Setting initial position to " + String(initialPosition) + "%");
@@ -160,11 +166,9 @@ ExecutionResult ServoDimmerComponent::execute() {
     }
     
     // Store last execution data for API/dashboard access
-    // Deep copy the data using serialize/deserialize to ensure it persists
     String dataStr;
     serializeJson(result.data, dataStr);
-    m_lastData.clear();
-    deserializeJson(m_lastData, dataStr);
+    storeExecutionDataString(dataStr);
     
     updateMovementSchedule();
     updateExecutionStats();
@@ -402,4 +406,8 @@ ActionResult ServoDimmerComponent::performAction(const String& actionName, const
     result.success = false;
     result.message = "Action not implemented: " + actionName;
     return result;
-}
\ No newline at end of file
+}
+
+REGISTER_COMPONENT_TYPE(ServoDimmerComponent, "ServoDimmer", nullptr)
+
+#endif // COMPONENT_SERVO_DIMMER
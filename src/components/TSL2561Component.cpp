@@ -4,8 +4,11 @@
  */
 
 #include "TSL2561Component.h"
+#include "../core/ComponentRegistry.h"
 #include "../core/Orchestrator.h"
 
+#if COMPONENT_TSL2561
+
 TSL2561Component::TSL2561Component(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator)
     : BaseComponent(id, "TSL2561", name, storage, orchestrator)
 {
@@ -699,4 +702,8 @@ ActionResult TSL2561Component::performAction(const String& actionName, const Jso
     }
     
     return result;
-}
\ No newline at end of file
+}
+
+REGISTER_COMPONENT_TYPE(TSL2561Component, "TSL2561", "LightSensor")
+
+#endif // COMPONENT_TSL2561
@@ -4,10 +4,13 @@
  */
 
 #include "TemplateComponent.h"
+#include "../core/ComponentRegistry.h"
 #include "../utils/Logger.h"
 #include "../core/Orchestrator.h"
 #include <Arduino.h>
 
+#if COMPONENT_TEMPLATE
+
 // =====================================================================
 // CONSTRUCTOR & DESTRUCTOR
 // =====================================================================
@@ -531,4 +534,8 @@ bool TemplateComponent::validateComponentState() {
  * ✅ Supports mock mode for testing without hardware
  * ✅ Provides configuration persistence via getCurrentConfig()
  * ✅ Uses default hydration pattern in applyConfig()
- */
\ No newline at end of file
+ */
+
+REGISTER_COMPONENT_TYPE(TemplateComponent, "Template", nullptr)
+
+#endif // COMPONENT_TEMPLATE
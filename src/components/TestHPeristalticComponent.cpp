@@ -1,7 +1,10 @@
 #include "TestHPeristalticComponent.h"
+#include "../core/ComponentRegistry.h"
 #include "PeristalticPumpComponent.h"
 #include "../core/Orchestrator.h"
 
+#if COMPONENT_TEST_H_PERISTALTIC
+
 TestHPeristalticComponent::TestHPeristalticComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator)
     : BaseComponent(id, "TestHPeristaltic", name, storage, orchestrator), m_orchestrator(orchestrator) {
     log(Logger::DEBUG, "TestHPeristalticComponent created");
@@ -418,4 +421,8 @@ ActionResult TestHPeristalticComponent::performAction(const String& actionName,
     result.success = false;
     result.message = "Action not implemented: " + actionName;
     return result;
-}
\ No newline at end of file
+}
+
+REGISTER_COMPONENT_TYPE(TestHPeristalticComponent, "TestHPeristaltic", nullptr)
+
+#endif // COMPONENT_TEST_H_PERISTALTIC
@@ -0,0 +1,634 @@
+#include "UdpTelemetryComponent.h"
+#include "../core/ComponentRegistry.h"
+#include "../core/Orchestrator.h"
+
+#if COMPONENT_UDP_TELEMETRY
+
+namespace {
+const size_t MAX_CHANNELS = 128;
+
+inline void putU16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+inline void putU32(uint8_t* p, uint32_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+}
+}
+
+// Out-of-line definitions for ODR-used constants
+const size_t UdpTelemetryComponent::HEADER_BYTES;
+const size_t UdpTelemetryComponent::MAX_DATAGRAM_BYTES;
+const size_t UdpTelemetryComponent::UDP_IP_OVERHEAD;
+
+UdpTelemetryComponent::UdpTelemetryComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator)
+    : BaseComponent(id, "UdpTelemetry", name, storage, orchestrator) {
+    log(Logger::DEBUG, "UdpTelemetryComponent created");
+}
+
+UdpTelemetryComponent::~UdpTelemetryComponent() {
+    cleanup();
+}
+
+JsonDocument UdpTelemetryComponent::getDefaultSchema() const {
+    JsonDocument schema;
+    schema["type"] = "object";
+    schema["title"] = "UDP Telemetry Configuration";
+
+    JsonObject properties = schema["properties"].to<JsonObject>();
+
+    JsonObject multicastProp = properties["multicast"].to<JsonObject>();
+    multicastProp["type"] = "boolean";
+    multicastProp["default"] = false;
+    multicastProp["description"] = "Send to the multicast group instead of a single collector";
+
+    JsonObject hostProp = properties["targetHost"].to<JsonObject>();
+    hostProp["type"] = "string";
+    hostProp["default"] = "192.168.1.100";
+    hostProp["maxLength"] = 64;
+    hostProp["description"] = "Collector IP address or hostname (unicast)";
+
+    JsonObject groupProp = properties["multicastGroup"].to<JsonObject>();
+    groupProp["type"] = "string";
+    groupProp["default"] = "239.10.0.1";
+    groupProp["maxLength"] = 15;
+    groupProp["description"] = "Multicast group address";
+
+    JsonObject portProp = properties["targetPort"].to<JsonObject>();
+    portProp["type"] = "integer";
+    portProp["minimum"] = 1;
+    portProp["maximum"] = 65535;
+    portProp["default"] = 5005;
+    portProp["description"] = "Collector UDP port";
+
+    JsonObject intervalProp = properties["intervalMs"].to<JsonObject>();
+    intervalProp["type"] = "integer";
+    intervalProp["minimum"] = 200;
+    intervalProp["maximum"] = 3600000;
+    intervalProp["default"] = 5000;
+    intervalProp["description"] = "Report interval in milliseconds";
+
+    JsonObject refreshProp = properties["fullRefreshSec"].to<JsonObject>();
+    refreshProp["type"] = "integer";
+    refreshProp["minimum"] = 0;
+    refreshProp["maximum"] = 86400;
+    refreshProp["default"] = 60;
+    refreshProp["description"] = "Send unchanged channels at least this often (0 = only on change)";
+
+    JsonObject dictProp = properties["dictionaryIntervalSec"].to<JsonObject>();
+    dictProp["type"] = "integer";
+    dictProp["minimum"] = 10;
+    dictProp["maximum"] = 86400;
+    dictProp["default"] = 300;
+    dictProp["description"] = "Re-announce channel names this often";
+
+    JsonObject nodeProp = properties["nodeId"].to<JsonObject>();
+    nodeProp["type"] = "integer";
+    nodeProp["minimum"] = 0;
+    nodeProp["default"] = 0;
+    nodeProp["description"] = "Node identifier on the wire (0 = derive from MAC address)";
+
+    return schema;
+}
+
+bool UdpTelemetryComponent::initialize(const JsonDocument& config) {
+    log(Logger::INFO, "Initializing UDP telemetry component...");
+    setState(ComponentState::INITIALIZING);
+
+    if (!loadConfiguration(config)) {
+        setError("Failed to load configuration");
+        return false;
+    }
+
+    if (!applyConfig(getConfiguration())) {
+        setError("Failed to apply configuration");
+        return false;
+    }
+
+    // Give sensors a chance to produce their first readings
+    setNextExecutionMs(millis() + m_intervalMs);
+
+    setState(ComponentState::READY);
+    log(Logger::INFO, String("UDP telemetry initialized - node ") + String(m_nodeId, HEX) + " -> " +
+                      (m_multicast ? m_multicastGroup : m_targetHost) + ":" + m_targetPort +
+                      " every " + m_intervalMs + "ms");
+    return true;
+}
+
+JsonDocument UdpTelemetryComponent::getCurrentConfig() const {
+    JsonDocument config;
+
+    config["multicast"] = m_multicast;
+    config["targetHost"] = m_targetHost;
+    config["multicastGroup"] = m_multicastGroup;
+    config["targetPort"] = m_targetPort;
+    config["intervalMs"] = m_intervalMs;
+    config["fullRefreshSec"] = m_fullRefreshSec;
+    config["dictionaryIntervalSec"] = m_dictionaryIntervalSec;
+    config["nodeId"] = m_nodeId;
+
+    return config;
+}
+
+bool UdpTelemetryComponent::applyConfig(const JsonDocument& config) {
+    m_multicast = config["multicast"] | false;
+    m_targetHost = config["targetHost"] | "192.168.1.100";
+    m_multicastGroup = config["multicastGroup"] | "239.10.0.1";
+    m_targetPort = config["targetPort"] | 5005;
+    m_intervalMs = config["intervalMs"] | 5000;
+    m_fullRefreshSec = config["fullRefreshSec"] | 60;
+    m_dictionaryIntervalSec = config["dictionaryIntervalSec"] | 300;
+    m_nodeId = config["nodeId"] | 0;
+
+    if (m_intervalMs < 200) m_intervalMs = 200;
+    if (m_nodeId == 0) {
+        // Last four bytes of the MAC address
+        m_nodeId = (uint32_t)(ESP.getEfuseMac() >> 16);
+    }
+
+    m_targetResolved = false;
+    m_lastDictionary = 0;  // Announce channel names to the (possibly new) collector
+    return true;
+}
+
+ExecutionResult UdpTelemetryComponent::execute() {
+    ExecutionResult result;
+    uint32_t startTime = millis();
+
+    setState(ComponentState::EXECUTING);
+
+    collectChannels();
+
+    uint32_t now = millis();
+    size_t reportBytes = 0;
+    if (WiFi.status() == WL_CONNECTED) {
+        if (m_lastDictionary == 0 || now - m_lastDictionary >= m_dictionaryIntervalSec * 1000) {
+            sendDictionary(true);
+            m_lastDictionary = now;
+        } else {
+            sendDictionary(false);  // Channels that appeared since the last announcement
+        }
+
+        bool fullRefresh = m_lastFullRefresh == 0 ||
+                           (m_fullRefreshSec > 0 && now - m_lastFullRefresh >= m_fullRefreshSec * 1000);
+        reportBytes = sendReport(fullRefresh);
+        if (fullRefresh) {
+            m_lastFullRefresh = now;
+        }
+    }
+
+    JsonDocument data;
+    data["timestamp"] = millis();
+    data["node_id"] = m_nodeId;
+    data["seq"] = m_seq;
+    data["channels"] = m_channels.size();
+    data["report_channels"] = m_lastReportChannels;
+    data["report_bytes"] = reportBytes;
+    data["report_us"] = m_lastEncodeUs;
+    data["reports_sent"] = m_reportsSent;
+    data["send_failures"] = m_sendFailures;
+    data["success"] = true;
+
+    setNextExecutionMs(millis() + m_intervalMs);
+
+    result.success = true;
+    result.data = data;
+    result.executionTimeMs = millis() - startTime;
+
+    setState(ComponentState::READY);
+    return result;
+}
+
+void UdpTelemetryComponent::collectChannels() {
+    if (!m_orchestrator) return;
+
+    for (BaseComponent* component : m_orchestrator->getComponents()) {
+        if (!component || component == this) continue;
+        if (component->getExecutionCount() == 0) continue;
+
+        JsonDocument core = component->getCoreData();
+        if (core.size() == 0) {
+            const String& lastData = component->getLastExecutionDataString();
+            if (lastData.isEmpty() || deserializeJson(core, lastData) != DeserializationError::Ok) {
+                continue;
+            }
+        }
+
+        const String& componentId = component->getId();
+        for (JsonPairConst field : core.as<JsonObjectConst>()) {
+            String key = field.key().c_str();
+            if (key == "timestamp") continue;
+
+            if (field.value().is<JsonObjectConst>()) {
+                // One level of nesting, e.g. pump "status": {...}
+                for (JsonPairConst nested : field.value().as<JsonObjectConst>()) {
+                    updateChannel(componentId + "." + key + "." + nested.key().c_str(), nested.value());
+                }
+            } else {
+                updateChannel(componentId + "." + key, field.value());
+            }
+        }
+    }
+}
+
+void UdpTelemetryComponent::updateChannel(const String& name, JsonVariantConst value) {
+    uint8_t valueType;
+    if (value.is<bool>()) {
+        valueType = VALUE_BOOL;
+    } else if (value.is<int32_t>()) {
+        valueType = VALUE_INT;
+    } else if (value.is<float>()) {
+        valueType = VALUE_FLOAT;
+    } else {
+        return;  // Strings, arrays and nulls are not telemetry channels
+    }
+
+    bool collision = false;
+    Channel* channel = findOrAddChannel(name, collision);
+    if (!channel) return;
+
+    bool changed = channel->valueType != valueType;
+    channel->valueType = valueType;
+    switch (valueType) {
+        case VALUE_FLOAT: {
+            float v = value.as<float>();
+            changed = changed || channel->value.f != v;
+            channel->value.f = v;
+            break;
+        }
+        case VALUE_INT: {
+            int32_t v = value.as<int32_t>();
+            changed = changed || channel->value.i != v;
+            channel->value.i = v;
+            break;
+        }
+        default: {
+            int32_t v = value.as<bool>() ? 1 : 0;
+            changed = changed || channel->value.i != v;
+            channel->value.i = v;
+            break;
+        }
+    }
+
+    if (changed) {
+        channel->dirty = true;
+    }
+}
+
+UdpTelemetryComponent::Channel* UdpTelemetryComponent::findOrAddChannel(const String& name, bool& collision) {
+    uint16_t id = channelId(name);
+    for (Channel& channel : m_channels) {
+        if (channel.id != id) continue;
+        if (channel.name == name) return &channel;
+
+        collision = true;
+        m_collisions++;
+        log(Logger::WARNING, "Channel id collision: " + name + " vs " + channel.name + " - skipped");
+        return nullptr;
+    }
+
+    if (m_channels.size() >= MAX_CHANNELS) {
+        return nullptr;
+    }
+
+    Channel channel;
+    channel.id = id;
+    channel.valueType = 0xFF;  // Forces the first update to mark it dirty
+    channel.dirty = true;
+    channel.announced = false;
+    channel.value.i = 0;
+    channel.name = name;
+    m_channels.push_back(channel);
+    return &m_channels.back();
+}
+
+size_t UdpTelemetryComponent::encodeHeader(uint8_t* buffer, uint8_t packetType, uint8_t count, uint8_t flags) {
+    putU16(buffer, MAGIC);
+    buffer[2] = VERSION;
+    buffer[3] = packetType;
+    putU32(buffer + 4, m_nodeId);
+    putU32(buffer + 8, ++m_seq);
+    putU32(buffer + 12, millis());
+    buffer[16] = count;
+    buffer[17] = flags;
+    return HEADER_BYTES;
+}
+
+size_t UdpTelemetryComponent::sendReport(bool fullRefresh) {
+    uint32_t startUs = micros();
+    uint8_t buffer[MAX_DATAGRAM_BYTES];
+    uint8_t flags = fullRefresh ? FLAG_FULL_REFRESH : 0;
+    size_t offset = HEADER_BYTES;
+    size_t total = 0;
+    uint8_t count = 0;
+    uint32_t channels = 0;
+
+    for (Channel& channel : m_channels) {
+        if (!fullRefresh && !channel.dirty) continue;
+
+        size_t entryBytes = 3 + (channel.valueType == VALUE_BOOL ? 1 : 4);
+        if (offset + entryBytes > MAX_DATAGRAM_BYTES || count == 255) {
+            encodeHeader(buffer, PACKET_REPORT, count, flags);
+            if (sendDatagram(buffer, offset)) total += offset;
+            offset = HEADER_BYTES;
+            count = 0;
+        }
+
+        putU16(buffer + offset, channel.id);
+        buffer[offset + 2] = channel.valueType;
+        if (channel.valueType == VALUE_BOOL) {
+            buffer[offset + 3] = channel.value.i ? 1 : 0;
+        } else if (channel.valueType == VALUE_FLOAT) {
+            memcpy(buffer + offset + 3, &channel.value.f, 4);  // IEEE754, little-endian on ESP32
+        } else {
+            putU32(buffer + offset + 3, (uint32_t)channel.value.i);
+        }
+        offset += entryBytes;
+        count++;
+        channels++;
+        channel.dirty = false;
+    }
+
+    if (count > 0) {
+        encodeHeader(buffer, PACKET_REPORT, count, flags);
+        if (sendDatagram(buffer, offset)) total += offset;
+    }
+
+    if (channels > 0) {
+        m_reportsSent++;
+    }
+    m_lastReportChannels = channels;
+    m_lastReportBytes = total;
+    m_lastEncodeUs = micros() - startUs;
+    return total;
+}
+
+size_t UdpTelemetryComponent::sendDictionary(bool all) {
+    uint8_t buffer[MAX_DATAGRAM_BYTES];
+    size_t offset = HEADER_BYTES;
+    size_t total = 0;
+    uint8_t count = 0;
+
+    for (Channel& channel : m_channels) {
+        if (!all && channel.announced) continue;
+
+        size_t nameLength = min((size_t)channel.name.length(), (size_t)255);
+        size_t entryBytes = 3 + nameLength;
+        if (offset + entryBytes > MAX_DATAGRAM_BYTES || count == 255) {
+            encodeHeader(buffer, PACKET_DICTIONARY, count, 0);
+            if (sendDatagram(buffer, offset)) total += offset;
+            offset = HEADER_BYTES;
+            count = 0;
+        }
+
+        putU16(buffer + offset, channel.id);
+        buffer[offset + 2] = (uint8_t)nameLength;
+        memcpy(buffer + offset + 3, channel.name.c_str(), nameLength);
+        offset += entryBytes;
+        count++;
+        channel.announced = true;
+    }
+
+    if (count > 0) {
+        encodeHeader(buffer, PACKET_DICTIONARY, count, 0);
+        if (sendDatagram(buffer, offset)) total += offset;
+    }
+    return total;
+}
+
+bool UdpTelemetryComponent::resolveTarget() {
+    if (m_targetResolved) return true;
+
+    if (m_multicast) {
+        m_targetResolved = m_targetIp.fromString(m_multicastGroup);
+    } else if (!m_targetIp.fromString(m_targetHost)) {
+        m_targetResolved = WiFi.hostByName(m_targetHost.c_str(), m_targetIp) == 1;
+    } else {
+        m_targetResolved = true;
+    }
+
+    if (!m_targetResolved) {
+        log(Logger::WARNING, "Cannot resolve telemetry target: " + (m_multicast ? m_multicastGroup : m_targetHost));
+    }
+    return m_targetResolved;
+}
+
+bool UdpTelemetryComponent::sendDatagram(const uint8_t* buffer, size_t length) {
+    if (!resolveTarget()) {
+        m_sendFailures++;
+        return false;
+    }
+
+    bool sent = m_udp.beginPacket(m_targetIp, m_targetPort) == 1 &&
+                m_udp.write(buffer, length) == length &&
+                m_udp.endPacket() == 1;
+    if (sent) {
+        m_datagramsSent++;
+        m_bytesSent += length;
+    } else {
+        m_sendFailures++;
+    }
+    return sent;
+}
+
+JsonDocument UdpTelemetryComponent::buildJsonEquivalent() const {
+    // Same readings in the shape the JSON API / MQTT batch uses
+    JsonDocument doc;
+    doc["node"] = m_nodeId;
+    doc["seq"] = m_seq;
+    doc["uptime_ms"] = millis();
+    JsonObject readings = doc["readings"].to<JsonObject>();
+
+    if (m_orchestrator) {
+        for (BaseComponent* component : m_orchestrator->getComponents()) {
+            if (!component || component == this || component->getExecutionCount() == 0) continue;
+            readings[component->getId()] = component->getCoreData();
+        }
+    }
+    return doc;
+}
+
+JsonDocument UdpTelemetryComponent::runBenchmark(uint32_t iterations) {
+    JsonDocument report;
+    if (iterations == 0) iterations = 1;
+
+    // Binary: encode every channel (full refresh), without sending
+    uint8_t buffer[MAX_DATAGRAM_BYTES];
+    size_t binaryBytes = 0;
+    size_t datagrams = 0;
+    uint32_t startUs = micros();
+    for (uint32_t n = 0; n < iterations; n++) {
+        size_t offset = HEADER_BYTES;
+        size_t bytes = 0;
+        size_t packets = 0;
+        for (const Channel& channel : m_channels) {
+            size_t entryBytes = 3 + (channel.valueType == VALUE_BOOL ? 1 : 4);
+            if (offset + entryBytes > MAX_DATAGRAM_BYTES) {
+                bytes += offset;
+                packets++;
+                offset = HEADER_BYTES;
+            }
+            putU16(buffer + offset, channel.id);
+            buffer[offset + 2] = channel.valueType;
+            memcpy(buffer + offset + 3, &channel.value, entryBytes - 3);
+            offset += entryBytes;
+        }
+        binaryBytes = bytes + offset;
+        datagrams = packets + 1;
+    }
+    uint32_t binaryUs = (micros() - startUs) / iterations;
+
+    // JSON: build and serialize the equivalent document
+    size_t jsonBytes = 0;
+    startUs = micros();
+    for (uint32_t n = 0; n < iterations; n++) {
+        JsonDocument doc = buildJsonEquivalent();
+        String json;
+        serializeJson(doc, json);
+        jsonBytes = json.length();
+    }
+    uint32_t jsonUs = (micros() - startUs) / iterations;
+
+    report["iterations"] = iterations;
+    report["channels"] = m_channels.size();
+
+    JsonObject binary = report["binary"].to<JsonObject>();
+    binary["bytes"] = binaryBytes;
+    binary["datagrams"] = datagrams;
+    binary["on_air_bytes"] = binaryBytes + datagrams * UDP_IP_OVERHEAD;
+    binary["encode_us"] = binaryUs;
+
+    JsonObject json = report["json"].to<JsonObject>();
+    json["bytes"] = jsonBytes;
+    json["on_air_bytes_min"] = jsonBytes + 40;  // TCP/IP headers only; HTTP headers and handshake excluded
+    json["serialize_us"] = jsonUs;
+
+    if (binaryBytes > 0) {
+        report["size_ratio"] = (float)jsonBytes / binaryBytes;
+    }
+    if (binaryUs > 0) {
+        report["cpu_ratio"] = (float)jsonUs / binaryUs;
+    }
+    return report;
+}
+
+JsonDocument UdpTelemetryComponent::getTelemetryStats() const {
+    JsonDocument stats;
+
+    stats["node_id"] = m_nodeId;
+    stats["target"] = (m_multicast ? m_multicastGroup : m_targetHost) + ":" + m_targetPort;
+    stats["mode"] = m_multicast ? "multicast" : "unicast";
+    stats["seq"] = m_seq;
+    stats["channels"] = m_channels.size();
+    stats["reports_sent"] = m_reportsSent;
+    stats["datagrams_sent"] = m_datagramsSent;
+    stats["send_failures"] = m_sendFailures;
+    stats["bytes_sent"] = m_bytesSent;
+    stats["on_air_bytes"] = m_bytesSent + m_datagramsSent * UDP_IP_OVERHEAD;
+    stats["last_report_bytes"] = m_lastReportBytes;
+    stats["last_report_channels"] = m_lastReportChannels;
+    stats["last_report_us"] = m_lastEncodeUs;
+    stats["channel_collisions"] = m_collisions;
+
+    return stats;
+}
+
+uint16_t UdpTelemetryComponent::channelId(const String& name) {
+    // 32-bit FNV-1a folded to 16 bits
+    uint32_t h = 2166136261UL;
+    for (size_t i = 0; i < name.length(); i++) {
+        h ^= (uint8_t)name[i];
+        h *= 16777619UL;
+    }
+    return (uint16_t)((h >> 16) ^ (h & 0xFFFF));
+}
+
+void UdpTelemetryComponent::onNetworkChange(bool connected) {
+    if (connected) {
+        m_targetResolved = false;
+        m_lastDictionary = 0;
+    }
+}
+
+void UdpTelemetryComponent::cleanup() {
+    m_udp.stop();
+}
+
+std::vector<ComponentAction> UdpTelemetryComponent::getSupportedActions() const {
+    std::vector<ComponentAction> actions;
+
+    ComponentAction statusAction;
+    statusAction.name = "status";
+    statusAction.description = "Get telemetry counters and channel list";
+    statusAction.timeoutMs = 1000;
+    statusAction.requiresReady = false;
+    actions.push_back(statusAction);
+
+    ComponentAction sendAction;
+    sendAction.name = "send_now";
+    sendAction.description = "Send the dictionary and a full report immediately";
+    sendAction.timeoutMs = 2000;
+    actions.push_back(sendAction);
+
+    ComponentAction benchAction;
+    benchAction.name = "benchmark";
+    benchAction.description = "Compare binary report vs JSON encoding (bytes and CPU time)";
+    benchAction.timeoutMs = 10000;
+
+    ActionParameter iterationsParam;
+    iterationsParam.name = "iterations";
+    iterationsParam.type = ActionParameterType::INTEGER;
+    iterationsParam.required = false;
+    iterationsParam.minValue = 1;
+    iterationsParam.maxValue = 1000;
+    iterationsParam.description = "Encoding passes to average over (default 50)";
+    benchAction.parameters.push_back(iterationsParam);
+    actions.push_back(benchAction);
+
+    return actions;
+}
+
+ActionResult UdpTelemetryComponent::performAction(const String& actionName, const JsonDocument& parameters) {
+    ActionResult result;
+    result.actionName = actionName;
+    result.success = false;
+
+    if (actionName == "status") {
+        result.success = true;
+        result.message = "UDP telemetry statistics";
+        result.data = getTelemetryStats();
+        JsonArray channels = result.data["channel_map"].to<JsonArray>();
+        for (const Channel& channel : m_channels) {
+            JsonObject entry = channels.add<JsonObject>();
+            entry["id"] = channel.id;
+            entry["name"] = channel.name;
+        }
+    } else if (actionName == "send_now") {
+        collectChannels();
+        sendDictionary(true);
+        size_t bytes = sendReport(true);
+        m_lastDictionary = m_lastFullRefresh = millis();
+        result.success = bytes > 0;
+        result.message = result.success ? String("Sent ") + bytes + " bytes" : "Nothing sent";
+        result.data["bytes"] = bytes;
+        result.data["channels"] = m_lastReportChannels;
+    } else if (actionName == "benchmark") {
+        collectChannels();
+        uint32_t iterations = parameters["iterations"] | 50;
+        result.data = runBenchmark(iterations);
+        result.success = true;
+        result.message = "Benchmark complete";
+    } else {
+        result.message = "Unknown action: " + actionName;
+    }
+
+    return result;
+}
+
+REGISTER_COMPONENT_TYPE(UdpTelemetryComponent, "UdpTelemetry", nullptr)
+
+#endif // COMPONENT_UDP_TELEMETRY
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "BaseComponent.h"
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+// Forward declaration
+class Orchestrator;
+
+/**
+ * @brief Compact binary UDP telemetry emitter
+ *
+ * Every report packs the numeric channels that changed since the previous
+ * report (all channels on a full refresh) into one datagram and sends it
+ * unicast or multicast. A channel is one numeric field of a component's
+ * core data, named "<componentId>.<field>" and identified on the wire by a
+ * 16-bit hash of that name. The names are sent separately in dictionary
+ * datagrams so reports stay small.
+ *
+ * Wire format (little-endian), see scripts/udp_telemetry_receiver.py:
+ *
+ *   Header (18 bytes)
+ *     u16 magic 0x5445 ("ET")  u8 version  u8 packetType
+ *     u32 nodeId  u32 seq  u32 uptimeMs  u8 entryCount  u8 flags
+ *   Report entries (packetType 1)
+ *     u16 channel  u8 valueType  value (f32 / i32 / u8 bool)
+ *   Dictionary entries (packetType 2)
+ *     u16 channel  u8 nameLength  name bytes
+ *
+ * seq increments for every datagram of a node (reports and dictionaries),
+ * so the receiver can count gaps as loss.
+ */
+class UdpTelemetryComponent : public BaseComponent {
+public:
+    static const uint16_t MAGIC = 0x5445;
+    static const uint8_t VERSION = 1;
+    static const uint8_t PACKET_REPORT = 1;
+    static const uint8_t PACKET_DICTIONARY = 2;
+    static const uint8_t FLAG_FULL_REFRESH = 0x01;
+    static const uint8_t VALUE_FLOAT = 0;
+    static const uint8_t VALUE_INT = 1;
+    static const uint8_t VALUE_BOOL = 2;
+    static const size_t HEADER_BYTES = 18;
+    static const size_t MAX_DATAGRAM_BYTES = 1024;   // Well below the WiFi MTU
+    static const size_t UDP_IP_OVERHEAD = 28;        // IPv4 + UDP headers per datagram
+
+    /**
+     * @brief Constructor
+     * @param id Unique component identifier
+     * @param name Human-readable component name
+     * @param storage Reference to ConfigStorage instance
+     * @param orchestrator Reference to orchestrator for component access
+     */
+    UdpTelemetryComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator);
+
+    /**
+     * @brief Destructor
+     */
+    ~UdpTelemetryComponent() override;
+
+    // Required BaseComponent implementations
+    JsonDocument getDefaultSchema() const override;
+    bool initialize(const JsonDocument& config) override;
+    ExecutionResult execute() override;
+    void cleanup() override;
+
+    /**
+     * @brief Re-resolve the target and re-announce channel names after a link change
+     * @param connected New link state
+     */
+    void onNetworkChange(bool connected) override;
+
+protected:
+    // === Configuration Management (BaseComponent virtual methods) ===
+    JsonDocument getCurrentConfig() const override;
+    bool applyConfig(const JsonDocument& config) override;
+
+    // === Action System (BaseComponent virtual methods) ===
+    std::vector<ComponentAction> getSupportedActions() const override;
+    ActionResult performAction(const String& actionName, const JsonDocument& parameters) override;
+
+private:
+    /**
+     * @brief One numeric telemetry channel
+     */
+    struct Channel {
+        uint16_t id;
+        uint8_t valueType;
+        bool dirty;                 // Changed since last report
+        bool announced;             // Included in a dictionary datagram
+        union {
+            float f;
+            int32_t i;
+        } value;
+        String name;
+    };
+
+    // Configuration parameters
+    bool m_multicast = false;                 // false = unicast to targetHost
+    String m_targetHost = "192.168.1.100";    // Collector address (unicast)
+    String m_multicastGroup = "239.10.0.1";   // Group address (multicast)
+    uint16_t m_targetPort = 5005;
+    uint32_t m_intervalMs = 5000;             // Report schedule
+    uint32_t m_fullRefreshSec = 60;           // Send all channels at least this often
+    uint32_t m_dictionaryIntervalSec = 300;   // Re-announce channel names
+    uint32_t m_nodeId = 0;                    // 0 = derived from the MAC address
+
+    // Runtime state
+    WiFiUDP m_udp;
+    IPAddress m_targetIp;
+    bool m_targetResolved = false;
+    std::vector<Channel> m_channels;
+    uint32_t m_seq = 0;
+    uint32_t m_lastFullRefresh = 0;
+    uint32_t m_lastDictionary = 0;
+
+    // Statistics
+    uint32_t m_reportsSent = 0;
+    uint32_t m_datagramsSent = 0;
+    uint32_t m_sendFailures = 0;
+    uint32_t m_bytesSent = 0;                 // Payload bytes (without UDP/IP headers)
+    uint32_t m_lastReportBytes = 0;
+    uint32_t m_lastReportChannels = 0;
+    uint32_t m_lastEncodeUs = 0;
+    uint32_t m_collisions = 0;
+
+    bool resolveTarget();
+    void collectChannels();
+    Channel* findOrAddChannel(const String& name, bool& collision);
+    void updateChannel(const String& name, JsonVariantConst value);
+    size_t sendReport(bool fullRefresh);
+    size_t sendDictionary(bool all);
+    size_t encodeHeader(uint8_t* buffer, uint8_t packetType, uint8_t count, uint8_t flags);
+    bool sendDatagram(const uint8_t* buffer, size_t length);
+    JsonDocument buildJsonEquivalent() const;
+    JsonDocument runBenchmark(uint32_t iterations);
+    JsonDocument getTelemetryStats() const;
+
+    static uint16_t channelId(const String& name);
+};
@@ -1,12 +1,40 @@
 #include "WebServerComponent.h"
+#include "../core/ComponentRegistry.h"
 #include "../utils/TimeUtils.h"
+#include "../utils/DeviceBenchmark.h"
+#include "../utils/Tracer.h"
+#include "../utils/SamplingProfiler.h"
+#include "../utils/SchemaValidator.h"
+#include "../utils/EventJournal.h"
 #include "../core/Orchestrator.h"
-// #include "LightOrchestrator.h"  // Disabled to save memory
+#include "../core/ComponentDataAggregator.h"
+#include "../core/CpuMonitor.h"
+#include "../core/ResourceGovernor.h"
+#include <memory>
+#if COMPONENT_MQTT_BROADCAST
+#include "MqttBroadcastComponent.h"
+#endif
 
-// Component includes for dynamic instantiation
-#include "../components/TSL2561Component.h"
-#include "../components/DHT22Component.h"
-#include "../components/PeristalticPumpComponent.h"
+#if COMPONENT_WEB_SERVER
+
+// API routes refused with 503 while the resource governor sheds load; pages and
+// static files are too. Status, data, actions, events and restart stay available.
+static const char* const SHEDDABLE_API_PREFIXES[] = {
+    "/api/debug/", "/api/components/debug", "/api/components/mqtt", "/api/logs",
+    "/api/light/", "/api/component/add"
+};
+
+static bool isSheddableRoute(const char* uri) {
+    if (strncmp(uri, "/api/", 5) != 0) {
+        return true;
+    }
+    for (const char* prefix : SHEDDABLE_API_PREFIXES) {
+        if (strncmp(uri, prefix, strlen(prefix)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
 
 WebServerComponent::WebServerComponent(const String& id, const String& name, ConfigStorage& storage, Orchestrator* orchestrator)
     : BaseComponent(id, "WebServer", name, storage, orchestrator) {
@@ -45,6 +73,12 @@ JsonDocument WebServerComponent::getDefaultSchema() const {
     nameProp["maxLength"] = 50;
     nameProp["description"] = "Server name for HTTP headers";
     
+    // Self-benchmark endpoint (optional, off by default: it loads flash, I2C and ADC)
+    JsonObject benchProp = properties["enableDebugBench"].to<JsonObject>();
+    benchProp["type"] = "boolean";
+    benchProp["default"] = false;
+    benchProp["description"] = "Allow POST /api/debug/bench self-benchmark runs";
+    
     log(Logger::DEBUG, "Generated web server schema with port=80, CORS=true");
     return schema;
 }
@@ -71,14 +105,13 @@ bool WebServerComponent::initialize(const JsonDocument& config) {
     }
     log(Logger::DEBUG, String("✅ Step 2: Configuration applied successfully (Port: ") + m_serverPort + ")");
     
-    // Check WiFi connection
+    // Check WiFi connection (connects in the background; the server binds to any address)
     log(Logger::DEBUG, "🔧 Step 3: Checking WiFi connection...");
     if (WiFi.status() != WL_CONNECTED) {
-        setError("WiFi not connected - web server requires network");
-        log(Logger::ERROR, "❌ Step 3 FAILED: WiFi not connected");
-        return false;
+        log(Logger::INFO, "⏳ Step 3: WiFi not connected yet - server reachable once the link is up");
+    } else {
+        log(Logger::DEBUG, String("✅ Step 3: WiFi connected (IP: ") + WiFi.localIP().toString() + ")");
     }
-    log(Logger::DEBUG, String("✅ Step 3: WiFi connected (IP: ") + WiFi.localIP().toString() + ")");
     
     // Initialize LittleFS filesystem for static file serving
     log(Logger::DEBUG, "🔧 Step 4: Initializing LittleFS filesystem...");
@@ -138,6 +171,7 @@ JsonDocument WebServerComponent::getCurrentConfig() const {
     config["serverPort"] = m_serverPort;
     config["enableCORS"] = m_enableCORS;
     config["serverName"] = m_serverName;
+    config["enableDebugBench"] = m_enableDebugBench;
     config["config_version"] = 1;
     
     return config;
@@ -150,6 +184,7 @@ bool WebServerComponent::applyConfig(const JsonDocument& config) {
     m_serverPort = config["serverPort"] | 80;
     m_enableCORS = config["enableCORS"] | true;
     m_serverName = config["serverName"] | "ESP32-Orchestrator";
+    m_enableDebugBench = config["enableDebugBench"] | false;
     
     // Handle version migration if needed
     uint16_t configVersion = config["config_version"] | 1;
@@ -170,6 +205,30 @@ bool WebServerComponent::applyConfiguration(const JsonDocument& config) {
     return applyConfig(config);
 }
 
+void WebServerComponent::onTraced(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction handler) {
+    // uri is a string literal, so it can name the span directly
+    bool sheddable = isSheddableRoute(uri);
+    m_webServer->on(uri, method, [this, uri, sheddable, handler](AsyncWebServerRequest* request) {
+        TRACE_SCOPE(TRACE_HTTP_SERVER, uri);
+        if (sheddable && ResourceGovernor::isShedding()) {
+            sendShedResponse(request);
+            return;
+        }
+        handler(request);
+    });
+}
+
+void WebServerComponent::sendShedResponse(AsyncWebServerRequest* request) {
+    ResourceGovernor::noteRejectedRequest();
+    
+    AsyncWebServerResponse* resp = request->beginResponse(503, "application/json",
+        String("{\"success\":false,\"error\":\"Unavailable under resource pressure\",\"level\":\"") +
+        ResourceGovernor::levelName(ResourceGovernor::getLevel()) + "\"}");
+    resp->addHeader("Retry-After", "30");
+    if (m_enableCORS) setCORSHeaders(resp);
+    request->send(resp);
+}
+
 void WebServerComponent::setupRoutes() {
     log(Logger::DEBUG, "Setting up web server routes");
     
@@ -179,7 +238,7 @@ void WebServerComponent::setupRoutes() {
     setupWebPages();
     
     // Static file handler for /www/* paths
-    m_webServer->on("/www/*", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/www/*", HTTP_GET, [this](AsyncWebServerRequest* request) {
         String path = request->url();
         // Serve the file if it exists in LittleFS
         if (!serveStaticFile(request, path)) {
@@ -188,7 +247,7 @@ void WebServerComponent::setupRoutes() {
     });
     
     // Generic static file handler for root-level files (MUST BE LAST)
-    m_webServer->on("/*", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/*", HTTP_GET, [this](AsyncWebServerRequest* request) {
         String path = request->url();
         // Skip API endpoints
         if (path.startsWith("/api/")) {
@@ -211,6 +270,10 @@ void WebServerComponent::setupRoutes() {
     // 404 handler
     m_webServer->onNotFound([this](AsyncWebServerRequest* request) {
         logRequest(request);
+        if (ResourceGovernor::isShedding()) {
+            sendShedResponse(request);
+            return;
+        }
         // Try to serve as static file one more time
         String path = "/www" + request->url();
         if (!serveStaticFile(request, path)) {
@@ -221,55 +284,80 @@ void WebServerComponent::setupRoutes() {
 
 void WebServerComponent::setupAPIEndpoints() {
     // System status endpoint
-    m_webServer->on("/api/system/status", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/system/status", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleSystemStatus(request);
     });
     
     // System restart endpoint
-    m_webServer->on("/api/system/restart", HTTP_POST, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/system/restart", HTTP_POST, [this](AsyncWebServerRequest* request) {
         handleSystemRestart(request);
     });
     
+    // Event journal: live stream first, "/api/system/events" would also match its path
+    setupEventStream();
+    onTraced("/api/system/events", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleSystemEvents(request);
+    });
+    
     // IMPORTANT: MORE SPECIFIC ROUTES MUST BE REGISTERED FIRST!
     
     // Execution loop control endpoints
-    m_webServer->on("/api/orchestrator/execution/status", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/orchestrator/execution/status", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleExecutionLoopStatus(request);
     });
     
-    m_webServer->on("/api/orchestrator/execution/pause", HTTP_POST, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/orchestrator/execution/pause", HTTP_POST, [this](AsyncWebServerRequest* request) {
         handleExecutionLoopPause(request);
     });
     
-    m_webServer->on("/api/orchestrator/execution/resume", HTTP_POST, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/orchestrator/execution/resume", HTTP_POST, [this](AsyncWebServerRequest* request) {
         handleExecutionLoopResume(request);
     });
     
-    m_webServer->on("/api/orchestrator/execution/config", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/orchestrator/execution/config", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleExecutionLoopConfig(request);
     });
     
-    m_webServer->on("/api/orchestrator/execution/config", HTTP_POST, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/orchestrator/execution/config", HTTP_POST, [this](AsyncWebServerRequest* request) {
         handleExecutionLoopConfigUpdate(request);
     });
 
     // Component data endpoint
-    m_webServer->on("/api/components/data", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/components/data", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleComponentData(request);
     });
     
+    // Components sampled since a sequence number (remote proxies)
+    onTraced("/api/components/delta", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleComponentDelta(request);
+    });
+    
     // Enhanced components with MQTT data endpoint
-    m_webServer->on("/api/components/mqtt", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/components/mqtt", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleComponentsMqtt(request);
     });
     
     // Debug endpoint to check raw component data
-    m_webServer->on("/api/components/debug", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/components/debug", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleComponentsDebug(request);
     });
     
+    // Component types linked into this build (COMPONENT_* build flags)
+    onTraced("/api/components/types", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        JsonDocument types;
+        types["count"] = ComponentRegistry::count();
+        types["types"] = ComponentRegistry::describe();
+        
+        String response;
+        serializeJson(types, response);
+        
+        AsyncWebServerResponse* resp = request->beginResponse(200, "application/json", response);
+        if (m_enableCORS) setCORSHeaders(resp);
+        request->send(resp);
+    });
+    
     // Time debug endpoint
-    m_webServer->on("/api/system/time", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/system/time", HTTP_GET, [this](AsyncWebServerRequest* request) {
         JsonDocument timeInfo;
         timeInfo["current_epoch"] = (long)TimeUtils::getEpochTime();
         timeInfo["current_timestamp"] = TimeUtils::getCurrentTimestamp();
@@ -283,6 +371,8 @@ void WebServerComponent::setupAPIEndpoints() {
         timeInfo["test_millis"] = testMillis;
         timeInfo["test_epoch"] = (long)testEpoch;
         timeInfo["stored_boot_time"] = (long)TimeUtils::getBootTime();
+        timeInfo["epoch_ms"] = TimeUtils::getEpochMillis();
+        timeInfo["clock"] = TimeUtils::getClockStats();
         
         String response;
         serializeJson(timeInfo, response);
@@ -293,122 +383,165 @@ void WebServerComponent::setupAPIEndpoints() {
     });
     
     // Component list endpoint (BASE ROUTE REGISTERED LAST!)
-    m_webServer->on("/api/components", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/components", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleComponentList(request);
     });
     
     // Log file endpoint (more specific route must come first)
-    m_webServer->on("/api/logs/system.log", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/logs/system.log", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleLogFile(request);
     });
     
     // Logs endpoint
-    m_webServer->on("/api/logs", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/logs", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleLogs(request);
     });
     
     // Memory information endpoint
-    m_webServer->on("/api/system/memory", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/system/memory", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleMemoryInfo(request);
     });
     
     // LittleFS debug endpoint
-    m_webServer->on("/api/debug/littlefs", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/debug/littlefs", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleLittleFSDebug(request);
     });
     
     // Direct config file read endpoint
-    m_webServer->on("/api/debug/config-file", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/debug/config-file", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleDirectConfigFileRead(request);
     });
     
     // Light sweep test endpoints
-    m_webServer->on("/api/light/sweep/start", HTTP_POST, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/light/sweep/start", HTTP_POST, [this](AsyncWebServerRequest* request) {
         // handleSweepTestStart(request); // Disabled to save memory
     });
     
-    m_webServer->on("/api/light/sweep/stop", HTTP_POST, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/light/sweep/stop", HTTP_POST, [this](AsyncWebServerRequest* request) {
         // handleSweepTestStop(request); // Disabled
     });
     
-    m_webServer->on("/api/light/sweep/status", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/light/sweep/status", HTTP_GET, [this](AsyncWebServerRequest* request) {
         // handleSweepTestStatus(request); // Disabled
     });
     
     // Generic component configuration endpoints (using query parameters)
-    m_webServer->on("/api/component/config", HTTP_PUT, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/component/config", HTTP_PUT, [this](AsyncWebServerRequest* request) {
         handleGenericComponentConfigUpdate(request);
     });
     
-    m_webServer->on("/api/component/config", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/component/config", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleGenericComponentConfigGet(request);
     });
     
     // Component creation endpoint
-    m_webServer->on("/api/component/add", HTTP_POST, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/component/add", HTTP_POST, [this](AsyncWebServerRequest* request) {
         handleComponentAdd(request);
     });
     
     // Component deletion endpoint
-    m_webServer->on("/api/component/delete", HTTP_DELETE, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/component/delete", HTTP_DELETE, [this](AsyncWebServerRequest* request) {
         handleComponentDelete(request);
     });
     
     // Component action endpoints
-    m_webServer->on("/api/components/{component_id}/actions", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/components/{component_id}/actions", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleComponentActionsGet(request);
     });
     
-    m_webServer->on("/api/components/{component_id}/actions/{action_name}", HTTP_POST, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/components/{component_id}/actions/{action_name}", HTTP_POST, [this](AsyncWebServerRequest* request) {
         handleComponentActionExecute(request);
     });
     
     // DEBUG: WebServer timing debug endpoint
-    m_webServer->on("/api/debug/webserver-timing", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/api/debug/webserver-timing", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleWebServerTimingDebug(request);
     });
+    
+    // Self-benchmark (gated by enableDebugBench, runs on a low-priority task)
+    onTraced("/api/debug/bench", HTTP_POST, [this](AsyncWebServerRequest* request) {
+        handleDebugBenchStart(request);
+    });
+    
+    onTraced("/api/debug/bench", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleDebugBenchReport(request);
+    });
+    
+    // Span tracing (sub-paths before the dump: "/api/debug/trace" also matches them)
+    onTraced("/api/debug/trace/start", HTTP_POST, [this](AsyncWebServerRequest* request) {
+        handleTraceStart(request);
+    });
+    
+    onTraced("/api/debug/trace/stop", HTTP_POST, [this](AsyncWebServerRequest* request) {
+        handleTraceStop(request);
+    });
+    
+    onTraced("/api/debug/trace/status", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleTraceStatus(request);
+    });
+    
+    onTraced("/api/debug/trace", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleTraceDump(request);
+    });
+    
+    // PC-sampling profiler (sub-paths before the dump, as above)
+    onTraced("/api/debug/profile/start", HTTP_POST, [this](AsyncWebServerRequest* request) {
+        handleProfileStart(request);
+    });
+    
+    onTraced("/api/debug/profile/stop", HTTP_POST, [this](AsyncWebServerRequest* request) {
+        handleProfileStop(request);
+    });
+    
+    onTraced("/api/debug/profile/status", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleProfileStatus(request);
+    });
+    
+    onTraced("/api/debug/profile", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleProfileDump(request);
+    });
 }
 
 void WebServerComponent::setupWebPages() {
     // Home page - try LittleFS first, then fallback
-    m_webServer->on("/", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/", HTTP_GET, [this](AsyncWebServerRequest* request) {
         if (!serveStaticFile(request, "/www/index.html")) {
             handleHomePage(request);  // Fallback to inline HTML
         }
     });
     
     // Components page
-    m_webServer->on("/components", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/components", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleComponentPage(request);
     });
     
     // Logs page  
-    m_webServer->on("/logs", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/logs", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleLogsPage(request);
     });
     
     // Dashboard page - try LittleFS first, then fallback
-    m_webServer->on("/dashboard", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/dashboard", HTTP_GET, [this](AsyncWebServerRequest* request) {
         if (!serveStaticFile(request, "/www/dashboard.html")) {
             handleDashboardPage(request);  // Fallback to inline HTML
         }
     });
     
     // Direct dashboard.html route
-    m_webServer->on("/dashboard.html", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/dashboard.html", HTTP_GET, [this](AsyncWebServerRequest* request) {
         if (!serveStaticFile(request, "/www/dashboard.html")) {
             handleDashboardPage(request);  // Fallback to inline HTML
         }
     });
     
     // Static assets
-    m_webServer->on("/style.css", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/style.css", HTTP_GET, [this](AsyncWebServerRequest* request) {
         if (!serveStaticFile(request, "/www/style.css")) {
             request->send(404, "text/plain", "File not found");
         }
     });
     
-    m_webServer->on("/app.js", HTTP_GET, [this](AsyncWebServerRequest* request) {
+    onTraced("/app.js", HTTP_GET, [this](AsyncWebServerRequest* request) {
         if (!serveStaticFile(request, "/www/app.js")) {
             request->send(404, "text/plain", "File not found");
         }
@@ -463,6 +596,9 @@ void WebServerComponent::handleSystemStatus(AsyncWebServerRequest* request) {
     status["rssi"] = WiFi.RSSI();
     status["components_count"] = m_orchestrator ? m_orchestrator->getComponentCount() : 0;
     status["server_requests"] = m_requestCount;
+    status["cpu"] = CpuMonitor::getSummary();
+    status["events"] = EventJournal::getStatus();
+    status["resources"] = ResourceGovernor::getStatus();
     
     String response;
     serializeJson(status, response);
@@ -593,6 +729,149 @@ void WebServerComponent::handleComponentData(AsyncWebServerRequest* request) {
     request->send(resp);
 }
 
+void WebServerComponent::handleComponentDelta(AsyncWebServerRequest* request) {
+    logRequest(request);
+    
+    if (!m_orchestrator) {
+        JsonDocument response;
+        response["success"] = false;
+        response["error"] = "Orchestrator not available";
+    
+        AsyncWebServerResponse* resp = request->beginResponse(500, "application/json", response.as<String>());
+        if (m_enableCORS) setCORSHeaders(resp);
+        request->send(resp);
+        return;
+    }
+    
+    uint32_t since = 0;
+    if (request->hasParam("since")) {
+        since = strtoul(request->getParam("since")->value().c_str(), nullptr, 10);
+    }
+    String ids = request->hasParam("ids") ? request->getParam("ids")->value() : String();
+    String fields = request->hasParam("fields") ? request->getParam("fields")->value() : String();
+    
+    // The cursor is taken before the components are visited: samples made during the
+    // walk get a higher number and are returned again on the next call, never skipped
+    uint32_t seq = m_orchestrator->getDataSeq();
+    
+    // A reader whose "since" is ahead of this node missed a restart: it must compare "boot"
+    JsonDocument delta = ComponentDataAggregator::collectDelta(m_orchestrator->getComponents(), since,
+                                                               ids, fields, this);
+    delta["node"] = WiFi.getHostname();
+    delta["boot"] = m_orchestrator->getBootId();
+    delta["seq"] = seq;
+    delta["since"] = since;
+    
+    String response;
+    serializeJson(delta, response);
+    
+    AsyncWebServerResponse* resp = request->beginResponse(200, "application/json", response);
+    if (m_enableCORS) setCORSHeaders(resp);
+    request->send(resp);
+}
+
+void WebServerComponent::handleSystemEvents(AsyncWebServerRequest* request) {
+    logRequest(request);
+    
+    EventQuery query;
+    if (request->hasParam("after")) {
+        query.after = strtoul(request->getParam("after")->value().c_str(), nullptr, 10);
+    }
+    if (request->hasParam("limit")) {
+        query.limit = (uint16_t)request->getParam("limit")->value().toInt();
+    }
+    if (request->hasParam("level")) {
+        query.minLevel = EventJournal::parseLevel(request->getParam("level")->value());
+    }
+    if (request->hasParam("type")) {
+        query.typeMask = EventJournal::parseTypes(request->getParam("type")->value());
+    }
+    if (request->hasParam("source")) {
+        query.source = request->getParam("source")->value();
+    }
+    
+    JsonDocument events = EventJournal::query(query);
+    
+    String response;
+    serializeJson(events, response);
+    
+    AsyncWebServerResponse* resp = request->beginResponse(200, "application/json", response);
+    if (m_enableCORS) setCORSHeaders(resp);
+    request->send(resp);
+}
+
+void WebServerComponent::setupEventStream() {
+    // Server-Sent Events; the event id is the journal sequence number, so a
+    // reconnecting browser resumes through its Last-Event-ID header
+    m_eventStream = new AsyncEventSource("/api/system/events/stream");
+    
+    m_eventStream->onConnect([](AsyncEventSourceClient* client) {
+        // Replay what the client missed while disconnected, within the send queue
+        const uint16_t REPLAY_LIMIT = 24;
+        uint32_t lastId = client->lastId();
+        if (ResourceGovernor::isShedding()) {
+            // No replay under pressure; the stream resumes with a resync once it is over
+            JsonDocument resync;
+            resync["after"] = lastId;
+            resync["last_seq"] = EventJournal::getLastSeq();
+            client->send(resync.as<String>().c_str(), "resync", lastId);
+            return;
+        }
+        if (lastId == 0 || lastId > EventJournal::getLastSeq()) {
+            client->send("connected", "hello", EventJournal::getLastSeq());
+            return;
+        }
+        
+        EventQuery query;
+        query.after = lastId;
+        query.limit = REPLAY_LIMIT;
+        std::vector<EventRecord> events;
+        uint32_t next = lastId;
+        EventJournal::read(query, events, next);
+        
+        if (next < EventJournal::getLastSeq()) {
+            // Too far behind: page through GET /api/system/events?after=<lastId> instead
+            JsonDocument resync;
+            resync["after"] = lastId;
+            resync["last_seq"] = EventJournal::getLastSeq();
+            client->send(resync.as<String>().c_str(), "resync", lastId);
+            return;
+        }
+        for (const EventRecord& event : events) {
+            JsonDocument doc;
+            EventJournal::toJson(event, doc.to<JsonObject>());
+            client->send(doc.as<String>().c_str(), "event", event.seq);
+        }
+    });
+    
+    m_webServer->addHandler(m_eventStream);
+    
+    // New events arrive from the main loop (EventJournal::dispatch)
+    m_eventListener = EventJournal::addListener([this](const EventRecord& event) {
+        if (!m_eventStream || m_eventStream->count() == 0) {
+            m_eventStreamPausedAfter = 0;
+            return;
+        }
+        if (ResourceGovernor::isShedding()) {
+            // Per-client send queues hold heap; clients page through the gap afterwards
+            if (m_eventStreamPausedAfter == 0) {
+                m_eventStreamPausedAfter = event.seq - 1;
+            }
+            return;
+        }
+        if (m_eventStreamPausedAfter != 0) {
+            JsonDocument resync;
+            resync["after"] = m_eventStreamPausedAfter;
+            resync["last_seq"] = EventJournal::getLastSeq();
+            m_eventStream->send(resync.as<String>().c_str(), "resync", m_eventStreamPausedAfter);
+            m_eventStreamPausedAfter = 0;
+        }
+        JsonDocument doc;
+        EventJournal::toJson(event, doc.to<JsonObject>());
+        m_eventStream->send(doc.as<String>().c_str(), "event", event.seq);
+    });
+}
+
 void WebServerComponent::handleLogs(AsyncWebServerRequest* request) {
     logRequest(request);
     
@@ -818,184 +1097,33 @@ void WebServerComponent::handleLogsPage(AsyncWebServerRequest* request) {
 }
 
 JsonDocument WebServerComponent::getAllComponentData() {
-    JsonDocument allData;
-    
-    if (m_orchestrator) {
-        JsonArray components = allData["components"].to<JsonArray>();
-        const std::vector<BaseComponent*>& componentList = m_orchestrator->getComponents();
-        
-        for (BaseComponent* component : componentList) {
-            if (component) {
-                JsonObject comp = components.add<JsonObject>();
-                comp["id"] = component->getId();
-                comp["type"] = component->getType();
-                comp["name"] = component->getName();
-                comp["state"] = component->getStateString();
-                
-                // Get component statistics with proper timestamps
-                JsonDocument stats = component->getStatistics();
-                if (!stats.isNull()) {
-                    comp["execution_count"] = stats["execution_count"] | 0;
-                    comp["error_count"] = stats["error_count"] | 0;
-                    
-                    // Convert millis() timestamps to epoch time for proper dashboard display
-                    unsigned long lastExecMs = stats["last_execution_ms"] | 0;
-                    if (lastExecMs > 0) {
-                        time_t lastExecEpoch = TimeUtils::millisToEpoch(lastExecMs);
-                        comp["last_execution_epoch"] = (long)lastExecEpoch;
-                        comp["last_execution_ms"] = lastExecMs;  // Keep for compatibility
-                    }
-                    
-                    unsigned long nextExecMs = component->getNextExecutionMs();
-                    if (nextExecMs > 0) {
-                        time_t nextExecEpoch = TimeUtils::millisToEpoch(nextExecMs);
-                        comp["next_execution_epoch"] = (long)nextExecEpoch;
-                        comp["next_execution_ms"] = nextExecMs;  // Keep for compatibility
-                    }
-                }
-                
-                // Get last error if any
-                if (!component->getLastError().isEmpty()) {
-                    comp["last_error"] = component->getLastError();
-                }
-                
-                // Get stored sensor data (non-blocking approach)
-                if (component != this) {
-                    // First try the debug string which we know gets populated
-                    const String& dataStr = component->getLastExecutionDataString();
-                    
-                    if (!dataStr.isEmpty()) {
-                        // Parse the string data
-                        JsonDocument tempDoc;
-                        DeserializationError error = deserializeJson(tempDoc, dataStr);
-                        
-                        if (error == DeserializationError::Ok && tempDoc.size() > 0) {
-                            JsonObject outputData = comp["output_data"].to<JsonObject>();
-                            
-                            // Copy all fields from the parsed data
-                            for (JsonPair kv : tempDoc.as<JsonObject>()) {
-                                outputData[kv.key().c_str()] = kv.value();
-                            }
-                            
-                            comp["has_data"] = true;
-                            comp["data_fields"] = outputData.size();
-                            log(Logger::Level::DEBUG, String("[API] Component ") + component->getId() + 
-                                " data retrieved: " + String(outputData.size()) + " fields");
-                        } else {
-                            comp["output_data"]["status"] = "Parse error";
-                            comp["has_data"] = false;
-                            log(Logger::Level::WARNING, String("[API] Failed to parse data for ") + component->getId());
-                        }
-                    } else {
-                        // No data available yet
-                        comp["output_data"]["status"] = "No data available";
-                        comp["has_data"] = false;
-                    }
-                    
-                    comp["component_uptime"] = millis();
-                    comp["ready_to_execute"] = component->isReadyToExecute();
-                }
-            }
-        }
+    if (!m_orchestrator) {
+        return JsonDocument();
     }
-    
-    return allData;
+    return ComponentDataAggregator::collect(m_orchestrator->getComponents(), this);
 }
 
 JsonDocument WebServerComponent::filterComponentData(const JsonDocument& data, DataFilterType filterType) {
-    if (filterType == FILTER_NONE) {
-        return data;  // Return data as-is
-    }
-    
-    // Create filtered document
-    JsonDocument filtered;
-    
-    // Check if input data is valid
-    if (data.isNull() || data.size() == 0) {
-        log(Logger::Level::WARNING, "[FILTER] Input data is null or empty");
-        return data;  // Return original if invalid
-    }
-    
-    // Copy top-level metadata
-    if (data["timestamp"].is<unsigned long>()) {
-        filtered["timestamp"] = data["timestamp"];
-    }
-    
-    if (data["components"].is<JsonArray>()) {
-        JsonArrayConst sourceComponents = data["components"];  // Use const reference to avoid conversion
-        JsonArray filteredComponents = filtered["components"].to<JsonArray>();
-        
-        for (JsonVariantConst comp : sourceComponents) {
-            JsonObject filteredComp = filteredComponents.add<JsonObject>();
-            
-            // Always include basic component info
-            filteredComp["id"] = comp["id"];
-            filteredComp["type"] = comp["type"];
-            filteredComp["name"] = comp["name"];
-            filteredComp["state"] = comp["state"];
-            filteredComp["has_data"] = comp["has_data"];
-            
-            if (filterType == FILTER_CORE) {
-                // CORE MODE: Only essential sensor values
-                log(Logger::DEBUG, String("[FILTER] Processing component ") + comp["id"].as<String>() + " for CORE data");
-                
-                if (comp["output_data"].is<JsonObject>()) {
-                    // Extract common sensor values directly from output_data
-                    JsonObjectConst outputData = comp["output_data"];
-                    JsonObject coreOutputData = filteredComp["output_data"].to<JsonObject>();
-                    
-                    // Core sensor values to include (expanded list)
-                    const char* coreFields[] = {
-                        "temperature", "humidity", "ph", "current_ph", "ec", "current_ec", 
-                        "tds", "current_tds", "lux", "timestamp", "success", "value", 
-                        "reading", "level", "voltage", "current", "pressure", "flow_rate",
-                        "calibrated", "is_calibrated", "healthy", "ppfd_category", "par_umol", nullptr
-                    };
-                    
-                    for (int i = 0; coreFields[i] != nullptr; i++) {
-                        if (!outputData[coreFields[i]].isNull()) {
-                            coreOutputData[coreFields[i]] = outputData[coreFields[i]];
-                        }
-                    }
-                    
-                    // If no core fields were found, include basic status info
-                    if (coreOutputData.size() == 0) {
-                        if (!outputData["timestamp"].isNull()) {
-                            coreOutputData["timestamp"] = outputData["timestamp"];
-                        }
-                        if (!outputData["success"].isNull()) {
-                            coreOutputData["success"] = outputData["success"];
-                        }
-                    }
-                }
-                
-                // Include minimal execution info
-                if (!comp["execution_count"].isNull()) {
-                    filteredComp["executions"] = comp["execution_count"];
-                }
-                
-            } else if (filterType == FILTER_DIAGNOSTICS) {
-                // DIAGNOSTICS MODE: All data including debug info
-                log(Logger::DEBUG, String("[FILTER] Processing component ") + comp["id"].as<String>() + " for DIAGNOSTICS data");
-                
-                // Copy all fields
-                for (JsonPairConst kv : comp.as<JsonObjectConst>()) {
-                    if (strcmp(kv.key().c_str(), "id") != 0 && 
-                        strcmp(kv.key().c_str(), "type") != 0 &&
-                        strcmp(kv.key().c_str(), "name") != 0 &&
-                        strcmp(kv.key().c_str(), "state") != 0 &&
-                        strcmp(kv.key().c_str(), "has_data") != 0) {
-                        filteredComp[kv.key().c_str()] = kv.value();
-                    }
-                }
+    return ComponentDataAggregator::filter(data, filterType);
+}
+
+String WebServerComponent::findPinOwner(int pin) const {
+    if (!m_orchestrator) {
+        return "";
+    }
+    // Pin settings are top-level integer keys named *pin* (pin, gpio_pin, pump_pin, sdaPin, ...)
+    for (BaseComponent* component : m_orchestrator->getComponents()) {
+        if (!component) continue;
+        JsonDocument config = component->getConfigurationAsJson();
+        for (JsonPairConst kv : config.as<JsonObjectConst>()) {
+            String key = kv.key().c_str();
+            key.toLowerCase();
+            if (key.indexOf("pin") >= 0 && kv.value().is<int>() && kv.value().as<int>() == pin) {
+                return component->getId();
             }
         }
     }
-    
-    log(Logger::DEBUG, String("[FILTER] Filtering complete - original: ") + 
-        String(data.size()) + " bytes, filtered: " + String(filtered.size()) + " bytes");
-    
-    return filtered;
+    return "";
 }
 
 void WebServerComponent::handleComponentsDebug(AsyncWebServerRequest* request) {
@@ -1016,7 +1144,7 @@ void WebServerComponent::handleComponentsDebug(AsyncWebServerRequest* request) {
                 comp["state"] = component->getStateString();
                 
                 // Test getLastExecutionData directly
-                const JsonDocument& lastData = component->getLastExecutionData();
+                JsonDocument lastData = component->getLastExecutionData();
                 comp["has_last_data"] = !lastData.isNull();
                 comp["last_data_size"] = lastData.size();
                 
@@ -1237,8 +1365,20 @@ void WebServerComponent::handleComponentsMqtt(AsyncWebServerRequest* request) {
     JsonArray components = data["components"].to<JsonArray>();
     
     if (m_orchestrator) {
-        // This would need orchestrator support to get MQTT timestamps
-        // For now, return basic component info
+#if COMPONENT_MQTT_BROADCAST
+        // Publish bookkeeping comes from the MQTT broadcast component, if one is configured
+        const MqttBroadcastComponent* mqtt = nullptr;
+        for (BaseComponent* candidate : m_orchestrator->getComponents()) {
+            if (candidate && candidate->getType() == "MqttBroadcast") {
+                mqtt = static_cast<const MqttBroadcastComponent*>(candidate);
+                break;
+            }
+        }
+        if (mqtt) {
+            data["mqtt"] = mqtt->getPublisherStats();
+        }
+#endif
+        
         JsonDocument allData = getAllComponentData();
         
         if (allData["components"].is<JsonArray>()) {
@@ -1278,13 +1418,20 @@ void WebServerComponent::handleComponentsMqtt(AsyncWebServerRequest* request) {
                     component["execution_time_ms"] = comp["execution_time_ms"];
                 }
                 
-                // Add MQTT information (for now using calculated values)
-                unsigned long mqttMillis = millis() - random(5000, 60000);
-                time_t mqttEpoch = TimeUtils::millisToEpoch(mqttMillis);
-                component["last_mqtt_publish_epoch"] = (long)mqttEpoch;
-                component["last_mqtt_publish"] = mqttMillis;  // Keep for compatibility
-                component["mqtt_topic"] = String("/EspOrch/") + comp["id"].as<String>();
-                component["mqtt_data_size"] = random(100, 500);
+                // Add MQTT information (null until the reading was part of a batch)
+                const MqttPublishInfo* info = mqtt ? mqtt->getPublishInfo(comp["id"].as<String>()) : nullptr;
+                if (info) {
+                    component["last_mqtt_publish_epoch"] = (long)TimeUtils::millisToEpoch(info->lastPublishMs);
+                    component["last_mqtt_publish"] = info->lastPublishMs;  // Keep for compatibility
+                    component["mqtt_topic"] = mqtt->getBatchTopic();
+                    component["mqtt_data_size"] = info->lastDataSize;
+                    component["mqtt_publish_count"] = info->publishCount;
+                } else {
+                    component["last_mqtt_publish_epoch"] = nullptr;
+                    component["last_mqtt_publish"] = nullptr;
+                    component["mqtt_topic"] = mqtt ? mqtt->getBatchTopic() : "";
+                    component["mqtt_data_size"] = 0;
+                }
             }
         }
     }
@@ -1475,9 +1622,9 @@ void WebServerComponent::handleDashboardPage(AsyncWebServerRequest* request) {
                         let timeSince;
                         if (comp.last_mqtt_publish_epoch && comp.last_mqtt_publish_epoch > 0) {
                             timeSince = Math.floor((Date.now() / 1000) - comp.last_mqtt_publish_epoch);
-                        } else {
+                        } else if (comp.last_mqtt_publish !== null && comp.last_mqtt_publish !== undefined) {
                             // Fallback to boot time calculation
-                            timeSince = Math.floor((Date.now() - comp.last_mqtt_publish) / 1000);
+                            timeSince = Math.floor((data.timestamp - comp.last_mqtt_publish) / 1000);
                         }
                         html += `
                             <div class="component-card">
@@ -1622,7 +1769,7 @@ void WebServerComponent::handleDashboardPage(AsyncWebServerRequest* request) {
                                 <div class="mqtt-info">
                                     <div class="mqtt-topic"><code>${comp.mqtt_topic}</code></div>
                                     <div class="mqtt-meta">
-                                        <span class="mqtt-time">${timeSince}s ago</span>
+                                        <span class="mqtt-time">${timeSince === undefined ? 'not published' : timeSince + 's ago'}</span>
                                         <span class="mqtt-size">${comp.mqtt_data_size}b</span>
                                     </div>
                                 </div>
@@ -1850,6 +1997,15 @@ void WebServerComponent::handleComponentConfig(AsyncWebServerRequest* request) {
     configData["device_ip"] = deviceIP;
     
     // Apply configuration to component using new architecture
+    SchemaError schemaError;
+    if (!component->validateConfiguration(configData, true, &schemaError)) {
+        response["success"] = false;
+        response["error"] = String(schemaError.field) + " " + schemaError.message;
+        response["field"] = schemaError.field;
+        request->send(400, "application/json", response.as<String>());
+        return;
+    }
+    
     if (component->applyConfigurationFromJson(configData)) {
         // Save the configuration to persistent storage
         if (component->saveCurrentConfiguration()) {
@@ -2042,10 +2198,29 @@ void WebServerComponent::handleGenericComponentConfigUpdate(AsyncWebServerReques
             return;
         }
     } else {
-        // Fall back to URL parameters for simple updates
+        // Fall back to URL parameters for simple updates; they arrive as text,
+        // so numbers and booleans are typed before schema validation
         for (int i = 0; i < request->params(); i++) {
             const AsyncWebParameter* param = request->getParam(i);
-            configUpdates[param->name()] = param->value();
+            const String& value = param->value();
+            char* end = nullptr;
+            if (value == "true" || value == "false") {
+                configUpdates[param->name()] = (value == "true");
+                continue;
+            }
+            if (!value.isEmpty() && (isdigit((unsigned char)value[0]) || value[0] == '-')) {
+                long integer = strtol(value.c_str(), &end, 10);
+                if (*end == '\0') {
+                    configUpdates[param->name()] = integer;
+                    continue;
+                }
+                double number = strtod(value.c_str(), &end);
+                if (*end == '\0') {
+                    configUpdates[param->name()] = number;
+                    continue;
+                }
+            }
+            configUpdates[param->name()] = value;
         }
     }
     
@@ -2056,6 +2231,16 @@ void WebServerComponent::handleGenericComponentConfigUpdate(AsyncWebServerReques
         return;
     }
     
+    // Reject out-of-schema values before anything is applied or saved
+    SchemaError schemaError;
+    if (!component->validateConfiguration(configUpdates, true, &schemaError)) {
+        response["success"] = false;
+        response["error"] = String(schemaError.field) + " " + schemaError.message;
+        response["field"] = schemaError.field;
+        request->send(400, "application/json", response.as<String>());
+        return;
+    }
+    
     // Apply configuration using virtual method
     if (component->applyConfigurationFromJson(configUpdates)) {
         if (component->saveCurrentConfiguration()) {
@@ -2094,7 +2279,7 @@ void WebServerComponent::handleComponentAdd(AsyncWebServerRequest* request) {
         response["error"] = "Component ID parameter missing. Required format: ?id=your-component-id&ComponentTypeID=TSL2561";
         response["expected_parameters"] = JsonArray();
         response["expected_parameters"][0] = "id (required): Unique component identifier";
-        response["expected_parameters"][1] = "ComponentTypeID (required): TSL2561, DHT22, or PeristalticPump";
+        response["expected_parameters"][1] = "ComponentTypeID (required): a type from GET /api/components/types";
         response["expected_parameters"][2] = "remote_ip (optional): Target IP for remote sensors";
         request->send(400, "application/json", response.as<String>());
         return;
@@ -2104,10 +2289,10 @@ void WebServerComponent::handleComponentAdd(AsyncWebServerRequest* request) {
     if (!request->hasParam("ComponentTypeID")) {
         response["success"] = false;
         response["error"] = "ComponentTypeID parameter missing. Required format: ?id=your-component-id&ComponentTypeID=TSL2561";
-        response["supported_types"] = JsonArray();
-        response["supported_types"][0] = "TSL2561 (Light sensor)";
-        response["supported_types"][1] = "DHT22 (Temperature/Humidity sensor)";
-        response["supported_types"][2] = "PeristalticPump (Pump control)";
+        JsonArray supported = response["supported_types"].to<JsonArray>();
+        for (const ComponentRegistry::Entry* entry = ComponentRegistry::first(); entry; entry = entry->next) {
+            supported.add(entry->typeName);
+        }
         request->send(400, "application/json", response.as<String>());
         return;
     }
@@ -2130,29 +2315,22 @@ void WebServerComponent::handleComponentAdd(AsyncWebServerRequest* request) {
     }
     
     // Step 2: Create component instance based on type
-    BaseComponent* newComponent = nullptr;
-    String componentName = componentId; // Default name, can be overridden
-    
-    if (componentType == "TSL2561" || componentType == "LightSensor") {
-        newComponent = new TSL2561Component(componentId, componentName, m_storage, m_orchestrator);
-    }
-    else if (componentType == "DHT22" || componentType == "TemperatureSensor") {
-        newComponent = new DHT22Component(componentId, componentName, m_storage, m_orchestrator);
-    }
-    else if (componentType == "PeristalticPump" || componentType == "Pump") {
-        newComponent = new PeristalticPumpComponent(componentId, componentName, m_storage, m_orchestrator);
-    }
-    else {
+    const ComponentRegistry::Entry* typeEntry = ComponentRegistry::find(componentType);
+    if (!typeEntry) {
         response["success"] = false;
         response["error"] = "Unsupported component type: " + componentType;
-        response["supported_types"] = JsonArray();
-        response["supported_types"][0] = "TSL2561";
-        response["supported_types"][1] = "DHT22"; 
-        response["supported_types"][2] = "PeristalticPump";
+        JsonArray supported = response["supported_types"].to<JsonArray>();
+        for (const ComponentRegistry::Entry* entry = ComponentRegistry::first(); entry; entry = entry->next) {
+            supported.add(entry->typeName);
+        }
         request->send(400, "application/json", response.as<String>());
         return;
     }
     
+    componentType = typeEntry->typeName;   // Store the canonical name, not an alias
+    String componentName = componentId; // Default name, can be overridden
+    BaseComponent* newComponent = typeEntry->factory(componentId, componentName, m_storage, m_orchestrator);
+    
     if (!newComponent) {
         response["success"] = false;
         response["error"] = "Failed to create component instance";
@@ -2167,7 +2345,7 @@ void WebServerComponent::handleComponentAdd(AsyncWebServerRequest* request) {
     defaultConfig["component_type"] = componentType;
     
     // Set component-specific defaults based on type
-    if (componentType == "TSL2561" || componentType == "LightSensor") {
+    if (componentType == "TSL2561") {
         // TSL2561 defaults - minimal configuration for remote sensor
         defaultConfig["useRemoteSensor"] = true;
         defaultConfig["remoteHost"] = "192.168.1.150";  // Default remote host
@@ -2180,11 +2358,11 @@ void WebServerComponent::handleComponentAdd(AsyncWebServerRequest* request) {
         if (request->hasParam("remote_ip")) {
             defaultConfig["remoteHost"] = request->getParam("remote_ip")->value();
         }
-    } else if (componentType == "DHT22" || componentType == "TemperatureSensor") {
+    } else if (componentType == "DHT22") {
         // DHT22 defaults
         defaultConfig["pin"] = 2;
         defaultConfig["samplingIntervalMs"] = 5000;
-    } else if (componentType == "PeristalticPump" || componentType == "Pump") {
+    } else if (componentType == "PeristalticPump") {
         // Pump defaults
         defaultConfig["pumpPin"] = 26;
         defaultConfig["mlPerSecond"] = 40.0;
@@ -2540,9 +2718,21 @@ void WebServerComponent::handleComponentActionExecute(AsyncWebServerRequest* req
                       " - " + (result.success ? "SUCCESS" : "FAILED"));
 }
 
+void WebServerComponent::onNetworkChange(bool connected) {
+    if (connected && m_webServer) {
+        log(Logger::INFO, String("🌐 Server URL: http://") + WiFi.localIP().toString() + ":" + m_serverPort + "/");
+    }
+}
+
 void WebServerComponent::cleanup() {
     log(Logger::DEBUG, "Cleaning up web server component");
     
+    if (m_eventListener) {
+        EventJournal::removeListener(m_eventListener);
+        m_eventListener = 0;
+    }
+    m_eventStream = nullptr;   // Deleted with the server's handlers
+    
     if (m_webServer) {
         m_webServer->end();
         delete m_webServer;
@@ -2779,7 +2969,7 @@ void WebServerComponent::handleWebServerTimingDebug(AsyncWebServerRequest* reque
     response["is_ready_to_execute"] = isReadyToExecute();
     response["never_executed"] = (m_executionCount == 0);
     response["state_ready"] = (getState() == ComponentState::READY);
-    response["time_ready"] = (currentTime >= nextExecTime);
+    response["time_ready"] = (TimeUtils::monoNowUs() >= getNextExecutionUs());
     
     // DEBUG: Add detailed timing breakdown
     response["debug_current_time"] = currentTime;
@@ -2797,3 +2987,271 @@ void WebServerComponent::handleWebServerTimingDebug(AsyncWebServerRequest* reque
     if (m_enableCORS) setCORSHeaders(resp);
     request->send(resp);
 }
+
+void WebServerComponent::handleDebugBenchStart(AsyncWebServerRequest* request) {
+    logRequest(request);
+    
+    JsonDocument response;
+    int status = 202;
+    
+    if (!m_enableDebugBench) {
+        status = 403;
+        response["success"] = false;
+        response["error"] = "Self-benchmark disabled (set enableDebugBench in the web server config)";
+    } else if (DeviceBenchmark::isRunning()) {
+        status = 409;
+        response["success"] = false;
+        response["error"] = "Self-benchmark already running";
+    } else {
+        DeviceBenchmarkOptions options;
+        
+        // Optional overrides, clamped so a run stays in the seconds range
+        if (request->hasParam("fs_kb")) {
+            options.fsBytes = constrain(request->getParam("fs_kb")->value().toInt(), 4, 256) * 1024;
+        }
+        if (request->hasParam("iterations")) {
+            options.jsonIterations = constrain(request->getParam("iterations")->value().toInt(), 1, 500);
+        }
+        if (request->hasParam("adc_pin")) {
+            // Sampling reconfigures the pin, so only free ADC1 input-only pins
+            int pin = request->getParam("adc_pin")->value().toInt();
+            String owner = DeviceBenchmark::isSafeAdcPin(pin) ? findPinOwner(pin) : String("");
+            if (!DeviceBenchmark::isSafeAdcPin(pin)) {
+                status = 400;
+                response["error"] = "adc_pin must be an ADC1 input-only pin (36-39)";
+            } else if (owner.length() > 0) {
+                status = 400;
+                response["error"] = String("adc_pin ") + pin + " is in use by " + owner;
+            } else {
+                options.adcPin = pin;
+            }
+        }
+        if (request->hasParam("adc_samples")) {
+            options.adcSamples = constrain(request->getParam("adc_samples")->value().toInt(), 10, 10000);
+        }
+        if (request->hasParam("skip")) {
+            String skip = request->getParam("skip")->value();
+            options.filesystem = skip.indexOf("fs") < 0;
+            options.json = skip.indexOf("json") < 0;
+            options.i2c = skip.indexOf("i2c") < 0;
+            options.adc = skip.indexOf("adc") < 0;
+            options.tick = skip.indexOf("tick") < 0;
+            options.isr = skip.indexOf("isr") < 0;
+        }
+        
+        // Representative document: what GET /api/components/data serves right now
+        if (options.json && status != 400) {
+            serializeJson(getAllComponentData(), options.sampleJson);
+        }
+        
+        if (status == 400) {
+            response["success"] = false;
+        } else if (DeviceBenchmark::start(options)) {
+            response["success"] = true;
+            response["status"] = "running";
+            response["message"] = "Poll GET /api/debug/bench for the report";
+        } else {
+            status = 500;
+            response["success"] = false;
+            response["error"] = "Failed to start self-benchmark";
+        }
+    }
+    
+    String responseStr;
+    serializeJson(response, responseStr);
+    
+    AsyncWebServerResponse* resp = request->beginResponse(status, "application/json", responseStr);
+    if (m_enableCORS) setCORSHeaders(resp);
+    request->send(resp);
+}
+
+void WebServerComponent::handleDebugBenchReport(AsyncWebServerRequest* request) {
+    logRequest(request);
+    
+    JsonDocument report = DeviceBenchmark::getReport();
+    report["enabled"] = m_enableDebugBench;
+    
+    // Main-loop pass cost as measured by the orchestrator itself
+    if (m_orchestrator) {
+        report["loop"] = m_orchestrator->getSystemStats()["loop"];
+    }
+    
+    String responseStr;
+    serializeJson(report, responseStr);
+    
+    AsyncWebServerResponse* resp = request->beginResponse(200, "application/json", responseStr);
+    if (m_enableCORS) setCORSHeaders(resp);
+    request->send(resp);
+}
+
+void WebServerComponent::handleTraceStart(AsyncWebServerRequest* request) {
+    logRequest(request);
+    
+    uint16_t events = Tracer::DEFAULT_EVENTS;
+    if (request->hasParam("events")) {
+        events = constrain(request->getParam("events")->value().toInt(), 64, (long)Tracer::MAX_EVENTS);
+    }
+    uint32_t categories = Tracer::ALL_CATEGORIES;
+    if (request->hasParam("categories")) {
+        categories = Tracer::parseCategories(request->getParam("categories")->value());
+    }
+    
+    JsonDocument response;
+    int status = 200;
+    if (Tracer::start(events, categories)) {
+        response["success"] = true;
+        response["trace"] = Tracer::getStatus();
+    } else {
+        status = 503;
+        response["success"] = false;
+        response["error"] = "Cannot start tracing (dump in progress or not enough heap)";
+    }
+    
+    String responseStr;
+    serializeJson(response, responseStr);
+    
+    AsyncWebServerResponse* resp = request->beginResponse(status, "application/json", responseStr);
+    if (m_enableCORS) setCORSHeaders(resp);
+    request->send(resp);
+}
+
+void WebServerComponent::handleTraceStop(AsyncWebServerRequest* request) {
+    logRequest(request);
+    
+    Tracer::stop();
+    
+    JsonDocument response;
+    response["success"] = true;
+    response["trace"] = Tracer::getStatus();
+    
+    String responseStr;
+    serializeJson(response, responseStr);
+    
+    AsyncWebServerResponse* resp = request->beginResponse(200, "application/json", responseStr);
+    if (m_enableCORS) setCORSHeaders(resp);
+    request->send(resp);
+}
+
+void WebServerComponent::handleTraceStatus(AsyncWebServerRequest* request) {
+    logRequest(request);
+    
+    String responseStr;
+    serializeJson(Tracer::getStatus(), responseStr);
+    
+    AsyncWebServerResponse* resp = request->beginResponse(200, "application/json", responseStr);
+    if (m_enableCORS) setCORSHeaders(resp);
+    request->send(resp);
+}
+
+void WebServerComponent::handleTraceDump(AsyncWebServerRequest* request) {
+    logRequest(request);
+    
+    // Streamed in chunks: a full ring is far larger than a String we could afford
+    std::shared_ptr<Tracer::DumpCursor> cursor = std::make_shared<Tracer::DumpCursor>();
+    if (!Tracer::beginDump(*cursor)) {
+        request->send(409, "application/json", "{\"success\":false,\"error\":\"Trace dump already in progress\"}");
+        return;
+    }
+    
+    AsyncWebServerResponse* resp = request->beginChunkedResponse("application/json",
+        [cursor](uint8_t* buffer, size_t maxLen, size_t /*index*/) -> size_t {
+            size_t written = Tracer::write(*cursor, (char*)buffer, maxLen);
+            if (written == 0) {
+                Tracer::endDump(*cursor);
+            }
+            return written;
+        });
+    resp->addHeader("Content-Disposition", "attachment; filename=\"trace.json\"");
+    if (m_enableCORS) setCORSHeaders(resp);
+    
+    // Resume recording even if the client goes away mid-dump
+    request->onDisconnect([cursor]() {
+        if (cursor->stage != 4) {
+            Tracer::endDump(*cursor);
+        }
+    });
+    request->send(resp);
+}
+
+void WebServerComponent::handleProfileStart(AsyncWebServerRequest* request) {
+    logRequest(request);
+    
+    uint16_t hz = SamplingProfiler::DEFAULT_HZ;
+    if (request->hasParam("hz")) {
+        hz = constrain(request->getParam("hz")->value().toInt(), 100, (long)SamplingProfiler::MAX_HZ);
+    }
+    bool loopTaskOnly = !(request->hasParam("mode") && request->getParam("mode")->value() == "all");
+    uint8_t core = request->hasParam("core") ? request->getParam("core")->value().toInt() : 1;
+    uint16_t buckets = SamplingProfiler::DEFAULT_BUCKETS;
+    if (request->hasParam("buckets")) {
+        buckets = constrain(request->getParam("buckets")->value().toInt(), 64, (long)SamplingProfiler::MAX_BUCKETS);
+    }
+    
+    JsonDocument response;
+    int status = 200;
+    if (SamplingProfiler::isRunning()) {
+        status = 409;
+        response["success"] = false;
+        response["error"] = "Profiler already running";
+    } else if (SamplingProfiler::start(hz, loopTaskOnly, core, buckets)) {
+        response["success"] = true;
+        response["profile"] = SamplingProfiler::getStatus();
+    } else {
+        status = 503;
+        response["success"] = false;
+        response["error"] = SamplingProfiler::isSupported() ? "Cannot start profiler" : "Profiling not supported on this target";
+    }
+    
+    String responseStr;
+    serializeJson(response, responseStr);
+    
+    AsyncWebServerResponse* resp = request->beginResponse(status, "application/json", responseStr);
+    if (m_enableCORS) setCORSHeaders(resp);
+    request->send(resp);
+}
+
+void WebServerComponent::handleProfileStop(AsyncWebServerRequest* request) {
+    logRequest(request);
+    
+    SamplingProfiler::stop();
+    
+    JsonDocument response;
+    response["success"] = true;
+    response["profile"] = SamplingProfiler::getStatus();
+    
+    String responseStr;
+    serializeJson(response, responseStr);
+    
+    AsyncWebServerResponse* resp = request->beginResponse(200, "application/json", responseStr);
+    if (m_enableCORS) setCORSHeaders(resp);
+    request->send(resp);
+}
+
+void WebServerComponent::handleProfileStatus(AsyncWebServerRequest* request) {
+    logRequest(request);
+    
+    String responseStr;
+    serializeJson(SamplingProfiler::getStatus(), responseStr);
+    
+    AsyncWebServerResponse* resp = request->beginResponse(200, "application/json", responseStr);
+    if (m_enableCORS) setCORSHeaders(resp);
+    request->send(resp);
+}
+
+void WebServerComponent::handleProfileDump(AsyncWebServerRequest* request) {
+    logRequest(request);
+    
+    // Raw addresses; scripts/symbolize_profile.py resolves them against firmware.elf
+    std::shared_ptr<SamplingProfiler::DumpCursor> cursor = std::make_shared<SamplingProfiler::DumpCursor>();
+    AsyncWebServerResponse* resp = request->beginChunkedResponse("text/plain",
+        [cursor](uint8_t* buffer, size_t maxLen, size_t /*index*/) -> size_t {
+            return SamplingProfiler::write(*cursor, (char*)buffer, maxLen);
+        });
+    resp->addHeader("Content-Disposition", "attachment; filename=\"profile.txt\"");
+    if (m_enableCORS) setCORSHeaders(resp);
+    request->send(resp);
+}
+
+REGISTER_COMPONENT_TYPE(WebServerComponent, "WebServer", nullptr)
+
+#endif // COMPONENT_WEB_SERVER
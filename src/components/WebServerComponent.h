@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BaseComponent.h"
+#include "../core/ComponentDataAggregator.h"
 #include <ESPAsyncWebServer.h>
 #include <LittleFS.h>
 
@@ -34,6 +35,12 @@ public:
     bool initialize(const JsonDocument& config) override;
     ExecutionResult execute() override;
     void cleanup() override;
+    
+    /**
+     * @brief Log the reachable URL whenever the link comes up
+     * @param connected New link state
+     */
+    void onNetworkChange(bool connected) override;
 
 protected:
     // === Configuration Management (BaseComponent virtual methods) ===
@@ -56,9 +63,13 @@ private:
     uint16_t m_serverPort = 80;              // HTTP server port
     bool m_enableCORS = true;                // Enable CORS headers
     String m_serverName = "ESP32-Orchestrator"; // Server name header
+    bool m_enableDebugBench = false;         // Allow /api/debug/bench runs
     
     // Web server
     AsyncWebServer* m_webServer = nullptr;
+    AsyncEventSource* m_eventStream = nullptr;   // Owned by m_webServer
+    int m_eventListener = 0;                     // EventJournal listener handle
+    uint32_t m_eventStreamPausedAfter = 0;       // Last event pushed before shedding paused the stream, 0 = live
     
     // Server state
     bool m_serverRunning = false;
@@ -70,11 +81,14 @@ private:
     void setupRoutes();
     void setupAPIEndpoints();
     void setupWebPages();
+    void setupEventStream();
     
     // API endpoint handlers
     void handleSystemStatus(AsyncWebServerRequest* request);
     void handleSystemRestart(AsyncWebServerRequest* request);
     void handleComponentData(AsyncWebServerRequest* request);
+    void handleComponentDelta(AsyncWebServerRequest* request);
+    void handleSystemEvents(AsyncWebServerRequest* request);
     void handleComponentList(AsyncWebServerRequest* request);
     void handleLogs(AsyncWebServerRequest* request);
     void handleLogFile(AsyncWebServerRequest* request);
@@ -102,6 +116,16 @@ private:
     void handleExecutionLoopConfig(AsyncWebServerRequest* request);
     void handleExecutionLoopConfigUpdate(AsyncWebServerRequest* request);
     void handleWebServerTimingDebug(AsyncWebServerRequest* request);
+    void handleDebugBenchStart(AsyncWebServerRequest* request);
+    void handleDebugBenchReport(AsyncWebServerRequest* request);
+    void handleTraceStart(AsyncWebServerRequest* request);
+    void handleTraceStop(AsyncWebServerRequest* request);
+    void handleTraceStatus(AsyncWebServerRequest* request);
+    void handleTraceDump(AsyncWebServerRequest* request);
+    void handleProfileStart(AsyncWebServerRequest* request);
+    void handleProfileStop(AsyncWebServerRequest* request);
+    void handleProfileStatus(AsyncWebServerRequest* request);
+    void handleProfileDump(AsyncWebServerRequest* request);
     
     // Web page handlers  
     void handleHomePage(AsyncWebServerRequest* request);
@@ -109,19 +133,15 @@ private:
     void handleLogsPage(AsyncWebServerRequest* request);
     void handleDashboardPage(AsyncWebServerRequest* request);
     
-    // Data filtering options
-    enum DataFilterType {
-        FILTER_NONE,         // All data (default)
-        FILTER_CORE,         // Core sensor values only
-        FILTER_DIAGNOSTICS   // Full diagnostic data
-    };
-    
     // Utility methods
+    void onTraced(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction handler);
+    void sendShedResponse(AsyncWebServerRequest* request);
     String getContentType(const String& filename);
     void setCORSHeaders(AsyncWebServerResponse* response);
     void logRequest(AsyncWebServerRequest* request);
     JsonDocument getAllComponentData();
     JsonDocument filterComponentData(const JsonDocument& data, DataFilterType filterType);
+    String findPinOwner(int pin) const;
     bool serveStaticFile(AsyncWebServerRequest* request, const String& path);
 
     // === Action System (BaseComponent virtual methods) ===
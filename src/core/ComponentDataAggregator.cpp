@@ -0,0 +1,257 @@
+/**
+ * @file ComponentDataAggregator.cpp
+ * @brief ComponentDataAggregator implementation
+ */
+
+#include "ComponentDataAggregator.h"
+#include "../components/BaseComponent.h"
+#include "../utils/Logger.h"
+#include "../utils/TimeUtils.h"
+
+namespace {
+// Exact match of an item in a comma-separated list
+bool listContains(const String& list, const char* item, size_t length) {
+    int start = 0;
+    while (start <= (int)list.length()) {
+        int end = list.indexOf(',', start);
+        if (end < 0) end = list.length();
+        if ((size_t)(end - start) == length && strncmp(list.c_str() + start, item, length) == 0) {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+}
+
+JsonDocument ComponentDataAggregator::collect(const std::vector<BaseComponent*>& components, const BaseComponent* self) {
+    JsonDocument allData;
+    
+    JsonArray componentArray = allData["components"].to<JsonArray>();
+    
+    for (BaseComponent* component : components) {
+        if (component) {
+            JsonObject comp = componentArray.add<JsonObject>();
+            comp["id"] = component->getId();
+            comp["type"] = component->getType();
+            comp["name"] = component->getName();
+            comp["state"] = component->getStateString();
+            
+            // Get component statistics with proper timestamps
+            JsonDocument stats = component->getStatistics();
+            if (!stats.isNull()) {
+                comp["execution_count"] = stats["execution_count"] | 0;
+                comp["error_count"] = stats["error_count"] | 0;
+                
+                // Convert millis() timestamps to epoch time for proper dashboard display
+                unsigned long lastExecMs = stats["last_execution_ms"] | 0;
+                if (lastExecMs > 0) {
+                    time_t lastExecEpoch = TimeUtils::millisToEpoch(lastExecMs);
+                    comp["last_execution_epoch"] = (long)lastExecEpoch;
+                    comp["last_execution_ms"] = lastExecMs;  // Keep for compatibility
+                }
+                
+                unsigned long nextExecMs = component->getNextExecutionMs();
+                if (nextExecMs > 0) {
+                    time_t nextExecEpoch = TimeUtils::millisToEpoch(nextExecMs);
+                    comp["next_execution_epoch"] = (long)nextExecEpoch;
+                    comp["next_execution_ms"] = nextExecMs;  // Keep for compatibility
+                }
+            }
+            
+            // Get last error if any
+            if (!component->getLastError().isEmpty()) {
+                comp["last_error"] = component->getLastError();
+            }
+            
+            // Get stored sensor data (non-blocking approach)
+            if (component != self) {
+                // First try the debug string which we know gets populated
+                const String& dataStr = component->getLastExecutionDataString();
+                
+                if (!dataStr.isEmpty()) {
+                    // Parse the string data
+                    JsonDocument tempDoc;
+                    DeserializationError error = deserializeJson(tempDoc, dataStr);
+                    
+                    if (error == DeserializationError::Ok && tempDoc.size() > 0) {
+                        JsonObject outputData = comp["output_data"].to<JsonObject>();
+                        
+                        // Copy all fields from the parsed data
+                        for (JsonPair kv : tempDoc.as<JsonObject>()) {
+                            outputData[kv.key().c_str()] = kv.value();
+                        }
+                        
+                        comp["has_data"] = true;
+                        comp["data_fields"] = outputData.size();
+                        Logger::debug("ComponentData", String("[API] Component ") + component->getId() + 
+                            " data retrieved: " + String(outputData.size()) + " fields");
+                    } else {
+                        comp["output_data"]["status"] = "Parse error";
+                        comp["has_data"] = false;
+                        Logger::warning("ComponentData", String("[API] Failed to parse data for ") + component->getId());
+                    }
+                } else {
+                    // No data available yet
+                    comp["output_data"]["status"] = "No data available";
+                    comp["has_data"] = false;
+                }
+                
+                comp["component_uptime"] = millis();
+                comp["ready_to_execute"] = component->isReadyToExecute();
+            }
+        }
+    }
+    
+    return allData;
+}
+
+JsonDocument ComponentDataAggregator::filter(const JsonDocument& data, DataFilterType filterType) {
+    if (filterType == FILTER_NONE) {
+        return data;  // Return data as-is
+    }
+    
+    // Create filtered document
+    JsonDocument filtered;
+    
+    // Check if input data is valid
+    if (data.isNull() || data.size() == 0) {
+        Logger::warning("ComponentData", "[FILTER] Input data is null or empty");
+        return data;  // Return original if invalid
+    }
+    
+    // Copy top-level metadata
+    if (data["timestamp"].is<unsigned long>()) {
+        filtered["timestamp"] = data["timestamp"];
+    }
+    
+    if (data["components"].is<JsonArray>()) {
+        JsonArrayConst sourceComponents = data["components"];  // Use const reference to avoid conversion
+        JsonArray filteredComponents = filtered["components"].to<JsonArray>();
+        
+        for (JsonVariantConst comp : sourceComponents) {
+            JsonObject filteredComp = filteredComponents.add<JsonObject>();
+            
+            // Always include basic component info
+            filteredComp["id"] = comp["id"];
+            filteredComp["type"] = comp["type"];
+            filteredComp["name"] = comp["name"];
+            filteredComp["state"] = comp["state"];
+            filteredComp["has_data"] = comp["has_data"];
+            
+            if (filterType == FILTER_CORE) {
+                // CORE MODE: Only essential sensor values
+                Logger::debug("ComponentData", String("[FILTER] Processing component ") + comp["id"].as<String>() + " for CORE data");
+                
+                if (comp["output_data"].is<JsonObject>()) {
+                    // Extract common sensor values directly from output_data
+                    JsonObjectConst outputData = comp["output_data"];
+                    JsonObject coreOutputData = filteredComp["output_data"].to<JsonObject>();
+                    
+                    // Core sensor values to include (expanded list)
+                    const char* coreFields[] = {
+                        "temperature", "humidity", "ph", "current_ph", "ec", "current_ec", 
+                        "tds", "current_tds", "lux", "timestamp", "success", "value", 
+                        "reading", "level", "voltage", "current", "pressure", "flow_rate",
+                        "calibrated", "is_calibrated", "healthy", "ppfd_category", "par_umol", nullptr
+                    };
+                    
+                    for (int i = 0; coreFields[i] != nullptr; i++) {
+                        if (!outputData[coreFields[i]].isNull()) {
+                            coreOutputData[coreFields[i]] = outputData[coreFields[i]];
+                        }
+                    }
+                    
+                    // If no core fields were found, include basic status info
+                    if (coreOutputData.size() == 0) {
+                        if (!outputData["timestamp"].isNull()) {
+                            coreOutputData["timestamp"] = outputData["timestamp"];
+                        }
+                        if (!outputData["success"].isNull()) {
+                            coreOutputData["success"] = outputData["success"];
+                        }
+                    }
+                }
+                
+                // Include minimal execution info
+                if (!comp["execution_count"].isNull()) {
+                    filteredComp["executions"] = comp["execution_count"];
+                }
+                
+            } else if (filterType == FILTER_DIAGNOSTICS) {
+                // DIAGNOSTICS MODE: All data including debug info
+                Logger::debug("ComponentData", String("[FILTER] Processing component ") + comp["id"].as<String>() + " for DIAGNOSTICS data");
+                
+                // Copy all fields
+                for (JsonPairConst kv : comp.as<JsonObjectConst>()) {
+                    if (strcmp(kv.key().c_str(), "id") != 0 && 
+                        strcmp(kv.key().c_str(), "type") != 0 &&
+                        strcmp(kv.key().c_str(), "name") != 0 &&
+                        strcmp(kv.key().c_str(), "state") != 0 &&
+                        strcmp(kv.key().c_str(), "has_data") != 0) {
+                        filteredComp[kv.key().c_str()] = kv.value();
+                    }
+                }
+            }
+        }
+    }
+    
+    Logger::debug("ComponentData", String("[FILTER] Filtering complete - original: ") + 
+        String(data.size()) + " bytes, filtered: " + String(filtered.size()) + " bytes");
+    
+    return filtered;
+}
+
+JsonDocument ComponentDataAggregator::collectDelta(const std::vector<BaseComponent*>& components, uint32_t since,
+                                                   const String& ids, const String& fields,
+                                                   const BaseComponent* self) {
+    JsonDocument delta;
+    JsonObject changed = delta["components"].to<JsonObject>();
+    
+    // Field selection doubles as a parse filter, so unwanted fields are never materialized
+    JsonDocument fieldFilter;
+    if (!fields.isEmpty()) {
+        int start = 0;
+        while (start < (int)fields.length()) {
+            int end = fields.indexOf(',', start);
+            if (end < 0) end = fields.length();
+            if (end > start) {
+                fieldFilter[fields.substring(start, end)] = true;
+            }
+            start = end + 1;
+        }
+    }
+    bool filtered = fieldFilter.size() > 0;
+    
+    for (BaseComponent* component : components) {
+        if (!component || component == self || component->getDataSeq() <= since) continue;
+        
+        const String& id = component->getId();
+        if (!ids.isEmpty() && !listContains(ids, id.c_str(), id.length())) continue;
+        
+        // Components keep only the serialized output
+        JsonDocument parsed;
+        const String& dataStr = component->getLastExecutionDataString();
+        DeserializationError error = filtered
+            ? deserializeJson(parsed, dataStr, DeserializationOption::Filter(fieldFilter))
+            : deserializeJson(parsed, dataStr);
+        if (error != DeserializationError::Ok) {
+            Logger::warning("ComponentData", String("[DELTA] Failed to parse data for ") + id);
+            continue;
+        }
+        JsonVariantConst source = parsed.as<JsonVariantConst>();
+        
+        JsonObject entry = changed[id].to<JsonObject>();
+        entry["seq"] = component->getDataSeq();
+        entry["type"] = component->getType();
+        entry["age_ms"] = component->getDataAgeMs();
+        JsonObject data = entry["data"].to<JsonObject>();
+        for (JsonPairConst kv : source.as<JsonObjectConst>()) {
+            if (!filtered || !fieldFilter[kv.key().c_str()].isNull()) {
+                data[kv.key().c_str()] = kv.value();
+            }
+        }
+    }
+    
+    return delta;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file ComponentDataAggregator.h
+ * @brief Builds and filters the component data documents served by /api/components/data
+ *        and /api/components/delta
+ *
+ * Kept free of web server types so the same code runs in the native
+ * benchmark build (env:native_bench) as on the target.
+ */
+
+#ifndef COMPONENT_DATA_AGGREGATOR_H
+#define COMPONENT_DATA_AGGREGATOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+
+class BaseComponent;
+
+/**
+ * @brief Data filtering options (?filter= on /api/components/data)
+ */
+enum DataFilterType {
+    FILTER_NONE,         // All data (default)
+    FILTER_CORE,         // Core sensor values only
+    FILTER_DIAGNOSTICS   // Full diagnostic data
+};
+
+/**
+ * @brief Static helpers producing the dashboard's component data view
+ */
+class ComponentDataAggregator {
+public:
+    /**
+     * @brief Collect identity, statistics and last output data of every component
+     * @param components Components to include
+     * @param self Component serving the request; listed without output data
+     * @return Document with a "components" array
+     */
+    static JsonDocument collect(const std::vector<BaseComponent*>& components, const BaseComponent* self = nullptr);
+
+    /**
+     * @brief Reduce a collected document to the fields of a filter mode
+     * @param data Document produced by collect()
+     * @param filterType Filter mode
+     * @return Filtered document (the input unchanged for FILTER_NONE or invalid input)
+     */
+    static JsonDocument filter(const JsonDocument& data, DataFilterType filterType);
+
+    /**
+     * @brief Collect the output data of components sampled after a sequence number
+     * 
+     * Backs GET /api/components/delta: a reader passes the "seq" of its last
+     * response and receives only the components that produced a new sample
+     * since, each with its own sequence number, type and data age. The
+     * caller adds the node's current sequence number and boot id.
+     * 
+     * @param components Components to consider
+     * @param since Sequence number the reader has seen (0 = everything)
+     * @param ids Comma-separated component ids to include (empty = all)
+     * @param fields Comma-separated output fields to include (empty = all)
+     * @param self Component serving the request; never included
+     * @return Document with a "components" object keyed by id
+     */
+    static JsonDocument collectDelta(const std::vector<BaseComponent*>& components, uint32_t since,
+                                     const String& ids = String(), const String& fields = String(),
+                                     const BaseComponent* self = nullptr);
+};
+
+#endif // COMPONENT_DATA_AGGREGATOR_H
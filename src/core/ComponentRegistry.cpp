@@ -0,0 +1,58 @@
+/**
+ * @file ComponentRegistry.cpp
+ * @brief ComponentRegistry implementation
+ */
+
+#include "ComponentRegistry.h"
+#include "../components/BaseComponent.h"
+
+// Static member initialization
+ComponentRegistry::Entry* ComponentRegistry::s_head = nullptr;
+
+void ComponentRegistry::add(Entry& entry) {
+    // Keep the list in name order: static constructors run in link order
+    Entry** link = &s_head;
+    while (*link && strcmp((*link)->typeName, entry.typeName) < 0) {
+        link = &(*link)->next;
+    }
+    entry.next = *link;
+    *link = &entry;
+}
+
+const ComponentRegistry::Entry* ComponentRegistry::find(const String& type) {
+    for (const Entry* entry = s_head; entry; entry = entry->next) {
+        if (type == entry->typeName || (entry->alias && type == entry->alias)) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+BaseComponent* ComponentRegistry::create(const String& type, const String& id, const String& name,
+                                         ConfigStorage& storage, Orchestrator* orchestrator) {
+    const Entry* entry = find(type);
+    return entry ? entry->factory(id, name, storage, orchestrator) : nullptr;
+}
+
+size_t ComponentRegistry::count() {
+    size_t n = 0;
+    for (const Entry* entry = s_head; entry; entry = entry->next) {
+        n++;
+    }
+    return n;
+}
+
+JsonDocument ComponentRegistry::describe() {
+    JsonDocument types;
+    JsonArray list = types.to<JsonArray>();
+    for (const Entry* entry = s_head; entry; entry = entry->next) {
+        JsonObject type = list.add<JsonObject>();
+        type["type"] = entry->typeName;
+        if (entry->alias) {
+            type["alias"] = entry->alias;
+        }
+        type["class"] = entry->className;
+        type["instance_bytes"] = entry->instanceBytes;
+    }
+    return types;
+}
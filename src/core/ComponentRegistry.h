@@ -0,0 +1,169 @@
+/**
+ * @file ComponentRegistry.h
+ * @brief Build-time selected, self-registering table of component types
+ *
+ * Each component translation unit is wrapped in its COMPONENT_<NAME> flag
+ * and ends with REGISTER_COMPONENT_TYPE(), which adds a static entry to the
+ * registry before setup() runs. A type whose flag is 0 compiles to nothing,
+ * so neither its code nor its factory is linked; nothing else in the tree
+ * names concrete component classes, so selecting a type is one build flag:
+ *
+ *     build_flags = -DCOMPONENT_SERVO_DIMMER=1 -DCOMPONENT_TSL2561=0
+ *
+ * Entries carry the instance size for the RAM column of the size report
+ * (scripts/component_size_report.py, run after each firmware build); the
+ * flash column comes from the ELF symbols of each class.
+ */
+
+#ifndef COMPONENT_REGISTRY_H
+#define COMPONENT_REGISTRY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+class BaseComponent;
+class ConfigStorage;
+class Orchestrator;
+
+// Component selection: override any of these with -DCOMPONENT_<NAME>=0/1
+#ifndef COMPONENT_DHT22
+#define COMPONENT_DHT22 1
+#endif
+#ifndef COMPONENT_TSL2561
+#define COMPONENT_TSL2561 1
+#endif
+#ifndef COMPONENT_PERISTALTIC_PUMP
+#define COMPONENT_PERISTALTIC_PUMP 1
+#endif
+#ifndef COMPONENT_PH_SENSOR
+#define COMPONENT_PH_SENSOR 1
+#endif
+#ifndef COMPONENT_EC_PROBE
+#define COMPONENT_EC_PROBE 1
+#endif
+#ifndef COMPONENT_RULES_ENGINE
+#define COMPONENT_RULES_ENGINE 1
+#endif
+#ifndef COMPONENT_TEST_H_PERISTALTIC
+#define COMPONENT_TEST_H_PERISTALTIC 0
+#endif
+#ifndef COMPONENT_SERVO_DIMMER
+#define COMPONENT_SERVO_DIMMER 0
+#endif
+#ifndef COMPONENT_LIGHT_ORCHESTRATOR
+#define COMPONENT_LIGHT_ORCHESTRATOR 0
+#endif
+#ifndef COMPONENT_TEMPLATE
+#define COMPONENT_TEMPLATE 0
+#endif
+
+// Network components have no native (host) implementation
+#ifdef NATIVE_SIM
+#undef COMPONENT_WEB_SERVER
+#undef COMPONENT_MQTT_BROADCAST
+#undef COMPONENT_UDP_TELEMETRY
+#undef COMPONENT_REMOTE_PROXY
+#undef COMPONENT_SERVO_DIMMER
+#undef COMPONENT_LIGHT_ORCHESTRATOR
+#define COMPONENT_WEB_SERVER 0
+#define COMPONENT_MQTT_BROADCAST 0
+#define COMPONENT_UDP_TELEMETRY 0
+#define COMPONENT_REMOTE_PROXY 0
+#define COMPONENT_SERVO_DIMMER 0        // HTTP client to the dimmer
+#define COMPONENT_LIGHT_ORCHESTRATOR 0  // Needs ServoDimmer
+#endif
+#ifndef COMPONENT_WEB_SERVER
+#define COMPONENT_WEB_SERVER 1
+#endif
+#ifndef COMPONENT_MQTT_BROADCAST
+#define COMPONENT_MQTT_BROADCAST 1
+#endif
+#ifndef COMPONENT_UDP_TELEMETRY
+#define COMPONENT_UDP_TELEMETRY 1
+#endif
+#ifndef COMPONENT_REMOTE_PROXY
+#define COMPONENT_REMOTE_PROXY 1
+#endif
+
+#if COMPONENT_TEST_H_PERISTALTIC && !COMPONENT_PERISTALTIC_PUMP
+#error "COMPONENT_TEST_H_PERISTALTIC drives PeristalticPump components; enable COMPONENT_PERISTALTIC_PUMP"
+#endif
+#if COMPONENT_LIGHT_ORCHESTRATOR && !COMPONENT_SERVO_DIMMER
+#error "COMPONENT_LIGHT_ORCHESTRATOR commands a ServoDimmer component; enable COMPONENT_SERVO_DIMMER"
+#endif
+
+/**
+ * @brief Static registry of the component types linked into this build
+ */
+class ComponentRegistry {
+public:
+    typedef BaseComponent* (*Factory)(const String& id, const String& name,
+                                      ConfigStorage& storage, Orchestrator* orchestrator);
+
+    /**
+     * @brief One component type; defined static by REGISTER_COMPONENT_TYPE()
+     */
+    struct Entry {
+        const char* typeName;         // Canonical name, stored as "component_type"
+        const char* alias;            // Older name still accepted, or nullptr
+        const char* className;        // C++ class, matched against ELF symbols by the size report
+        Factory factory;
+        uint16_t instanceBytes;       // sizeof(class), excluding heap the instance allocates
+        Entry* next;
+    };
+
+    /**
+     * @brief Adds an entry during static initialization
+     */
+    class Registrar {
+    public:
+        explicit Registrar(Entry& entry) { ComponentRegistry::add(entry); }
+    };
+
+    /**
+     * @brief Construct a component by type name or alias
+     * @return New, uninitialized component, or nullptr if the type is not in this build
+     */
+    static BaseComponent* create(const String& type, const String& id, const String& name,
+                                 ConfigStorage& storage, Orchestrator* orchestrator);
+
+    /**
+     * @brief Look up a type by canonical name or alias
+     */
+    static const Entry* find(const String& type);
+
+    /**
+     * @brief First entry in name order; follow Entry::next to iterate
+     */
+    static const Entry* first() { return s_head; }
+
+    static size_t count();
+
+    /**
+     * @brief Types in this build: name, alias, class and instance bytes
+     */
+    static JsonDocument describe();
+
+private:
+    static Entry* s_head;             // Constant-initialized, so safe to use from static constructors
+
+    static void add(Entry& entry);
+};
+
+/**
+ * @brief Register a component class under a type name (use once, at the end of its .cpp)
+ * @param ClassName Component class with the (id, name, storage, orchestrator) constructor
+ * @param typeName Canonical type name
+ * @param alias Older type name still accepted, or nullptr
+ */
+#define REGISTER_COMPONENT_TYPE(ClassName, typeName, alias)                                    \
+    static BaseComponent* create##ClassName(const String& id, const String& name,             \
+                                            ConfigStorage& storage, Orchestrator* orchestrator) { \
+        return new ClassName(id, name, storage, orchestrator);                                 \
+    }                                                                                          \
+    static ComponentRegistry::Entry s_registryEntry##ClassName = {                             \
+        typeName, alias, #ClassName, &create##ClassName, (uint16_t)sizeof(ClassName), nullptr  \
+    };                                                                                         \
+    static ComponentRegistry::Registrar s_registrar##ClassName(s_registryEntry##ClassName);
+
+#endif // COMPONENT_REGISTRY_H
@@ -0,0 +1,375 @@
+/**
+ * @file CpuMonitor.cpp
+ * @brief CpuMonitor implementation
+ */
+
+#include "CpuMonitor.h"
+#include "../components/BaseComponent.h"
+#include <esp_timer.h>
+#ifndef NATIVE_SIM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+// The Arduino core's prebuilt FreeRTOS counts task run time in esp_timer microseconds
+#if defined(CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS) && defined(CONFIG_FREERTOS_USE_TRACE_FACILITY) && \
+    defined(CONFIG_FREERTOS_RUN_TIME_STATS_USING_ESP_TIMER)
+#define CPU_MONITOR_TASK_STATS 1
+#endif
+#endif
+
+// Out-of-line definitions for ODR-used constants
+const uint32_t CpuMonitor::SAMPLE_INTERVAL_MS;
+const uint8_t CpuMonitor::WINDOW_SLOTS;
+const uint8_t CpuMonitor::MAX_TASKS;
+const uint8_t CpuMonitor::MAX_COMPONENTS;
+const uint8_t CpuMonitor::NAME_LENGTH;
+
+// Static member initialization
+std::vector<CpuMonitor::Counter> CpuMonitor::s_tasks;
+std::vector<CpuMonitor::Counter> CpuMonitor::s_components;
+uint64_t CpuMonitor::s_sampleTimesUs[CpuMonitor::WINDOW_SLOTS + 1] = {};
+uint8_t CpuMonitor::s_head = 0;
+uint8_t CpuMonitor::s_filled = 0;
+uint32_t CpuMonitor::s_lastSampleMs = 0;
+CpuMonitor::Usage* CpuMonitor::s_usage = nullptr;
+uint8_t CpuMonitor::s_usageCount = 0;
+uint8_t CpuMonitor::s_usageCapacity = 0;
+uint8_t CpuMonitor::s_shortSlots = 0;
+uint8_t CpuMonitor::s_longSlots = 0;
+uint32_t CpuMonitor::s_samples = 0;
+
+static portMUX_TYPE s_usageLock = portMUX_INITIALIZER_UNLOCKED;
+
+static const uint8_t RING_SLOTS = CpuMonitor::WINDOW_SLOTS + 1;
+
+static float round1(float value) {
+    return roundf(value * 10.0f) / 10.0f;
+}
+
+void CpuMonitor::update(const std::vector<BaseComponent*>& components) {
+    uint32_t now = millis();
+    if (s_filled > 0 && now - s_lastSampleMs < SAMPLE_INTERVAL_MS) {
+        return;
+    }
+    s_lastSampleMs = now;
+
+    uint8_t slot = s_filled == 0 ? 0 : (s_head + 1) % RING_SLOTS;
+    s_sampleTimesUs[slot] = esp_timer_get_time();
+    sampleTasks(slot);
+    sampleComponents(components, slot);
+
+    s_head = slot;
+    if (s_filled < RING_SLOTS) s_filled++;
+    s_samples++;
+
+    publish();
+}
+
+bool CpuMonitor::hasTaskStats() {
+#ifdef CPU_MONITOR_TASK_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void CpuMonitor::sampleTasks(uint8_t slot) {
+#ifdef CPU_MONITOR_TASK_STATS
+    carryForward(s_tasks, slot);
+
+    UBaseType_t capacity = uxTaskGetNumberOfTasks() + 2;  // Room for tasks created meanwhile
+    TaskStatus_t* status = (TaskStatus_t*)malloc(capacity * sizeof(TaskStatus_t));
+    if (!status) {
+        for (auto& counter : s_tasks) counter.seen = true;  // Keep history; this slot repeats the last one
+        return;
+    }
+
+    UBaseType_t count = uxTaskGetSystemState(status, capacity, nullptr);
+    for (UBaseType_t i = 0; i < count; i++) {
+        BaseType_t affinity = xTaskGetAffinity(status[i].xHandle);
+        record(s_tasks, MAX_TASKS, status[i].xHandle, status[i].pcTaskName,
+               affinity == tskNO_AFFINITY ? -1 : (int8_t)affinity, slot, status[i].ulRunTimeCounter, 0);
+    }
+    free(status);
+
+    dropUnseen(s_tasks);
+#else
+    (void)slot;
+#endif
+}
+
+void CpuMonitor::sampleComponents(const std::vector<BaseComponent*>& components, uint8_t slot) {
+    carryForward(s_components, slot);
+
+    for (auto* component : components) {
+        if (!component) continue;
+        uint64_t totalUs = component->getTotalExecutionUs();
+        record(s_components, MAX_COMPONENTS, component, component->getTraceName(), -1, slot,
+               (uint32_t)totalUs, (uint32_t)(totalUs / 1000));
+    }
+
+    dropUnseen(s_components);
+}
+
+void CpuMonitor::carryForward(std::vector<Counter>& counters, uint8_t slot) {
+    for (auto& counter : counters) {
+        counter.samples[slot] = counter.samples[s_head];
+        counter.seen = false;
+    }
+}
+
+void CpuMonitor::record(std::vector<Counter>& counters, size_t limit, const void* key, const char* name,
+                        int8_t core, uint8_t slot, uint32_t value, uint32_t totalMs) {
+    for (auto& counter : counters) {
+        // A recycled handle under a different name is a different task
+        if (counter.key == key && strncmp(counter.name, name, NAME_LENGTH - 1) == 0) {
+            counter.samples[slot] = value;
+            counter.totalMs = totalMs;
+            counter.core = core;
+            counter.seen = true;
+            return;
+        }
+    }
+    if (counters.size() >= limit) {
+        return;
+    }
+
+    // First sighting: time before it counts as idle, so every window starts at this value
+    Counter counter;
+    counter.key = key;
+    strncpy(counter.name, name ? name : "?", NAME_LENGTH - 1);
+    counter.name[NAME_LENGTH - 1] = '\0';
+    counter.core = core;
+    counter.seen = true;
+    counter.totalMs = totalMs;
+    for (uint8_t i = 0; i < RING_SLOTS; i++) {
+        counter.samples[i] = value;
+    }
+    counters.push_back(counter);
+}
+
+void CpuMonitor::dropUnseen(std::vector<Counter>& counters) {
+    for (auto it = counters.begin(); it != counters.end();) {
+        if (!it->seen) {
+            it = counters.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+float CpuMonitor::percent(const Counter& counter, uint8_t slots) {
+    if (slots == 0) {
+        return 0.0f;
+    }
+    uint8_t older = (s_head + RING_SLOTS - slots) % RING_SLOTS;
+    uint64_t elapsedUs = s_sampleTimesUs[s_head] - s_sampleTimesUs[older];
+    if (elapsedUs == 0) {
+        return 0.0f;
+    }
+    uint32_t busyUs = counter.samples[s_head] - counter.samples[older];
+    float pct = busyUs * 100.0f / elapsedUs;
+    return pct > 100.0f ? 100.0f : pct;
+}
+
+void CpuMonitor::publish() {
+    uint8_t shortSlots = s_filled > 1 ? 1 : 0;
+    uint8_t longSlots = s_filled > 1 ? s_filled - 1 : 0;
+
+    uint8_t cores = 0;
+#ifdef CPU_MONITOR_TASK_STATS
+    cores = portNUM_PROCESSORS;
+#endif
+    size_t needed = cores + s_tasks.size() + s_components.size();
+
+    // Grow outside the lock; readers only ever see a complete buffer
+    Usage* retired = nullptr;
+    if (needed > s_usageCapacity) {
+        Usage* grown = (Usage*)malloc(needed * sizeof(Usage));
+        if (!grown) {
+            return;
+        }
+        portENTER_CRITICAL(&s_usageLock);
+        retired = s_usage;
+        s_usage = grown;
+        s_usageCapacity = needed;
+        s_usageCount = 0;
+        portEXIT_CRITICAL(&s_usageLock);
+    }
+    free(retired);
+
+    portENTER_CRITICAL(&s_usageLock);
+    uint8_t count = 0;
+
+#ifdef CPU_MONITOR_TASK_STATS
+    // Core load is whatever its IDLE task did not get
+    for (uint8_t core = 0; core < cores; core++) {
+        Usage& usage = s_usage[count++];
+        snprintf(usage.name, NAME_LENGTH, "core%u", core);
+        usage.kind = USAGE_CORE;
+        usage.core = core;
+        usage.shortPct = 0.0f;
+        usage.longPct = 0.0f;
+        usage.totalMs = 0;
+        TaskHandle_t idle = xTaskGetIdleTaskHandleForCPU(core);
+        for (const auto& counter : s_tasks) {
+            if (counter.key == idle) {
+                usage.shortPct = 100.0f - percent(counter, shortSlots);
+                usage.longPct = 100.0f - percent(counter, longSlots);
+                break;
+            }
+        }
+    }
+#endif
+
+    const std::vector<Counter>* groups[2] = { &s_tasks, &s_components };
+    for (uint8_t group = 0; group < 2; group++) {
+        uint8_t first = count;
+        for (const auto& counter : *groups[group]) {
+            Usage entry;
+            memcpy(entry.name, counter.name, NAME_LENGTH);
+            entry.kind = group == 0 ? USAGE_TASK : USAGE_COMPONENT;
+            entry.core = counter.core;
+            entry.shortPct = percent(counter, shortSlots);
+            entry.longPct = percent(counter, longSlots);
+            entry.totalMs = counter.totalMs;
+
+            // Insertion sort by long-window load, busiest first
+            uint8_t i = count++;
+            while (i > first && s_usage[i - 1].longPct < entry.longPct) {
+                s_usage[i] = s_usage[i - 1];
+                i--;
+            }
+            s_usage[i] = entry;
+        }
+    }
+
+    s_usageCount = count;
+    s_shortSlots = shortSlots;
+    s_longSlots = longSlots;
+    portEXIT_CRITICAL(&s_usageLock);
+}
+
+uint8_t CpuMonitor::copyUsage(Usage*& usage, uint8_t& shortSlots, uint8_t& longSlots) {
+    usage = nullptr;
+    portENTER_CRITICAL(&s_usageLock);
+    uint8_t capacity = s_usageCount;
+    portEXIT_CRITICAL(&s_usageLock);
+    if (capacity == 0) {
+        return 0;
+    }
+
+    usage = (Usage*)malloc(capacity * sizeof(Usage));
+    if (!usage) {
+        return 0;
+    }
+
+    portENTER_CRITICAL(&s_usageLock);
+    uint8_t count = s_usageCount < capacity ? s_usageCount : capacity;
+    memcpy(usage, s_usage, count * sizeof(Usage));
+    shortSlots = s_shortSlots;
+    longSlots = s_longSlots;
+    portEXIT_CRITICAL(&s_usageLock);
+    return count;
+}
+
+JsonDocument CpuMonitor::getStats() {
+    JsonDocument stats;
+    stats["task_stats"] = hasTaskStats();
+    stats["samples"] = s_samples;
+
+    Usage* usage = nullptr;
+    uint8_t shortSlots = 0;
+    uint8_t longSlots = 0;
+    uint8_t count = copyUsage(usage, shortSlots, longSlots);
+
+    JsonObject windows = stats["window_s"].to<JsonObject>();
+    windows["short"] = shortSlots * SAMPLE_INTERVAL_MS / 1000;
+    windows["long"] = longSlots * SAMPLE_INTERVAL_MS / 1000;
+
+    JsonArray cores = stats["cores"].to<JsonArray>();
+    JsonArray tasks = stats["tasks"].to<JsonArray>();
+    JsonArray components = stats["components"].to<JsonArray>();
+    float loopShort = -1.0f, loopLong = -1.0f;
+    float componentsShort = 0.0f, componentsLong = 0.0f;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const Usage& entry = usage[i];
+        JsonObject item;
+        if (entry.kind == USAGE_CORE) {
+            item = cores.add<JsonObject>();
+            item["core"] = entry.core;
+        } else if (entry.kind == USAGE_TASK) {
+            item = tasks.add<JsonObject>();
+            item["name"] = entry.name;
+            if (entry.core >= 0) {
+                item["core"] = entry.core;
+            }
+            if (strcmp(entry.name, "loopTask") == 0) {
+                loopShort = entry.shortPct;
+                loopLong = entry.longPct;
+            }
+        } else {
+            item = components.add<JsonObject>();
+            item["id"] = entry.name;
+            item["total_ms"] = entry.totalMs;
+            componentsShort += entry.shortPct;
+            componentsLong += entry.longPct;
+        }
+        item["short_pct"] = round1(entry.shortPct);
+        item["long_pct"] = round1(entry.longPct);
+    }
+    free(usage);
+
+    // How much of the Arduino loop task goes to component execute() vs. everything else
+    if (loopLong >= 0.0f) {
+        JsonObject loop = stats["loop"].to<JsonObject>();
+        loop["task_short_pct"] = round1(loopShort);
+        loop["task_long_pct"] = round1(loopLong);
+        loop["components_short_pct"] = round1(componentsShort);
+        loop["components_long_pct"] = round1(componentsLong);
+        loop["other_long_pct"] = round1(max(0.0f, loopLong - componentsLong));
+    }
+
+    return stats;
+}
+
+JsonDocument CpuMonitor::getSummary(uint8_t topComponents) {
+    JsonDocument summary;
+
+    Usage* usage = nullptr;
+    uint8_t shortSlots = 0;
+    uint8_t longSlots = 0;
+    uint8_t count = copyUsage(usage, shortSlots, longSlots);
+
+    summary["window_s"] = longSlots * SAMPLE_INTERVAL_MS / 1000;
+    JsonArray cores = summary["cores_pct"].to<JsonArray>();
+    JsonArray components = summary["top_components"].to<JsonArray>();
+    uint8_t listed = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const Usage& entry = usage[i];
+        if (entry.kind == USAGE_CORE) {
+            cores.add(round1(entry.longPct));
+        } else if (entry.kind == USAGE_COMPONENT && listed < topComponents) {
+            JsonObject item = components.add<JsonObject>();
+            item["id"] = entry.name;
+            item["pct"] = round1(entry.longPct);
+            listed++;
+        }
+    }
+    free(usage);
+
+    return summary;
+}
+
+float CpuMonitor::getPeakCoreLoad() {
+    float peak = 0.0f;
+    portENTER_CRITICAL(&s_usageLock);
+    for (uint8_t i = 0; i < s_usageCount; i++) {
+        if (s_usage[i].kind == USAGE_CORE && s_usage[i].shortPct > peak) {
+            peak = s_usage[i].shortPct;
+        }
+    }
+    portEXIT_CRITICAL(&s_usageLock);
+    return peak;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file CpuMonitor.h
+ * @brief Per-task and per-component CPU utilization over sliding windows
+ *
+ * Every SAMPLE_INTERVAL_MS the orchestrator loop snapshots the cumulative
+ * FreeRTOS run-time counter of each task and the cumulative execute() time
+ * of each component into a small ring. Utilization over a window is the
+ * counter delta between two snapshots divided by the elapsed time, so the
+ * per-loop cost is a single time comparison.
+ *
+ * Percentages are of one core: a task pinned to core 1 at 100% saturates
+ * that core. Per-core load is derived from the IDLE tasks.
+ */
+
+#ifndef CPU_MONITOR_H
+#define CPU_MONITOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+
+class BaseComponent;
+
+/**
+ * @brief Static CPU accounting
+ */
+class CpuMonitor {
+public:
+    static const uint32_t SAMPLE_INTERVAL_MS = 5000;
+    static const uint8_t WINDOW_SLOTS = 12;           // Long window: 12 x 5s = 60s
+    static const uint8_t MAX_TASKS = 24;
+    static const uint8_t MAX_COMPONENTS = 32;
+    static const uint8_t NAME_LENGTH = 24;
+
+    /**
+     * @brief Take a snapshot when the sample interval has elapsed (call every loop pass)
+     * @param components Registered components
+     */
+    static void update(const std::vector<BaseComponent*>& components);
+
+    /**
+     * @brief Check if per-task run-time stats are available in this build
+     */
+    static bool hasTaskStats();
+
+    /**
+     * @brief Full report: per core, per task and per component, short and long window
+     */
+    static JsonDocument getStats();
+
+    /**
+     * @brief Compact report: per-core load and the busiest components
+     * @param topComponents Number of components to list
+     */
+    static JsonDocument getSummary(uint8_t topComponents = 3);
+
+    /**
+     * @brief Load of the busiest core over the short window (callable from any task)
+     * @return Percent, 0 when per-task run-time stats are not available
+     */
+    static float getPeakCoreLoad();
+
+private:
+    enum UsageKind : uint8_t { USAGE_TASK, USAGE_COMPONENT, USAGE_CORE };
+
+    /**
+     * @brief Cumulative counter history of one task or component (loop task only)
+     */
+    struct Counter {
+        const void* key;                              // Task handle or component pointer
+        char name[NAME_LENGTH];
+        int8_t core;                                  // -1 = not pinned
+        bool seen;                                    // Present in the latest snapshot
+        uint32_t totalMs;                             // Lifetime total (components only)
+        uint32_t samples[WINDOW_SLOTS + 1];           // Cumulative us; deltas are wrap-safe
+    };
+
+    /**
+     * @brief Published result, copied out under the lock by readers on other tasks
+     */
+    struct Usage {
+        char name[NAME_LENGTH];
+        uint8_t kind;
+        int8_t core;
+        float shortPct;
+        float longPct;
+        uint32_t totalMs;
+    };
+
+    static std::vector<Counter> s_tasks;
+    static std::vector<Counter> s_components;
+    static uint64_t s_sampleTimesUs[WINDOW_SLOTS + 1];
+    static uint8_t s_head;                            // Slot of the latest snapshot
+    static uint8_t s_filled;                          // Valid snapshots in the ring
+    static uint32_t s_lastSampleMs;
+
+    static Usage* s_usage;                            // Cores, then tasks and components by load
+    static uint8_t s_usageCount;
+    static uint8_t s_usageCapacity;
+    static uint8_t s_shortSlots;
+    static uint8_t s_longSlots;
+    static uint32_t s_samples;
+
+    static void sampleTasks(uint8_t slot);
+    static void sampleComponents(const std::vector<BaseComponent*>& components, uint8_t slot);
+    static void carryForward(std::vector<Counter>& counters, uint8_t slot);
+    static void record(std::vector<Counter>& counters, size_t limit, const void* key, const char* name,
+                       int8_t core, uint8_t slot, uint32_t value, uint32_t totalMs);
+    static void dropUnseen(std::vector<Counter>& counters);
+    static void publish();
+
+    /**
+     * @brief Utilization of one counter over the last `slots` sample intervals
+     * @return Percent of one core
+     */
+    static float percent(const Counter& counter, uint8_t slots);
+
+    /**
+     * @brief Copy the published results (callable from any task)
+     * @param usage Set to a malloc'd copy the caller frees; nullptr if nothing is published
+     * @return Number of entries copied
+     */
+    static uint8_t copyUsage(Usage*& usage, uint8_t& shortSlots, uint8_t& longSlots);
+};
+
+#endif // CPU_MONITOR_H
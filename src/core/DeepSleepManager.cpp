@@ -0,0 +1,388 @@
+/**
+ * @file DeepSleepManager.cpp
+ * @brief DeepSleepManager implementation
+ */
+
+#include "DeepSleepManager.h"
+#include "../components/BaseComponent.h"
+#include "../storage/RtcStateStore.h"
+#include <WiFi.h>
+#include <esp_attr.h>
+#include <esp_sleep.h>
+#include <esp_system.h>
+#include <rom/crc.h>
+#include <stddef.h>
+#include <time.h>
+
+namespace {
+
+const uint32_t RTC_MAGIC = 0x44534C50;   // "DSLP"
+const uint16_t RTC_VERSION = 1;
+const size_t RECORD_HEADER = 9;          // idHash(4) + virtual seconds(4) + payload length(1)
+
+/**
+ * @brief Duty-cycle state kept in RTC slow memory across deep sleep
+ */
+struct DeepSleepRtcState {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t enabled;               // Mirrors config so timer wakes know before storage is up
+    uint8_t uploadPending;         // Next wake should bring up WiFi and upload
+    uint32_t wakeCount;
+    uint32_t uploadCount;
+    uint32_t failedUploads;
+    uint32_t droppedRecords;
+    uint32_t recordCount;
+    uint32_t bufferUsed;
+    uint32_t lastSleepMs;
+    uint64_t virtualMs;            // Awake + sleep time up to the last sleep entry
+    uint64_t lastUploadVirtualMs;
+    uint64_t cpuAwakeMs;           // Awake time with the radio off
+    uint64_t wifiAwakeMs;          // Awake time with WiFi up
+    uint64_t sleepMs;
+    uint32_t crc;
+    uint8_t buffer[DeepSleepManager::BUFFER_BYTES];
+};
+
+RTC_NOINIT_ATTR DeepSleepRtcState s_rtc;
+
+uint32_t stateCrc() {
+    size_t used = s_rtc.bufferUsed <= DeepSleepManager::BUFFER_BYTES ? s_rtc.bufferUsed : DeepSleepManager::BUFFER_BYTES;
+    size_t length = offsetof(DeepSleepRtcState, buffer) + used;
+
+    uint32_t savedCrc = s_rtc.crc;
+    s_rtc.crc = 0;
+    uint32_t crc = crc32_le(0, reinterpret_cast<const uint8_t*>(&s_rtc), length);
+    s_rtc.crc = savedCrc;
+
+    return crc;
+}
+
+}  // namespace
+
+// Out-of-line definitions for ODR-used constants
+const size_t DeepSleepManager::BUFFER_BYTES;
+const size_t DeepSleepManager::MAX_RECORD_PAYLOAD;
+
+// Static member initialization
+DeepSleepConfig DeepSleepManager::s_config;
+bool DeepSleepManager::s_begun = false;
+bool DeepSleepManager::s_timerWake = false;
+bool DeepSleepManager::s_networkThisWake = true;
+bool DeepSleepManager::s_uploadAttempted = false;
+
+void DeepSleepManager::begin() {
+    if (s_begun) {
+        return;
+    }
+    s_begun = true;
+
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool intact = (s_rtc.magic == RTC_MAGIC) &&
+                  (s_rtc.version == RTC_VERSION) &&
+                  (s_rtc.bufferUsed <= BUFFER_BYTES) &&
+                  (s_rtc.crc == stateCrc()) &&
+                  (reason != ESP_RST_POWERON);
+
+    if (!intact) {
+        memset(&s_rtc, 0, sizeof(s_rtc));
+        s_rtc.magic = RTC_MAGIC;
+        s_rtc.version = RTC_VERSION;
+        seal();
+    }
+
+    s_timerWake = intact && s_rtc.enabled &&
+                  reason == ESP_RST_DEEPSLEEP &&
+                  esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+
+    if (s_timerWake) {
+        s_config.enabled = true;  // Full config arrives with the system config
+        s_rtc.wakeCount++;
+        seal();
+    }
+
+    s_networkThisWake = !s_timerWake || s_rtc.uploadPending;
+
+    if (s_timerWake) {
+        Logger::info("DeepSleep", String("Timer wake #") + s_rtc.wakeCount + " after " + s_rtc.lastSleepMs +
+                     "ms sleep, " + s_rtc.recordCount + " buffered readings" +
+                     (s_networkThisWake ? ", upload due" : ""));
+    }
+}
+
+bool DeepSleepManager::needsNetworkThisWake() {
+    begin();
+    return s_networkThisWake;
+}
+
+void DeepSleepManager::configure(JsonVariantConst config) {
+    if (config.isNull()) {
+        return;
+    }
+
+    s_config.enabled = config["enabled"] | s_config.enabled;
+    s_config.minSleepMs = config["minSleepMs"] | s_config.minSleepMs;
+    s_config.maxSleepMs = config["maxSleepMs"] | s_config.maxSleepMs;
+    s_config.uploadIntervalSec = config["uploadIntervalSec"] | s_config.uploadIntervalSec;
+    s_config.uploadUrl = config["uploadUrl"] | s_config.uploadUrl;
+    s_config.maintenanceWindowMs = config["maintenanceWindowMs"] | s_config.maintenanceWindowMs;
+    s_config.networkTimeoutMs = config["networkTimeoutMs"] | s_config.networkTimeoutMs;
+    s_config.activeCurrentMa = config["activeCurrentMa"] | s_config.activeCurrentMa;
+    s_config.wifiCurrentMa = config["wifiCurrentMa"] | s_config.wifiCurrentMa;
+    s_config.sleepCurrentUa = config["sleepCurrentUa"] | s_config.sleepCurrentUa;
+    s_config.bootOverheadMs = config["bootOverheadMs"] | s_config.bootOverheadMs;
+    s_config.batteryCapacityMah = config["batteryCapacityMah"] | s_config.batteryCapacityMah;
+
+    // Keep sleeps sane: at least 1 s, never shorter than the minimum
+    if (s_config.minSleepMs < 1000) s_config.minSleepMs = 1000;
+    if (s_config.maxSleepMs < s_config.minSleepMs) s_config.maxSleepMs = s_config.minSleepMs;
+
+    s_rtc.enabled = s_config.enabled ? 1 : 0;
+    seal();
+
+    Logger::info("DeepSleep", String("Duty-cycled mode ") + (s_config.enabled ? "enabled" : "disabled") +
+                 " (upload every " + s_config.uploadIntervalSec + "s)");
+}
+
+JsonDocument DeepSleepManager::getConfig() {
+    JsonDocument config;
+
+    config["enabled"] = s_config.enabled;
+    config["minSleepMs"] = s_config.minSleepMs;
+    config["maxSleepMs"] = s_config.maxSleepMs;
+    config["uploadIntervalSec"] = s_config.uploadIntervalSec;
+    config["uploadUrl"] = s_config.uploadUrl;
+    config["maintenanceWindowMs"] = s_config.maintenanceWindowMs;
+    config["networkTimeoutMs"] = s_config.networkTimeoutMs;
+    config["activeCurrentMa"] = s_config.activeCurrentMa;
+    config["wifiCurrentMa"] = s_config.wifiCurrentMa;
+    config["sleepCurrentUa"] = s_config.sleepCurrentUa;
+    config["bootOverheadMs"] = s_config.bootOverheadMs;
+    config["batteryCapacityMah"] = s_config.batteryCapacityMah;
+
+    return config;
+}
+
+JsonDocument DeepSleepManager::getStats() {
+    JsonDocument stats;
+
+    // Include the current wake so the estimate is live
+    uint64_t currentAwakeMs = millis() + s_config.bootOverheadMs;
+    uint64_t cpuMs = s_rtc.cpuAwakeMs + (s_networkThisWake ? 0 : currentAwakeMs);
+    uint64_t wifiMs = s_rtc.wifiAwakeMs + (s_networkThisWake ? currentAwakeMs : 0);
+    uint64_t sleepMs = s_rtc.sleepMs;
+    double dutyPercent;
+    double meanCurrentMa;
+    estimate(cpuMs, wifiMs, sleepMs, dutyPercent, meanCurrentMa);
+
+    stats["enabled"] = s_config.enabled;
+    stats["timerWake"] = s_timerWake;
+    stats["networkThisWake"] = s_networkThisWake;
+    stats["wakeCount"] = s_rtc.wakeCount;
+    stats["uploadCount"] = s_rtc.uploadCount;
+    stats["failedUploads"] = s_rtc.failedUploads;
+    stats["bufferedRecords"] = s_rtc.recordCount;
+    stats["bufferBytes"] = s_rtc.bufferUsed;
+    stats["bufferCapacity"] = BUFFER_BYTES;
+    stats["droppedRecords"] = s_rtc.droppedRecords;
+    stats["cpuAwakeMs"] = (double)cpuMs;
+    stats["wifiAwakeMs"] = (double)wifiMs;
+    stats["sleepMs"] = (double)sleepMs;
+    stats["dutyCyclePercent"] = dutyPercent;
+    stats["meanCurrentMa"] = meanCurrentMa;
+    if (s_config.batteryCapacityMah > 0 && meanCurrentMa > 0) {
+        stats["estimatedBatteryHours"] = s_config.batteryCapacityMah / meanCurrentMa;
+    }
+
+    return stats;
+}
+
+bool DeepSleepManager::inMaintenanceWindow() {
+    return !s_timerWake && millis() < s_config.maintenanceWindowMs;
+}
+
+uint32_t DeepSleepManager::getTimeSinceSnapshotMs() {
+    if (s_timerWake) {
+        return s_rtc.lastSleepMs + s_config.bootOverheadMs + millis();
+    }
+    return millis();
+}
+
+void DeepSleepManager::bufferReading(const BaseComponent* component) {
+    if (!s_config.enabled || !component) {
+        return;
+    }
+
+    JsonDocument data = component->getCoreData();
+    if (data.isNull() || data.size() == 0) {
+        return;  // Nothing worth buffering (e.g. web server)
+    }
+
+    size_t payloadLen = measureMsgPack(data);
+    if (payloadLen > MAX_RECORD_PAYLOAD) {
+        Logger::debug("DeepSleep", "Reading too large to buffer: " + component->getId());
+        return;
+    }
+
+    // Drop the oldest readings until the new one fits
+    size_t needed = RECORD_HEADER + payloadLen;
+    while (s_rtc.bufferUsed + needed > BUFFER_BYTES && s_rtc.bufferUsed > 0) {
+        size_t oldest = RECORD_HEADER + s_rtc.buffer[8];
+        memmove(s_rtc.buffer, s_rtc.buffer + oldest, s_rtc.bufferUsed - oldest);
+        s_rtc.bufferUsed -= oldest;
+        s_rtc.recordCount--;
+        s_rtc.droppedRecords++;
+    }
+
+    uint8_t* record = s_rtc.buffer + s_rtc.bufferUsed;
+    uint32_t idHash = RtcStateStore::hash(component->getId());
+    uint32_t virtualSec = (uint32_t)(virtualNowMs() / 1000);
+    memcpy(record, &idHash, 4);
+    memcpy(record + 4, &virtualSec, 4);
+    record[8] = (uint8_t)payloadLen;
+    serializeMsgPack(data, record + RECORD_HEADER, payloadLen);
+
+    s_rtc.bufferUsed += needed;
+    s_rtc.recordCount++;
+    seal();
+}
+
+bool DeepSleepManager::isUploadDue() {
+    return s_networkThisWake && !s_uploadAttempted &&
+           s_rtc.recordCount > 0 && !s_config.uploadUrl.isEmpty();
+}
+
+bool DeepSleepManager::isNetworkReady() {
+    return WiFi.status() == WL_CONNECTED;
+}
+
+bool DeepSleepManager::networkWaitExpired() {
+    return millis() >= s_config.networkTimeoutMs;
+}
+
+bool DeepSleepManager::uploadBufferedReadings(HttpClientWrapper& http, const std::vector<BaseComponent*>& components) {
+    s_uploadAttempted = true;
+
+    if (!isNetworkReady()) {
+        s_rtc.failedUploads++;
+        seal();
+        Logger::warning("DeepSleep", "Upload skipped - network not available, keeping buffer");
+        return false;
+    }
+
+    time_t nowEpoch = time(nullptr);
+    bool haveEpoch = nowEpoch > 1600000000;  // RTC time survives deep sleep once NTP synced
+    uint32_t nowVirtualSec = (uint32_t)(virtualNowMs() / 1000);
+
+    JsonDocument batch;
+    batch["node"] = WiFi.macAddress();
+    batch["wake"] = s_rtc.wakeCount;
+    batch["dropped"] = s_rtc.droppedRecords;
+    JsonArray readings = batch["readings"].to<JsonArray>();
+
+    size_t offset = 0;
+    while (offset + RECORD_HEADER <= s_rtc.bufferUsed) {
+        const uint8_t* record = s_rtc.buffer + offset;
+        uint32_t idHash;
+        uint32_t virtualSec;
+        memcpy(&idHash, record, 4);
+        memcpy(&virtualSec, record + 4, 4);
+        size_t payloadLen = record[8];
+
+        JsonObject reading = readings.add<JsonObject>();
+        String componentId = String(idHash, HEX);
+        for (BaseComponent* component : components) {
+            if (component && RtcStateStore::hash(component->getId()) == idHash) {
+                componentId = component->getId();
+                break;
+            }
+        }
+        reading["id"] = componentId;
+
+        uint32_t ageSec = nowVirtualSec >= virtualSec ? nowVirtualSec - virtualSec : 0;
+        reading["age_s"] = ageSec;
+        if (haveEpoch) {
+            reading["ts"] = (long)(nowEpoch - ageSec);
+        }
+
+        JsonDocument data;
+        if (deserializeMsgPack(data, record + RECORD_HEADER, payloadLen) == DeserializationError::Ok) {
+            reading["data"] = data;
+        }
+
+        offset += RECORD_HEADER + payloadLen;
+    }
+
+    String payload;
+    serializeJson(batch, payload);
+
+    HttpResult result = http.post(s_config.uploadUrl, payload);
+    if (result.success) {
+        Logger::info("DeepSleep", String("Uploaded ") + s_rtc.recordCount + " readings (" +
+                     payload.length() + " bytes)");
+        s_rtc.bufferUsed = 0;
+        s_rtc.recordCount = 0;
+        s_rtc.uploadCount++;
+        s_rtc.lastUploadVirtualMs = virtualNowMs();
+    } else {
+        s_rtc.failedUploads++;
+        Logger::warning("DeepSleep", "Batch upload failed: " + result.error + " - keeping buffer");
+    }
+
+    seal();
+    return result.success;
+}
+
+void DeepSleepManager::enterSleep(uint32_t sleepMs) {
+    uint32_t awakeMs = millis() + s_config.bootOverheadMs;
+
+    if (s_networkThisWake) {
+        s_rtc.wifiAwakeMs += awakeMs;
+    } else {
+        s_rtc.cpuAwakeMs += awakeMs;
+    }
+    s_rtc.sleepMs += sleepMs;
+    s_rtc.lastSleepMs = sleepMs;
+    s_rtc.virtualMs += (uint64_t)awakeMs + sleepMs;
+
+    // Decide now whether the next wake brings up the network
+    uint64_t sinceUploadMs = s_rtc.virtualMs - s_rtc.lastUploadVirtualMs;
+    bool intervalDue = sinceUploadMs >= (uint64_t)s_config.uploadIntervalSec * 1000ULL;
+    bool bufferHigh = s_rtc.bufferUsed >= (BUFFER_BYTES * 3) / 4;
+    s_rtc.uploadPending = (!s_config.uploadUrl.isEmpty() && s_rtc.recordCount > 0 &&
+                           (intervalDue || bufferHigh)) ? 1 : 0;
+    s_rtc.enabled = 1;
+    seal();
+
+    // The totals already hold this wake and the coming sleep; getStats() would add the wake again
+    double dutyPercent;
+    double meanCurrentMa;
+    estimate(s_rtc.cpuAwakeMs, s_rtc.wifiAwakeMs, s_rtc.sleepMs, dutyPercent, meanCurrentMa);
+    Logger::info("DeepSleep", String("Sleeping ") + sleepMs + "ms after " + awakeMs + "ms awake | duty " +
+                 String((float)dutyPercent, 2) + "% | mean " +
+                 String((float)meanCurrentMa, 3) + "mA | buffered " + s_rtc.recordCount +
+                 (s_rtc.uploadPending ? " | upload next wake" : ""));
+
+    Serial.flush();
+    esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+    esp_deep_sleep_start();
+}
+
+void DeepSleepManager::estimate(uint64_t cpuMs, uint64_t wifiMs, uint64_t sleepMs,
+                                double& dutyPercent, double& meanCurrentMa) {
+    uint64_t totalMs = cpuMs + wifiMs + sleepMs;
+    dutyPercent = totalMs > 0 ? (double)(cpuMs + wifiMs) * 100.0 / (double)totalMs : 100.0;
+    meanCurrentMa = totalMs > 0
+        ? ((double)cpuMs * s_config.activeCurrentMa +
+           (double)wifiMs * s_config.wifiCurrentMa +
+           (double)sleepMs * s_config.sleepCurrentUa / 1000.0) / (double)totalMs
+        : s_config.wifiCurrentMa;
+}
+
+uint64_t DeepSleepManager::virtualNowMs() {
+    return s_rtc.virtualMs + millis();
+}
+
+void DeepSleepManager::seal() {
+    s_rtc.crc = stateCrc();
+}
@@ -0,0 +1,186 @@
+/**
+ * @file DeepSleepManager.h
+ * @brief Deep-sleep duty-cycled operation for battery-powered sensor nodes
+ *
+ * When enabled, the orchestrator sleeps between component executions
+ * instead of idling. Each timer wake boots without WiFi or the web server,
+ * runs whatever is due, buffers the readings in RTC memory and goes back
+ * to sleep. Every uploadIntervalSec (or when the buffer fills up) a wake
+ * brings the network up and posts the buffered readings in one batch.
+ */
+
+#ifndef DEEP_SLEEP_MANAGER_H
+#define DEEP_SLEEP_MANAGER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include "../utils/Logger.h"
+#include "../utils/HttpClientWrapper.h"
+
+class BaseComponent;
+
+/**
+ * @brief Duty-cycle configuration (persisted in /config/system.json as "deepSleep")
+ */
+struct DeepSleepConfig {
+    bool enabled = false;
+    uint32_t minSleepMs = 5000;              // Stay awake if the next job is closer than this
+    uint32_t maxSleepMs = 3600000;           // Upper bound for a single sleep (1 hour)
+    uint32_t uploadIntervalSec = 300;        // Batch upload cadence
+    String uploadUrl = "";                   // HTTP endpoint for batches (empty = keep buffering)
+    uint32_t maintenanceWindowMs = 120000;   // Stay awake with web server after a cold boot
+    uint32_t networkTimeoutMs = 15000;       // Give up on WiFi for this upload wake after this
+    float activeCurrentMa = 40.0;            // CPU awake, radio off
+    float wifiCurrentMa = 120.0;             // CPU awake, WiFi associated
+    float sleepCurrentUa = 10.0;             // Deep sleep (board dependent)
+    uint32_t bootOverheadMs = 250;           // ROM/bootloader time not visible to millis()
+    uint32_t batteryCapacityMah = 0;         // Optional, for battery life estimate
+};
+
+/**
+ * @brief Static manager for deep-sleep duty cycling
+ *
+ * Runtime counters and the readings buffer live in RTC slow memory next to
+ * the RtcStateStore snapshot; the schedule itself is carried by
+ * RtcStateStore (saved right before sleeping).
+ */
+class DeepSleepManager {
+public:
+    static const size_t BUFFER_BYTES = 1536;         // RTC bytes reserved for buffered readings
+    static const size_t MAX_RECORD_PAYLOAD = 96;     // MessagePack bytes per buffered reading
+
+    /**
+     * @brief Read wake cause and RTC state (idempotent, call early in setup())
+     */
+    static void begin();
+
+    /**
+     * @brief Check if duty-cycled mode is enabled
+     * @return true if enabled
+     */
+    static bool isEnabled() { return s_config.enabled; }
+
+    /**
+     * @brief Check if this boot is a timer wake from duty-cycled sleep
+     * @return true if woken by the sleep timer
+     */
+    static bool isTimerWake() { return s_timerWake; }
+
+    /**
+     * @brief Check whether this wake should bring up WiFi
+     *
+     * Cold boots always need the network; timer wakes only when an upload
+     * was scheduled before going to sleep.
+     *
+     * @return true if WiFi should be started
+     */
+    static bool needsNetworkThisWake();
+
+    /**
+     * @brief Apply configuration (from system.json or the API)
+     * @param config JSON object with DeepSleepConfig fields
+     */
+    static void configure(JsonVariantConst config);
+
+    /**
+     * @brief Get current configuration
+     * @return Configuration as JSON document
+     */
+    static JsonDocument getConfig();
+
+    /**
+     * @brief Get duty-cycle statistics and current estimate
+     * @return Statistics as JSON document
+     */
+    static JsonDocument getStats();
+
+    /**
+     * @brief Check if the post-cold-boot maintenance window is still open
+     * @return true while the node should stay awake for configuration
+     */
+    static bool inMaintenanceWindow();
+
+    /**
+     * @brief Time since the RTC schedule snapshot was taken
+     * @return Milliseconds (sleep duration + time since boot on timer wakes)
+     */
+    static uint32_t getTimeSinceSnapshotMs();
+
+    /**
+     * @brief Append a component's latest reading to the RTC buffer
+     * @param component Component that just executed
+     */
+    static void bufferReading(const BaseComponent* component);
+
+    /**
+     * @brief Check if this wake should upload the buffer
+     * @return true if an upload is due and has not been attempted yet
+     */
+    static bool isUploadDue();
+
+    /**
+     * @brief Check if the network is usable for the upload
+     * @return true if WiFi is connected
+     */
+    static bool isNetworkReady();
+
+    /**
+     * @brief Check if waiting for WiFi on this wake should be abandoned
+     * @return true once networkTimeoutMs has elapsed
+     */
+    static bool networkWaitExpired();
+
+    /**
+     * @brief Post all buffered readings as one JSON batch
+     * @param http HTTP client used for the request
+     * @param components Registered components (to map hashes back to IDs)
+     * @return true if the batch was accepted (buffer cleared)
+     */
+    static bool uploadBufferedReadings(HttpClientWrapper& http, const std::vector<BaseComponent*>& components);
+
+    /**
+     * @brief Account awake time, schedule the timer and enter deep sleep
+     * @param sleepMs Sleep duration in milliseconds
+     * @note Does not return
+     */
+    static void enterSleep(uint32_t sleepMs);
+
+    /**
+     * @brief Get minimum sleep worth entering
+     * @return Milliseconds
+     */
+    static uint32_t getMinSleepMs() { return s_config.minSleepMs; }
+
+    /**
+     * @brief Get maximum single sleep duration
+     * @return Milliseconds
+     */
+    static uint32_t getMaxSleepMs() { return s_config.maxSleepMs; }
+
+private:
+    static DeepSleepConfig s_config;
+    static bool s_begun;
+    static bool s_timerWake;
+    static bool s_networkThisWake;
+    static bool s_uploadAttempted;
+
+    /**
+     * @brief Current virtual time (awake + sleep since the RTC state was created)
+     * @return Milliseconds
+     */
+    static uint64_t virtualNowMs();
+
+    /**
+     * @brief Duty cycle and mean current over awake (CPU, WiFi) and sleep totals
+     */
+    static void estimate(uint64_t cpuMs, uint64_t wifiMs, uint64_t sleepMs,
+                         double& dutyPercent, double& meanCurrentMa);
+
+    /**
+     * @brief Recompute the RTC state checksum after a modification
+     */
+    static void seal();
+};
+
+#endif // DEEP_SLEEP_MANAGER_H
@@ -4,16 +4,23 @@
  */
 
 #include "Orchestrator.h"
-#include "../components/DHT22Component.h"
-#include "../components/TSL2561Component.h"
-#include "../components/PeristalticPumpComponent.h"
-#include "../components/WebServerComponent.h"
-#include "../components/PHSensorComponent.h"
-#include "../components/ECProbeComponent.h"
-// #include "../components/TestHPeristalticComponent.h"  // Disabled to save memory
-// #include "../components/MqttBroadcastComponent.h"      // Disabled to save memory
-// #include "../components/ServoDimmerComponent.h"         // Disabled to save memory
-// #include "../components/LightOrchestrator.h"            // Disabled to save memory
+#include "ComponentRegistry.h"
+#include "../storage/RtcStateStore.h"
+#include "DeepSleepManager.h"
+#include "CpuMonitor.h"
+#include "ResourceGovernor.h"
+#include "WiFiConnectionManager.h"
+#include "../utils/FlashSafeTimer.h"
+#include "../utils/EventJournal.h"
+#include <algorithm>
+
+// Out-of-line definitions for ODR-used constants
+const uint8_t Orchestrator::BACKOFF_AFTER_FAILURES;
+const uint32_t Orchestrator::MIN_BACKOFF_MS;
+const uint32_t Orchestrator::MAX_BACKOFF_MS;
+const uint32_t Orchestrator::LATENCY_BUDGET_US;
+const uint32_t Orchestrator::DEFAULT_MAX_COMPONENTS;
+const uint32_t Orchestrator::REGISTER_MIN_FREE_HEAP;
 
 Orchestrator::Orchestrator() {
     log(Logger::DEBUG, "Orchestrator created");
@@ -31,6 +38,11 @@ bool Orchestrator::init() {
     
     // Record start time
     m_startTime = millis();
+    m_bootId = esp_random() | 1;   // Never 0, which readers use for "unknown"
+    
+    // Check for a warm-restart snapshot left in RTC memory by the previous run
+    bool warmBoot = RtcStateStore::begin();
+    DeepSleepManager::begin();
     
     // Initialize configuration storage
     log(Logger::INFO, "Initializing configuration storage...");
@@ -39,6 +51,9 @@ bool Orchestrator::init() {
         return false;
     }
     
+    // Event history: reload persisted events and continue the sequence (needs LittleFS)
+    EventJournal::begin();
+    
     // Load system configuration
     loadSystemConfig();
     
@@ -57,6 +72,17 @@ bool Orchestrator::init() {
         return false;
     }
     
+    // Reapply last readings, schedule phase and counters so a restart has no data gap
+    if (warmBoot) {
+        RtcStateStore::restore(m_components, DeepSleepManager::getTimeSinceSnapshotMs());
+    }
+    
+    // WiFi comes up in the background; pause/resume network users on link changes
+    m_httpWrapper.setLinkState(WiFiConnectionManager::isConnected());
+    WiFiConnectionManager::addLinkListener([this](bool connected) {
+        onNetworkChange(connected);
+    });
+    
     m_initialized = true;
     m_running = true;
     
@@ -71,13 +97,34 @@ void Orchestrator::loop() {
         return;
     }
     
+    TRACE_SCOPE(TRACE_ORCHESTRATOR, "tick");
+    MonoTimeUs loopStartUs = TimeUtils::monoNowUs();
+    if (m_lastLoopStartUs > 0) {
+        uint32_t intervalUs = (uint32_t)(loopStartUs - m_lastLoopStartUs);
+        if (intervalUs > m_loopMaxIntervalUs) m_loopMaxIntervalUs = intervalUs;
+    }
+    m_lastLoopStartUs = loopStartUs;
     m_loopCount++;
     
     // Execute component loop (unless paused)
     if (!m_executionLoopPaused) {
         executeComponentLoop();
+        
+        // Battery nodes sleep between jobs instead of idling
+        if (DeepSleepManager::isEnabled() && !m_restartPending) {
+            handleDutyCycle();
+        }
     }
     
+    // CPU accounting snapshot (self-rate-limited)
+    CpuMonitor::update(m_components);
+    
+    // Degrade or recover under heap/CPU pressure (self-rate-limited)
+    ResourceGovernor::update(m_components);
+    
+    // Persist and push events recorded since the last pass
+    EventJournal::dispatch();
+    
     // Perform system checks periodically
     uint32_t now = millis();
     if (now - m_lastSystemCheck >= m_systemCheckInterval) {
@@ -87,7 +134,6 @@ void Orchestrator::loop() {
     
     // Handle pending restart with countdown
     if (m_restartPending) {
-        uint32_t elapsed = now - m_countdownStartTime;
         uint32_t remainingMs = (m_restartTime > now) ? (m_restartTime - now) : 0;
         uint32_t remainingSeconds = (remainingMs + 999) / 1000;  // Round up
         
@@ -103,6 +149,8 @@ void Orchestrator::loop() {
         // Execute restart when time is up
         if (now >= m_restartTime) {
             log(Logger::INFO, "Restarting system now!");
+            EventJournal::dispatch();
+            RtcStateStore::save(m_components);
             delay(100);  // Brief delay to ensure message is sent
             ESP.restart();
         }
@@ -110,6 +158,10 @@ void Orchestrator::loop() {
     
     // Update statistics
     updateStatistics();
+    
+    uint32_t loopUs = (uint32_t)(TimeUtils::monoNowUs() - loopStartUs);
+    m_loopTotalUs += loopUs;
+    if (loopUs > m_loopMaxUs) m_loopMaxUs = loopUs;
 }
 
 void Orchestrator::shutdown() {
@@ -130,6 +182,7 @@ void Orchestrator::shutdown() {
         }
     }
     m_components.clear();
+    m_executionOrder.clear();
     
     // Save system configuration
     saveSystemConfig();
@@ -156,9 +209,20 @@ bool Orchestrator::registerComponent(BaseComponent* component) {
         log(Logger::ERROR, "Maximum component limit reached: " + String(m_maxComponents));
         return false;
     }
+    if (ESP.getFreeHeap() < REGISTER_MIN_FREE_HEAP) {
+        log(Logger::ERROR, "Not enough free heap to register " + component->getId() + ": " +
+                           ESP.getFreeHeap() + " bytes");
+        return false;
+    }
     
     // Add component to list
     m_components.push_back(component);
+    m_executionOrderDirty = true;
+    
+    // Components added under pressure start degraded like the rest
+    if (ResourceGovernor::getLevel() != RESOURCE_NORMAL) {
+        component->onResourceLevel(ResourceGovernor::getLevel());
+    }
     
     log(Logger::INFO, "Component registered: " + component->getId() + 
                       " (" + component->getType() + ")");
@@ -178,6 +242,9 @@ bool Orchestrator::unregisterComponent(const String& componentId) {
     }
     
     BaseComponent* component = *it;
+    m_executionOrder.erase(std::remove(m_executionOrder.begin(), m_executionOrder.end(), component),
+                           m_executionOrder.end());
+    m_executionOrderDirty = true;
     component->cleanup();
     delete component;
     m_components.erase(it);
@@ -220,9 +287,15 @@ JsonDocument Orchestrator::getSystemStats() const {
     
     stats["uptime"] = getUptime();
     stats["componentCount"] = m_components.size();
+    stats["maxComponents"] = m_maxComponents;
+    stats["componentTypes"] = ComponentRegistry::count();
     stats["totalExecutions"] = m_totalExecutions;
     stats["totalErrors"] = m_totalErrors;
     stats["loopCount"] = m_loopCount;
+    JsonObject loopStats = stats["loop"].to<JsonObject>();
+    loopStats["avg_us"] = m_loopCount ? (uint32_t)(m_loopTotalUs / m_loopCount) : 0;
+    loopStats["max_us"] = m_loopMaxUs;
+    loopStats["max_interval_us"] = m_loopMaxIntervalUs;
     stats["initialized"] = m_initialized;
     stats["running"] = m_running;
     
@@ -231,6 +304,51 @@ JsonDocument Orchestrator::getSystemStats() const {
     stats["minFreeHeap"] = ESP.getMinFreeHeap();
     stats["maxAllocHeap"] = ESP.getMaxAllocHeap();
     
+    // Warm-restart snapshot status
+    stats["warmRestart"] = RtcStateStore::getStatus();
+    
+    // Deep-sleep duty cycle accounting
+    if (DeepSleepManager::isEnabled()) {
+        stats["dutyCycle"] = DeepSleepManager::getStats();
+    }
+    
+    // WiFi link metrics
+    stats["wifi"] = WiFiConnectionManager::getStats();
+    stats["clock"] = TimeUtils::getClockStats();
+    
+    // Per-core, per-task and per-component CPU utilization
+    stats["cpu"] = CpuMonitor::getStats();
+    
+    // Degradation level and per-level transition metrics
+    stats["resourceGovernor"] = ResourceGovernor::getStatus();
+    
+    // Flash-safe deadline timer (pump relay cut-offs) and its worst ISR latency
+    stats["deadlineTimer"] = FlashSafeTimer::getStats();
+    
+    // Dependency-ordered schedule and data age at consumption
+    JsonObject dependencies = stats["dependencies"].to<JsonObject>();
+    JsonArray order = dependencies["order"].to<JsonArray>();
+    for (auto* component : m_executionOrder) {
+        if (component) {
+            order.add(component->getId());
+        }
+    }
+    dependencies["cycles"] = m_dependencyCycles;
+    JsonArray edges = dependencies["edges"].to<JsonArray>();
+    for (auto* component : m_components) {
+        if (!component) continue;
+        for (const auto& dependency : component->getDependencies()) {
+            JsonObject edge = edges.add<JsonObject>();
+            edge["consumer"] = component->getId();
+            edge["producer"] = dependency.producerId;
+            edge["max_age_ms"] = dependency.maxAgeMs;
+            edge["last_age_ms"] = dependency.lastAgeMs;
+            edge["max_age_seen_ms"] = dependency.maxAgeSeenMs;
+            edge["refreshed"] = dependency.refreshed;
+            edge["stale"] = dependency.stale;
+        }
+    }
+    
     // Component states
     JsonObject componentStates = stats["componentStates"].to<JsonObject>();
     for (auto* component : m_components) {
@@ -257,26 +375,42 @@ JsonDocument Orchestrator::getHealthStatus() const {
     JsonObject components = health["components"].to<JsonObject>();
     int healthyCount = 0;
     int errorCount = 0;
+    int backoffCount = 0;
+    int unhealthyCount = 0;
     
     for (auto* component : m_components) {
         if (component) {
-            String componentId = component->getId();
             ComponentState state = component->getState();
+            const ComponentHealth& componentHealth = component->getHealth();
             
-            if (state == ComponentState::READY) {
-                components[componentId] = "healthy";
-                healthyCount++;
-            } else if (state == ComponentState::ERROR) {
-                components[componentId] = "error";
+            JsonObject entry = components[component->getId()].to<JsonObject>();
+            entry["state"] = component->getStateString();
+            entry["score"] = componentHealth.score;
+            entry["error_rate"] = (uint8_t)(componentHealth.errorEwma * 100.0f + 0.5f);
+            entry["latency_us"] = (uint32_t)componentHealth.latencyEwmaUs;
+            entry["consecutive_failures"] = componentHealth.consecutiveFailures;
+            
+            if (state == ComponentState::ERROR) {
+                entry["status"] = "error";
                 errorCount++;
+            } else if (component->isBackingOff()) {
+                entry["status"] = "backoff";
+                entry["next_probe_in_ms"] = (int32_t)((component->getBackoffUntilUs() - TimeUtils::monoNowUs()) / 1000);
+                backoffCount++;
+            } else if (state != ComponentState::READY) {
+                entry["status"] = component->getStateString();
+            } else if (componentHealth.score >= 80) {
+                entry["status"] = "healthy";
+                healthyCount++;
             } else {
-                components[componentId] = component->getStateString();
+                entry["status"] = componentHealth.score >= 50 ? "degraded" : "unhealthy";
+                unhealthyCount++;
             }
         }
     }
     
     // Overall health assessment
-    if (errorCount > 0) {
+    if (errorCount > 0 || backoffCount > 0 || unhealthyCount > 0) {
         health["overall"] = "degraded";
     } else if (healthyCount == 0 && m_components.size() > 0) {
         health["overall"] = "critical";
@@ -284,6 +418,8 @@ JsonDocument Orchestrator::getHealthStatus() const {
     
     health["healthyComponents"] = healthyCount;
     health["errorComponents"] = errorCount;
+    health["backoffComponents"] = backoffCount;
+    health["unhealthyComponents"] = unhealthyCount;
     
     return health;
 }
@@ -298,7 +434,18 @@ bool Orchestrator::loadSystemConfig() {
             m_systemCheckInterval = config["systemCheckInterval"].as<uint32_t>();
         }
         if (config["maxComponents"].is<uint16_t>()) {
-            m_maxComponents = config["maxComponents"].as<uint32_t>();
+            // Version 1.0.0 files saved the old fixed limit whether or not anyone chose it
+            uint32_t maxComponents = config["maxComponents"].as<uint32_t>();
+            String version = config["version"] | "";
+            if (maxComponents == LEGACY_MAX_COMPONENTS && version == "1.0.0") {
+                log(Logger::INFO, String("Ignoring legacy maxComponents ") + maxComponents + " - using " +
+                                  m_maxComponents);
+            } else {
+                m_maxComponents = maxComponents;
+            }
+        }
+        if (config["deepSleep"].is<JsonObject>()) {
+            DeepSleepManager::configure(config["deepSleep"]);
         }
         
         log(Logger::INFO, "System configuration loaded");
@@ -315,7 +462,8 @@ bool Orchestrator::saveSystemConfig() {
     JsonDocument config;
     config["systemCheckInterval"] = m_systemCheckInterval;
     config["maxComponents"] = m_maxComponents;
-    config["version"] = "1.0.0";
+    config["deepSleep"] = DeepSleepManager::getConfig();
+    config["version"] = "1.1.0";   // 1.1.0: maxComponents is a deliberate setting
     config["lastSaved"] = millis();
     
     if (m_storage.saveSystemConfig(config)) {
@@ -358,6 +506,14 @@ bool Orchestrator::initializeComponents() {
                 continue;
             }
             
+            // Duty-cycled timer wakes run sensors only - no web server, no WiFi
+            // (counted as loaded so we don't fall back to the default web server)
+            if (DeepSleepManager::isTimerWake() && componentType == "WebServer") {
+                log(Logger::DEBUG, "Skipping web server on duty-cycle wake: " + componentId);
+                loadedCount++;
+                continue;
+            }
+            
             // Create component instance based on type
             BaseComponent* component = createComponentByType(componentId, componentType);
             if (!component) {
@@ -402,28 +558,12 @@ bool Orchestrator::initializeComponents() {
 BaseComponent* Orchestrator::createComponentByType(const String& componentId, const String& componentType) {
     String componentName = componentId; // Default name, can be overridden by config
     
-    if (componentType == "DHT22" || componentType == "TemperatureSensor") {
-        return new DHT22Component(componentId, componentName, m_storage, this);
-    }
-    else if (componentType == "TSL2561" || componentType == "LightSensor") {
-        return new TSL2561Component(componentId, componentName, m_storage, this);
-    }
-    else if (componentType == "PeristalticPump" || componentType == "Pump") {
-        return new PeristalticPumpComponent(componentId, componentName, m_storage, this);
-    }
-    else if (componentType == "WebServer") {
-        return new WebServerComponent(componentId, componentName, m_storage, this);
-    }
-    else if (componentType == "PHSensor") {
-        return new PHSensorComponent(componentId, componentName, m_storage, this);
-    }
-    else if (componentType == "ECProbe") {
-        return new ECProbeComponent(componentId, componentName, m_storage, this);
-    }
-    else {
-        log(Logger::ERROR, "Unknown component type: " + componentType);
-        return nullptr;
+    BaseComponent* component = ComponentRegistry::create(componentType, componentId, componentName, m_storage, this);
+    if (!component) {
+        log(Logger::ERROR, "Unknown component type: " + componentType + " (not in this build, " +
+                           ComponentRegistry::count() + " types linked)");
     }
+    return component;
 }
 
 bool Orchestrator::initializeDefaultComponents() {
@@ -431,80 +571,19 @@ bool Orchestrator::initializeDefaultComponents() {
     
     bool allSuccess = true;
     
-    // DHT22 sensor disabled - only creating web server for minimal defaults
-    // log(Logger::INFO, "Creating DHT22 temperature/humidity sensor...");
-    // DHT22Component* dht = new DHT22Component("dht22-1", "Room Temperature/Humidity", m_storage, this);
-    
-    // Local TSL2561 light sensor disabled to save flash memory
-    // log(Logger::INFO, "Creating local TSL2561 light sensor...");
-    // TSL2561Component* tslLocal = new TSL2561Component("tsl2561-local", "Local Light Sensor", m_storage, this);
-    
-    // TSL2561 sensor disabled - only creating web server for minimal defaults
-    // log(Logger::INFO, "Creating remote TSL2561 light sensor...");
-    // TSL2561Component* tslRemote = new TSL2561Component("tsl2561-remote", "Remote Light Sensor", m_storage, this);
-    
-    // Pump components disabled - only creating web server for minimal defaults
-    // struct PumpConfig {
-    //     String id;
-    //     String name;
-    //     String function;
-    //     uint8_t pin;
-    // };
-    // 
-    // PumpConfig pumpConfigs[1] = {
-    //     {"pump-1", "Nutrient-A", "Base nutrients", 26}
-    // };
-    // 
-    // for (int i = 0; i < 1; i++) {  // Single pump for debugging
-    //     log(Logger::INFO, String("Creating pump ") + (i+1) + ": " + pumpConfigs[i].name + " (" + pumpConfigs[i].function + ")");
-    //     PeristalticPumpComponent* pump = new PeristalticPumpComponent(pumpConfigs[i].id, pumpConfigs[i].name, m_storage, this);
-    //     
-    //     // Create custom config with specific GPIO pin
-    //     JsonDocument pumpConfig;
-    //     pumpConfig["pumpPin"] = pumpConfigs[i].pin;
-    //     pumpConfig["mlPerSecond"] = 40.0;  // Standard flow rate
-    //     pumpConfig["maxRuntimeMs"] = 60000; // 60 second safety timeout
-    //     
-    //     if (!pump->initialize(pumpConfig)) {
-    //         log(Logger::ERROR, String("Failed to initialize pump: ") + pumpConfigs[i].id);
-    //         delete pump;
-    //         allSuccess = false;
-    //     } else {
-    //         if (!registerComponent(pump)) {
-    //             log(Logger::ERROR, String("Failed to register pump: ") + pumpConfigs[i].id);
-    //             delete pump;
-    //             allSuccess = false;
-    //         } else {
-    //             log(Logger::INFO, String("Successfully registered pump: ") + pumpConfigs[i].id + " on GPIO" + pumpConfigs[i].pin);
-    //         }
-    //     }
-    // }
-    
-    // Initialize Test Harness for pump testing - TEMPORARILY DISABLED TO SAVE FLASH MEMORY
-    // log(Logger::INFO, "Creating pump test harness...");
-    // TestHPeristalticComponent* testHarness = new TestHPeristalticComponent("test-harness-1", "Pump Test Harness", m_storage, this);
-    // 
-    // if (!testHarness->initialize(JsonDocument())) {  // Use default configuration
-    //     log(Logger::ERROR, "Failed to initialize test harness component");
-    //     delete testHarness;
-    //     allSuccess = false;
-    // } else {
-    //     if (!registerComponent(testHarness)) {
-    //         log(Logger::ERROR, "Failed to register test harness component");
-    //         delete testHarness;
-    //         allSuccess = false;
-    //     }
-    // }
-    
-    // MQTT Broadcast Component disabled to save flash memory
-    // log(Logger::INFO, "Creating MQTT broadcast component...");
-    // MqttBroadcastComponent* mqttBroadcast = new MqttBroadcastComponent("mqtt-broadcast-1", "MQTT Component Broadcaster", m_storage, this);
+    // Sensors, pumps and the rest are added through /api/components/add and
+    // restored from their saved configs; see ComponentRegistry for the types
+    // linked into this build.
     
+#if COMPONENT_WEB_SERVER
     // Initialize Web Server Component (after WiFi is connected)
     log(Logger::INFO, "Creating web server component...");
-    WebServerComponent* webServer = new WebServerComponent("web-server-1", "HTTP API Server", m_storage, this);
+    BaseComponent* webServer = ComponentRegistry::create("WebServer", "web-server-1", "HTTP API Server", m_storage, this);
     
-    if (!webServer->initialize(JsonDocument())) {  // Use default configuration
+    if (!webServer) {
+        log(Logger::ERROR, "Web server type is not linked into this build - skipping");
+        allSuccess = false;
+    } else if (!webServer->initialize(JsonDocument())) {  // Use default configuration
         log(Logger::ERROR, "Failed to initialize web server component");
         delete webServer;
         allSuccess = false;
@@ -515,103 +594,7 @@ bool Orchestrator::initializeDefaultComponents() {
             allSuccess = false;
         }
     }
-    
-    // Initialize Servo Dimmer Component - TEMPORARILY DISABLED TO SAVE FLASH MEMORY
-    // log(Logger::INFO, "Creating servo dimmer component...");
-    // ServoDimmerComponent* servoDimmer = new ServoDimmerComponent("servo-dimmer-1", "Lighting Servo Dimmer", m_storage, this);
-    // 
-    // if (!servoDimmer->initialize(JsonDocument())) {  // Use default configuration
-    //     log(Logger::ERROR, "Failed to initialize servo dimmer component");
-    //     delete servoDimmer;
-    //     allSuccess = false;
-    // } else {
-    //     if (!registerComponent(servoDimmer)) {
-    //         log(Logger::ERROR, "Failed to register servo dimmer component");
-    //         delete servoDimmer;
-    //         allSuccess = false;
-    //     }
-    // }
-    
-    // Initialize Light Orchestrator Component - TEMPORARILY DISABLED TO SAVE FLASH MEMORY
-    // log(Logger::INFO, "Creating light orchestrator component...");
-    // LightOrchestrator* lightOrchestrator = new LightOrchestrator("light-orchestrator-1", "Intelligent Lighting Controller", m_storage, this);
-    // 
-    // if (!lightOrchestrator->initialize(JsonDocument())) {  // Use default configuration
-    //     log(Logger::ERROR, "Failed to initialize light orchestrator component");
-    //     delete lightOrchestrator;
-    //     allSuccess = false;
-    // } else {
-    //     if (!registerComponent(lightOrchestrator)) {
-    //         log(Logger::ERROR, "Failed to register light orchestrator component");
-    //         delete lightOrchestrator;
-    //         allSuccess = false;
-    //     }
-    // }
-    
-    // pH sensor disabled - only creating web server for minimal defaults
-    // log(Logger::INFO, "Creating pH sensor component in mock mode...");
-    // PHSensorComponent* phSensor = new PHSensorComponent("ph-sensor-1", "pH Sensor (Mock)", m_storage, this);
-    // 
-    // // Configure for mock mode (GPIO pin 0)
-    // JsonDocument phConfig;
-    // phConfig["gpio_pin"] = 0;  // Mock mode
-    // phConfig["temp_coefficient"] = 0.05992;
-    // phConfig["sample_size"] = 10;
-    // phConfig["adc_voltage_ref"] = 3.3;
-    // phConfig["adc_resolution"] = 4096;
-    // phConfig["reading_interval_ms"] = 500;
-    // phConfig["time_period_for_sampling"] = 10000;
-    // phConfig["outlier_threshold"] = 2.0;
-    // phConfig["temperature_source_id"] = "dht22-1";
-    // phConfig["excite_voltage_component_id"] = "";
-    // phConfig["excite_stabilize_ms"] = 500;
-    // 
-    // if (!phSensor->initialize(phConfig)) {
-    //     log(Logger::ERROR, "Failed to initialize pH sensor component");
-    //     delete phSensor;
-    //     allSuccess = false;
-    // } else {
-    //     if (!registerComponent(phSensor)) {
-    //         log(Logger::ERROR, "Failed to register pH sensor component");
-    //         delete phSensor;
-    //         allSuccess = false;
-    //     } else {
-    //         log(Logger::INFO, "Successfully registered pH sensor in mock mode");
-    //     }
-    // }
-    
-    // EC probe disabled - only creating web server for minimal defaults
-    // log(Logger::INFO, "Creating EC probe component in mock mode...");
-    // ECProbeComponent* ecProbe = new ECProbeComponent("ec-probe-1", "EC Probe (Mock)", m_storage, this);
-    // 
-    // // Configure for mock mode (GPIO pin 0)
-    // JsonDocument ecConfig;
-    // ecConfig["gpio_pin"] = 0;  // Mock mode
-    // ecConfig["temp_coefficient"] = 2.0;
-    // ecConfig["sample_size"] = 15;
-    // ecConfig["adc_voltage_ref"] = 3.3;
-    // ecConfig["adc_resolution"] = 4096;
-    // ecConfig["reading_interval_ms"] = 800;
-    // ecConfig["time_period_for_sampling"] = 15000;
-    // ecConfig["outlier_threshold"] = 2.5;
-    // ecConfig["tds_conversion_factor"] = 0.64;
-    // ecConfig["temperature_source_id"] = "dht22-1";
-    // ecConfig["excite_voltage_component_id"] = "";
-    // ecConfig["excite_stabilize_ms"] = 1000;
-    // 
-    // if (!ecProbe->initialize(ecConfig)) {
-    //     log(Logger::ERROR, "Failed to initialize EC probe component");
-    //     delete ecProbe;
-    //     allSuccess = false;
-    // } else {
-    //     if (!registerComponent(ecProbe)) {
-    //         log(Logger::ERROR, "Failed to register EC probe component");
-    //         delete ecProbe;
-    //         allSuccess = false;
-    //     } else {
-    //         log(Logger::INFO, "Successfully registered EC probe in mock mode");
-    //     }
-    // }
+#endif
     
     if (allSuccess) {
         log(Logger::INFO, String("Default components initialized successfully (") + 
@@ -647,10 +630,10 @@ void Orchestrator::executeComponentLoop() {
             
             // Check if any components are properly scheduled (not stuck)
             bool anyComponentScheduled = false;
-            uint32_t currentTime = millis();
+            MonoTimeUs currentTime = TimeUtils::monoNowUs();
             for (auto* component : m_components) {
                 if (component && component->getState() == ComponentState::READY && 
-                    component->getNextExecutionMs() > currentTime) {
+                    component->getNextExecutionUs() > currentTime) {
                     anyComponentScheduled = true;
                     break;
                 }
@@ -672,6 +655,7 @@ void Orchestrator::executeComponentLoop() {
 }
 
 void Orchestrator::performSystemCheck() {
+    TRACE_SCOPE(TRACE_ORCHESTRATOR, "systemCheck");
     log(Logger::DEBUG, "Performing system health check...");
     
     // Check system resources
@@ -693,8 +677,10 @@ void Orchestrator::performSystemCheck() {
         log(Logger::WARNING, String(errorComponents) + " components in error state");
     }
     
+    // Refresh the RTC snapshot so watchdog/panic resets also restart warm
+    RtcStateStore::save(m_components);
+    
     // Log system statistics periodically
-    JsonDocument stats = getSystemStats();
     log(Logger::INFO, String("System Stats - Uptime: ") + (getUptime() / 1000) + "s" +
                       ", Components: " + m_components.size() +
                       ", Executions: " + m_totalExecutions +
@@ -704,40 +690,185 @@ void Orchestrator::performSystemCheck() {
 int Orchestrator::executeReadyComponents() {
     int executedCount = 0;
     
-    for (auto* component : m_components) {
+    if (m_executionOrderDirty) {
+        rebuildExecutionOrder();
+    }
+    
+    // Dependency order: a consumer due in the same pass sees its producer's new sample.
+    // The clock is read once per pass and again only after something executed, so an
+    // idle pass over hundreds of components is a field comparison per component.
+    MonoTimeUs nowUs = TimeUtils::monoNowUs();
+    for (size_t i = 0; i < m_executionOrder.size(); i++) {
+        BaseComponent* component = m_executionOrder[i];
         if (!component) continue;
         
         // Check if component is ready to execute
-        if (component->isReadyToExecute()) {
+        if (component->isReadyToExecute(nowUs)) {
             log(Logger::DEBUG, "Executing component: " + component->getId());
             
-            // Execute the component
-            ExecutionResult result = component->execute();
-            
-            // Handle the result
-            handleExecutionResult(component, result);
-            
+            if (runComponent(component)) {
+                scheduleFollowers(component);
+            }
             executedCount++;
+            nowUs = TimeUtils::monoNowUs();
         }
     }
     
     return executedCount;
 }
 
+bool Orchestrator::runComponent(BaseComponent* component) {
+    // Execute the component, measuring start lag and duration on the monotonic clock
+    MonoTimeUs startUs = TimeUtils::monoNowUs();
+    MonoTimeUs lagUs = startUs - component->getNextExecutionUs();
+    BaseComponent* previous = m_executingComponent;
+    m_executingComponent = component;
+    Tracer::begin(TRACE_COMPONENT, component->getTraceName());
+    ExecutionResult result = component->execute();
+    Tracer::end(TRACE_COMPONENT, component->getTraceName());
+    m_executingComponent = previous;
+    component->recordExecutionTiming((uint32_t)(TimeUtils::monoNowUs() - startUs),
+                                     lagUs > 0 ? (uint32_t)min(lagUs, (MonoTimeUs)UINT32_MAX) : 0);
+    
+    // Handle the result
+    handleExecutionResult(component, result);
+    
+    // Under resource pressure sensors sample less often; time-critical components keep their
+    // schedule, and a paused task's in-cycle delays are not stretched (only the gap between cycles)
+    uint8_t scale = ResourceGovernor::getIntervalScale();
+    if (scale > 1 && !component->isTimeCritical() && !component->isTaskSuspended()) {
+        MonoTimeUs nextUs = component->getNextExecutionUs();
+        if (nextUs > startUs) {
+            component->setNextExecutionUs(startUs + (nextUs - startUs) * scale);
+            ResourceGovernor::noteStretchedExecution();
+        }
+    }
+    return result.success;
+}
+
+bool Orchestrator::refreshComponent(BaseComponent* component) {
+    if (!component || m_refreshing || component == m_executingComponent ||
+        component->getState() != ComponentState::READY || component->isBackingOff()) {
+        return false;
+    }
+    
+    log(Logger::DEBUG, "On-demand read of " + component->getId() +
+                       (m_executingComponent ? " for " + m_executingComponent->getId() : String("")));
+    m_refreshing = true;
+    bool success = runComponent(component);
+    m_refreshing = false;
+    return success;
+}
+
+void Orchestrator::rebuildExecutionOrder() {
+    m_executionOrderDirty = false;
+    m_executionOrder.clear();
+    m_executionOrder.reserve(m_components.size());
+    
+    // In-degree = number of registered producers each component consumes
+    std::vector<uint8_t> pending(m_components.size(), 0);
+    for (size_t i = 0; i < m_components.size(); i++) {
+        if (!m_components[i]) continue;
+        for (const auto& dependency : m_components[i]->getDependencies()) {
+            if (findComponent(dependency.producerId)) {
+                pending[i]++;
+            }
+        }
+    }
+    
+    // Repeatedly take the first component whose producers are all placed (keeps registration order)
+    std::vector<bool> placed(m_components.size(), false);
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (size_t i = 0; i < m_components.size(); i++) {
+            if (placed[i] || pending[i] > 0 || !m_components[i]) continue;
+            
+            placed[i] = true;
+            progress = true;
+            m_executionOrder.push_back(m_components[i]);
+            const String& producerId = m_components[i]->getId();
+            for (size_t j = 0; j < m_components.size(); j++) {
+                if (placed[j] || !m_components[j]) continue;
+                for (const auto& dependency : m_components[j]->getDependencies()) {
+                    if (dependency.producerId == producerId && pending[j] > 0) {
+                        pending[j]--;
+                    }
+                }
+            }
+        }
+    }
+    
+    m_dependencyCycles = 0;
+    for (size_t i = 0; i < m_components.size(); i++) {
+        if (!placed[i] && m_components[i]) {
+            m_executionOrder.push_back(m_components[i]);
+            m_dependencyCycles++;
+        }
+    }
+    
+    if (m_dependencyCycles > 0) {
+        log(Logger::WARNING, String(m_dependencyCycles) + " components are in a data dependency cycle; "
+                             "they keep registration order");
+    }
+}
+
+void Orchestrator::scheduleFollowers(BaseComponent* producer) {
+    MonoTimeUs nowUs = TimeUtils::monoNowUs();
+    for (auto* consumer : m_executionOrder) {
+        if (consumer && consumer != producer && consumer->getState() == ComponentState::READY &&
+            consumer->getNextExecutionUs() > nowUs && consumer->followsProducer(producer->getId())) {
+            consumer->setNextExecutionUs(nowUs);
+        }
+    }
+}
+
 void Orchestrator::handleExecutionResult(BaseComponent* component, const ExecutionResult& result) {
     m_totalExecutions++;
     
+    // Consumers measure data age from the last successful sample
+    if (result.success && !result.data.isNull()) {
+        // Component first, then the node-wide number: delta readers snapshot the latter
+        uint32_t seq = m_dataSeq.load(std::memory_order_relaxed) + 1;
+        component->markSampled(seq);
+        m_dataSeq.store(seq, std::memory_order_release);
+    }
+    
+    component->recordExecutionOutcome(result.success, LATENCY_BUDGET_US);
+    const ComponentHealth& health = component->getHealth();
+    
     if (result.success) {
-        log(Logger::DEBUG, "Component execution successful: " + component->getId() +
-                           " (" + result.executionTimeMs + "ms)");
+        if (Logger::isEnabled(Logger::DEBUG)) {
+            log(Logger::DEBUG, "Component execution successful: " + component->getId() +
+                               " (" + result.executionTimeMs + "ms)");
+        }
+        if (component->isBackingOff()) {
+            log(Logger::INFO, "Component recovered: " + component->getId() + " - resuming normal schedule");
+            component->clearBackoff();
+        }
     } else {
         m_totalErrors++;
-        log(Logger::WARNING, "Component execution failed: " + component->getId() +
-                            " - " + result.message);
+        if (health.consecutiveFailures < BACKOFF_AFTER_FAILURES) {
+            log(Logger::WARNING, "Component execution failed: " + component->getId() +
+                                " - " + result.message);
+        } else {
+            // Back off exponentially; only the first failure of a streak is logged loudly
+            bool wasBackingOff = component->isBackingOff();
+            uint32_t backoffMs = wasBackingOff ? min(health.backoffMs * 2, MAX_BACKOFF_MS) : MIN_BACKOFF_MS;
+            component->enterBackoff(backoffMs);
+            log(wasBackingOff ? Logger::DEBUG : Logger::WARNING,
+                "Component " + component->getId() + " failed " + health.consecutiveFailures +
+                " times in a row (" + result.message + ") - next recovery probe in " + (backoffMs / 1000) + "s");
+        }
+    }
+    
+    // Duty-cycled nodes keep readings in RTC memory until the next batch upload
+    if (result.success && DeepSleepManager::isEnabled()) {
+        DeepSleepManager::bufferReading(component);
     }
     
     // Log detailed data for debugging (only in DEBUG mode)
-    if (result.success && !result.data.isNull()) {
+    if (result.success && !result.data.isNull() && Logger::isEnabled(Logger::DEBUG)) {
         String dataStr;
         serializeJson(result.data, dataStr);
         log(Logger::DEBUG, "Component data: " + component->getId() + " -> " + dataStr);
@@ -764,6 +895,20 @@ void Orchestrator::log(Logger::Level level, const String& message) {
     }
 }
 
+void Orchestrator::onNetworkChange(bool connected) {
+    log(Logger::INFO, String("Network ") + (connected ? "up - resuming" : "down - pausing") + " network users");
+    
+    EventJournal::record(EVENT_NETWORK, connected ? Logger::INFO : Logger::WARNING, "wifi",
+                         connected ? "Link up" : "Link down", connected ? 1 : 0);
+    
+    m_httpWrapper.setLinkState(connected);
+    for (BaseComponent* component : m_components) {
+        if (component) {
+            component->onNetworkChange(connected);
+        }
+    }
+}
+
 JsonDocument Orchestrator::fetchRemoteData(const String& url, uint32_t timeoutMs) {
     JsonDocument result;
     
@@ -799,27 +944,64 @@ JsonDocument Orchestrator::fetchRemoteData(const String& url, uint32_t timeoutMs
     return result;
 }
 
+void Orchestrator::handleDutyCycle() {
+    if (DeepSleepManager::inMaintenanceWindow()) {
+        return;
+    }
+    
+    // Find the next due time; stay awake while anything is due or busy
+    MonoTimeUs now = TimeUtils::monoNowUs();
+    uint32_t sleepMs = DeepSleepManager::getMaxSleepMs();
+    for (auto* component : m_components) {
+        if (!component) continue;
+        
+        ComponentState state = component->getState();
+        if (state == ComponentState::INITIALIZING || state == ComponentState::EXECUTING) {
+            return;
+        }
+        if (state != ComponentState::READY) continue;
+        if (component->isReadyToExecute(now)) {
+            return;
+        }
+        
+        MonoTimeUs remainingUs = component->getNextExecutionUs() - now;
+        if (remainingUs / 1000 < (MonoTimeUs)sleepMs) {
+            sleepMs = (uint32_t)(remainingUs / 1000);
+        }
+    }
+    
+    // Upload wakes: wait (bounded) for WiFi, then send the batch once
+    if (DeepSleepManager::isUploadDue()) {
+        if (!DeepSleepManager::isNetworkReady() && !DeepSleepManager::networkWaitExpired()) {
+            return;
+        }
+        DeepSleepManager::uploadBufferedReadings(m_httpWrapper, m_components);
+    }
+    
+    if (sleepMs < DeepSleepManager::getMinSleepMs()) {
+        return;  // Next job is too close for a sleep to pay off
+    }
+    
+    // Schedule offsets travel in the RTC snapshot; restore() deducts the sleep
+    EventJournal::dispatch();
+    RtcStateStore::save(m_components);
+    DeepSleepManager::enterSleep(sleepMs);
+}
+
 void Orchestrator::updateStatistics() {
     // Statistics are updated in real-time during execution
     // This function could be used for periodic calculations
 }
 
 bool Orchestrator::checkSystemResources() {
-    // Check available heap memory
-    uint32_t freeHeap = ESP.getFreeHeap();
-    if (freeHeap < 10000) {  // Less than 10KB free
-        log(Logger::WARNING, String("Low memory: ") + freeHeap + " bytes free");
-        return false;
-    }
-    
-    // Check for heap fragmentation
-    uint32_t maxBlock = ESP.getMaxAllocHeap();
-    if (maxBlock < freeHeap / 2) {  // Fragmentation detected
-        log(Logger::WARNING, "Heap fragmentation detected");
-        return false;
+    // The governor samples every second and acts on its own; this only reports
+    uint8_t level = ResourceGovernor::getLevel();
+    if (level == RESOURCE_NORMAL) {
+        return true;
     }
-    
-    return true;
+    log(Logger::WARNING, String("Resource level ") + ResourceGovernor::levelName(level) + " - " +
+                         ESP.getFreeHeap() + " bytes free, largest block " + ESP.getMaxAllocHeap());
+    return false;
 }
 
 ActionResult Orchestrator::executeComponentAction(const String& componentId, const String& actionName, const JsonDocument& parameters) {
@@ -904,6 +1086,7 @@ bool Orchestrator::scheduleRestart(uint32_t delaySeconds) {
     m_restartTime = now + (delaySeconds * 1000);
     
     log(Logger::INFO, String("System restart scheduled in ") + delaySeconds + " seconds");
+    EventJournal::record(EVENT_RESTART, Logger::WARNING, "system", "Restart scheduled", (int32_t)delaySeconds);
     return true;
 }
 
@@ -917,6 +1100,7 @@ JsonDocument Orchestrator::getExecutionLoopConfig() const {
     config["total_errors"] = m_totalErrors;
     config["loop_count"] = m_loopCount;
     config["uptime_ms"] = getUptime();
+    config["deep_sleep"] = DeepSleepManager::getConfig();
     
     return config;
 }
@@ -938,6 +1122,12 @@ bool Orchestrator::updateExecutionLoopConfig(const JsonDocument& config) {
         }
     }
     
+    // Update deep-sleep duty cycle settings if provided (persisted with system config)
+    if (config["deep_sleep"].is<JsonObjectConst>()) {
+        DeepSleepManager::configure(config["deep_sleep"]);
+        saveSystemConfig();
+    }
+    
     // Update pause state if provided
     if (config["paused"].is<bool>()) {
         bool shouldPause = config["paused"];
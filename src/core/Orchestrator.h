@@ -10,12 +10,11 @@
 #define ORCHESTRATOR_H
 
 #include <Arduino.h>
+#include <atomic>
 #include <vector>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include "../components/BaseComponent.h"
-#include "../components/DHT22Component.h"
-#include "../components/TSL2561Component.h"
 #include "../storage/ConfigStorage.h"
 #include "../utils/Logger.h"
 #include "../utils/HttpClientWrapper.h"
@@ -27,11 +26,29 @@
  * Provides a minimal but complete foundation for IoT component orchestration.
  */
 class Orchestrator {
+public:
+    // Failure backoff: after BACKOFF_AFTER_FAILURES consecutive failures a component
+    // only runs as a recovery probe, with the interval doubling up to MAX_BACKOFF_MS
+    static const uint8_t BACKOFF_AFTER_FAILURES = 3;
+    static const uint32_t MIN_BACKOFF_MS = 5000;
+    static const uint32_t MAX_BACKOFF_MS = 300000;     // 5 minutes between probes at most
+    static const uint32_t LATENCY_BUDGET_US = 50000;   // execute() time above this lowers the health score
+    
+    // The component count is bounded by memory, not a fixed small table
+    static const uint32_t DEFAULT_MAX_COMPONENTS = 256;
+    static const uint32_t LEGACY_MAX_COMPONENTS = 20;       // Fixed limit saved by system.json version 1.0.0
+    static const uint32_t REGISTER_MIN_FREE_HEAP = 24576;   // Headroom kept for the web server and JSON
+
 private:
     // Core components
     ConfigStorage m_storage;
     HttpClientWrapper m_httpWrapper;
     std::vector<BaseComponent*> m_components;
+    std::vector<BaseComponent*> m_executionOrder;   // Producers before their consumers
+    bool m_executionOrderDirty = true;
+    uint8_t m_dependencyCycles = 0;                  // Components left in dependency cycles
+    BaseComponent* m_executingComponent = nullptr;
+    bool m_refreshing = false;                       // Inside an on-demand producer read
     
     // System state
     bool m_initialized = false;
@@ -41,12 +58,20 @@ private:
     
     // Configuration
     uint32_t m_systemCheckInterval = 30000;  // 30 seconds
-    uint32_t m_maxComponents = 20;           // Maximum number of components (increased for 8-pump system)
+    uint32_t m_maxComponents = DEFAULT_MAX_COMPONENTS;   // Override with "maxComponents" in system.json
     
     // Statistics
     uint32_t m_totalExecutions = 0;
     uint32_t m_totalErrors = 0;
     uint32_t m_loopCount = 0;
+    std::atomic<uint32_t> m_dataSeq{0};              // Last sequence number given to a sample
+    uint32_t m_bootId = 0;                           // Random per boot; peers detect restarts by it
+    
+    // Loop pass timing (tick overhead seen by the main task)
+    MonoTimeUs m_lastLoopStartUs = 0;
+    uint64_t m_loopTotalUs = 0;
+    uint32_t m_loopMaxUs = 0;
+    uint32_t m_loopMaxIntervalUs = 0;
     
     // Execution loop control
     bool m_executionLoopPaused = false;
@@ -105,6 +130,22 @@ public:
      * @return Component pointer or nullptr if not found
      */
     BaseComponent* findComponent(const String& componentId);
+    
+    /**
+     * @brief Execute a producer now because a consumer needs fresher data
+     * 
+     * Only one level deep: a producer refreshed on demand cannot refresh its own
+     * producers, and the component currently executing is never re-entered.
+     * 
+     * @param component Producer to execute
+     * @return true if it executed successfully
+     */
+    bool refreshComponent(BaseComponent* component);
+    
+    /**
+     * @brief Rebuild the dependency order before the next loop pass
+     */
+    void invalidateExecutionOrder() { m_executionOrderDirty = true; }
 
     /**
      * @brief Fetch data from remote HTTP endpoint (shared service)
@@ -137,6 +178,20 @@ public:
      */
     ActionResult executeComponentAction(const String& componentId, const String& actionName, const JsonDocument& parameters);
 
+    /**
+     * @brief Get the sequence number of the most recent sample of any component
+     * 
+     * Published after the sample's component carries it, so every component
+     * sampled at or below the returned number already shows its sequence
+     * number (any task).
+     */
+    uint32_t getDataSeq() const { return m_dataSeq.load(std::memory_order_acquire); }
+    
+    /**
+     * @brief Get the random identifier of this boot (sequence numbers restart with it)
+     */
+    uint32_t getBootId() const { return m_bootId; }
+
     /**
      * @brief Get component count
      * @return Number of registered components
@@ -272,6 +327,26 @@ private:
      */
     int executeReadyComponents();
 
+    /**
+     * @brief Execute one component with lag/duration accounting and result handling
+     * @return true if the execution succeeded
+     */
+    bool runComponent(BaseComponent* component);
+
+    /**
+     * @brief Order components so producers run before consumers (Kahn's algorithm)
+     * 
+     * Components caught in a dependency cycle keep their registration order
+     * after the acyclic part and are counted in m_dependencyCycles.
+     */
+    void rebuildExecutionOrder();
+
+    /**
+     * @brief Pull consumers that follow a producer forward to run right after its sample
+     * @param producer Component that just produced fresh data
+     */
+    void scheduleFollowers(BaseComponent* producer);
+
     /**
      * @brief Initialize any components in UNINITIALIZED state (created via API)
      * This handles deferred initialization for components created through the API
@@ -285,6 +360,12 @@ private:
      */
     void handleExecutionResult(BaseComponent* component, const ExecutionResult& result);
 
+    /**
+     * @brief Propagate a WiFi link change to the HTTP client and all components
+     * @param connected New link state
+     */
+    void onNetworkChange(bool connected);
+
     /**
      * @brief Log system message
      * @param level Log level
@@ -302,6 +383,14 @@ private:
      * @return true if resources are healthy
      */
     bool checkSystemResources();
+    
+    /**
+     * @brief Deep-sleep duty cycling: upload when due, then sleep until the next job
+     * 
+     * Only returns when the node should stay awake (job due soon, component
+     * busy, waiting for WiFi or inside the post-boot maintenance window).
+     */
+    void handleDutyCycle();
 };
 
 #endif // ORCHESTRATOR_H
\ No newline at end of file
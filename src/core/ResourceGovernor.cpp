@@ -0,0 +1,224 @@
+/**
+ * @file ResourceGovernor.cpp
+ * @brief ResourceGovernor implementation
+ */
+
+#include "ResourceGovernor.h"
+#include "CpuMonitor.h"
+#include "../components/BaseComponent.h"
+#include "../utils/EventJournal.h"
+#include "../utils/Tracer.h"
+#ifndef NATIVE_SIM
+#include "../utils/SamplingProfiler.h"
+#include "../utils/DeviceBenchmark.h"
+#endif
+
+// Out-of-line definitions for ODR-used constants
+const uint32_t ResourceGovernor::UPDATE_INTERVAL_MS;
+const uint32_t ResourceGovernor::RELAX_HOLD_MS;
+const uint8_t ResourceGovernor::HYSTERESIS_PCT;
+const uint8_t ResourceGovernor::CPU_HYSTERESIS_PCT;
+
+// Index = level; NORMAL has no thresholds. The 10 KB protect level is the
+// point the orchestrator used to report as "low memory".
+const ResourceGovernor::Thresholds ResourceGovernor::ENTER[RESOURCE_LEVEL_COUNT] = {
+    { 0, 0, 0 },
+    { 40000, 16000, 85 },     // conserve
+    { 28000, 12000, 92 },     // stretch
+    { 18000, 8000, 97 },      // shed
+    { 10000, 4000, 0 },       // protect: memory only, a busy CPU is no danger to actuators
+};
+
+// Static member initialization
+volatile uint8_t ResourceGovernor::s_level = RESOURCE_NORMAL;
+uint8_t ResourceGovernor::s_peakLevel = RESOURCE_NORMAL;
+uint32_t ResourceGovernor::s_lastUpdateMs = 0;
+uint32_t ResourceGovernor::s_levelSinceMs = 0;
+uint32_t ResourceGovernor::s_calmSinceMs = 0;
+const char* ResourceGovernor::s_reason = "";
+uint32_t ResourceGovernor::s_freeHeap = 0;
+uint32_t ResourceGovernor::s_largestBlock = 0;
+float ResourceGovernor::s_corePct = 0.0f;
+uint32_t ResourceGovernor::s_minFreeHeap = UINT32_MAX;
+uint32_t ResourceGovernor::s_transitions = 0;
+uint32_t ResourceGovernor::s_entries[RESOURCE_LEVEL_COUNT] = {};
+uint64_t ResourceGovernor::s_levelTimeMs[RESOURCE_LEVEL_COUNT] = {};
+std::atomic<uint32_t> ResourceGovernor::s_rejectedRequests(0);
+uint32_t ResourceGovernor::s_stretchedExecutions = 0;
+
+static const char* LEVEL_NAMES[RESOURCE_LEVEL_COUNT] = {
+    "normal", "conserve", "stretch", "shed", "protect"
+};
+
+void ResourceGovernor::update(const std::vector<BaseComponent*>& components) {
+    uint32_t now = millis();
+    if (s_lastUpdateMs != 0 && now - s_lastUpdateMs < UPDATE_INTERVAL_MS) {
+        return;
+    }
+    s_lastUpdateMs = now;
+
+    s_freeHeap = ESP.getFreeHeap();
+    s_largestBlock = ESP.getMaxAllocHeap();
+    s_corePct = CpuMonitor::getPeakCoreLoad();
+    if (s_freeHeap < s_minFreeHeap) s_minFreeHeap = s_freeHeap;
+
+    const char* reason = "";
+    uint8_t pressure = pressureLevel(false, reason);
+    if (pressure > s_level) {
+        s_calmSinceMs = 0;
+        changeLevel(pressure, reason, components);
+        return;
+    }
+
+    // Leave only when clear of the current level's thresholds by the margin, one level per hold
+    const char* relaxedReason = "";
+    uint8_t relaxed = pressureLevel(true, relaxedReason);
+    if (relaxed >= s_level) {
+        s_calmSinceMs = 0;
+        return;
+    }
+    if (s_calmSinceMs == 0) {
+        s_calmSinceMs = now;
+    } else if (now - s_calmSinceMs >= RELAX_HOLD_MS) {
+        s_calmSinceMs = now;
+        changeLevel(s_level - 1, "recovered", components);
+    }
+}
+
+uint8_t ResourceGovernor::pressureLevel(bool withMargin, const char*& reason) {
+    for (uint8_t level = RESOURCE_LEVEL_COUNT - 1; level > RESOURCE_NORMAL; level--) {
+        const Thresholds& enter = ENTER[level];
+        uint32_t heapLimit = withMargin ? enter.freeHeap + enter.freeHeap * HYSTERESIS_PCT / 100 : enter.freeHeap;
+        uint32_t blockLimit = withMargin ? enter.largestBlock + enter.largestBlock * HYSTERESIS_PCT / 100
+                                         : enter.largestBlock;
+        float cpuLimit = withMargin ? (float)enter.corePct - CPU_HYSTERESIS_PCT : (float)enter.corePct;
+
+        if (s_freeHeap < heapLimit) {
+            reason = "free_heap";
+            return level;
+        }
+        if (s_largestBlock < blockLimit) {
+            reason = "largest_block";
+            return level;
+        }
+        if (enter.corePct > 0 && s_corePct > cpuLimit) {
+            reason = "cpu";
+            return level;
+        }
+    }
+    reason = "";
+    return RESOURCE_NORMAL;
+}
+
+void ResourceGovernor::changeLevel(uint8_t level, const char* reason, const std::vector<BaseComponent*>& components) {
+    uint8_t previous = s_level;
+    uint32_t now = millis();
+
+    s_levelTimeMs[previous] += now - s_levelSinceMs;
+    s_levelSinceMs = now;
+    s_level = level;
+    s_reason = reason;
+    s_transitions++;
+    s_entries[level]++;
+    if (level > s_peakLevel) s_peakLevel = level;
+
+    // Log output first: shedding it must not hide the transition itself
+    String message = String("Resource level ") + LEVEL_NAMES[previous] + " -> " + LEVEL_NAMES[level] +
+                     " (" + reason + ": heap " + s_freeHeap + ", block " + s_largestBlock +
+                     ", core " + (int)s_corePct + "%)";
+    Logger::shed(Logger::DEBUG, false);
+    if (level > previous) {
+        Logger::warning("ResourceGovernor", message);
+    } else {
+        Logger::info("ResourceGovernor", message);
+    }
+    EventJournal::record(EVENT_RESOURCE, level > previous ? Logger::WARNING : Logger::INFO, "governor",
+                         String(LEVEL_NAMES[previous]) + "->" + LEVEL_NAMES[level] + " " + reason, level);
+
+    Logger::shed(level >= RESOURCE_SHED ? Logger::WARNING :
+                 level >= RESOURCE_CONSERVE ? Logger::INFO : Logger::DEBUG,
+                 level >= RESOURCE_SHED);
+
+    // Diagnostics that hold heap or interrupt time; restarted by hand when wanted
+    if (level >= RESOURCE_SHED && previous < RESOURCE_SHED) {
+        Tracer::release();
+#ifndef NATIVE_SIM
+        SamplingProfiler::stop();
+        DeviceBenchmark::releaseReport();
+#endif
+    }
+
+    rescaleSchedules(scaleFor(previous), scaleFor(level), components);
+
+    for (BaseComponent* component : components) {
+        if (component) {
+            component->onResourceLevel(level);
+        }
+    }
+}
+
+void ResourceGovernor::rescaleSchedules(uint8_t fromScale, uint8_t toScale, const std::vector<BaseComponent*>& components) {
+    // Pending waits follow the new scale at once instead of at the next execution
+    if (fromScale == toScale) {
+        return;
+    }
+    MonoTimeUs nowUs = TimeUtils::monoNowUs();
+    for (BaseComponent* component : components) {
+        if (!component || component->isTimeCritical() || component->isTaskSuspended() ||
+            component->getState() != ComponentState::READY) {
+            continue;
+        }
+        MonoTimeUs remainingUs = component->getNextExecutionUs() - nowUs;
+        if (remainingUs > 0) {
+            component->setNextExecutionUs(nowUs + remainingUs * toScale / fromScale);
+        }
+    }
+}
+
+uint8_t ResourceGovernor::getIntervalScale() {
+    return scaleFor(s_level);
+}
+
+uint8_t ResourceGovernor::scaleFor(uint8_t level) {
+    return level >= RESOURCE_SHED ? 4 : (level >= RESOURCE_STRETCH ? 2 : 1);
+}
+
+const char* ResourceGovernor::levelName(uint8_t level) {
+    return level < RESOURCE_LEVEL_COUNT ? LEVEL_NAMES[level] : "unknown";
+}
+
+JsonDocument ResourceGovernor::getStatus() {
+    JsonDocument status;
+    uint32_t now = millis();
+    uint8_t level = s_level;
+
+    status["level"] = LEVEL_NAMES[level];
+    status["level_code"] = level;
+    status["reason"] = s_reason;
+    status["since_ms"] = now - s_levelSinceMs;
+    status["peak_level"] = LEVEL_NAMES[s_peakLevel];
+    status["interval_scale"] = scaleFor(level);
+    status["free_heap"] = s_freeHeap;
+    status["min_free_heap"] = s_minFreeHeap == UINT32_MAX ? 0 : s_minFreeHeap;
+    status["largest_block"] = s_largestBlock;
+    status["core_pct"] = roundf(s_corePct * 10.0f) / 10.0f;
+    status["transitions"] = s_transitions;
+    status["rejected_requests"] = s_rejectedRequests.load();
+    status["stretched_executions"] = s_stretchedExecutions;
+
+    JsonObject levels = status["levels"].to<JsonObject>();
+    for (uint8_t i = 0; i < RESOURCE_LEVEL_COUNT; i++) {
+        JsonObject entry = levels[LEVEL_NAMES[i]].to<JsonObject>();
+        uint64_t timeMs = s_levelTimeMs[i] + (i == level ? now - s_levelSinceMs : 0);
+        entry["entries"] = s_entries[i];
+        entry["time_s"] = (uint32_t)(timeMs / 1000);
+        if (i > RESOURCE_NORMAL) {
+            entry["enter_free_heap"] = ENTER[i].freeHeap;
+            entry["enter_largest_block"] = ENTER[i].largestBlock;
+            if (ENTER[i].corePct > 0) {
+                entry["enter_core_pct"] = ENTER[i].corePct;
+            }
+        }
+    }
+    return status;
+}
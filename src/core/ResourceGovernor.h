@@ -0,0 +1,134 @@
+/**
+ * @file ResourceGovernor.h
+ * @brief Ordered, reversible degradation under heap or CPU pressure
+ *
+ * Once per second the orchestrator loop hands the governor the free heap,
+ * the largest allocatable block and the load of the busiest core. Each
+ * level has entry thresholds; the highest level whose thresholds are
+ * crossed is entered at once. Steps back down go one level at a time,
+ * and only after the readings have stayed clear of the current level's
+ * thresholds by the hysteresis margin for RELAX_HOLD_MS, so a heap
+ * hovering around a threshold does not flap.
+ *
+ * Levels (each includes the measures of the ones below it):
+ *   normal    Everything on
+ *   conserve  Debug logging shed
+ *   stretch   Intervals of non-time-critical components doubled
+ *   shed      Non-essential HTTP routes answer 503, tracing/profiling and
+ *             file logging stop, live event push pauses, only warnings are
+ *             logged, intervals x4, the self-benchmark report and remote
+ *             mirrors' duplicate value documents are released
+ *   protect   Actuators finish or stop their current run and refuse new ones
+ *
+ * Every transition is logged, recorded in the event journal (type
+ * "resource") and counted per level.
+ */
+
+#ifndef RESOURCE_GOVERNOR_H
+#define RESOURCE_GOVERNOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+#include <vector>
+
+class BaseComponent;
+
+/**
+ * @brief Degradation levels, in escalation order
+ */
+enum ResourceLevel : uint8_t {
+    RESOURCE_NORMAL = 0,
+    RESOURCE_CONSERVE,
+    RESOURCE_STRETCH,
+    RESOURCE_SHED,
+    RESOURCE_PROTECT,
+    RESOURCE_LEVEL_COUNT
+};
+
+/**
+ * @brief Static resource governor
+ */
+class ResourceGovernor {
+public:
+    static const uint32_t UPDATE_INTERVAL_MS = 1000;
+    static const uint32_t RELAX_HOLD_MS = 15000;       // Calm time before each step down
+    static const uint8_t HYSTERESIS_PCT = 25;          // Heap margin above the entry threshold to leave
+    static const uint8_t CPU_HYSTERESIS_PCT = 10;      // Load points below the entry threshold to leave
+
+    /**
+     * @brief Entry thresholds of one level; any one crossed enters it
+     */
+    struct Thresholds {
+        uint32_t freeHeap;        // Free heap below this (bytes)
+        uint32_t largestBlock;    // Largest allocatable block below this (bytes)
+        uint8_t corePct;          // Busiest core above this (percent), 0 = not used
+    };
+
+    /**
+     * @brief Sample heap and CPU and change level when due (call every loop pass)
+     * @param components Registered components, notified of level changes
+     */
+    static void update(const std::vector<BaseComponent*>& components);
+
+    static uint8_t getLevel() { return s_level; }
+
+    /**
+     * @brief Check if non-essential work is refused (callable from any task)
+     */
+    static bool isShedding() { return s_level >= RESOURCE_SHED; }
+
+    /**
+     * @brief Factor applied to the intervals of non-time-critical components
+     */
+    static uint8_t getIntervalScale();
+
+    /**
+     * @brief Count an HTTP request answered with 503 (any task)
+     */
+    static void noteRejectedRequest() { s_rejectedRequests.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Count an execution whose next run was pushed out
+     */
+    static void noteStretchedExecution() { s_stretchedExecutions++; }
+
+    static const char* levelName(uint8_t level);
+
+    /**
+     * @brief Current level, readings, thresholds and per-level transition metrics
+     */
+    static JsonDocument getStatus();
+
+private:
+    static const Thresholds ENTER[RESOURCE_LEVEL_COUNT];
+
+    static volatile uint8_t s_level;
+    static uint8_t s_peakLevel;
+    static uint32_t s_lastUpdateMs;
+    static uint32_t s_levelSinceMs;
+    static uint32_t s_calmSinceMs;                    // 0 = readings not calm
+    static const char* s_reason;                      // Reading that set the current level
+    static uint32_t s_freeHeap;
+    static uint32_t s_largestBlock;
+    static float s_corePct;
+    static uint32_t s_minFreeHeap;
+    static uint32_t s_transitions;
+    static uint32_t s_entries[RESOURCE_LEVEL_COUNT];
+    static uint64_t s_levelTimeMs[RESOURCE_LEVEL_COUNT];  // Completed stays
+    static std::atomic<uint32_t> s_rejectedRequests;
+    static uint32_t s_stretchedExecutions;
+
+    /**
+     * @brief Highest level whose thresholds the readings cross
+     * @param withMargin Raise heap thresholds (and lower load thresholds) by the hysteresis
+     * @param reason Set to the reading that decided the level
+     */
+    static uint8_t pressureLevel(bool withMargin, const char*& reason);
+
+    static void changeLevel(uint8_t level, const char* reason, const std::vector<BaseComponent*>& components);
+    static void rescaleSchedules(uint8_t fromScale, uint8_t toScale, const std::vector<BaseComponent*>& components);
+    static uint8_t scaleFor(uint8_t level);
+};
+
+#endif // RESOURCE_GOVERNOR_H
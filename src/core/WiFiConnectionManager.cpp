@@ -0,0 +1,252 @@
+/**
+ * @file WiFiConnectionManager.cpp
+ * @brief WiFiConnectionManager implementation
+ */
+
+#include "WiFiConnectionManager.h"
+
+// Out-of-line definitions for ODR-used constants
+const uint32_t WiFiConnectionManager::CONNECT_TIMEOUT_MS;
+const uint32_t WiFiConnectionManager::MIN_BACKOFF_MS;
+const uint32_t WiFiConnectionManager::MAX_BACKOFF_MS;
+
+// Static member initialization
+String WiFiConnectionManager::s_ssid = "";
+String WiFiConnectionManager::s_password = "";
+WiFiLinkState WiFiConnectionManager::s_state = WiFiLinkState::IDLE;
+std::vector<WiFiConnectionManager::LinkListener> WiFiConnectionManager::s_listeners;
+volatile bool WiFiConnectionManager::s_gotIpEvent = false;
+volatile bool WiFiConnectionManager::s_disconnectEvent = false;
+volatile uint8_t WiFiConnectionManager::s_disconnectReason = 0;
+uint32_t WiFiConnectionManager::s_attemptStartMs = 0;
+uint32_t WiFiConnectionManager::s_backoffMs = 0;
+uint32_t WiFiConnectionManager::s_nextAttemptMs = 0;
+uint32_t WiFiConnectionManager::s_attempts = 0;
+uint32_t WiFiConnectionManager::s_connects = 0;
+uint32_t WiFiConnectionManager::s_disconnects = 0;
+uint32_t WiFiConnectionManager::s_connectedSinceMs = 0;
+uint32_t WiFiConnectionManager::s_lastLinkUpMs = 0;
+uint32_t WiFiConnectionManager::s_maxLinkUpMs = 0;
+uint32_t WiFiConnectionManager::s_totalLinkUpMs = 0;
+uint32_t WiFiConnectionManager::s_linkDownSinceMs = 0;
+uint32_t WiFiConnectionManager::s_outages = 0;
+uint32_t WiFiConnectionManager::s_lastOutageMs = 0;
+uint32_t WiFiConnectionManager::s_longestOutageMs = 0;
+uint32_t WiFiConnectionManager::s_totalOutageMs = 0;
+uint8_t WiFiConnectionManager::s_lastReason = 0;
+
+void WiFiConnectionManager::begin(const char* ssid, const char* password) {
+    s_ssid = ssid;
+    s_password = password;
+
+    WiFi.onEvent(onWiFiEvent);
+    WiFi.persistent(false);        // Credentials come from firmware, no NVS writes
+    WiFi.setAutoReconnect(false);  // Reconnects are paced by our backoff
+    WiFi.mode(WIFI_STA);
+
+    Logger::info("WiFi", "Connecting to " + s_ssid + " in the background");
+    startAttempt();
+}
+
+void WiFiConnectionManager::loop() {
+    if (s_state == WiFiLinkState::IDLE) return;
+
+    // Events first; disconnect before got-IP so a quick flap ends up connected
+    if (s_disconnectEvent) {
+        s_disconnectEvent = false;
+        s_lastReason = s_disconnectReason;
+        if (s_state == WiFiLinkState::CONNECTED) {
+            handleLinkDown();
+        } else if (s_state == WiFiLinkState::CONNECTING) {
+            scheduleRetry("attempt failed");
+        }
+    }
+
+    if (s_gotIpEvent) {
+        s_gotIpEvent = false;
+        if (s_state != WiFiLinkState::CONNECTED && WiFi.status() == WL_CONNECTED) {
+            handleLinkUp();
+        }
+    }
+
+    uint32_t now = millis();
+    switch (s_state) {
+        case WiFiLinkState::CONNECTING:
+            if (now - s_attemptStartMs >= CONNECT_TIMEOUT_MS) {
+                WiFi.disconnect();
+                scheduleRetry("attempt timed out");
+            }
+            break;
+
+        case WiFiLinkState::BACKOFF:
+            if ((int32_t)(now - s_nextAttemptMs) >= 0) {
+                startAttempt();
+            }
+            break;
+
+        case WiFiLinkState::CONNECTED:
+            // Safety net in case a disconnect event was missed
+            if (WiFi.status() != WL_CONNECTED) {
+                handleLinkDown();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void WiFiConnectionManager::addLinkListener(LinkListener listener) {
+    s_listeners.push_back(listener);
+}
+
+const char* WiFiConnectionManager::getStateString() {
+    switch (s_state) {
+        case WiFiLinkState::IDLE:       return "idle";
+        case WiFiLinkState::CONNECTING: return "connecting";
+        case WiFiLinkState::CONNECTED:  return "connected";
+        case WiFiLinkState::BACKOFF:    return "backoff";
+        default:                        return "unknown";
+    }
+}
+
+void WiFiConnectionManager::reconnectNow() {
+    if (s_state == WiFiLinkState::IDLE) return;
+
+    Logger::info("WiFi", "Reconnect requested");
+    if (s_state == WiFiLinkState::CONNECTED) {
+        handleLinkDown();
+    }
+    WiFi.disconnect();
+
+    // Let the disconnect event drain in BACKOFF so it is not taken as a failed attempt
+    s_backoffMs = 0;
+    s_state = WiFiLinkState::BACKOFF;
+    s_nextAttemptMs = millis() + 250;
+}
+
+JsonDocument WiFiConnectionManager::getStats() {
+    JsonDocument stats;
+    uint32_t now = millis();
+
+    stats["state"] = getStateString();
+    stats["ssid"] = s_ssid;
+    stats["connected"] = isConnected();
+    if (isConnected()) {
+        stats["ip"] = WiFi.localIP().toString();
+        stats["rssi"] = WiFi.RSSI();
+        stats["connected_for_ms"] = now - s_connectedSinceMs;
+    }
+    stats["attempts"] = s_attempts;
+    stats["connects"] = s_connects;
+    stats["disconnects"] = s_disconnects;
+    stats["last_disconnect_reason"] = s_lastReason;
+
+    // Link-up time: attempt start until an IP address is assigned
+    stats["link_up_ms_last"] = s_lastLinkUpMs;
+    stats["link_up_ms_max"] = s_maxLinkUpMs;
+    stats["link_up_ms_avg"] = s_connects > 0 ? s_totalLinkUpMs / s_connects : 0;
+
+    // Outages: established link lost until it is back
+    stats["outages"] = s_outages;
+    stats["outage_ms_last"] = s_lastOutageMs;
+    stats["outage_ms_longest"] = s_longestOutageMs;
+    stats["outage_ms_total"] = s_totalOutageMs;
+    if (s_linkDownSinceMs != 0) {
+        stats["outage_ms_current"] = now - s_linkDownSinceMs;
+    }
+
+    if (s_state == WiFiLinkState::BACKOFF) {
+        stats["next_attempt_in_ms"] = (int32_t)(s_nextAttemptMs - now) > 0 ? s_nextAttemptMs - now : 0;
+    }
+    stats["backoff_ms"] = s_backoffMs;
+
+    return stats;
+}
+
+void WiFiConnectionManager::startAttempt() {
+    s_attempts++;
+    s_attemptStartMs = millis();
+    s_state = WiFiLinkState::CONNECTING;
+    s_gotIpEvent = false;
+    s_disconnectEvent = false;
+
+    Logger::debug("WiFi", String("Connection attempt #") + s_attempts);
+    WiFi.begin(s_ssid.c_str(), s_password.c_str());
+}
+
+void WiFiConnectionManager::scheduleRetry(const char* why) {
+    // Exponential backoff with +/-25% jitter so nodes behind one AP spread out
+    s_backoffMs = s_backoffMs == 0 ? MIN_BACKOFF_MS : min(s_backoffMs * 2, MAX_BACKOFF_MS);
+    int32_t jitter = (int32_t)random(0, s_backoffMs / 2 + 1) - (int32_t)(s_backoffMs / 4);
+    uint32_t delayMs = s_backoffMs + jitter;
+
+    s_nextAttemptMs = millis() + delayMs;
+    s_state = WiFiLinkState::BACKOFF;
+
+    Logger::warning("WiFi", String("Connection ") + why + " (reason " + s_lastReason +
+                    "), retry in " + delayMs + "ms");
+}
+
+void WiFiConnectionManager::handleLinkUp() {
+    uint32_t now = millis();
+
+    s_state = WiFiLinkState::CONNECTED;
+    s_connects++;
+    s_connectedSinceMs = now;
+    s_backoffMs = 0;
+
+    s_lastLinkUpMs = now - s_attemptStartMs;
+    s_totalLinkUpMs += s_lastLinkUpMs;
+    if (s_lastLinkUpMs > s_maxLinkUpMs) s_maxLinkUpMs = s_lastLinkUpMs;
+
+    String message = String("Connected, IP ") + WiFi.localIP().toString() + ", RSSI " + WiFi.RSSI() +
+                     " dBm, link up in " + s_lastLinkUpMs + "ms";
+    if (s_linkDownSinceMs != 0) {
+        s_lastOutageMs = now - s_linkDownSinceMs;
+        s_totalOutageMs += s_lastOutageMs;
+        if (s_lastOutageMs > s_longestOutageMs) s_longestOutageMs = s_lastOutageMs;
+        s_linkDownSinceMs = 0;
+        message += String(" after ") + s_lastOutageMs + "ms outage";
+    }
+    Logger::info("WiFi", message);
+
+    notify(true);
+}
+
+void WiFiConnectionManager::handleLinkDown() {
+    s_disconnects++;
+    s_outages++;
+    s_linkDownSinceMs = millis();
+    if (s_linkDownSinceMs == 0) s_linkDownSinceMs = 1;
+
+    Logger::warning("WiFi", String("Link lost (reason ") + s_lastReason + ")");
+    notify(false);
+
+    s_backoffMs = 0;  // First retry after MIN_BACKOFF_MS
+    scheduleRetry("lost");
+}
+
+void WiFiConnectionManager::notify(bool connected) {
+    for (LinkListener& listener : s_listeners) {
+        listener(connected);
+    }
+}
+
+void WiFiConnectionManager::onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    // Runs on the WiFi event task: record and return
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            s_gotIpEvent = true;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            s_disconnectReason = info.wifi_sta_disconnected.reason;
+            s_disconnectEvent = true;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+            s_disconnectEvent = true;
+            break;
+        default:
+            break;
+    }
+}
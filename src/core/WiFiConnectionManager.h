@@ -0,0 +1,134 @@
+/**
+ * @file WiFiConnectionManager.h
+ * @brief Non-blocking WiFi station connection manager
+ *
+ * Replaces the blocking connect loop in setup(): the connection is started
+ * asynchronously, driven by WiFi driver events, and re-established with a
+ * jittered exponential backoff whenever the access point goes away.
+ * Link changes are delivered to registered listeners from loop(), so the
+ * orchestrator can pause and resume network users instead of letting them
+ * run into timeouts.
+ */
+
+#ifndef WIFI_CONNECTION_MANAGER_H
+#define WIFI_CONNECTION_MANAGER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <WiFi.h>
+#include <functional>
+#include <vector>
+#include "../utils/Logger.h"
+
+/**
+ * @brief Connection state machine states
+ */
+enum class WiFiLinkState {
+    IDLE,           // begin() not called (e.g. duty-cycled wake without network)
+    CONNECTING,     // Association / DHCP in progress
+    CONNECTED,      // Got an IP address
+    BACKOFF         // Waiting before the next attempt
+};
+
+/**
+ * @brief Static WiFi connection manager
+ *
+ * Driver events arrive on the WiFi event task and only set flags; all state
+ * changes, logging and listener calls happen in loop() on the main task.
+ */
+class WiFiConnectionManager {
+public:
+    typedef std::function<void(bool connected)> LinkListener;
+
+    /**
+     * @brief Start connecting (returns immediately)
+     * @param ssid Network name
+     * @param password Network password
+     */
+    static void begin(const char* ssid, const char* password);
+
+    /**
+     * @brief Advance the state machine and deliver link notifications
+     * @note Call from the Arduino loop()
+     */
+    static void loop();
+
+    /**
+     * @brief Register a callback for link up/down transitions
+     * @param listener Called from loop() with the new link state
+     */
+    static void addLinkListener(LinkListener listener);
+
+    /**
+     * @brief Check if the station has an IP address
+     * @return true if connected
+     */
+    static bool isConnected() { return s_state == WiFiLinkState::CONNECTED; }
+
+    /**
+     * @brief Get current state
+     * @return State machine state
+     */
+    static WiFiLinkState getState() { return s_state; }
+
+    /**
+     * @brief Get state as string
+     * @return "idle", "connecting", "connected" or "backoff"
+     */
+    static const char* getStateString();
+
+    /**
+     * @brief Drop the link and reconnect immediately (resets backoff)
+     */
+    static void reconnectNow();
+
+    /**
+     * @brief Get link metrics (link-up times, outages, attempts)
+     * @return Metrics as JSON document
+     */
+    static JsonDocument getStats();
+
+private:
+    static const uint32_t CONNECT_TIMEOUT_MS = 20000;    // Association + DHCP per attempt
+    static const uint32_t MIN_BACKOFF_MS = 1000;
+    static const uint32_t MAX_BACKOFF_MS = 60000;
+
+    static String s_ssid;
+    static String s_password;
+    static WiFiLinkState s_state;
+    static std::vector<LinkListener> s_listeners;
+
+    // Set from the WiFi event task
+    static volatile bool s_gotIpEvent;
+    static volatile bool s_disconnectEvent;
+    static volatile uint8_t s_disconnectReason;
+
+    // Attempt / backoff bookkeeping
+    static uint32_t s_attemptStartMs;
+    static uint32_t s_backoffMs;
+    static uint32_t s_nextAttemptMs;
+
+    // Metrics
+    static uint32_t s_attempts;
+    static uint32_t s_connects;
+    static uint32_t s_disconnects;
+    static uint32_t s_connectedSinceMs;
+    static uint32_t s_lastLinkUpMs;       // Attempt start -> IP for the last connection
+    static uint32_t s_maxLinkUpMs;
+    static uint32_t s_totalLinkUpMs;
+    static uint32_t s_linkDownSinceMs;    // 0 while connected or before the first connection
+    static uint32_t s_outages;
+    static uint32_t s_lastOutageMs;
+    static uint32_t s_longestOutageMs;
+    static uint32_t s_totalOutageMs;
+    static uint8_t s_lastReason;
+
+    static void startAttempt();
+    static void scheduleRetry(const char* why);
+    static void handleLinkUp();
+    static void handleLinkDown();
+    static void notify(bool connected);
+    static void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info);
+};
+
+#endif // WIFI_CONNECTION_MANAGER_H
@@ -12,10 +12,13 @@
 #include <WiFi.h>
 #include <LittleFS.h>
 #include <time.h>
+#include <esp_sntp.h>
 #include <WiFiUdp.h>
 #include "utils/Logger.h"
 #include "utils/TimeUtils.h"
 #include "core/Orchestrator.h"
+#include "core/DeepSleepManager.h"
+#include "core/WiFiConnectionManager.h"
 
 // WiFi credentials
 const char* WIFI_SSID = "edtiot";
@@ -24,8 +27,9 @@ const char* WIFI_PASSWORD = "spindle1";
 // Forward declarations
 void setup();
 void loop();
-void connectWiFi();
+void onLinkChange(bool connected);
 void initializeNTP();
+void checkNTPSync();
 void printHeartbeat();
 void checkLittleFS();
 
@@ -41,6 +45,8 @@ const char* ntpServer = "pool.ntp.org";
 const long gmtOffset_sec = 0;     // UTC offset
 const int daylightOffset_sec = 0; // No daylight saving
 time_t bootTime = 0;              // System boot time in epoch seconds
+bool ntpRequested = false;        // configTime() issued, waiting for the first sync
+bool ntpSynced = false;
 
 /**
  * @brief Arduino setup function
@@ -53,18 +59,23 @@ void setup() {
     Logger::info("main", "ESP32 IoT Orchestrator - Baseline v1.0.0");
     Logger::info("main", "Starting system initialization...");
     
-    // Check LittleFS partition and mounting
-    checkLittleFS();
+    // Duty-cycled timer wakes keep boot short: no flash self-test, no file
+    // logging (flash wear) and no WiFi unless a batch upload is due
+    DeepSleepManager::begin();
+    bool timerWake = DeepSleepManager::isTimerWake();
     
-    // Enable file logging to LittleFS
-    Logger::enableFileLogging(true, 50);  // 50KB max log file
-    
-    // Connect to WiFi
-    connectWiFi();
+    if (!timerWake) {
+        // Check LittleFS partition and mounting
+        checkLittleFS();
+        
+        // Enable file logging to LittleFS
+        Logger::enableFileLogging(true, 50);  // 50KB max log file
+    }
     
-    // Initialize NTP time synchronization
-    if (WiFi.status() == WL_CONNECTED) {
-        initializeNTP();
+    // Connect to WiFi in the background; NTP starts on the first link-up
+    if (DeepSleepManager::needsNetworkThisWake()) {
+        WiFiConnectionManager::addLinkListener(onLinkChange);
+        WiFiConnectionManager::begin(WIFI_SSID, WIFI_PASSWORD);
     }
     
     // Initialize orchestrator
@@ -86,6 +97,10 @@ void setup() {
  * @brief Arduino main loop
  */
 void loop() {
+    // Advance WiFi state machine (delivers link notifications)
+    WiFiConnectionManager::loop();
+    checkNTPSync();
+    
     // Run orchestrator
     orchestrator.loop();
     
@@ -101,25 +116,12 @@ void loop() {
 }
 
 /**
- * @brief Connect to WiFi network
+ * @brief React to WiFi link changes
+ * @param connected true when the station got an IP address
  */
-void connectWiFi() {
-    Logger::info("main", "Connecting to WiFi...");
-    
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-    
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
-    }
-    
-    if (WiFi.status() == WL_CONNECTED) {
-        Logger::info("main", String("WiFi connected! IP: ") + WiFi.localIP().toString());
-        Logger::info("main", String("RSSI: ") + WiFi.RSSI() + " dBm");
-    } else {
-        Logger::error("main", "WiFi connection failed - continuing without network");
+void onLinkChange(bool connected) {
+    if (connected && !ntpRequested) {
+        initializeNTP();
     }
 }
 
@@ -240,44 +242,48 @@ void checkLittleFS() {
 }
 
 /**
- * @brief Initialize NTP time synchronization
+ * @brief Initialize NTP time synchronization (non-blocking)
  */
 void initializeNTP() {
     Logger::info("main", "Initializing NTP time synchronization...");
     
-    // Configure NTP
+    // Configure NTP; SNTP runs in the background and checkNTPSync() picks up the result.
+    // Every (re-)sync also refreshes the monotonic-to-epoch mapping in TimeUtils.
+    sntp_set_time_sync_notification_cb(TimeUtils::onNtpSync);
     configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
-    
-    // Wait for time synchronization
-    Logger::info("main", "Waiting for NTP time sync...");
-    
-    int attempts = 0;
-    while (!time(nullptr) && attempts < 30) {
-        delay(1000);
-        Serial.print(".");
-        attempts++;
+    ntpRequested = true;
+}
+
+/**
+ * @brief Record boot time once the first NTP sync has completed
+ */
+void checkNTPSync() {
+    if (!ntpRequested || ntpSynced) {
+        return;
     }
     
     time_t now = time(nullptr);
-    if (now > 0) {
-        // Calculate actual boot time by subtracting uptime
-        unsigned long uptimeSeconds = millis() / 1000;
-        time_t actualBootTime = now - uptimeSeconds;
-        
-        bootTime = actualBootTime;  // Record actual boot time
-        TimeUtils::setBootTime(actualBootTime);  // Share with TimeUtils
-        
-        // Format and display current time
-        struct tm* timeinfo = localtime(&now);
-        char timeStr[64];
-        strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S UTC", timeinfo);
-        
-        Logger::info("main", String("NTP sync successful! Current time: ") + timeStr);
-        Logger::info("main", String("System boot time: ") + actualBootTime + " (epoch seconds)");
-        Logger::info("main", String("Uptime at NTP sync: ") + uptimeSeconds + " seconds");
-    } else {
-        Logger::error("main", "NTP sync failed - using millis() for timing");
-        bootTime = 0;  // Indicate NTP failed
+    if (now < 1600000000) {  // Still the 1970-based default
+        return;
+    }
+    ntpSynced = true;
+    if (!TimeUtils::hasEpochMapping()) {
+        TimeUtils::onNtpSync(nullptr);  // Sync callback not delivered (yet)
     }
+    
+    // Calculate actual boot time by subtracting uptime
+    unsigned long uptimeSeconds = TimeUtils::getBootSeconds();
+    time_t actualBootTime = now - uptimeSeconds;
+    
+    bootTime = actualBootTime;  // Record actual boot time
+    TimeUtils::setBootTime(actualBootTime);  // Share with TimeUtils
+    
+    // Format and display current time
+    struct tm* timeinfo = localtime(&now);
+    char timeStr[64];
+    strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S UTC", timeinfo);
+    
+    Logger::info("main", String("NTP sync successful! Current time: ") + timeStr);
+    Logger::info("main", String("System boot time: ") + actualBootTime + " (epoch seconds)");
+    Logger::info("main", String("Uptime at NTP sync: ") + uptimeSeconds + " seconds");
 }
-
@@ -4,6 +4,7 @@
  */
 
 #include "ConfigStorage.h"
+#include "../utils/Tracer.h"
 #include <vector>
 
 // Static path constants
@@ -55,17 +56,11 @@ bool ConfigStorage::saveComponentConfig(const String& componentId, const JsonDoc
     }
     
     String filePath = getComponentConfigPath(componentId);
-    Logger::info("ConfigStorage", "💾 [STORAGE-SAVE] Saving: " + componentId + " -> " + filePath);
-    
-    // Log the content being saved
-    String configStr;
-    serializeJson(config, configStr);
-    Logger::info("ConfigStorage", "💾 [STORAGE-SAVE] Content: " + configStr);
-    
     bool result = saveJsonToFile(filePath, config);
     
     if (result) {
-        Logger::info("ConfigStorage", "✅ [STORAGE-SAVE] Successfully wrote: " + filePath);
+        rememberConfig(componentId);
+        Logger::info("ConfigStorage", "💾 [STORAGE-SAVE] Saved: " + componentId + " -> " + filePath);
     } else {
         Logger::error("ConfigStorage", "❌ [STORAGE-SAVE] Failed to write: " + filePath);
     }
@@ -79,23 +74,17 @@ bool ConfigStorage::loadComponentConfig(const String& componentId, JsonDocument&
         return false;
     }
     
+    // loadJsonFromFile performs the (single) existence check
     String filePath = getComponentConfigPath(componentId);
-    Logger::info("ConfigStorage", "📂 [STORAGE-LOAD] Loading: " + componentId + " <- " + filePath);
-    
-    // Check if file exists
-    if (!fileExists(filePath)) {
-        Logger::warning("ConfigStorage", "⚠️ [STORAGE-LOAD] File does not exist: " + filePath);
-        return false;
-    }
-    
     bool result = loadJsonFromFile(filePath, config);
-    
     if (result) {
+        rememberConfig(componentId);
+    }
+    
+    if (result && Logger::isEnabled(Logger::DEBUG)) {
         String loadedStr;
         serializeJson(config, loadedStr);
-        Logger::info("ConfigStorage", "✅ [STORAGE-LOAD] Successfully loaded: " + loadedStr);
-    } else {
-        Logger::error("ConfigStorage", "❌ [STORAGE-LOAD] Failed to parse JSON from: " + filePath);
+        Logger::debug("ConfigStorage", "📂 [STORAGE-LOAD] " + componentId + ": " + loadedStr);
     }
     
     return result;
@@ -104,6 +93,10 @@ bool ConfigStorage::loadComponentConfig(const String& componentId, JsonDocument&
 bool ConfigStorage::hasComponentConfig(const String& componentId) {
     if (!m_initialized) return false;
     
+    for (const String& knownId : m_knownConfigIds) {
+        if (knownId == componentId) return true;
+    }
+    
     String filePath = getComponentConfigPath(componentId);
     return fileExists(filePath);
 }
@@ -117,6 +110,12 @@ bool ConfigStorage::deleteComponentConfig(const String& componentId) {
     String filePath = getComponentConfigPath(componentId);
     log("Deleting component config: " + componentId + " (" + filePath + ")");
     
+    for (size_t i = 0; i < m_knownConfigIds.size(); i++) {
+        if (m_knownConfigIds[i] == componentId) {
+            m_knownConfigIds.erase(m_knownConfigIds.begin() + i);
+            break;
+        }
+    }
     return deleteFile(filePath);
 }
 
@@ -172,6 +171,7 @@ bool ConfigStorage::loadSystemConfig(JsonDocument& config) {
 }
 
 std::vector<String> ConfigStorage::listComponentConfigs() {
+    TRACE_SCOPE(TRACE_STORAGE, "storage.list");
     std::vector<String> configs;
     
     if (!m_initialized) return configs;
@@ -246,6 +246,8 @@ JsonDocument ConfigStorage::getStorageStats() {
         file = root.openNextFile();
     }
     stats["fileCount"] = fileCount;
+    stats["fileReads"] = m_readCount;
+    stats["fileWrites"] = m_writeCount;
     
     return stats;
 }
@@ -259,6 +261,7 @@ bool ConfigStorage::formatStorage() {
     Logger::warning("ConfigStorage", "Formatting storage - all data will be lost!");
     
     bool result = LittleFS.format();
+    m_knownConfigIds.clear();
     if (result) {
         log("Storage formatted successfully");
     } else {
@@ -271,108 +274,54 @@ bool ConfigStorage::formatStorage() {
 // Private methods
 
 bool ConfigStorage::saveJsonToFile(const String& filePath, const JsonDocument& doc) {
-    Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] Starting saveJsonToFile for: " + filePath);
-    
-    // Check if LittleFS is mounted
-    if (!LittleFS.begin()) {
-        Logger::error("ConfigStorage", "🔍 [SAVE-DEBUG] CRITICAL: LittleFS not mounted!");
-        return false;
-    }
-    
-    // Test JSON document validity
+    TRACE_SCOPE(TRACE_STORAGE, "storage.save");
+    // LittleFS is mounted once in init(); callers are gated on m_initialized
     if (doc.isNull()) {
-        Logger::error("ConfigStorage", "🔍 [SAVE-DEBUG] ERROR: JsonDocument is null!");
+        Logger::error("ConfigStorage", "Refusing to save null document: " + filePath);
         return false;
     }
     
-    size_t docSize = measureJson(doc);
-    Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] JSON size: " + String(docSize) + " bytes");
-    
-    // Debug JSON content (limited to prevent memory issues)
-    if (docSize < 500) {
-        String debugJson;
-        serializeJson(doc, debugJson);
-        Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] JSON content: " + debugJson);
-    }
-    
-    // Ensure directory exists by creating parent directories
+    // Ensure parent directories exist (only touches the filesystem when missing)
     String dirPath = filePath.substring(0, filePath.lastIndexOf('/'));
-    Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] Target directory: " + dirPath);
-    
-    if (dirPath.length() > 0) {
-        // Check if directory exists
-        if (LittleFS.exists(dirPath)) {
-            Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] Directory already exists: " + dirPath);
-        } else {
-            Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] Creating directory: " + dirPath);
-            if (!LittleFS.mkdir(dirPath)) {
-                Logger::error("ConfigStorage", "🔍 [SAVE-DEBUG] Failed to create directory: " + dirPath);
-                
-                // Try creating parent directories recursively
-                Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] Attempting recursive directory creation");
-                int lastSlash = dirPath.lastIndexOf('/');
-                while (lastSlash > 0) {
-                    String parentDir = dirPath.substring(0, lastSlash);
-                    if (!LittleFS.exists(parentDir)) {
-                        Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] Creating parent: " + parentDir);
-                        LittleFS.mkdir(parentDir);
-                    }
-                    lastSlash = dirPath.lastIndexOf('/', lastSlash - 1);
-                }
-                // Try creating the directory again
-                Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] Retrying directory creation: " + dirPath);
-                LittleFS.mkdir(dirPath);
-            } else {
-                Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] Directory created successfully: " + dirPath);
+    if (dirPath.length() > 0 && !LittleFS.exists(dirPath)) {
+        int slash = dirPath.indexOf('/', 1);
+        while (slash > 0) {
+            String parentDir = dirPath.substring(0, slash);
+            if (!LittleFS.exists(parentDir)) {
+                LittleFS.mkdir(parentDir);
             }
+            slash = dirPath.indexOf('/', slash + 1);
+        }
+        if (!LittleFS.mkdir(dirPath)) {
+            Logger::error("ConfigStorage", "Failed to create directory: " + dirPath);
+            return false;
         }
     }
     
-    // Attempt to open file for writing
-    Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] Opening file for write: " + filePath);
     File file = LittleFS.open(filePath, "w");
     if (!file) {
-        Logger::error("ConfigStorage", "🔍 [SAVE-DEBUG] FAILED to open file for writing: " + filePath);
-        
-        // Additional debugging - check available space
         size_t totalBytes = LittleFS.totalBytes();
         size_t usedBytes = LittleFS.usedBytes();
-        Logger::error("ConfigStorage", "🔍 [SAVE-DEBUG] LittleFS space - Total: " + String(totalBytes) + ", Used: " + String(usedBytes) + ", Free: " + String(totalBytes - usedBytes));
-        
+        Logger::error("ConfigStorage", "Failed to open file for writing: " + filePath +
+                      " (free " + String(totalBytes - usedBytes) + " of " + String(totalBytes) + " bytes)");
         return false;
     }
     
-    Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] File opened successfully, writing JSON...");
     size_t bytesWritten = serializeJson(doc, file);
     file.close();
-    
-    Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] Bytes written: " + String(bytesWritten));
+    m_writeCount++;
     
     if (bytesWritten == 0) {
-        Logger::error("ConfigStorage", "🔍 [SAVE-DEBUG] ERROR: Zero bytes written to file!");
+        Logger::error("ConfigStorage", "Zero bytes written to file: " + filePath);
         return false;
     }
     
-    // Verify file was actually created and has content
-    if (LittleFS.exists(filePath)) {
-        File verifyFile = LittleFS.open(filePath, "r");
-        if (verifyFile) {
-            size_t fileSize = verifyFile.size();
-            verifyFile.close();
-            Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] SUCCESS: File verified, size: " + String(fileSize) + " bytes");
-        } else {
-            Logger::error("ConfigStorage", "🔍 [SAVE-DEBUG] ERROR: File exists but cannot be opened for verification");
-        }
-    } else {
-        Logger::error("ConfigStorage", "🔍 [SAVE-DEBUG] ERROR: File does not exist after write operation!");
-        return false;
-    }
-    
-    Logger::info("ConfigStorage", "🔍 [SAVE-DEBUG] saveJsonToFile completed successfully for: " + filePath);
+    Logger::debug("ConfigStorage", "Wrote " + String(bytesWritten) + " bytes to " + filePath);
     return true;
 }
 
 bool ConfigStorage::loadJsonFromFile(const String& filePath, JsonDocument& doc) {
+    TRACE_SCOPE(TRACE_STORAGE, "storage.load");
     if (!fileExists(filePath)) {
         Logger::debug("ConfigStorage", "File does not exist: " + filePath);
         return false;
@@ -393,6 +342,7 @@ bool ConfigStorage::loadJsonFromFile(const String& filePath, JsonDocument& doc)
     
     DeserializationError error = deserializeJson(doc, file);
     file.close();
+    m_readCount++;
     
     if (error) {
         Logger::error("ConfigStorage", "JSON parsing error in " + filePath + ": " + String(error.c_str()));
@@ -408,6 +358,7 @@ bool ConfigStorage::fileExists(const String& filePath) {
 }
 
 bool ConfigStorage::deleteFile(const String& filePath) {
+    TRACE_SCOPE(TRACE_STORAGE, "storage.delete");
     if (!fileExists(filePath)) {
         Logger::debug("ConfigStorage", "File does not exist (cannot delete): " + filePath);
         return false;
@@ -421,6 +372,13 @@ bool ConfigStorage::deleteFile(const String& filePath) {
     return result;
 }
 
+void ConfigStorage::rememberConfig(const String& componentId) {
+    for (const String& knownId : m_knownConfigIds) {
+        if (knownId == componentId) return;
+    }
+    m_knownConfigIds.push_back(componentId);
+}
+
 String ConfigStorage::getComponentConfigPath(const String& componentId) {
     return String(COMPONENT_CONFIG_PATH) + "/" + componentId + ".json";
 }
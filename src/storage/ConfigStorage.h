@@ -28,6 +28,9 @@
 class ConfigStorage {
 private:
     bool m_initialized = false;
+    uint32_t m_readCount = 0;                  // JSON documents parsed from flash
+    uint32_t m_writeCount = 0;                 // JSON documents written to flash
+    std::vector<String> m_knownConfigIds;      // Component configs loaded or saved since boot
     static const size_t MAX_FILE_SIZE = 8192;  // 8KB max file size
     static const char* COMPONENT_CONFIG_PATH;
     static const char* COMPONENT_SCHEMA_PATH;
@@ -66,6 +69,9 @@ public:
 
     /**
      * @brief Check if component configuration exists
+     *
+     * Configs loaded or saved through this instance are answered from memory;
+     * only unknown ids cost a filesystem check.
      * @param componentId Component identifier
      * @return true if configuration exists
      */
@@ -192,6 +198,12 @@ private:
      */
     bool deleteFile(const String& filePath);
 
+    /**
+     * @brief Record that a component config is on flash
+     * @param componentId Component identifier
+     */
+    void rememberConfig(const String& componentId);
+
     /**
      * @brief Get component config file path
      * @param componentId Component identifier
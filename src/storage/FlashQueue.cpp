@@ -0,0 +1,227 @@
+/**
+ * @file FlashQueue.cpp
+ * @brief FlashQueue implementation
+ */
+
+#include "FlashQueue.h"
+
+FlashQueue::FlashQueue(const String& basePath, size_t maxBytes)
+    : m_dataPath(basePath + ".dat"), m_indexPath(basePath + ".idx"), m_maxBytes(maxBytes) {
+}
+
+bool FlashQueue::begin() {
+    m_readOffset = 0;
+    m_fileSize = 0;
+    m_count = 0;
+    m_headLength = 0;
+
+    // Leftover from a compaction interrupted before the rename
+    String tempPath = m_dataPath + ".tmp";
+    if (LittleFS.exists(tempPath)) {
+        LittleFS.remove(tempPath);
+    }
+
+    if (LittleFS.exists(m_indexPath)) {
+        File index = LittleFS.open(m_indexPath, "r");
+        if (index) {
+            uint32_t offset = 0;
+            if (index.read(reinterpret_cast<uint8_t*>(&offset), sizeof(offset)) == sizeof(offset)) {
+                m_readOffset = offset;
+            }
+            index.close();
+        }
+    }
+
+    if (LittleFS.exists(m_dataPath)) {
+        File data = LittleFS.open(m_dataPath, "r");
+        if (!data) {
+            Logger::error("FlashQueue", "Failed to open " + m_dataPath);
+            return false;
+        }
+        m_fileSize = data.size();
+        if (m_readOffset > m_fileSize) {
+            m_readOffset = 0;
+        }
+
+        // One pass to count records; the file is bounded by m_maxBytes
+        data.seek(m_readOffset);
+        while (data.available()) {
+            if (data.read() == '\n') m_count++;
+        }
+        data.close();
+    }
+
+    if (m_count == 0 && m_fileSize > 0) {
+        clear();
+    }
+
+    m_ready = true;
+    if (m_count > 0) {
+        Logger::info("FlashQueue", String("Recovered ") + m_count + " queued records (" +
+                     pendingBytes() + " bytes) from " + m_dataPath);
+    }
+    return true;
+}
+
+bool FlashQueue::push(const String& record) {
+    if (!m_ready) return false;
+
+    size_t needed = record.length() + 1;
+    if (needed > m_maxBytes) {
+        m_dropped++;
+        Logger::warning("FlashQueue", String("Record of ") + needed + " bytes exceeds queue budget");
+        return false;
+    }
+
+    if (m_fileSize + needed > m_maxBytes) {
+        // Decide how many of the oldest records have to go, then rewrite once
+        size_t liveBytes = pendingBytes();
+        if (liveBytes + needed > m_maxBytes) {
+            File data = LittleFS.open(m_dataPath, "r");
+            if (data) {
+                data.seek(m_readOffset);
+                size_t skip = 0;
+                while (data.available() && liveBytes + needed > m_maxBytes) {
+                    size_t lineLength = data.readStringUntil('\n').length() + 1;
+                    skip += lineLength;
+                    liveBytes -= lineLength;
+                    m_count--;
+                    m_dropped++;
+                    m_headSeq++;
+                }
+                data.close();
+                m_readOffset += skip;
+                m_headLength = 0;
+                Logger::warning("FlashQueue", String("Queue full - dropped oldest records (") +
+                                m_dropped + " dropped total)");
+            }
+        }
+        if (!compact()) {
+            return false;
+        }
+    }
+
+    File data = LittleFS.open(m_dataPath, "a");
+    if (!data) {
+        Logger::error("FlashQueue", "Failed to append to " + m_dataPath);
+        return false;
+    }
+    size_t written = data.print(record);
+    written += data.print('\n');
+    data.close();
+
+    if (written != needed) {
+        Logger::error("FlashQueue", "Short write to " + m_dataPath);
+        return false;
+    }
+
+    m_fileSize += needed;
+    m_count++;
+    return true;
+}
+
+bool FlashQueue::peek(String& record, uint32_t* seq) {
+    if (m_count == 0) return false;
+
+    File data = LittleFS.open(m_dataPath, "r");
+    if (!data) return false;
+
+    data.seek(m_readOffset);
+    record = data.readStringUntil('\n');
+    data.close();
+
+    m_headLength = record.length() + 1;
+    if (seq) *seq = m_headSeq;
+    return true;
+}
+
+bool FlashQueue::pop() {
+    if (m_count == 0) return false;
+
+    if (m_headLength == 0) {
+        String head;
+        if (!peek(head)) return false;
+    }
+
+    m_readOffset += m_headLength;
+    m_headLength = 0;
+    m_count--;
+    m_headSeq++;
+
+    if (m_count == 0) {
+        clear();
+    } else {
+        writeIndex();
+    }
+    return true;
+}
+
+bool FlashQueue::popIfHead(uint32_t seq) {
+    if (m_count == 0 || seq != m_headSeq) return false;
+    return pop();
+}
+
+void FlashQueue::clear() {
+    m_headSeq += m_count;
+    LittleFS.remove(m_dataPath);
+    LittleFS.remove(m_indexPath);
+    m_readOffset = 0;
+    m_fileSize = 0;
+    m_count = 0;
+    m_headLength = 0;
+}
+
+bool FlashQueue::compact() {
+    if (m_readOffset == 0) return true;
+    if (m_count == 0) {
+        clear();
+        return true;
+    }
+
+    String tempPath = m_dataPath + ".tmp";
+    File source = LittleFS.open(m_dataPath, "r");
+    File target = LittleFS.open(tempPath, "w");
+    if (!source || !target) {
+        Logger::error("FlashQueue", "Failed to compact " + m_dataPath);
+        return false;
+    }
+
+    uint8_t buffer[256];
+    source.seek(m_readOffset);
+    size_t copied = 0;
+    while (source.available()) {
+        size_t n = source.read(buffer, sizeof(buffer));
+        if (n == 0) break;
+        copied += target.write(buffer, n);
+    }
+    source.close();
+    target.close();
+
+    // Reset the index before the swap: a crash in between replays consumed
+    // records from the old file rather than skipping into the new one
+    size_t consumed = m_readOffset;
+    m_readOffset = 0;
+    writeIndex();
+
+    // LittleFS renames over an existing file atomically
+    if (!LittleFS.rename(tempPath, m_dataPath)) {
+        Logger::error("FlashQueue", "Failed to replace " + m_dataPath + " after compaction");
+        LittleFS.remove(tempPath);
+        m_readOffset = consumed;
+        writeIndex();
+        return false;
+    }
+
+    Logger::debug("FlashQueue", String("Compacted ") + m_dataPath + ": " + m_fileSize + " -> " + copied + " bytes");
+    m_fileSize = copied;
+    m_headLength = 0;
+    return true;
+}
+
+void FlashQueue::writeIndex() {
+    File index = LittleFS.open(m_indexPath, "w");
+    if (!index) return;
+    uint32_t offset = m_readOffset;
+    index.write(reinterpret_cast<const uint8_t*>(&offset), sizeof(offset));
+    index.close();
+}
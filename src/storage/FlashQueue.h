@@ -0,0 +1,121 @@
+/**
+ * @file FlashQueue.h
+ * @brief Bounded FIFO of text records persisted on LittleFS
+ *
+ * Used for store-and-forward: records are appended to a data file while
+ * the consumer (e.g. an MQTT broker) is unreachable and read back in order
+ * once it is available again. Survives reboots.
+ */
+
+#ifndef FLASH_QUEUE_H
+#define FLASH_QUEUE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "../utils/Logger.h"
+
+/**
+ * @brief Append-only record file with a persisted read offset
+ *
+ * Layout on flash:
+ * - <basePath>.dat: records separated by '\n' (records must not contain '\n')
+ * - <basePath>.idx: read offset of the oldest unconsumed record
+ *
+ * Consuming a record only rewrites the 4-byte index. The data file is
+ * compacted (consumed prefix dropped) when an append would exceed the byte
+ * budget; if that is still not enough, the oldest records are discarded.
+ */
+class FlashQueue {
+public:
+    /**
+     * @brief Constructor
+     * @param basePath Path without extension (e.g. "/data/mqtt_queue")
+     * @param maxBytes Byte budget for the data file
+     */
+    FlashQueue(const String& basePath, size_t maxBytes);
+
+    /**
+     * @brief Recover queue state from flash (call after LittleFS is mounted)
+     * @return true if the queue is usable
+     */
+    bool begin();
+
+    /**
+     * @brief Change the byte budget (takes effect on the next push)
+     * @param maxBytes New budget
+     */
+    void setMaxBytes(size_t maxBytes) { m_maxBytes = maxBytes; }
+
+    /**
+     * @brief Append a record, dropping the oldest ones if the budget is exceeded
+     * @param record Record text (single line)
+     * @return true if the record was stored
+     */
+    bool push(const String& record);
+
+    /**
+     * @brief Read the oldest record without consuming it
+     * @param record Output record text
+     * @param seq Optional output: sequence number of the record (for popIfHead)
+     * @return true if a record was available
+     */
+    bool peek(String& record, uint32_t* seq = nullptr);
+
+    /**
+     * @brief Consume the oldest record
+     * @return true if a record was consumed
+     */
+    bool pop();
+
+    /**
+     * @brief Consume the oldest record only if it is still the one peeked as seq
+     *
+     * A full queue drops its oldest records on push, so a record handed out
+     * by peek() may be gone by the time its delivery is confirmed.
+     * @param seq Sequence number returned by peek()
+     * @return true if the record was consumed, false if it is no longer the head
+     */
+    bool popIfHead(uint32_t seq);
+
+    /**
+     * @brief Remove all records and delete the backing files
+     */
+    void clear();
+
+    bool isEmpty() const { return m_count == 0; }
+    size_t count() const { return m_count; }
+    size_t pendingBytes() const { return m_fileSize - m_readOffset; }
+    size_t fileBytes() const { return m_fileSize; }
+    size_t maxBytes() const { return m_maxBytes; }
+    uint32_t droppedCount() const { return m_dropped; }
+    uint32_t headSeq() const { return m_headSeq; }
+
+private:
+    String m_dataPath;
+    String m_indexPath;
+    size_t m_maxBytes;
+    size_t m_readOffset = 0;
+    size_t m_fileSize = 0;
+    size_t m_count = 0;
+    size_t m_headLength = 0;      // Length of the record last returned by peek() (0 = unknown)
+    uint32_t m_dropped = 0;
+    uint32_t m_headSeq = 0;       // Sequence number of the oldest record (advances on pop and drop)
+    bool m_ready = false;
+
+    /**
+     * @brief Rewrite the data file without the consumed prefix
+     *
+     * The compacted copy is renamed over the data file; the index is reset
+     * first, so a crash in between replays consumed records instead of
+     * losing live ones.
+     * @return true on success
+     */
+    bool compact();
+
+    /**
+     * @brief Persist the read offset
+     */
+    void writeIndex();
+};
+
+#endif // FLASH_QUEUE_H
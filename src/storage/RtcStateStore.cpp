@@ -0,0 +1,259 @@
+/**
+ * @file RtcStateStore.cpp
+ * @brief RtcStateStore implementation
+ */
+
+#include "RtcStateStore.h"
+#include "../components/BaseComponent.h"
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <rom/crc.h>
+#include <stddef.h>
+
+namespace {
+
+/**
+ * @brief Per-component snapshot slot (fixed size, no pointers)
+ */
+struct RtcComponentSlot {
+    uint32_t idHash;
+    uint32_t typeHash;
+    uint32_t nextDueInMs;      // Remaining time until next execution when saved
+    uint32_t executionCount;
+    uint16_t dataLen;
+    uint8_t stateLen;
+    uint8_t reserved;
+    uint8_t data[RtcStateStore::DATA_BYTES];
+    uint8_t state[RtcStateStore::STATE_BYTES];
+};
+
+/**
+ * @brief Complete snapshot as laid out in RTC slow memory
+ */
+struct RtcSnapshot {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t slotCount;
+    uint32_t bootCount;
+    uint32_t sequence;         // Incremented on every save
+    uint32_t savedUptimeMs;    // millis() of the run that wrote the snapshot
+    uint32_t crc;
+    RtcComponentSlot slots[RtcStateStore::MAX_SLOTS];
+};
+
+// Not touched by the startup code, so it survives software resets and deep sleep
+RTC_NOINIT_ATTR RtcSnapshot s_snapshot;
+
+}  // namespace
+
+// Out-of-line definitions for ODR-used constants
+const uint32_t RtcStateStore::MAGIC;
+const uint16_t RtcStateStore::VERSION;
+const size_t RtcStateStore::MAX_SLOTS;
+const size_t RtcStateStore::DATA_BYTES;
+const size_t RtcStateStore::STATE_BYTES;
+
+// Static member initialization
+bool RtcStateStore::s_valid = false;
+uint32_t RtcStateStore::s_restoredCount = 0;
+uint32_t RtcStateStore::s_saveCount = 0;
+uint32_t RtcStateStore::s_lastSaveMs = 0;
+uint32_t RtcStateStore::s_lastSaveDurationUs = 0;
+
+bool RtcStateStore::begin() {
+    esp_reset_reason_t reason = esp_reset_reason();
+
+    bool headerOk = (s_snapshot.magic == MAGIC) &&
+                    (s_snapshot.version == VERSION) &&
+                    (s_snapshot.slotCount <= MAX_SLOTS);
+    bool intact = headerOk && (s_snapshot.crc == computeCrc());
+
+    // RTC memory content is undefined after power-on, regardless of checksum luck
+    if (reason == ESP_RST_POWERON) {
+        intact = false;
+    }
+
+    if (intact) {
+        s_snapshot.bootCount++;
+        s_valid = s_snapshot.slotCount > 0;
+        Logger::info("RtcStateStore", String("Warm boot (") + getResetReason() + "): snapshot #" +
+                     s_snapshot.sequence + " with " + s_snapshot.slotCount + " components, boot " +
+                     s_snapshot.bootCount);
+    } else {
+        memset(&s_snapshot, 0, sizeof(s_snapshot));
+        s_snapshot.magic = MAGIC;
+        s_snapshot.version = VERSION;
+        s_snapshot.bootCount = 1;
+        s_valid = false;
+        Logger::info("RtcStateStore", String("Cold boot (") + getResetReason() + ") - " +
+                     (headerOk ? "snapshot checksum mismatch" : "no snapshot"));
+    }
+
+    s_snapshot.crc = computeCrc();
+    return s_valid;
+}
+
+size_t RtcStateStore::save(const std::vector<BaseComponent*>& components) {
+    uint32_t startUs = micros();
+    MonoTimeUs nowUs = TimeUtils::monoNowUs();
+    uint32_t now = (uint32_t)(nowUs / 1000);
+    size_t count = 0;
+
+    for (BaseComponent* component : components) {
+        if (!component || count >= MAX_SLOTS) continue;
+
+        RtcComponentSlot& slot = s_snapshot.slots[count];
+        memset(&slot, 0, sizeof(slot));
+        slot.idHash = hash(component->getId());
+        slot.typeHash = hash(component->getType());
+
+        MonoTimeUs dueInUs = component->getNextExecutionUs() - nowUs;
+        slot.nextDueInMs = dueInUs > 0 ? (uint32_t)(dueInUs / 1000) : 0;
+        slot.executionCount = component->getExecutionCount();
+
+        JsonDocument data = component->getLastExecutionData();
+        if (measureMsgPack(data) > DATA_BYTES) {
+            data = component->getCoreData();
+        }
+        if (data.size() > 0 && measureMsgPack(data) <= DATA_BYTES) {
+            slot.dataLen = serializeMsgPack(data, slot.data, DATA_BYTES);
+        }
+
+        JsonDocument state;
+        component->getWarmState(state.to<JsonObject>());
+        if (state.size() > 0) {
+            if (measureMsgPack(state) <= STATE_BYTES) {
+                slot.stateLen = serializeMsgPack(state, slot.state, STATE_BYTES);
+            } else {
+                Logger::warning("RtcStateStore", "Warm state too large for slot: " + component->getId());
+            }
+        }
+
+        count++;
+    }
+
+    s_snapshot.magic = MAGIC;
+    s_snapshot.version = VERSION;
+    s_snapshot.slotCount = count;
+    s_snapshot.sequence++;
+    s_snapshot.savedUptimeMs = now;
+    s_snapshot.crc = computeCrc();
+
+    s_saveCount++;
+    s_lastSaveMs = now;
+    s_lastSaveDurationUs = micros() - startUs;
+
+    Logger::debug("RtcStateStore", String("Snapshot #") + s_snapshot.sequence + " saved: " + count +
+                  " components in " + s_lastSaveDurationUs + "us");
+    return count;
+}
+
+size_t RtcStateStore::restore(const std::vector<BaseComponent*>& components, uint32_t elapsedMs) {
+    if (!s_valid) {
+        return 0;
+    }
+
+    size_t restored = 0;
+    for (BaseComponent* component : components) {
+        if (!component) continue;
+
+        uint32_t idHash = hash(component->getId());
+        uint32_t typeHash = hash(component->getType());
+
+        for (size_t i = 0; i < s_snapshot.slotCount; i++) {
+            const RtcComponentSlot& slot = s_snapshot.slots[i];
+            if (slot.idHash != idHash || slot.typeHash != typeHash) continue;
+
+            JsonDocument data;
+            if (slot.dataLen > 0 && slot.dataLen <= DATA_BYTES) {
+                if (deserializeMsgPack(data, slot.data, slot.dataLen) != DeserializationError::Ok) {
+                    data.clear();
+                }
+            }
+            uint32_t remainingMs = slot.nextDueInMs > elapsedMs ? slot.nextDueInMs - elapsedMs : 0;
+            component->restoreRuntimeSnapshot(data, remainingMs, slot.executionCount);
+
+            if (slot.stateLen > 0 && slot.stateLen <= STATE_BYTES) {
+                JsonDocument state;
+                if (deserializeMsgPack(state, slot.state, slot.stateLen) == DeserializationError::Ok) {
+                    component->restoreWarmState(state.as<JsonObjectConst>());
+                }
+            }
+
+            restored++;
+            break;
+        }
+    }
+
+    s_restoredCount = restored;
+    s_valid = false;  // Snapshot consumed; the next save() rewrites it
+
+    Logger::info("RtcStateStore", String("Restored warm state for ") + restored + "/" +
+                 components.size() + " components (snapshot was " + s_snapshot.savedUptimeMs +
+                 "ms into the previous run)");
+    return restored;
+}
+
+void RtcStateStore::invalidate() {
+    s_snapshot.magic = 0;
+    s_snapshot.crc = 0;
+    s_valid = false;
+}
+
+JsonDocument RtcStateStore::getStatus() {
+    JsonDocument status;
+
+    status["version"] = VERSION;
+    status["resetReason"] = getResetReason();
+    status["bootCount"] = s_snapshot.bootCount;
+    status["restoredComponents"] = s_restoredCount;
+    status["slotCount"] = s_snapshot.slotCount;
+    status["sequence"] = s_snapshot.sequence;
+    status["saveCount"] = s_saveCount;
+    status["lastSaveMs"] = s_lastSaveMs;
+    status["lastSaveUs"] = s_lastSaveDurationUs;
+    status["snapshotBytes"] = sizeof(RtcSnapshot);
+
+    return status;
+}
+
+uint32_t RtcStateStore::getBootCount() {
+    return s_snapshot.bootCount;
+}
+
+const char* RtcStateStore::getResetReason() {
+    switch (esp_reset_reason()) {
+        case ESP_RST_POWERON:   return "poweron";
+        case ESP_RST_EXT:       return "external";
+        case ESP_RST_SW:        return "software";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:   return "int_wdt";
+        case ESP_RST_TASK_WDT:  return "task_wdt";
+        case ESP_RST_WDT:       return "wdt";
+        case ESP_RST_DEEPSLEEP: return "deepsleep";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        case ESP_RST_SDIO:      return "sdio";
+        default:                return "unknown";
+    }
+}
+
+uint32_t RtcStateStore::hash(const String& text) {
+    uint32_t h = 2166136261UL;
+    for (size_t i = 0; i < text.length(); i++) {
+        h ^= (uint8_t)text[i];
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+uint32_t RtcStateStore::computeCrc() {
+    size_t slots = s_snapshot.slotCount <= MAX_SLOTS ? s_snapshot.slotCount : MAX_SLOTS;
+    size_t length = offsetof(RtcSnapshot, slots) + slots * sizeof(RtcComponentSlot);
+
+    uint32_t savedCrc = s_snapshot.crc;
+    s_snapshot.crc = 0;
+    uint32_t crc = crc32_le(0, reinterpret_cast<const uint8_t*>(&s_snapshot), length);
+    s_snapshot.crc = savedCrc;
+
+    return crc;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file RtcStateStore.h
+ * @brief Warm-restart state retention in RTC slow memory
+ *
+ * Keeps a compact, checksummed snapshot of runtime state (last readings,
+ * schedule offsets, component counters) in RTC slow memory so that a
+ * software reset, watchdog reset or deep-sleep wake resumes with almost
+ * no data gap instead of starting cold.
+ */
+
+#ifndef RTC_STATE_STORE_H
+#define RTC_STATE_STORE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include "../utils/Logger.h"
+
+class BaseComponent;
+
+/**
+ * @brief Static accessor for the RTC snapshot
+ *
+ * RTC slow memory survives software/watchdog resets and deep sleep but not
+ * power loss, so every snapshot carries a magic, a layout version and a
+ * CRC32; anything that fails those checks is ignored and boot is cold.
+ *
+ * Per-slot payloads are MessagePack to keep the footprint under 4KB:
+ * - data:  last execution data (falls back to getCoreData() if too large)
+ * - state: component-specific warm state (see BaseComponent::getWarmState)
+ */
+class RtcStateStore {
+public:
+    static const uint32_t MAGIC = 0x52544353;   // "RTCS"
+    static const uint16_t VERSION = 1;          // Bump when the layout changes
+    static const size_t MAX_SLOTS = 20;         // First 20 components; RTC slow memory is 8 KB
+    static const size_t DATA_BYTES = 128;       // MessagePack bytes of last data per slot
+    static const size_t STATE_BYTES = 48;       // MessagePack bytes of warm state per slot
+
+    /**
+     * @brief Validate the snapshot left by the previous run
+     *
+     * Must be called once at boot before restore(). Power-on resets always
+     * discard the snapshot.
+     *
+     * @return true if a valid snapshot is available for restore
+     */
+    static bool begin();
+
+    /**
+     * @brief Check whether a valid snapshot was found at boot
+     * @return true if restore() has something to apply
+     */
+    static bool hasSnapshot() { return s_valid; }
+
+    /**
+     * @brief Capture runtime state of all components into RTC memory
+     * @param components Registered components
+     * @return Number of component slots written
+     */
+    static size_t save(const std::vector<BaseComponent*>& components);
+
+    /**
+     * @brief Apply the boot-time snapshot to matching components
+     *
+     * Components are matched by ID hash and type hash; unmatched slots are
+     * ignored. Consumes the snapshot (subsequent calls return 0).
+     *
+     * @param components Registered, initialized components
+     * @param elapsedMs Time passed since the snapshot was taken (deducted from schedule offsets)
+     * @return Number of components restored
+     */
+    static size_t restore(const std::vector<BaseComponent*>& components, uint32_t elapsedMs = 0);
+
+    /**
+     * @brief Invalidate the snapshot (e.g. before a factory reset)
+     */
+    static void invalidate();
+
+    /**
+     * @brief Get snapshot status for diagnostics
+     * @return Status as JSON document
+     */
+    static JsonDocument getStatus();
+
+    /**
+     * @brief Get number of boots since the snapshot chain started
+     * @return Boot counter (1 on a cold boot)
+     */
+    static uint32_t getBootCount();
+
+    /**
+     * @brief Get reason for the last reset as string
+     * @return Reset reason (e.g. "software", "task_wdt", "deepsleep")
+     */
+    static const char* getResetReason();
+
+    /**
+     * @brief 32-bit FNV-1a hash used to identify components in the snapshot
+     * @param text String to hash
+     * @return Hash value
+     */
+    static uint32_t hash(const String& text);
+
+private:
+    static bool s_valid;
+    static uint32_t s_restoredCount;
+    static uint32_t s_saveCount;
+    static uint32_t s_lastSaveMs;
+    static uint32_t s_lastSaveDurationUs;
+
+    /**
+     * @brief Compute the checksum of the current snapshot
+     * @return CRC32 over the whole snapshot with the crc field zeroed
+     */
+    static uint32_t computeCrc();
+};
+
+#endif // RTC_STATE_STORE_H
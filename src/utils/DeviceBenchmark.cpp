@@ -0,0 +1,481 @@
+/**
+ * @file DeviceBenchmark.cpp
+ * @brief DeviceBenchmark implementation
+ */
+
+#include "DeviceBenchmark.h"
+#include "Logger.h"
+#include "TimeUtils.h"
+#include "FlashSafeTimer.h"
+#include <LittleFS.h>
+#include <Wire.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Out-of-line definitions for ODR-used constants
+const uint32_t DeviceBenchmark::TASK_STACK_BYTES;
+const uint8_t DeviceBenchmark::TASK_PRIORITY;
+const uint8_t DeviceBenchmark::TASK_CORE;
+
+// Static member initialization
+volatile bool DeviceBenchmark::s_running = false;
+DeviceBenchmarkOptions DeviceBenchmark::s_options;
+String DeviceBenchmark::s_lastReport = "";
+uint32_t DeviceBenchmark::s_runCount = 0;
+
+namespace {
+
+const char* BENCH_FILE = "/bench.tmp";
+
+/**
+ * @brief Running min/avg/max of a latency series in microseconds
+ */
+struct LatencyStats {
+    uint32_t count = 0;
+    uint64_t totalUs = 0;
+    uint32_t minUs = UINT32_MAX;
+    uint32_t maxUs = 0;
+
+    void add(int64_t us) {
+        uint32_t value = us < 0 ? 0 : (uint32_t)us;
+        count++;
+        totalUs += value;
+        if (value < minUs) minUs = value;
+        if (value > maxUs) maxUs = value;
+    }
+
+    void toJson(JsonObject out) const {
+        out["avg_us"] = count ? (uint32_t)(totalUs / count) : 0;
+        out["min_us"] = count ? minUs : 0;
+        out["max_us"] = maxUs;
+    }
+};
+
+float kbPerSecond(uint32_t bytes, int64_t us) {
+    return us > 0 ? (float)bytes * 1000000.0f / 1024.0f / (float)us : 0.0f;
+}
+
+/**
+ * @brief Synthetic sensor reading, the document every component produces per execute()
+ */
+void buildReading(JsonDocument& doc) {
+    doc["timestamp"] = millis();
+    doc["success"] = true;
+    doc["temperature"] = 23.45;
+    doc["humidity"] = 61.2;
+    doc["ph"] = 6.12;
+    doc["ec"] = 1.84;
+    doc["voltage"] = 1.6523;
+    doc["calibrated"] = true;
+    doc["sensor_status"] = "ok";
+}
+
+} // namespace
+
+bool DeviceBenchmark::start(const DeviceBenchmarkOptions& options) {
+    if (s_running) {
+        return false;
+    }
+
+    s_options = options;
+    s_running = true;
+    BaseType_t created = xTaskCreatePinnedToCore(taskEntry, "bench", TASK_STACK_BYTES, nullptr,
+                                                 TASK_PRIORITY, nullptr, TASK_CORE);
+    if (created != pdPASS) {
+        s_running = false;
+        Logger::error("Bench", "Failed to create benchmark task");
+        return false;
+    }
+
+    Logger::info("Bench", "Self-benchmark started");
+    return true;
+}
+
+JsonDocument DeviceBenchmark::getReport() {
+    JsonDocument report;
+
+    // The task only writes s_lastReport while s_running is set
+    if (s_running) {
+        report["status"] = "running";
+    } else if (s_lastReport.isEmpty()) {
+        report["status"] = "idle";
+    } else {
+        deserializeJson(report, s_lastReport);
+    }
+    return report;
+}
+
+size_t DeviceBenchmark::releaseReport() {
+    if (s_running) {
+        return 0;
+    }
+    size_t bytes = s_lastReport.length();
+    s_lastReport = String();
+    return bytes;
+}
+
+void DeviceBenchmark::taskEntry(void* /*parameter*/) {
+    JsonDocument report;
+    run(s_options, report);
+
+    s_lastReport = "";
+    serializeJson(report, s_lastReport);
+    s_options.sampleJson = "";  // Release the snapshot
+    s_runCount++;
+
+    Logger::info("Bench", String("Self-benchmark complete in ") + (report["duration_ms"].as<uint32_t>()) + "ms");
+    s_running = false;
+    vTaskDelete(nullptr);
+}
+
+void DeviceBenchmark::run(const DeviceBenchmarkOptions& options, JsonDocument& report) {
+    int64_t startUs = esp_timer_get_time();
+
+    report["status"] = "complete";
+    report["run"] = s_runCount + 1;
+    report["uptime_ms"] = millis();
+    report["chip_model"] = ESP.getChipModel();
+    report["chip_revision"] = ESP.getChipRevision();
+    report["cpu_freq_mhz"] = ESP.getCpuFreqMHz();
+    report["sdk_version"] = ESP.getSdkVersion();
+    report["sketch_size"] = ESP.getSketchSize();
+    report["free_heap_before"] = ESP.getFreeHeap();
+    if (TimeUtils::hasEpochMapping()) {
+        report["epoch_ms"] = TimeUtils::getEpochMillis();
+    }
+
+    if (options.filesystem) benchFilesystem(options, report["filesystem"].to<JsonObject>());
+    if (options.json) benchJson(options, report["json"].to<JsonObject>());
+    if (options.i2c) benchI2C(options, report["i2c"].to<JsonObject>());
+    if (options.adc) benchAdc(options, report["adc"].to<JsonObject>());
+    if (options.tick) benchTick(report["tick"].to<JsonObject>());
+    if (options.isr) benchIsrLatency(options, report["isr"].to<JsonObject>());
+
+    report["free_heap_after"] = ESP.getFreeHeap();
+    report["min_free_heap"] = ESP.getMinFreeHeap();
+    report["duration_ms"] = (uint32_t)((esp_timer_get_time() - startUs) / 1000);
+}
+
+void DeviceBenchmark::benchFilesystem(const DeviceBenchmarkOptions& options, JsonObject result) {
+    size_t freeBytes = LittleFS.totalBytes() - LittleFS.usedBytes();
+    result["total_bytes"] = LittleFS.totalBytes();
+    result["free_bytes"] = freeBytes;
+
+    // Leave headroom for configuration writes happening in parallel
+    uint32_t bytes = options.fsBytes;
+    if (bytes + 16384 > freeBytes) {
+        result["skipped"] = "Not enough free space";
+        return;
+    }
+
+    uint16_t blockBytes = options.fsBlockBytes ? options.fsBlockBytes : 512;
+    uint8_t* block = (uint8_t*)malloc(blockBytes);
+    if (!block) {
+        result["skipped"] = "Out of memory";
+        return;
+    }
+    for (uint16_t i = 0; i < blockBytes; i++) {
+        block[i] = (uint8_t)(i * 31 + 7);
+    }
+    result["stream_bytes"] = bytes;
+    result["block_bytes"] = blockBytes;
+
+    // Streamed write
+    LatencyStats writeBlocks;
+    int64_t start = esp_timer_get_time();
+    File file = LittleFS.open(BENCH_FILE, "w");
+    if (!file) {
+        free(block);
+        result["error"] = "Cannot create test file";
+        return;
+    }
+    uint32_t written = 0;
+    while (written < bytes) {
+        int64_t blockStart = esp_timer_get_time();
+        size_t n = file.write(block, blockBytes);
+        writeBlocks.add(esp_timer_get_time() - blockStart);
+        if (n != blockBytes) break;
+        written += n;
+    }
+    int64_t closeStart = esp_timer_get_time();
+    file.close();
+    int64_t closeUs = esp_timer_get_time() - closeStart;
+    int64_t writeUs = esp_timer_get_time() - start;
+
+    JsonObject write = result["write"].to<JsonObject>();
+    write["bytes"] = written;
+    write["kb_per_s"] = kbPerSecond(written, writeUs);
+    write["close_us"] = (uint32_t)closeUs;
+    writeBlocks.toJson(write["block"].to<JsonObject>());
+
+    // Streamed read
+    LatencyStats readBlocks;
+    uint32_t readBytes = 0;
+    start = esp_timer_get_time();
+    file = LittleFS.open(BENCH_FILE, "r");
+    if (file) {
+        while (true) {
+            int64_t blockStart = esp_timer_get_time();
+            size_t n = file.read(block, blockBytes);
+            if (n == 0) break;
+            readBlocks.add(esp_timer_get_time() - blockStart);
+            readBytes += n;
+        }
+        file.close();
+    }
+    int64_t readUs = esp_timer_get_time() - start;
+
+    JsonObject read = result["read"].to<JsonObject>();
+    read["bytes"] = readBytes;
+    read["kb_per_s"] = kbPerSecond(readBytes, readUs);
+    readBlocks.toJson(read["block"].to<JsonObject>());
+    LittleFS.remove(BENCH_FILE);
+
+    // Small files, the pattern of every configuration save and load
+    LatencyStats smallWrite;
+    LatencyStats smallRead;
+    uint16_t smallBytes = blockBytes < 256 ? blockBytes : 256;
+    for (uint16_t i = 0; i < options.fsSmallFiles; i++) {
+        start = esp_timer_get_time();
+        file = LittleFS.open(BENCH_FILE, "w");
+        if (!file) break;
+        file.write(block, smallBytes);
+        file.close();
+        smallWrite.add(esp_timer_get_time() - start);
+
+        start = esp_timer_get_time();
+        file = LittleFS.open(BENCH_FILE, "r");
+        if (!file) break;
+        file.read(block, smallBytes);
+        file.close();
+        smallRead.add(esp_timer_get_time() - start);
+    }
+    LittleFS.remove(BENCH_FILE);
+    free(block);
+
+    JsonObject small = result["small_file"].to<JsonObject>();
+    small["bytes"] = smallBytes;
+    smallWrite.toJson(small["write"].to<JsonObject>());
+    smallRead.toJson(small["read"].to<JsonObject>());
+}
+
+void DeviceBenchmark::benchJson(const DeviceBenchmarkOptions& options, JsonObject result) {
+    uint16_t iterations = options.jsonIterations ? options.jsonIterations : 1;
+
+    JsonDocument reading;
+    buildReading(reading);
+    String readingStr;
+    serializeJson(reading, readingStr);
+
+    struct Sample {
+        const char* name;
+        const String* text;
+    };
+    Sample samples[] = {
+        {"reading", &readingStr},
+        {"component_data", &options.sampleJson},
+    };
+
+    for (const Sample& sample : samples) {
+        if (sample.text->isEmpty()) continue;
+
+        JsonDocument doc;
+        if (deserializeJson(doc, *sample.text)) continue;
+
+        JsonObject out = result[sample.name].to<JsonObject>();
+        out["bytes"] = sample.text->length();
+
+        int64_t start = esp_timer_get_time();
+        for (uint16_t i = 0; i < iterations; i++) {
+            String text;
+            serializeJson(doc, text);
+        }
+        int64_t serializeUs = esp_timer_get_time() - start;
+
+        start = esp_timer_get_time();
+        for (uint16_t i = 0; i < iterations; i++) {
+            JsonDocument parsed;
+            deserializeJson(parsed, *sample.text);
+        }
+        int64_t parseUs = esp_timer_get_time() - start;
+
+        out["serialize_us"] = (uint32_t)(serializeUs / iterations);
+        out["parse_us"] = (uint32_t)(parseUs / iterations);
+        out["serialize_kb_per_s"] = kbPerSecond(sample.text->length() * iterations, serializeUs);
+        out["parse_kb_per_s"] = kbPerSecond(sample.text->length() * iterations, parseUs);
+    }
+    result["iterations"] = iterations;
+}
+
+void DeviceBenchmark::benchI2C(const DeviceBenchmarkOptions& options, JsonObject result) {
+    // No-op if a component already started the bus (keeps its pins and clock)
+    Wire.begin();
+    result["clock_hz"] = Wire.getClock();
+
+    JsonArray devices = result["devices"].to<JsonArray>();
+    int64_t scanStart = esp_timer_get_time();
+    for (uint8_t address = 0x08; address < 0x78; address++) {
+        Wire.beginTransmission(address);
+        if (Wire.endTransmission() != 0) continue;
+
+        // Address-only write (what a probe costs) and a one-byte read
+        LatencyStats probe;
+        LatencyStats readByte;
+        for (uint16_t i = 0; i < options.i2cIterations; i++) {
+            int64_t start = esp_timer_get_time();
+            Wire.beginTransmission(address);
+            Wire.endTransmission();
+            probe.add(esp_timer_get_time() - start);
+
+            start = esp_timer_get_time();
+            if (Wire.requestFrom(address, (uint8_t)1) == 1) {
+                Wire.read();
+                readByte.add(esp_timer_get_time() - start);
+            }
+        }
+
+        JsonObject device = devices.add<JsonObject>();
+        char hex[5];
+        snprintf(hex, sizeof(hex), "0x%02X", address);
+        device["address"] = hex;
+        probe.toJson(device["probe"].to<JsonObject>());
+        if (readByte.count > 0) {
+            readByte.toJson(device["read_byte"].to<JsonObject>());
+        }
+    }
+    result["scan_ms"] = (uint32_t)((esp_timer_get_time() - scanStart) / 1000);
+}
+
+void DeviceBenchmark::benchAdc(const DeviceBenchmarkOptions& options, JsonObject result) {
+    uint16_t samples = options.adcSamples ? options.adcSamples : 1;
+    result["pin"] = options.adcPin;
+    if (!isSafeAdcPin(options.adcPin)) {
+        result["error"] = "Not an ADC1 input-only pin";
+        return;
+    }
+    result["samples"] = samples;
+
+    uint32_t sum = 0;
+    int64_t start = esp_timer_get_time();
+    for (uint16_t i = 0; i < samples; i++) {
+        sum += analogRead(options.adcPin);
+    }
+    int64_t rawUs = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (uint16_t i = 0; i < samples; i++) {
+        analogReadMilliVolts(options.adcPin);
+    }
+    int64_t mvUs = esp_timer_get_time() - start;
+
+    result["raw_us"] = (float)rawUs / samples;
+    result["raw_samples_per_s"] = rawUs > 0 ? (uint32_t)((int64_t)samples * 1000000 / rawUs) : 0;
+    result["millivolts_us"] = (float)mvUs / samples;
+    result["millivolts_samples_per_s"] = mvUs > 0 ? (uint32_t)((int64_t)samples * 1000000 / mvUs) : 0;
+    result["mean_raw"] = sum / samples;
+}
+
+void DeviceBenchmark::benchTick(JsonObject result) {
+    const int calls = 1000;
+
+    // Cost of the clock reads every loop pass and scheduler check makes
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < calls; i++) {
+        esp_timer_get_time();
+    }
+    result["esp_timer_ns"] = (uint32_t)((esp_timer_get_time() - start) * 1000 / calls);
+
+    volatile uint32_t sink = 0;
+    start = esp_timer_get_time();
+    for (int i = 0; i < calls; i++) {
+        sink += millis();
+    }
+    result["millis_ns"] = (uint32_t)((esp_timer_get_time() - start) * 1000 / calls);
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < calls; i++) {
+        sink += (uint32_t)TimeUtils::monoNowUs();
+    }
+    result["mono_now_ns"] = (uint32_t)((esp_timer_get_time() - start) * 1000 / calls);
+    (void)sink;
+
+    // One-tick sleep: scheduler granularity and wake-up jitter at this priority
+    LatencyStats delayTick;
+    for (int i = 0; i < 20; i++) {
+        int64_t tickStart = esp_timer_get_time();
+        vTaskDelay(1);
+        delayTick.add(esp_timer_get_time() - tickStart);
+    }
+    result["tick_period_us"] = (uint32_t)(portTICK_PERIOD_MS * 1000);
+    delayTick.toJson(result["delay_1_tick"].to<JsonObject>());
+
+    // Context switch round trip through the scheduler
+    start = esp_timer_get_time();
+    for (int i = 0; i < 100; i++) {
+        taskYIELD();
+    }
+    result["yield_us"] = (float)(esp_timer_get_time() - start) / 100.0f;
+}
+
+void DeviceBenchmark::benchIsrLatency(const DeviceBenchmarkOptions& options, JsonObject result) {
+    if (!FlashSafeTimer::isSupported()) {
+        result["skipped"] = "Unsupported";
+        return;
+    }
+    const uint16_t writeBytes = 4096;
+    if (LittleFS.totalBytes() - LittleFS.usedBytes() < (size_t)writeBytes * options.isrRounds + 16384) {
+        result["skipped"] = "Not enough free space";
+        return;
+    }
+    uint8_t* block = (uint8_t*)malloc(writeBytes);
+    if (!block) {
+        result["skipped"] = "Out of memory";
+        return;
+    }
+    memset(block, 0x5A, writeBytes);
+
+    // Same deadlines, same flash load: first with an ordinary interrupt (held off while
+    // the cache is disabled), then with the IRAM interrupt the pump cut-off uses
+    const bool iramModes[2] = { false, true };
+    for (uint8_t mode = 0; mode < 2; mode++) {
+        JsonObject pass = result[iramModes[mode] ? "iram" : "flash_blocked"].to<JsonObject>();
+        if (!FlashSafeTimer::begin(iramModes[mode])) {
+            pass["skipped"] = "Deadline timer busy";
+            continue;
+        }
+        FlashSafeTimer::resetStats();
+
+        LatencyStats flashOps;
+        File file = LittleFS.open(BENCH_FILE, "w");
+        if (!file) {
+            pass["error"] = "Cannot create test file";
+            continue;
+        }
+        for (uint16_t round = 0; round < options.isrRounds; round++) {
+            // Due 500 us into a write that takes milliseconds
+            int32_t handle = FlashSafeTimer::armGpio(FlashSafeTimer::NO_PIN, false, 500);
+            int64_t opStart = esp_timer_get_time();
+            file.write(block, writeBytes);
+            file.flush();
+            flashOps.add(esp_timer_get_time() - opStart);
+            for (uint8_t wait = 0; FlashSafeTimer::isPending(handle) && wait < 10; wait++) {
+                vTaskDelay(1);
+            }
+            FlashSafeTimer::cancel(handle);
+        }
+        file.close();
+        LittleFS.remove(BENCH_FILE);
+
+        JsonDocument stats = FlashSafeTimer::getStats();
+        pass["deadlines"] = stats["fired"];
+        pass["avg_latency_us"] = stats["avg_latency_us"];
+        pass["max_latency_us"] = stats["max_latency_us"];
+        flashOps.toJson(pass["flash_write"].to<JsonObject>());
+    }
+
+    // Leave the timer flash-safe for the pumps
+    FlashSafeTimer::begin(true);
+    FlashSafeTimer::resetStats();
+    free(block);
+}
@@ -0,0 +1,101 @@
+/**
+ * @file DeviceBenchmark.h
+ * @brief On-device self-benchmark of flash, JSON, I2C, ADC, tick and ISR latency
+ *
+ * Backs /api/debug/bench. A run executes on its own low-priority task so
+ * the web server and the component loop keep their timing; the result is
+ * a JSON report meant for comparing boards and firmware builds.
+ */
+
+#ifndef DEVICE_BENCHMARK_H
+#define DEVICE_BENCHMARK_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/**
+ * @brief What to measure and how hard
+ */
+struct DeviceBenchmarkOptions {
+    bool filesystem = true;
+    bool json = true;
+    bool i2c = true;
+    bool adc = true;
+    bool tick = true;
+    bool isr = true;                  // Deadline-timer latency under flash writes
+    uint32_t fsBytes = 32768;         // Streamed write/read size
+    uint16_t fsBlockBytes = 512;      // Write/read chunk size
+    uint16_t fsSmallFiles = 10;       // Config-sized open/write/close rounds
+    uint16_t jsonIterations = 50;
+    uint16_t i2cIterations = 20;      // Transactions per responding device
+    uint8_t adcPin = 36;              // ADC1 input-only pin, safe to sample
+    uint16_t adcSamples = 1000;
+    uint16_t isrRounds = 20;          // Deadlines, each fired during a 4 KB write + sync
+    String sampleJson = "";           // Representative document (e.g. /api/components/data)
+};
+
+/**
+ * @brief Static runner for the self-benchmark
+ */
+class DeviceBenchmark {
+public:
+    static const uint32_t TASK_STACK_BYTES = 8192;
+    static const uint8_t TASK_PRIORITY = 1;          // Above idle only
+    static const uint8_t TASK_CORE = 0;              // Off the Arduino loop core
+
+    /**
+     * @brief Start a run on the background task
+     * @param options Run options
+     * @return false if a run is already in progress or the task cannot start
+     */
+    static bool start(const DeviceBenchmarkOptions& options);
+
+    /**
+     * @brief Check if a run is in progress
+     * @return true while the background task is measuring
+     */
+    static bool isRunning() { return s_running; }
+
+    /**
+     * @brief Get the report of the last completed run
+     * @return Report, or a status-only document while running / before the first run
+     */
+    static JsonDocument getReport();
+
+    /**
+     * @brief Drop the held report of the last run (no-op while running)
+     * @return Bytes released
+     */
+    static size_t releaseReport();
+
+    /**
+     * @brief Check if a pin can be sampled without touching an output
+     * @param pin GPIO number
+     * @return true for the ADC1 input-only pins (36-39)
+     */
+    static bool isSafeAdcPin(int pin) { return pin >= 36 && pin <= 39; }
+
+    /**
+     * @brief Run synchronously on the calling task
+     * @param options Run options
+     * @param report Filled with one section per enabled measurement
+     */
+    static void run(const DeviceBenchmarkOptions& options, JsonDocument& report);
+
+private:
+    static volatile bool s_running;
+    static DeviceBenchmarkOptions s_options;
+    static String s_lastReport;
+    static uint32_t s_runCount;
+
+    static void taskEntry(void* parameter);
+
+    static void benchFilesystem(const DeviceBenchmarkOptions& options, JsonObject result);
+    static void benchJson(const DeviceBenchmarkOptions& options, JsonObject result);
+    static void benchI2C(const DeviceBenchmarkOptions& options, JsonObject result);
+    static void benchAdc(const DeviceBenchmarkOptions& options, JsonObject result);
+    static void benchTick(JsonObject result);
+    static void benchIsrLatency(const DeviceBenchmarkOptions& options, JsonObject result);
+};
+
+#endif // DEVICE_BENCHMARK_H
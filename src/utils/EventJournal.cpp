@@ -0,0 +1,492 @@
+/**
+ * @file EventJournal.cpp
+ * @brief EventJournal implementation
+ */
+
+#include "EventJournal.h"
+#include "Logger.h"
+#include "TimeUtils.h"
+#include "../storage/RtcStateStore.h"
+#include <LittleFS.h>
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <algorithm>
+#include <string.h>
+#ifndef NATIVE_SIM
+#include <freertos/FreeRTOS.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Sequence counter kept across software resets and deep sleep
+ */
+struct RtcJournalState {
+    uint32_t magic;
+    uint32_t nextSeq;
+    uint32_t check;            // magic ^ nextSeq
+};
+
+const uint32_t JOURNAL_MAGIC = 0x45564A31;   // "EVJ1"
+const uint16_t FILE_VERSION = 1;
+const char* const JOURNAL_PATH = "/data/events.bin";
+const uint8_t DISPATCH_BATCH = 32;             // Events handled per dispatch() call
+
+// Not touched by the startup code, so it survives software resets and deep sleep
+RTC_NOINIT_ATTR RtcJournalState s_rtc;
+
+const char* const TYPE_NAMES[EVENT_TYPE_COUNT] = {
+    "boot", "restart", "state", "error", "dose", "rule", "network", "resource"
+};
+
+// Indexed by Logger::Level
+const char* const LEVEL_NAMES[] = {
+    "debug", "info", "warning", "error", "critical"
+};
+const uint8_t LEVEL_COUNT = sizeof(LEVEL_NAMES) / sizeof(LEVEL_NAMES[0]);
+
+void copyText(char* dest, size_t size, const char* text) {
+    if (!text) text = "";
+    strncpy(dest, text, size - 1);
+    dest[size - 1] = '\0';
+}
+
+}  // namespace
+
+// Out-of-line definitions for ODR-used constants
+const uint16_t EventJournal::CAPACITY;
+const uint16_t EventJournal::PERSIST_SLOTS;
+const uint8_t EventJournal::PERSIST_PER_MINUTE;
+const uint16_t EventJournal::MAX_QUERY;
+const uint32_t EventJournal::SEQ_RESERVE;
+
+// Static member initialization
+EventRecord EventJournal::s_events[EventJournal::CAPACITY];
+uint16_t EventJournal::s_write = 0;
+uint16_t EventJournal::s_count = 0;
+uint32_t EventJournal::s_lastSeq = 0;
+uint32_t EventJournal::s_dispatchedSeq = 0;
+uint32_t EventJournal::s_reservedSeq = 0;
+uint16_t EventJournal::s_persistSlot = 0;
+uint32_t EventJournal::s_persistWindowMs = 0;
+uint8_t EventJournal::s_persistInWindow = 0;
+bool EventJournal::s_persistReady = false;
+uint32_t EventJournal::s_persisted = 0;
+uint32_t EventJournal::s_persistSkipped = 0;
+uint32_t EventJournal::s_overrun = 0;
+std::vector<std::pair<int, EventJournal::Listener>> EventJournal::s_listeners;
+int EventJournal::s_nextListener = 1;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static_assert(sizeof(EventRecord) == 96, "EventRecord layout is part of the event file format");
+
+void EventJournal::begin() {
+    // Exact continuation after a software reset or deep sleep
+    uint32_t rtcLastSeq = 0;
+    bool rtcValid = esp_reset_reason() != ESP_RST_POWERON &&
+                    s_rtc.magic == JOURNAL_MAGIC &&
+                    s_rtc.check == (JOURNAL_MAGIC ^ s_rtc.nextSeq) &&
+                    s_rtc.nextSeq > 0;
+    if (rtcValid) {
+        rtcLastSeq = s_rtc.nextSeq - 1;
+    }
+
+    // Reload persisted events; the slot after the newest one is written next
+    std::vector<EventRecord> persisted;
+    uint32_t fileReserved = 0;
+    const size_t fileBytes = sizeof(FileHeader) + (size_t)PERSIST_SLOTS * sizeof(EventRecord);
+    bool fileOk = false;
+
+    if (LittleFS.exists(JOURNAL_PATH)) {
+        File file = LittleFS.open(JOURNAL_PATH, "r");
+        FileHeader header;
+        if (file && file.size() == fileBytes &&
+            file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+            header.magic == JOURNAL_MAGIC && header.version == FILE_VERSION &&
+            header.recordBytes == sizeof(EventRecord) && header.slots == PERSIST_SLOTS) {
+            fileOk = true;
+            fileReserved = header.reservedSeq;
+            uint32_t newest = 0;
+            EventRecord event;
+            for (uint16_t slot = 0; slot < PERSIST_SLOTS; slot++) {
+                if (file.read(reinterpret_cast<uint8_t*>(&event), sizeof(event)) != sizeof(event)) {
+                    fileOk = false;
+                    break;
+                }
+                if (event.seq == 0 || event.type >= EVENT_TYPE_COUNT) continue;
+                event.source[sizeof(event.source) - 1] = '\0';
+                event.text[sizeof(event.text) - 1] = '\0';
+                persisted.push_back(event);
+                if (event.seq > newest) {
+                    newest = event.seq;
+                    s_persistSlot = (slot + 1) % PERSIST_SLOTS;
+                }
+            }
+        }
+        if (file) file.close();
+    }
+
+    if (!fileOk) {
+        persisted.clear();
+        s_persistSlot = 0;
+        File file = LittleFS.open(JOURNAL_PATH, "w");
+        if (file) {
+            FileHeader header = {};
+            file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+            EventRecord empty = {};
+            for (uint16_t slot = 0; slot < PERSIST_SLOTS; slot++) {
+                file.write(reinterpret_cast<const uint8_t*>(&empty), sizeof(empty));
+            }
+            fileOk = file.size() == fileBytes;
+            file.close();
+        }
+        if (!fileOk) {
+            Logger::warning("EventJournal", "Cannot create " + String(JOURNAL_PATH) + ", events kept in RAM only");
+        }
+    }
+
+    std::sort(persisted.begin(), persisted.end(), [](const EventRecord& a, const EventRecord& b) {
+        return a.seq < b.seq;
+    });
+    uint32_t base = rtcLastSeq;
+    if (!persisted.empty()) base = std::max(base, persisted.back().seq);
+    if (!rtcValid) base = std::max(base, fileReserved);
+
+    // Events recorded before begin() move behind the restored ones
+    std::vector<EventRecord> early;
+    early.reserve(CAPACITY);   // No allocation inside the critical section
+    portENTER_CRITICAL(&s_lock);
+    for (size_t i = 0; i < s_count; i++) {
+        early.push_back(at(i));
+    }
+    s_write = 0;
+    s_count = 0;
+    size_t skip = persisted.size() + early.size() > CAPACITY ? persisted.size() + early.size() - CAPACITY : 0;
+    for (size_t i = skip; i < persisted.size(); i++) {
+        append(persisted[i]);
+    }
+    s_lastSeq = base;
+    s_dispatchedSeq = base;
+    for (EventRecord& event : early) {
+        event.seq = ++s_lastSeq;
+        append(event);
+    }
+    s_rtc.magic = JOURNAL_MAGIC;
+    s_rtc.nextSeq = s_lastSeq + 1;
+    s_rtc.check = JOURNAL_MAGIC ^ s_rtc.nextSeq;
+    portEXIT_CRITICAL(&s_lock);
+
+    s_persistReady = fileOk;
+    if (s_persistReady) {
+        writeHeader();
+    }
+
+    Logger::info("EventJournal", String("Journal at seq ") + s_lastSeq + ", " + persisted.size() +
+                 " persisted events restored" + (rtcValid ? "" : " (sequence from flash)"));
+
+    // The boot itself, with the reason the previous run ended
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool abnormal = reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT || reason == ESP_RST_TASK_WDT ||
+                    reason == ESP_RST_WDT || reason == ESP_RST_BROWNOUT;
+    record(EVENT_BOOT, abnormal ? Logger::WARNING : Logger::INFO, "system",
+           RtcStateStore::getResetReason(), (int32_t)reason);
+}
+
+void EventJournal::record(EventType type, uint8_t level, const char* source, const char* text,
+                          int32_t code, float value) {
+    EventRecord event;
+    memset(&event, 0, sizeof(event));
+    event.uptimeMs = millis();
+    event.epoch = (uint32_t)(TimeUtils::getEpochMillis() / 1000);
+    event.code = code;
+    event.value = value;
+    event.type = type;
+    event.level = level;
+    copyText(event.source, sizeof(event.source), source);
+    copyText(event.text, sizeof(event.text), text);
+
+    portENTER_CRITICAL(&s_lock);
+    event.seq = ++s_lastSeq;
+    if (s_count == CAPACITY && at(0).seq > s_dispatchedSeq) {
+        s_overrun++;
+    }
+    append(event);
+    s_rtc.magic = JOURNAL_MAGIC;
+    s_rtc.nextSeq = s_lastSeq + 1;
+    s_rtc.check = JOURNAL_MAGIC ^ s_rtc.nextSeq;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void EventJournal::dispatch() {
+    for (uint8_t handled = 0; handled < DISPATCH_BATCH; handled++) {
+        EventRecord event;
+        portENTER_CRITICAL(&s_lock);
+        size_t index = lowerBound(s_dispatchedSeq + 1);
+        bool found = index < s_count;
+        if (found) {
+            event = at(index);
+            s_dispatchedSeq = event.seq;
+        }
+        portEXIT_CRITICAL(&s_lock);
+        if (!found) break;
+
+        if (s_persistReady && shouldPersist(event)) {
+            persist(event);
+        }
+        for (size_t i = 0; i < s_listeners.size(); i++) {
+            s_listeners[i].second(event);
+        }
+    }
+
+    // Keep the stored reservation ahead, so a power loss never reuses numbers
+    if (s_persistReady && s_lastSeq + SEQ_RESERVE / 2 > s_reservedSeq) {
+        writeHeader();
+    }
+}
+
+int EventJournal::addListener(Listener listener) {
+    int handle = s_nextListener++;
+    s_listeners.push_back(std::make_pair(handle, listener));
+    return handle;
+}
+
+void EventJournal::removeListener(int handle) {
+    for (auto it = s_listeners.begin(); it != s_listeners.end(); ++it) {
+        if (it->first == handle) {
+            s_listeners.erase(it);
+            return;
+        }
+    }
+}
+
+size_t EventJournal::read(const EventQuery& query, std::vector<EventRecord>& events, uint32_t& next) {
+    uint16_t limit = query.limit == 0 ? 1 : (query.limit > MAX_QUERY ? MAX_QUERY : query.limit);
+    uint32_t cursor = query.after;
+    size_t found = 0;
+
+    // One short critical section per event; a full ring scan is CAPACITY steps at most
+    for (uint16_t examined = 0; examined < CAPACITY && found < limit; examined++) {
+        EventRecord event;
+        portENTER_CRITICAL(&s_lock);
+        size_t index = lowerBound(cursor + 1);
+        bool held = index < s_count;
+        if (held) {
+            event = at(index);
+        }
+        portEXIT_CRITICAL(&s_lock);
+        if (!held) break;
+
+        cursor = event.seq;
+        if (matches(event, query)) {
+            events.push_back(event);
+            found++;
+        }
+    }
+
+    next = cursor;
+    return found;
+}
+
+JsonDocument EventJournal::query(const EventQuery& query) {
+    EventQuery selection = query;
+
+    uint32_t firstSeq = 0;
+    uint32_t lastSeq = 0;
+    portENTER_CRITICAL(&s_lock);
+    if (s_count > 0) {
+        firstSeq = at(0).seq;
+    }
+    lastSeq = s_lastSeq;
+    portEXIT_CRITICAL(&s_lock);
+
+    // A cursor ahead of the journal (event file erased) starts over from the oldest event
+    if (selection.after > lastSeq) {
+        selection.after = 0;
+    }
+
+    std::vector<EventRecord> events;
+    uint32_t next = selection.after;
+    read(selection, events, next);
+
+    JsonDocument doc;
+    doc["first_seq"] = firstSeq;
+    doc["last_seq"] = lastSeq;
+    doc["next"] = next;
+    doc["missed"] = (selection.after > 0 && firstSeq > selection.after + 1) ? firstSeq - selection.after - 1 : 0;
+    doc["more"] = next < lastSeq;
+    doc["count"] = events.size();
+
+    JsonArray list = doc["events"].to<JsonArray>();
+    for (const EventRecord& event : events) {
+        toJson(event, list.add<JsonObject>());
+    }
+    return doc;
+}
+
+void EventJournal::toJson(const EventRecord& event, JsonObject out) {
+    out["seq"] = event.seq;
+    out["type"] = typeName(event.type);
+    out["level"] = levelName(event.level);
+    out["source"] = event.source;
+    out["text"] = event.text;
+    out["code"] = event.code;
+    if (event.value != 0.0f) {
+        out["value"] = event.value;
+    }
+    out["uptime_ms"] = event.uptimeMs;
+    if (event.epoch > 0) {
+        out["timestamp"] = event.epoch;
+    }
+}
+
+uint32_t EventJournal::parseTypes(const String& list) {
+    if (list.isEmpty()) {
+        return 0xFFFFFFFF;
+    }
+
+    uint32_t mask = 0;
+    int start = 0;
+    while (start <= (int)list.length()) {
+        int comma = list.indexOf(',', start);
+        if (comma < 0) comma = list.length();
+        String name = list.substring(start, comma);
+        name.trim();
+        for (uint8_t type = 0; type < EVENT_TYPE_COUNT; type++) {
+            if (name.equalsIgnoreCase(TYPE_NAMES[type])) {
+                mask |= 1UL << type;
+            }
+        }
+        start = comma + 1;
+    }
+    return mask;
+}
+
+uint8_t EventJournal::parseLevel(const String& name) {
+    for (uint8_t level = 0; level < LEVEL_COUNT; level++) {
+        if (name.equalsIgnoreCase(LEVEL_NAMES[level])) {
+            return level;
+        }
+    }
+    if (name.equalsIgnoreCase("warn")) {
+        return Logger::WARNING;
+    }
+    long level = name.toInt();
+    return (level > 0 && level < LEVEL_COUNT) ? (uint8_t)level : Logger::DEBUG;
+}
+
+JsonDocument EventJournal::getStatus() {
+    JsonDocument doc;
+    portENTER_CRITICAL(&s_lock);
+    uint32_t firstSeq = s_count > 0 ? at(0).seq : 0;
+    uint16_t held = s_count;
+    uint32_t lastSeq = s_lastSeq;
+    portEXIT_CRITICAL(&s_lock);
+
+    doc["capacity"] = CAPACITY;
+    doc["held"] = held;
+    doc["first_seq"] = firstSeq;
+    doc["last_seq"] = lastSeq;
+    doc["dispatched_seq"] = s_dispatchedSeq;
+    doc["overrun"] = s_overrun;
+    doc["listeners"] = s_listeners.size();
+    doc["persist_file"] = s_persistReady ? JOURNAL_PATH : "";
+    doc["persist_slots"] = PERSIST_SLOTS;
+    doc["persisted"] = s_persisted;
+    doc["persist_skipped"] = s_persistSkipped;
+    doc["reserved_seq"] = s_reservedSeq;
+    return doc;
+}
+
+void EventJournal::append(const EventRecord& event) {
+    s_events[s_write] = event;
+    s_write = (s_write + 1) % CAPACITY;
+    if (s_count < CAPACITY) s_count++;
+}
+
+size_t EventJournal::lowerBound(uint32_t seq) {
+    // Records are held in sequence order, oldest first
+    size_t low = 0;
+    size_t high = s_count;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (at(mid).seq < seq) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+const EventRecord& EventJournal::at(size_t index) {
+    return s_events[(s_write + CAPACITY - s_count + index) % CAPACITY];
+}
+
+bool EventJournal::matches(const EventRecord& event, const EventQuery& query) {
+    if (event.level < query.minLevel) return false;
+    if (event.type >= 32 || !(query.typeMask & (1UL << event.type))) return false;
+    if (!query.source.isEmpty() && strcmp(event.source, query.source.c_str()) != 0) return false;
+    return true;
+}
+
+bool EventJournal::shouldPersist(const EventRecord& event) {
+    return event.level >= Logger::WARNING || event.type == EVENT_RESTART;
+}
+
+void EventJournal::persist(const EventRecord& event) {
+    uint32_t now = millis();
+    if (now - s_persistWindowMs >= 60000) {
+        s_persistWindowMs = now;
+        s_persistInWindow = 0;
+    }
+    // Restarts always get through: they explain the next boot
+    if (s_persistInWindow >= PERSIST_PER_MINUTE && event.type != EVENT_RESTART) {
+        s_persistSkipped++;
+        return;
+    }
+
+    File file = LittleFS.open(JOURNAL_PATH, "r+");
+    if (!file) {
+        s_persistReady = false;
+        Logger::warning("EventJournal", "Event file unavailable, persistence disabled");
+        return;
+    }
+    file.seek(sizeof(FileHeader) + (uint32_t)s_persistSlot * sizeof(EventRecord));
+    bool ok = file.write(reinterpret_cast<const uint8_t*>(&event), sizeof(event)) == sizeof(event);
+    file.close();
+
+    if (ok) {
+        s_persistSlot = (s_persistSlot + 1) % PERSIST_SLOTS;
+        s_persistInWindow++;
+        s_persisted++;
+    }
+}
+
+bool EventJournal::writeHeader() {
+    FileHeader header = {};
+    header.magic = JOURNAL_MAGIC;
+    header.version = FILE_VERSION;
+    header.recordBytes = sizeof(EventRecord);
+    header.slots = PERSIST_SLOTS;
+    header.reservedSeq = s_lastSeq + SEQ_RESERVE;
+
+    File file = LittleFS.open(JOURNAL_PATH, "r+");
+    if (!file) {
+        return false;
+    }
+    bool ok = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header);
+    file.close();
+    if (ok) {
+        s_reservedSeq = header.reservedSeq;
+    }
+    return ok;
+}
+
+const char* EventJournal::typeName(uint8_t type) {
+    return type < EVENT_TYPE_COUNT ? TYPE_NAMES[type] : "unknown";
+}
+
+const char* EventJournal::levelName(uint8_t level) {
+    return level < LEVEL_COUNT ? LEVEL_NAMES[level] : "unknown";
+}
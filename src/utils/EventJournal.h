@@ -0,0 +1,199 @@
+/**
+ * @file EventJournal.h
+ * @brief Fixed-size ring of typed, sequence-numbered system events
+ *
+ * State transitions, component errors, dose completions, rule firings,
+ * link changes, boots and restarts are recorded as 96-byte binary records
+ * in a static RAM ring (no heap, any task, a short critical section per
+ * event). Every record gets the next sequence number; sequence numbers
+ * never go back, also across reboots, so a client that remembers the last
+ * number it saw can ask for exactly the events after it.
+ *
+ * WARNING and higher events (and restarts) are also written to a fixed
+ * slot file on LittleFS by dispatch(), which runs on the main task and
+ * hands new events to listeners (the web server's live stream). The file
+ * is reloaded into the ring at boot, so the causes of a crash or restart
+ * are still visible afterwards. Writes are capped per minute to bound
+ * flash wear when a component keeps failing.
+ *
+ * Sequence continuity: the next number is kept in RTC memory across
+ * software resets and deep sleep; after a power-on the journal continues
+ * from a reservation stored in the file header, leaving a gap instead of
+ * reusing numbers that were handed out but never persisted.
+ */
+
+#ifndef EVENT_JOURNAL_H
+#define EVENT_JOURNAL_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <functional>
+#include <vector>
+
+// Ring capacity in events (96 bytes each); override with -DEVENT_JOURNAL_CAPACITY=<n>
+#ifndef EVENT_JOURNAL_CAPACITY
+#define EVENT_JOURNAL_CAPACITY 128
+#endif
+
+/**
+ * @brief Event types ("type" in the API, selectable with ?type=)
+ */
+enum EventType : uint8_t {
+    EVENT_BOOT = 0,           // code: esp_reset_reason(), text: reason name
+    EVENT_RESTART,            // Restart scheduled; code: delay in seconds
+    EVENT_STATE,              // Component state change; code: new state, text: "OLD->NEW"
+    EVENT_ERROR,              // Component error; text: message
+    EVENT_DOSE,               // Dose finished; value: ml dispensed, text: liquid
+    EVENT_RULE,               // Rule fired; code: 1 = action succeeded, text: rule name
+    EVENT_NETWORK,            // Link change; code: 1 = up
+    EVENT_RESOURCE,           // Resource governor level change; code: new level, text: "OLD->NEW reason"
+    EVENT_TYPE_COUNT
+};
+
+/**
+ * @brief One journal record (96 bytes)
+ */
+struct EventRecord {
+    uint32_t seq;             // 1-based, never reused
+    uint32_t uptimeMs;        // millis() when recorded
+    uint32_t epoch;           // Unix seconds, 0 before NTP sync
+    int32_t code;             // Type-specific integer
+    float value;              // Type-specific number
+    uint8_t type;             // EventType
+    uint8_t level;            // Logger::Level
+    uint16_t reserved;
+    char source[24];          // Component id or subsystem, truncated
+    char text[48];            // Detail, truncated
+};
+
+/**
+ * @brief Selection for query(): events after a cursor, filtered
+ */
+struct EventQuery {
+    uint32_t after = 0;       // Cursor: only events with seq > after
+    uint16_t limit = 50;
+    uint8_t minLevel = 0;     // Logger::Level
+    uint32_t typeMask = 0xFFFFFFFF;
+    String source;            // Empty = any
+};
+
+/**
+ * @brief Static event journal
+ */
+class EventJournal {
+public:
+    typedef std::function<void(const EventRecord& event)> Listener;
+
+    static const uint16_t CAPACITY = EVENT_JOURNAL_CAPACITY;
+    static const uint16_t PERSIST_SLOTS = 64;          // File size: header + 64 records (~6 KB)
+    static const uint8_t PERSIST_PER_MINUTE = 12;      // Flash writes allowed per minute
+    static const uint16_t MAX_QUERY = 100;
+    static const uint32_t SEQ_RESERVE = 1024;          // Numbers reserved per header write
+
+    /**
+     * @brief Reload persisted events and restore the sequence (after LittleFS is mounted)
+     *
+     * Records the boot event. Events recorded before begin() are kept.
+     */
+    static void begin();
+
+    /**
+     * @brief Record an event (any task, not from an ISR)
+     */
+    static void record(EventType type, uint8_t level, const char* source, const char* text,
+                       int32_t code = 0, float value = 0.0f);
+    static void record(EventType type, uint8_t level, const String& source, const String& text,
+                       int32_t code = 0, float value = 0.0f) {
+        record(type, level, source.c_str(), text.c_str(), code, value);
+    }
+
+    /**
+     * @brief Persist and hand new events to listeners (main task, each loop pass)
+     */
+    static void dispatch();
+
+    /**
+     * @brief Register a callback for new events, called from dispatch()
+     * @return Handle for removeListener()
+     */
+    static int addListener(Listener listener);
+    static void removeListener(int handle);
+
+    /**
+     * @brief Events after a cursor, as the /api/system/events response
+     *
+     * "next" is the cursor for the following call (events skipped by the
+     * filters are not examined again); "missed" counts events after the
+     * cursor that are no longer held (ring overwritten or lost in a reboot).
+     */
+    static JsonDocument query(const EventQuery& query);
+
+    /**
+     * @brief Copy matching events after a cursor
+     * @param next Receives the cursor for the following call
+     * @return Number of events copied
+     */
+    static size_t read(const EventQuery& query, std::vector<EventRecord>& events, uint32_t& next);
+
+    /**
+     * @brief Serialize one record
+     */
+    static void toJson(const EventRecord& event, JsonObject out);
+
+    /**
+     * @brief Parse a comma-separated type list ("state,error")
+     * @return Type mask (all types for an empty list)
+     */
+    static uint32_t parseTypes(const String& list);
+
+    /**
+     * @brief Parse a level name ("warning") or number
+     * @return Logger::Level value, DEBUG for unknown names
+     */
+    static uint8_t parseLevel(const String& name);
+
+    static uint32_t getLastSeq() { return s_lastSeq; }
+
+    /**
+     * @brief Ring usage, persistence and dispatch counters
+     */
+    static JsonDocument getStatus();
+
+private:
+    struct FileHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t recordBytes;
+        uint16_t slots;
+        uint16_t reserved;
+        uint32_t reservedSeq;    // Sequence numbers below this may have been handed out
+    };
+
+    static EventRecord s_events[CAPACITY];
+    static uint16_t s_write;             // Next ring slot
+    static uint16_t s_count;             // Records held
+    static uint32_t s_lastSeq;
+    static uint32_t s_dispatchedSeq;
+    static uint32_t s_reservedSeq;
+    static uint16_t s_persistSlot;       // Next file slot
+    static uint32_t s_persistWindowMs;
+    static uint8_t s_persistInWindow;
+    static bool s_persistReady;
+    static uint32_t s_persisted;
+    static uint32_t s_persistSkipped;    // Over the per-minute cap
+    static uint32_t s_overrun;           // Overwritten before dispatch()
+    static std::vector<std::pair<int, Listener>> s_listeners;
+    static int s_nextListener;
+
+    static void append(const EventRecord& event);
+    static size_t lowerBound(uint32_t seq);
+    static const EventRecord& at(size_t index);
+    static bool matches(const EventRecord& event, const EventQuery& query);
+    static bool shouldPersist(const EventRecord& event);
+    static void persist(const EventRecord& event);
+    static bool writeHeader();
+    static const char* typeName(uint8_t type);
+    static const char* levelName(uint8_t level);
+};
+
+#endif // EVENT_JOURNAL_H
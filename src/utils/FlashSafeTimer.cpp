@@ -0,0 +1,297 @@
+/**
+ * @file FlashSafeTimer.cpp
+ * @brief FlashSafeTimer implementation
+ */
+
+#include "FlashSafeTimer.h"
+#include "Logger.h"
+#include "../components/BaseComponent.h"
+#ifndef NATIVE_SIM
+#include <driver/timer.h>
+#include <soc/gpio_struct.h>
+
+// Group 1 timer 0 (Arduino timer 2); the sampling profiler owns timer 3
+#define FLASH_SAFE_TIMER_GROUP TIMER_GROUP_1
+#define FLASH_SAFE_TIMER_INDEX TIMER_0
+#endif
+
+// Out-of-line definitions for ODR-used constants
+const uint8_t FlashSafeTimer::MAX_CHANNELS;
+const uint8_t FlashSafeTimer::NO_PIN;
+const uint32_t FlashSafeTimer::MIN_LEAD_US;
+
+// Static member initialization (mutable statics live in DRAM, reachable with the cache off)
+FlashSafeTimer::Channel FlashSafeTimer::s_channels[FlashSafeTimer::MAX_CHANNELS] = {};
+bool FlashSafeTimer::s_initialized = false;
+bool FlashSafeTimer::s_iramSafe = true;
+volatile bool FlashSafeTimer::s_reconfiguring = false;
+volatile uint32_t FlashSafeTimer::s_fired = 0;
+volatile uint32_t FlashSafeTimer::s_maxLatencyUs = 0;
+volatile uint32_t FlashSafeTimer::s_lastLatencyUs = 0;
+volatile uint64_t FlashSafeTimer::s_totalLatencyUs = 0;
+
+static portMUX_TYPE s_timerLock = portMUX_INITIALIZER_UNLOCKED;
+
+bool FlashSafeTimer::isSupported() {
+#ifndef NATIVE_SIM
+    return true;
+#else
+    return false;
+#endif
+}
+
+void IRAM_ATTR FlashSafeTimer::writePin(uint8_t pin, uint8_t level) {
+#ifndef NATIVE_SIM
+    // Direct register writes; gpio_set_level() is not guaranteed to be in IRAM
+    if (pin < 32) {
+        if (level) GPIO.out_w1ts = (1UL << pin);
+        else GPIO.out_w1tc = (1UL << pin);
+    } else if (pin < 40) {
+        if (level) GPIO.out1_w1ts.val = (1UL << (pin - 32));
+        else GPIO.out1_w1tc.val = (1UL << (pin - 32));
+    }
+#else
+    (void)pin;
+    (void)level;
+#endif
+}
+
+uint64_t IRAM_ATTR FlashSafeTimer::nextDeadline() {
+    uint64_t next = UINT64_MAX;
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+        if (s_channels[i].armed && s_channels[i].deadline < next) {
+            next = s_channels[i].deadline;
+        }
+    }
+    return next;
+}
+
+bool IRAM_ATTR FlashSafeTimer::onAlarm(void* /*arg*/) {
+#ifndef NATIVE_SIM
+    uint64_t now = timer_group_get_counter_value_in_isr(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX);
+
+    portENTER_CRITICAL_ISR(&s_timerLock);
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+        Channel& channel = s_channels[i];
+        if (!channel.armed || channel.deadline > now) {
+            continue;
+        }
+        channel.armed = false;
+        if (channel.pin != NO_PIN) {
+            writePin(channel.pin, channel.level);
+        }
+
+        uint32_t lateUs = (uint32_t)(now - channel.deadline);
+        s_fired++;
+        s_lastLatencyUs = lateUs;
+        s_totalLatencyUs += lateUs;
+        if (lateUs > s_maxLatencyUs) s_maxLatencyUs = lateUs;
+
+        // Wake the owner's task; signal() is IRAM-safe and makes no RTOS calls
+        if (channel.notify) {
+            channel.notify->signal(channel.signalBits);
+        }
+    }
+
+    uint64_t next = nextDeadline();
+    if (next != UINT64_MAX) {
+        if (next < now + MIN_LEAD_US) next = now + MIN_LEAD_US;
+        timer_group_set_alarm_value_in_isr(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX, next);
+        timer_group_enable_alarm_in_isr(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX);
+    }
+    portEXIT_CRITICAL_ISR(&s_timerLock);
+#endif
+    return false;   // No task was unblocked, no yield needed
+}
+
+bool FlashSafeTimer::begin(bool iramSafe) {
+    if (!isSupported()) {
+        return false;
+    }
+
+#ifndef NATIVE_SIM
+    // Claim the switch under the lock: the benchmark task and a lazy armGpio() on the
+    // loop task may both get here, and nothing may be armed while the ISR is replaced
+    portENTER_CRITICAL(&s_timerLock);
+    if (s_reconfiguring) {
+        portEXIT_CRITICAL(&s_timerLock);
+        return false;
+    }
+    if (s_initialized && s_iramSafe == iramSafe) {
+        portEXIT_CRITICAL(&s_timerLock);
+        return true;
+    }
+    if (s_initialized) {
+        // Switching the interrupt allocation would drop armed deadlines
+        for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+            if (s_channels[i].armed) {
+                portEXIT_CRITICAL(&s_timerLock);
+                return false;
+            }
+        }
+    }
+    bool wasInitialized = s_initialized;
+    s_reconfiguring = true;
+    s_initialized = false;
+    portEXIT_CRITICAL(&s_timerLock);
+
+    // Driver calls allocate and may block, so they run outside the critical section
+    if (wasInitialized) {
+        timer_pause(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX);
+        timer_isr_callback_remove(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX);
+        timer_deinit(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX);
+    }
+
+    timer_config_t config = {};
+    config.divider = 80;                      // 80 MHz APB / 80 = 1 us ticks
+    config.counter_dir = TIMER_COUNT_UP;
+    config.counter_en = TIMER_PAUSE;
+    config.alarm_en = TIMER_ALARM_DIS;
+    config.auto_reload = TIMER_AUTORELOAD_DIS;
+    config.intr_type = TIMER_INTR_LEVEL;
+    if (timer_init(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX, &config) != ESP_OK) {
+        s_reconfiguring = false;
+        Logger::error("FlashTimer", "Cannot initialize the deadline timer");
+        return false;
+    }
+    timer_set_counter_value(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX, 0);
+
+    if (timer_isr_callback_add(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX, &FlashSafeTimer::onAlarm,
+                               nullptr, iramSafe ? ESP_INTR_FLAG_IRAM : 0) != ESP_OK) {
+        timer_deinit(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX);
+        s_reconfiguring = false;
+        Logger::error("FlashTimer", "Cannot allocate the deadline timer interrupt");
+        return false;
+    }
+    timer_start(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX);
+
+    portENTER_CRITICAL(&s_timerLock);
+    s_iramSafe = iramSafe;
+    s_initialized = true;
+    s_reconfiguring = false;
+    portEXIT_CRITICAL(&s_timerLock);
+    Logger::info("FlashTimer", String("Deadline timer ready (") +
+                 (iramSafe ? "IRAM interrupt" : "flash-blocked interrupt") + ")");
+    return true;
+#else
+    return false;
+#endif
+}
+
+int32_t FlashSafeTimer::armGpio(uint8_t pin, bool level, uint32_t delayUs,
+                                BaseComponent* notify, uint32_t signalBits) {
+    if (!s_initialized && !begin(true)) {
+        return -1;
+    }
+
+    int32_t handle = -1;
+    const char* refused = "All deadline channels in use";
+#ifndef NATIVE_SIM
+    portENTER_CRITICAL(&s_timerLock);
+    bool available = true;
+    if (!s_initialized || s_reconfiguring) {
+        // begin() on another task is replacing the interrupt
+        refused = "Deadline timer is being reconfigured";
+        available = false;
+    } else if (pin != NO_PIN && !s_iramSafe) {
+        // The self-benchmark's flash-blocked pass: a GPIO cut-off here would not be flash-safe
+        refused = "Deadline timer is in flash-blocked mode (self-benchmark)";
+        available = false;
+    }
+    uint64_t now = available ?
+        timer_group_get_counter_value_in_isr(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX) : 0;
+    for (uint8_t i = 0; available && i < MAX_CHANNELS; i++) {
+        Channel& channel = s_channels[i];
+        if (channel.armed) {
+            continue;
+        }
+        channel.pin = pin;
+        channel.level = level ? 1 : 0;
+        channel.generation++;
+        channel.deadline = now + delayUs;
+        channel.notify = notify;
+        channel.signalBits = signalBits;
+        channel.armed = true;
+        handle = ((int32_t)channel.generation << 8) | i;
+        break;
+    }
+
+    if (handle >= 0) {
+        uint64_t next = nextDeadline();
+        if (next < now + MIN_LEAD_US) next = now + MIN_LEAD_US;
+        timer_group_set_alarm_value_in_isr(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX, next);
+        timer_group_enable_alarm_in_isr(FLASH_SAFE_TIMER_GROUP, FLASH_SAFE_TIMER_INDEX);
+    }
+    portEXIT_CRITICAL(&s_timerLock);
+#else
+    (void)pin;
+    (void)level;
+    (void)delayUs;
+    (void)notify;
+    (void)signalBits;
+#endif
+
+    if (handle < 0) {
+        Logger::warning("FlashTimer", refused);
+    }
+    return handle;
+}
+
+bool FlashSafeTimer::cancel(int32_t handle) {
+    if (handle < 0) {
+        return false;
+    }
+
+    // A stale alarm left programmed for this channel just finds nothing due
+    bool wasPending = false;
+    portENTER_CRITICAL(&s_timerLock);
+    Channel& channel = s_channels[(handle & 0xFF) % MAX_CHANNELS];
+    if (channel.armed && channel.generation == (uint8_t)(handle >> 8)) {
+        channel.armed = false;
+        wasPending = true;
+    }
+    portEXIT_CRITICAL(&s_timerLock);
+    return wasPending;
+}
+
+bool FlashSafeTimer::isPending(int32_t handle) {
+    if (handle < 0) {
+        return false;
+    }
+    const Channel& channel = s_channels[(handle & 0xFF) % MAX_CHANNELS];
+    return channel.armed && channel.generation == (uint8_t)(handle >> 8);
+}
+
+JsonDocument FlashSafeTimer::getStats() {
+    JsonDocument stats;
+    uint8_t armed = 0;
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+        if (s_channels[i].armed) armed++;
+    }
+
+    portENTER_CRITICAL(&s_timerLock);
+    uint32_t fired = s_fired;
+    uint64_t totalLatencyUs = s_totalLatencyUs;
+    uint32_t maxLatencyUs = s_maxLatencyUs;
+    uint32_t lastLatencyUs = s_lastLatencyUs;
+    portEXIT_CRITICAL(&s_timerLock);
+
+    stats["supported"] = isSupported();
+    stats["initialized"] = s_initialized;
+    stats["iram_safe"] = s_iramSafe;
+    stats["armed"] = armed;
+    stats["fired"] = fired;
+    stats["last_latency_us"] = lastLatencyUs;
+    stats["max_latency_us"] = maxLatencyUs;
+    stats["avg_latency_us"] = fired ? (uint32_t)(totalLatencyUs / fired) : 0;
+    return stats;
+}
+
+void FlashSafeTimer::resetStats() {
+    portENTER_CRITICAL(&s_timerLock);
+    s_fired = 0;
+    s_maxLatencyUs = 0;
+    s_lastLatencyUs = 0;
+    s_totalLatencyUs = 0;
+    portEXIT_CRITICAL(&s_timerLock);
+}
@@ -0,0 +1,106 @@
+/**
+ * @file FlashSafeTimer.h
+ * @brief One-shot GPIO deadlines driven by an IRAM-resident timer interrupt
+ *
+ * While LittleFS writes or erases, the flash cache is off and every
+ * interrupt handler that lives in flash is held back until the operation
+ * completes - tens of milliseconds for a sector erase. Deadlines that move
+ * hardware (ending a pump dose, the relay safety cut-off) are therefore
+ * armed here: the handler and everything it touches are in IRAM/DRAM and
+ * the interrupt is allocated with ESP_INTR_FLAG_IRAM, so the GPIO changes
+ * on time even in the middle of a configuration save.
+ *
+ * One hardware timer serves MAX_CHANNELS deadlines; the alarm is always
+ * programmed for the earliest. The handler records how late each deadline
+ * was serviced, which is the worst-case ISR latency reported in stats and
+ * measured under flash load by the self-benchmark.
+ */
+
+#ifndef FLASH_SAFE_TIMER_H
+#define FLASH_SAFE_TIMER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+class BaseComponent;
+
+/**
+ * @brief Static deadline timer
+ */
+class FlashSafeTimer {
+public:
+    static const uint8_t MAX_CHANNELS = 8;
+    static const uint8_t NO_PIN = 0xFF;               // Deadline only: signal and latency probe
+    static const uint32_t MIN_LEAD_US = 20;           // Alarms closer than this are pushed out
+
+    /**
+     * @brief Allocate the timer interrupt (done lazily by the first armGpio())
+     *
+     * Safe to call from any task: a switch in progress on another task makes
+     * this call, and armGpio(), return false instead of racing it.
+     * @param iramSafe Allocate with ESP_INTR_FLAG_IRAM; false reproduces an ordinary,
+     *                 flash-blocked interrupt for latency comparisons
+     * @return false if unsupported, a switch is in progress, or a different mode is
+     *         requested while deadlines are armed
+     */
+    static bool begin(bool iramSafe = true);
+
+    /**
+     * @brief Drive a GPIO to a level after a delay, independent of the loop task and flash
+     * @param pin Output pin (already configured) or NO_PIN
+     * @param level Level to write at the deadline
+     * @param delayUs Delay from now
+     * @param notify Component whose signal() is raised at the deadline (optional)
+     * @param signalBits Signal bits for notify
+     * @return Handle for cancel()/isPending(), or -1 if no channel is free, the timer
+     *         is being reconfigured, or a GPIO deadline is asked for in flash-blocked mode
+     */
+    static int32_t armGpio(uint8_t pin, bool level, uint32_t delayUs,
+                           BaseComponent* notify = nullptr, uint32_t signalBits = 0);
+
+    /**
+     * @brief Cancel a pending deadline; no effect once it fired or the channel was reused
+     * @return true if the deadline was still pending
+     */
+    static bool cancel(int32_t handle);
+
+    /**
+     * @brief Check if a deadline has not fired yet
+     */
+    static bool isPending(int32_t handle);
+
+    static bool isSupported();
+    static bool isIramSafe() { return s_iramSafe; }
+
+    /**
+     * @brief Deadlines serviced and how late (max is the worst-case ISR latency)
+     */
+    static JsonDocument getStats();
+    static void resetStats();
+
+private:
+    struct Channel {
+        volatile bool armed;
+        uint8_t pin;
+        uint8_t level;
+        uint8_t generation;                           // Distinguishes reuses of the slot in handles
+        uint64_t deadline;                            // Timer counter, 1 tick = 1 us
+        BaseComponent* notify;
+        uint32_t signalBits;
+    };
+
+    static Channel s_channels[MAX_CHANNELS];
+    static bool s_initialized;
+    static bool s_iramSafe;
+    static volatile bool s_reconfiguring;            // begin() is replacing the interrupt
+    static volatile uint32_t s_fired;
+    static volatile uint32_t s_maxLatencyUs;
+    static volatile uint32_t s_lastLatencyUs;
+    static volatile uint64_t s_totalLatencyUs;
+
+    static bool onAlarm(void* arg);
+    static uint64_t nextDeadline();
+    static void writePin(uint8_t pin, uint8_t level);
+};
+
+#endif // FLASH_SAFE_TIMER_H
@@ -4,6 +4,7 @@
  */
 
 #include "HttpClientWrapper.h"
+#include "Tracer.h"
 
 HttpClientWrapper::HttpClientWrapper() {
     log(Logger::DEBUG, "HttpClientWrapper initialized");
@@ -14,8 +15,14 @@ HttpClientWrapper::~HttpClientWrapper() {
 }
 
 HttpResult HttpClientWrapper::get(const String& url, uint32_t timeoutMs) {
+    TRACE_SCOPE(TRACE_HTTP_CLIENT, "GET");
     HttpResult result;
     
+    // No link: defer without touching the URL's failure history
+    if (!m_linkUp) {
+        return linkDownResult();
+    }
+    
     // Check if URL is in backoff period
     if (isInBackoff(url)) {
         result.success = false;
@@ -80,8 +87,14 @@ HttpResult HttpClientWrapper::get(const String& url, uint32_t timeoutMs) {
 }
 
 HttpResult HttpClientWrapper::post(const String& url, const String& payload, const String& contentType, uint32_t timeoutMs) {
+    TRACE_SCOPE(TRACE_HTTP_CLIENT, "POST");
     HttpResult result;
     
+    // No link: defer without touching the URL's failure history
+    if (!m_linkUp) {
+        return linkDownResult();
+    }
+    
     // Check if URL is in backoff period
     if (isInBackoff(url)) {
         result.success = false;
@@ -192,11 +205,47 @@ JsonDocument HttpClientWrapper::getFailureStats() const {
     }
     
     stats["total_failed_urls"] = m_urlFailures.size();
+    stats["link_up"] = m_linkUp;
     stats["timestamp"] = millis();
     
     return stats;
 }
 
+void HttpClientWrapper::setLinkState(bool up) {
+    if (up == m_linkUp) {
+        return;
+    }
+    m_linkUp = up;
+    
+    if (!up) {
+        m_linkDownMs = millis();
+        log(Logger::INFO, "⏸️ Link down - HTTP requests deferred");
+        return;
+    }
+    
+    // Forgive failures caused by the outage rather than by the endpoint
+    size_t cleared = 0;
+    for (auto it = m_urlFailures.begin(); it != m_urlFailures.end();) {
+        if ((int32_t)(it->second.lastFailureMs - (m_linkDownMs - LINK_LOSS_GRACE_MS)) >= 0) {
+            it = m_urlFailures.erase(it);
+            cleared++;
+        } else {
+            ++it;
+        }
+    }
+    log(Logger::INFO, "▶️ Link up - HTTP requests resumed (" + String(cleared) + " backoffs cleared, down " +
+        String((millis() - m_linkDownMs) / 1000) + "s)");
+}
+
+HttpResult HttpClientWrapper::linkDownResult() const {
+    HttpResult result;
+    result.success = false;
+    result.shouldDefer = true;
+    result.error = "Network down";
+    result.nextRetryMs = millis() + LINK_DOWN_RETRY_MS;
+    return result;
+}
+
 void HttpClientWrapper::recordFailure(const String& url) {
     UrlFailureInfo& info = m_urlFailures[url];
     info.failureCount++;
@@ -47,6 +47,8 @@ private:
     std::map<String, UrlFailureInfo> m_urlFailures;
     HTTPClient m_httpClient;
     uint32_t m_defaultTimeoutMs = 5000;
+    bool m_linkUp = true;
+    uint32_t m_linkDownMs = 0;
     
     // Retry policy constants
     static const uint32_t MAX_ATTEMPTS = 5;
@@ -54,6 +56,8 @@ private:
     static const uint32_t MED_BACKOFF_MS = 600000;      // 10 minutes  
     static const uint32_t LONG_BACKOFF_MS = 1200000;    // 20 minutes
     static const uint32_t MAX_BACKOFF_MS = 3600000;     // 60 minutes
+    static const uint32_t LINK_DOWN_RETRY_MS = 5000;    // Suggested deferral while WiFi is down
+    static const uint32_t LINK_LOSS_GRACE_MS = 30000;   // Failures this close to a link loss are forgiven
     
 public:
     /**
@@ -115,6 +119,24 @@ public:
      * @param timeoutMs Default timeout in milliseconds
      */
     void setDefaultTimeout(uint32_t timeoutMs) { m_defaultTimeoutMs = timeoutMs; }
+    
+    /**
+     * @brief Pause or resume requests on WiFi link changes
+     * 
+     * While the link is down, requests return immediately with shouldDefer
+     * and are not counted as URL failures. When it comes back, failures
+     * recorded around the outage are cleared so URLs are not stuck in long
+     * backoffs caused by the network rather than the endpoint.
+     * 
+     * @param up true if the link is up
+     */
+    void setLinkState(bool up);
+    
+    /**
+     * @brief Check if requests are currently allowed by the link state
+     * @return true if the link is up
+     */
+    bool isLinkUp() const { return m_linkUp; }
 
 private:
     /**
@@ -137,6 +159,12 @@ private:
      */
     void updateFailureTracking(const String& url, UrlFailureInfo& info);
     
+    /**
+     * @brief Build the immediate result returned while the link is down
+     * @return Deferred result without failure tracking
+     */
+    HttpResult linkDownResult() const;
+    
     /**
      * @brief Log HTTP operation
      * @param level Log level
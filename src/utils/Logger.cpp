@@ -4,12 +4,15 @@
  */
 
 #include "Logger.h"
+#include "Tracer.h"
 #include <LittleFS.h>
 
 // Static member initialization
 Logger::Level Logger::s_currentLevel = Logger::INFO;
 bool Logger::s_initialized = false;
 bool Logger::s_fileLoggingEnabled = false;
+Logger::Level Logger::s_shedFloor = Logger::DEBUG;
+bool Logger::s_fileSuspended = false;
 uint32_t Logger::s_maxLogFileSize = 100 * 1024;  // 100KB default
 String Logger::s_logFilePath = "/logs/system.log";
 
@@ -44,6 +47,18 @@ void Logger::enableFileLogging(bool enabled, uint32_t maxLogFileSizeKB) {
     }
 }
 
+void Logger::shed(Level floor, bool suspendFile) {
+    s_shedFloor = floor;
+    s_fileSuspended = suspendFile;
+}
+
+bool Logger::isEnabled(Level level) {
+    #ifdef NDEBUG
+        if (level < WARNING) return false;
+    #endif
+    return level >= s_currentLevel && level >= s_shedFloor;
+}
+
 void Logger::debug(const char* component, const String& message) {
     log(DEBUG, component, message);
 }
@@ -71,7 +86,7 @@ void Logger::log(Level level, const char* component, const String& message) {
     #endif
     
     // Check if we should log this level
-    if (level < s_currentLevel) {
+    if (level < s_currentLevel || level < s_shedFloor) {
         return;
     }
     
@@ -80,6 +95,8 @@ void Logger::log(Level level, const char* component, const String& message) {
         init();
     }
     
+    TRACE_SCOPE(TRACE_LOG, levelToString(level));
+    
     // Get timestamp
     uint32_t timestamp = millis();
     uint32_t seconds = timestamp / 1000;
@@ -97,7 +114,7 @@ void Logger::log(Level level, const char* component, const String& message) {
                   message.c_str());
     
     // Also write to file if file logging is enabled
-    if (s_fileLoggingEnabled) {
+    if (s_fileLoggingEnabled && !s_fileSuspended) {
         writeToFile(level, component, message);
     }
 }
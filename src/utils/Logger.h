@@ -34,6 +34,8 @@ private:
     static Level s_currentLevel;
     static bool s_initialized;
     static bool s_fileLoggingEnabled;
+    static Level s_shedFloor;
+    static bool s_fileSuspended;
     static uint32_t s_maxLogFileSize;
     static String s_logFilePath;
 
@@ -57,6 +59,28 @@ public:
      */
     static void enableFileLogging(bool enabled, uint32_t maxLogFileSizeKB = 100);
 
+    /**
+     * @brief Drop output under resource pressure without changing the settings
+     * 
+     * Used by the resource governor; shed(DEBUG, false) restores the
+     * configured level and file logging.
+     * 
+     * @param floor Messages below this level are dropped
+     * @param suspendFile Skip writes to the log file
+     */
+    static void shed(Level floor, bool suspendFile);
+
+    /**
+     * @brief Check whether messages at a level would be emitted
+     * 
+     * Lets callers skip building expensive messages (e.g. serialized JSON)
+     * that would be discarded anyway.
+     * 
+     * @param level Log level to check
+     * @return true if the level is currently enabled
+     */
+    static bool isEnabled(Level level);
+
     /**
      * @brief Log a debug message
      * @param component Component name
@@ -0,0 +1,244 @@
+/**
+ * @file SamplingProfiler.cpp
+ * @brief SamplingProfiler implementation
+ */
+
+#include "SamplingProfiler.h"
+#include "Logger.h"
+#include <esp_heap_caps.h>
+#include <esp_ipc.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#ifdef __XTENSA__
+#include <freertos/xtensa_context.h>
+#endif
+
+// Out-of-line definitions for ODR-used constants
+const uint16_t SamplingProfiler::DEFAULT_HZ;
+const uint16_t SamplingProfiler::MAX_HZ;
+const uint16_t SamplingProfiler::DEFAULT_BUCKETS;
+const uint16_t SamplingProfiler::MAX_BUCKETS;
+const uint8_t SamplingProfiler::TIMER_NUMBER;
+const uint8_t SamplingProfiler::MAX_PROBES;
+
+// Static member initialization
+SamplingProfiler::Bucket* SamplingProfiler::s_buckets = nullptr;
+uint32_t SamplingProfiler::s_bucketMask = 0;
+volatile bool SamplingProfiler::s_running = false;
+bool SamplingProfiler::s_loopTaskOnly = true;
+uint8_t SamplingProfiler::s_core = 1;
+uint16_t SamplingProfiler::s_hz = SamplingProfiler::DEFAULT_HZ;
+void* SamplingProfiler::s_loopTask = nullptr;
+void* SamplingProfiler::s_idleTask = nullptr;
+hw_timer_t* SamplingProfiler::s_timer = nullptr;
+volatile uint32_t SamplingProfiler::s_samples = 0;
+volatile uint32_t SamplingProfiler::s_recorded = 0;
+volatile uint32_t SamplingProfiler::s_idle = 0;
+volatile uint32_t SamplingProfiler::s_otherTask = 0;
+volatile uint32_t SamplingProfiler::s_dropped = 0;
+uint32_t SamplingProfiler::s_startMs = 0;
+uint32_t SamplingProfiler::s_elapsedMs = 0;
+
+// FreeRTOS keeps the running TCB per core; its first member is pxTopOfStack,
+// which the interrupt entry code points at the interrupted task's XtExcFrame.
+extern "C" void* volatile pxCurrentTCB[portNUM_PROCESSORS];
+
+bool SamplingProfiler::isSupported() {
+#ifdef __XTENSA__
+    return true;
+#else
+    return false;
+#endif
+}
+
+void IRAM_ATTR SamplingProfiler::onTimer() {
+#ifdef __XTENSA__
+    s_samples++;
+
+    void* tcb = pxCurrentTCB[xPortGetCoreID()];
+    if (!tcb) {
+        return;
+    }
+    if (tcb == s_idleTask) {
+        s_idle++;
+        return;
+    }
+    if (s_loopTaskOnly && tcb != s_loopTask) {
+        s_otherTask++;
+        return;
+    }
+
+    const XtExcFrame* frame = *(const XtExcFrame* const*)tcb;
+    uint32_t pc = frame->pc;
+
+    // Open addressing on a Fibonacci hash of the address
+    uint32_t index = ((pc >> 1) * 2654435761u) & s_bucketMask;
+    for (uint8_t probe = 0; probe < MAX_PROBES; probe++) {
+        Bucket& bucket = s_buckets[index];
+        if (bucket.pc == pc) {
+            bucket.count++;
+            s_recorded++;
+            return;
+        }
+        if (bucket.pc == 0) {
+            bucket.pc = pc;
+            bucket.count = 1;
+            s_recorded++;
+            return;
+        }
+        index = (index + 1) & s_bucketMask;
+    }
+    s_dropped++;
+#endif
+}
+
+void SamplingProfiler::attachOnCore(void* /*arg*/) {
+    // The interrupt is allocated on the calling core, which is the one it samples
+    s_timer = timerBegin(TIMER_NUMBER, 80, true);   // 80 MHz APB / 80 = 1 us ticks
+    if (!s_timer) {
+        return;
+    }
+    timerAttachInterrupt(s_timer, &SamplingProfiler::onTimer, true);
+    timerAlarmWrite(s_timer, 1000000UL / s_hz, true);
+    timerAlarmEnable(s_timer);
+}
+
+void SamplingProfiler::detachOnCore(void* /*arg*/) {
+    if (!s_timer) {
+        return;
+    }
+    timerAlarmDisable(s_timer);
+    timerDetachInterrupt(s_timer);
+    timerEnd(s_timer);
+    s_timer = nullptr;
+}
+
+bool SamplingProfiler::start(uint16_t hz, bool loopTaskOnly, uint8_t core, uint16_t buckets) {
+    if (s_running || !isSupported() || core >= portNUM_PROCESSORS) {
+        return false;
+    }
+
+    if (hz < 100) hz = 100;
+    if (hz > MAX_HZ) hz = MAX_HZ;
+    if (buckets > MAX_BUCKETS) buckets = MAX_BUCKETS;
+    if (buckets < 64) buckets = 64;
+    uint32_t capacity = 1;
+    while (capacity * 2 <= buckets) capacity *= 2;
+
+    // The ISR touches the histogram, so it must live in internal RAM
+    if (capacity - 1 != s_bucketMask || !s_buckets) {
+        heap_caps_free(s_buckets);
+        s_bucketMask = 0;
+        s_buckets = (Bucket*)heap_caps_malloc(capacity * sizeof(Bucket), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (!s_buckets) {
+            Logger::warning("Profiler", String("Cannot allocate ") + capacity + " histogram buckets");
+            return false;
+        }
+        s_bucketMask = capacity - 1;
+    }
+    memset(s_buckets, 0, capacity * sizeof(Bucket));
+
+    s_samples = 0;
+    s_recorded = 0;
+    s_idle = 0;
+    s_otherTask = 0;
+    s_dropped = 0;
+    s_hz = hz;
+    s_core = core;
+    s_loopTaskOnly = loopTaskOnly;
+    s_loopTask = (void*)xTaskGetHandle("loopTask");
+    s_idleTask = (void*)xTaskGetIdleTaskHandleForCPU(core);
+
+    if (esp_ipc_call_blocking(core, &SamplingProfiler::attachOnCore, nullptr) != ESP_OK || !s_timer) {
+        Logger::error("Profiler", "Cannot attach the sampling timer");
+        return false;
+    }
+
+    s_running = true;
+    s_startMs = millis();
+    s_elapsedMs = 0;
+    Logger::info("Profiler", String("Sampling core ") + core + " at " + hz + " Hz (" +
+                 (loopTaskOnly ? "loop task" : "all tasks") + ", " + capacity + " buckets)");
+    return true;
+}
+
+void SamplingProfiler::stop() {
+    if (!s_running) {
+        return;
+    }
+    esp_ipc_call_blocking(s_core, &SamplingProfiler::detachOnCore, nullptr);
+    s_running = false;
+    s_elapsedMs = millis() - s_startMs;
+    Logger::info("Profiler", String("Sampling stopped: ") + s_samples + " samples, " + s_recorded + " recorded");
+}
+
+JsonDocument SamplingProfiler::getStatus() {
+    JsonDocument status;
+    uint32_t used = 0;
+    if (s_buckets) {
+        for (uint32_t i = 0; i <= s_bucketMask; i++) {
+            if (s_buckets[i].pc != 0) used++;
+        }
+    }
+
+    status["supported"] = isSupported();
+    status["running"] = (bool)s_running;
+    status["hz"] = s_hz;
+    status["core"] = s_core;
+    status["mode"] = s_loopTaskOnly ? "loop" : "all";
+    status["elapsed_ms"] = s_running ? millis() - s_startMs : s_elapsedMs;
+    status["samples"] = s_samples;
+    status["recorded"] = s_recorded;
+    status["idle"] = s_idle;
+    status["other_task"] = s_otherTask;
+    status["dropped"] = s_dropped;
+    status["buckets"] = s_buckets ? s_bucketMask + 1 : 0;
+    status["buckets_used"] = used;
+    return status;
+}
+
+size_t SamplingProfiler::write(DumpCursor& cursor, char* buffer, size_t maxLen) {
+    size_t used = 0;
+    char line[160];
+
+    while (cursor.stage < 2) {
+        int n = 0;
+        if (cursor.stage == 0) {
+            n = snprintf(line, sizeof(line),
+                         "# esp32-pc-profile v1\n"
+                         "# hz=%u core=%u mode=%s running=%u\n"
+                         "# samples=%u recorded=%u idle=%u other_task=%u dropped=%u\n",
+                         s_hz, s_core, s_loopTaskOnly ? "loop" : "all", s_running ? 1 : 0,
+                         s_samples, s_recorded, s_idle, s_otherTask, s_dropped);
+        } else {
+            if (!s_buckets || cursor.index > s_bucketMask) {
+                cursor.stage = 2;
+                break;
+            }
+            const Bucket& bucket = s_buckets[cursor.index];
+            if (bucket.pc == 0) {
+                cursor.index++;
+                continue;
+            }
+            n = snprintf(line, sizeof(line), "0x%08x %u\n", bucket.pc, bucket.count);
+        }
+
+        if (n <= 0) {
+            n = 0;
+        }
+        if ((size_t)n >= sizeof(line)) {
+            n = sizeof(line) - 1;
+        }
+        if (used + n > maxLen) {
+            break;
+        }
+        memcpy(buffer + used, line, n);
+        used += n;
+        if (cursor.stage == 0) {
+            cursor.stage = 1;
+        } else {
+            cursor.index++;
+        }
+    }
+    return used;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file SamplingProfiler.h
+ * @brief Statistical PC-sampling profiler driven by a hardware timer interrupt
+ *
+ * A timer ISR on the profiled core reads the program counter the running
+ * task was interrupted at and counts it in a fixed-size hash histogram.
+ * The dump is a list of raw addresses with sample counts; the host script
+ * scripts/symbolize_profile.py resolves them against firmware.elf into a
+ * flat profile, so hot spots show up without a JTAG probe.
+ *
+ * Code that runs with interrupts masked (critical sections, higher-level
+ * ISRs) cannot be sampled and is attributed to where interrupts reopen.
+ */
+
+#ifndef SAMPLING_PROFILER_H
+#define SAMPLING_PROFILER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/**
+ * @brief Static sampling profiler
+ */
+class SamplingProfiler {
+public:
+    static const uint16_t DEFAULT_HZ = 1000;
+    static const uint16_t MAX_HZ = 10000;
+    static const uint16_t DEFAULT_BUCKETS = 1024;
+    static const uint16_t MAX_BUCKETS = 4096;
+    static const uint8_t TIMER_NUMBER = 3;            // Group 1 timer 1, unused by the core
+    static const uint8_t MAX_PROBES = 8;              // Linear probing limit before a sample is dropped
+
+    /**
+     * @brief Start sampling
+     * @param hz Sampling frequency (clamped to 100..MAX_HZ)
+     * @param loopTaskOnly Only count samples that hit the Arduino loop task
+     * @param core Core whose running task is sampled
+     * @param buckets Histogram capacity (power of two, rounded down)
+     * @return false if already running, unsupported or out of memory
+     */
+    static bool start(uint16_t hz = DEFAULT_HZ, bool loopTaskOnly = true, uint8_t core = 1,
+                      uint16_t buckets = DEFAULT_BUCKETS);
+
+    /**
+     * @brief Stop sampling; the histogram is kept until the next start()
+     */
+    static void stop();
+
+    static bool isRunning() { return s_running; }
+
+    /**
+     * @brief Check if the target can be profiled (Xtensa cores only)
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Sample counters and histogram fill
+     */
+    static JsonDocument getStatus();
+
+    /**
+     * @brief Incremental text dump: '#' header lines, then "0x<pc> <count>" per address
+     */
+    struct DumpCursor {
+        uint32_t index = 0;       // Next histogram bucket
+        uint8_t stage = 0;        // 0 header, 1 buckets, 2 done
+    };
+
+    static size_t write(DumpCursor& cursor, char* buffer, size_t maxLen);
+
+private:
+    struct Bucket {
+        uint32_t pc;
+        uint32_t count;
+    };
+
+    static Bucket* s_buckets;
+    static uint32_t s_bucketMask;
+    static volatile bool s_running;
+    static bool s_loopTaskOnly;
+    static uint8_t s_core;
+    static uint16_t s_hz;
+    static void* s_loopTask;
+    static void* s_idleTask;
+    static hw_timer_t* s_timer;
+
+    static volatile uint32_t s_samples;       // Timer interrupts taken
+    static volatile uint32_t s_recorded;      // Counted in the histogram
+    static volatile uint32_t s_idle;          // Idle task was running
+    static volatile uint32_t s_otherTask;     // Another task was running (loop-task mode)
+    static volatile uint32_t s_dropped;       // Histogram full around this address
+    static uint32_t s_startMs;
+    static uint32_t s_elapsedMs;
+
+    static void onTimer();
+    static void attachOnCore(void* arg);
+    static void detachOnCore(void* arg);
+};
+
+#endif // SAMPLING_PROFILER_H
@@ -0,0 +1,298 @@
+/**
+ * @file SchemaValidator.cpp
+ * @brief SchemaValidator implementation
+ */
+
+#include "SchemaValidator.h"
+#include "Logger.h"
+#include <algorithm>
+#include <new>
+#include <stdarg.h>
+
+// Out-of-line definitions for ODR-used constants
+const uint16_t SchemaValidator::NO_STRING;
+const uint16_t SchemaValidator::UNBOUNDED;
+
+// Static member initialization
+std::vector<SchemaValidator*> SchemaValidator::s_validators;
+
+const SchemaValidator* SchemaValidator::find(const String& componentType) {
+    for (const SchemaValidator* validator : s_validators) {
+        if (validator->m_componentType == componentType) {
+            return validator;
+        }
+    }
+    return nullptr;
+}
+
+const SchemaValidator* SchemaValidator::compile(const String& componentType, const JsonDocument& schema) {
+    const SchemaValidator* existing = find(componentType);
+    if (existing) {
+        return existing;
+    }
+
+    SchemaValidator* validator = new (std::nothrow) SchemaValidator();
+    if (!validator) {
+        return nullptr;
+    }
+    validator->m_componentType = componentType;
+    if (!validator->build(schema)) {
+        delete validator;
+        Logger::error("Schema", "Cannot compile schema for " + componentType);
+        return nullptr;
+    }
+    s_validators.push_back(validator);
+
+    Logger::debug("Schema", "Compiled " + componentType + ": " + validator->m_rules.size() + " rules, " +
+                  validator->getFootprint() + " bytes");
+    return validator;
+}
+
+size_t SchemaValidator::getFootprint() const {
+    return sizeof(*this) + m_rules.capacity() * sizeof(Rule) +
+           m_enumValues.capacity() * sizeof(EnumValue) + m_strings.capacity();
+}
+
+uint16_t SchemaValidator::addString(const char* value) {
+    size_t offset = m_strings.size();
+    if (offset >= NO_STRING) {
+        return NO_STRING;
+    }
+    m_strings.insert(m_strings.end(), value, value + strlen(value) + 1);
+    return (uint16_t)offset;
+}
+
+SchemaValidator::ValueType SchemaValidator::parseType(const char* type) {
+    if (!type) return ANY;
+    if (strcmp(type, "integer") == 0) return INTEGER;
+    if (strcmp(type, "number") == 0) return NUMBER;
+    if (strcmp(type, "string") == 0) return STRING;
+    if (strcmp(type, "boolean") == 0) return BOOLEAN;
+    if (strcmp(type, "array") == 0) return ARRAY;
+    if (strcmp(type, "object") == 0) return OBJECT;
+    return ANY;
+}
+
+const char* SchemaValidator::typeName(uint8_t type) {
+    switch (type) {
+        case INTEGER: return "an integer";
+        case NUMBER: return "a number";
+        case STRING: return "a string";
+        case BOOLEAN: return "a boolean";
+        case ARRAY: return "an array";
+        case OBJECT: return "an object";
+        default: return "any value";
+    }
+}
+
+bool SchemaValidator::build(const JsonDocument& schema) {
+    JsonObjectConst properties = schema["properties"].as<JsonObjectConst>();
+    m_rules.reserve(properties.size());
+
+    for (JsonPairConst prop : properties) {
+        JsonObjectConst definition = prop.value().as<JsonObjectConst>();
+        Rule rule = {};
+        rule.name = addString(prop.key().c_str());
+        rule.type = parseType(definition["type"].as<const char*>());
+        rule.maxLength = UNBOUNDED;
+        if (rule.name == NO_STRING) {
+            return false;
+        }
+
+        // Draft-07 exclusive bounds are numbers; draft-04 style is a flag on minimum/maximum
+        if (definition["minimum"].is<double>()) {
+            rule.minimum = definition["minimum"].as<double>();
+            rule.flags |= HAS_MINIMUM;
+            if (definition["exclusiveMinimum"].is<bool>() && definition["exclusiveMinimum"].as<bool>()) rule.flags |= EXCLUSIVE_MINIMUM;
+        }
+        if (definition["exclusiveMinimum"].is<double>()) {
+            rule.minimum = definition["exclusiveMinimum"].as<double>();
+            rule.flags |= HAS_MINIMUM | EXCLUSIVE_MINIMUM;
+        }
+        if (definition["maximum"].is<double>()) {
+            rule.maximum = definition["maximum"].as<double>();
+            rule.flags |= HAS_MAXIMUM;
+            if (definition["exclusiveMaximum"].is<bool>() && definition["exclusiveMaximum"].as<bool>()) rule.flags |= EXCLUSIVE_MAXIMUM;
+        }
+        if (definition["exclusiveMaximum"].is<double>()) {
+            rule.maximum = definition["exclusiveMaximum"].as<double>();
+            rule.flags |= HAS_MAXIMUM | EXCLUSIVE_MAXIMUM;
+        }
+        if (definition["minLength"].is<uint16_t>()) {
+            rule.minLength = definition["minLength"].as<uint16_t>();
+        }
+        if (definition["maxLength"].is<uint16_t>()) {
+            rule.maxLength = definition["maxLength"].as<uint16_t>();
+        }
+
+        JsonArrayConst values = definition["enum"].as<JsonArrayConst>();
+        if (values.size() > 0) {
+            rule.enumFirst = (uint16_t)m_enumValues.size();
+            for (JsonVariantConst value : values) {
+                if (rule.enumCount == 0xFF) break;
+                EnumValue entry = {0, NO_STRING};
+                if (value.is<const char*>()) {
+                    entry.string = addString(value.as<const char*>());
+                    if (entry.string == NO_STRING) return false;
+                } else {
+                    entry.number = value.as<double>();
+                }
+                m_enumValues.push_back(entry);
+                rule.enumCount++;
+            }
+        }
+        m_rules.push_back(rule);
+    }
+
+    std::sort(m_rules.begin(), m_rules.end(), [this](const Rule& a, const Rule& b) {
+        return strcmp(str(a.name), str(b.name)) < 0;
+    });
+
+    for (JsonVariantConst required : schema["required"].as<JsonArrayConst>()) {
+        const char* name = required.as<const char*>();
+        Rule* rule = name ? const_cast<Rule*>(findRule(name, strlen(name))) : nullptr;
+        if (rule && !(rule->flags & REQUIRED)) {
+            rule->flags |= REQUIRED;
+            m_requiredCount++;
+        }
+    }
+
+    m_rules.shrink_to_fit();
+    m_enumValues.shrink_to_fit();
+    m_strings.shrink_to_fit();
+    return true;
+}
+
+const SchemaValidator::Rule* SchemaValidator::findRule(const char* key, size_t length) const {
+    size_t low = 0;
+    size_t high = m_rules.size();
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        const char* name = str(m_rules[mid].name);
+        int cmp = strncmp(name, key, length);
+        if (cmp == 0 && name[length] != '\0') {
+            cmp = 1;   // name is longer than the key
+        }
+        if (cmp == 0) {
+            return &m_rules[mid];
+        }
+        if (cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return nullptr;
+}
+
+bool SchemaValidator::fail(SchemaError* error, const char* field, size_t fieldLength, const char* format, ...) {
+    if (!error) {
+        return false;
+    }
+    if (fieldLength >= sizeof(error->field)) {
+        fieldLength = sizeof(error->field) - 1;
+    }
+    memcpy(error->field, field, fieldLength);
+    error->field[fieldLength] = '\0';
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(error->message, sizeof(error->message), format, args);
+    va_end(args);
+    return false;
+}
+
+bool SchemaValidator::checkValue(const Rule& rule, JsonVariantConst value, SchemaError* error) const {
+    const char* name = str(rule.name);
+    size_t nameLength = strlen(name);
+
+    bool typeOk = true;
+    switch (rule.type) {
+        case INTEGER: typeOk = value.is<JsonInteger>(); break;
+        case NUMBER: typeOk = value.is<double>(); break;
+        case STRING: typeOk = value.is<const char*>(); break;
+        case BOOLEAN: typeOk = value.is<bool>(); break;
+        case ARRAY: typeOk = value.is<JsonArrayConst>(); break;
+        case OBJECT: typeOk = value.is<JsonObjectConst>(); break;
+        default: break;
+    }
+    if (!typeOk) {
+        return fail(error, name, nameLength, "must be %s", typeName(rule.type));
+    }
+
+    if ((rule.flags & (HAS_MINIMUM | HAS_MAXIMUM)) && value.is<double>()) {
+        double number = value.as<double>();
+        if (rule.flags & HAS_MINIMUM) {
+            bool exclusive = rule.flags & EXCLUSIVE_MINIMUM;
+            if (exclusive ? number <= rule.minimum : number < rule.minimum) {
+                return fail(error, name, nameLength, "%g is below the %s %g", number,
+                            exclusive ? "exclusive minimum" : "minimum", rule.minimum);
+            }
+        }
+        if (rule.flags & HAS_MAXIMUM) {
+            bool exclusive = rule.flags & EXCLUSIVE_MAXIMUM;
+            if (exclusive ? number >= rule.maximum : number > rule.maximum) {
+                return fail(error, name, nameLength, "%g is above the %s %g", number,
+                            exclusive ? "exclusive maximum" : "maximum", rule.maximum);
+            }
+        }
+    }
+
+    if (value.is<const char*>() && (rule.minLength > 0 || rule.maxLength != UNBOUNDED)) {
+        size_t length = value.as<JsonString>().size();
+        if (length < rule.minLength) {
+            return fail(error, name, nameLength, "is %u characters, minimum %u", (unsigned)length, rule.minLength);
+        }
+        if (length > rule.maxLength) {
+            return fail(error, name, nameLength, "is %u characters, maximum %u", (unsigned)length, rule.maxLength);
+        }
+    }
+
+    if (rule.enumCount > 0) {
+        const char* text = value.as<const char*>();
+        for (uint16_t i = rule.enumFirst; i < rule.enumFirst + rule.enumCount; i++) {
+            const EnumValue& allowed = m_enumValues[i];
+            if (allowed.string != NO_STRING) {
+                if (text && strcmp(text, str(allowed.string)) == 0) return true;
+            } else if (!text && value.is<double>() && value.as<double>() == allowed.number) {
+                return true;
+            }
+        }
+        return fail(error, name, nameLength, "is not one of the %u allowed values", rule.enumCount);
+    }
+
+    return true;
+}
+
+bool SchemaValidator::validate(JsonVariantConst config, bool partial, SchemaError* error) const {
+    // A null configuration is an empty object: only the required check applies
+    if (!config.isNull() && !config.is<JsonObjectConst>()) {
+        return fail(error, "", 0, "configuration must be a JSON object");
+    }
+
+    uint16_t requiredSeen = 0;
+    for (JsonPairConst pair : config.as<JsonObjectConst>()) {
+        JsonString key = pair.key();
+        const Rule* rule = findRule(key.c_str(), key.size());
+        if (!rule) {
+            continue;
+        }
+        if (!checkValue(*rule, pair.value(), error)) {
+            return false;
+        }
+        if (rule->flags & REQUIRED) {
+            requiredSeen++;
+        }
+    }
+
+    if (!partial && requiredSeen < m_requiredCount) {
+        // Rare path: name the first missing key
+        for (const Rule& rule : m_rules) {
+            if ((rule.flags & REQUIRED) && config[str(rule.name)].isNull()) {
+                const char* name = str(rule.name);
+                return fail(error, name, strlen(name), "is required");
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file SchemaValidator.h
+ * @brief Component configuration schemas compiled into flat, heap-free validators
+ *
+ * getDefaultSchema() builds a JSON Schema document on every call, which
+ * is too slow and allocation-heavy to run on each configuration update.
+ * The first validation of a component type compiles its "properties" into
+ * a sorted table of fixed-size rules (type, numeric range, enum, string
+ * length) plus the "required" list; the table is kept for the lifetime of
+ * the firmware and shared by every instance of the type.
+ *
+ * validate() walks the configuration object once and finds each key's rule
+ * by binary search, so it runs in O(keys * log(rules)) without touching
+ * the heap. The first violation is reported as a field name and a message
+ * in caller-provided fixed buffers. Keys the schema does not describe are
+ * accepted (component_type and other bookkeeping live in the same file).
+ */
+
+#ifndef SCHEMA_VALIDATOR_H
+#define SCHEMA_VALIDATOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+
+/**
+ * @brief First violation found by SchemaValidator::validate()
+ */
+struct SchemaError {
+    char field[40];
+    char message[96];
+};
+
+/**
+ * @brief Compiled validator for one component type
+ */
+class SchemaValidator {
+public:
+    /**
+     * @brief Compiled validator of a component type, or nullptr if not compiled yet
+     */
+    static const SchemaValidator* find(const String& componentType);
+
+    /**
+     * @brief Compile a schema and keep it for the type (allocates once per type)
+     * @return Validator, or nullptr when out of memory
+     */
+    static const SchemaValidator* compile(const String& componentType, const JsonDocument& schema);
+
+    /**
+     * @brief Check a configuration against the compiled schema
+     * @param config Configuration object
+     * @param partial Update containing only changed keys: skip the "required" check
+     * @param error Receives the first violation (optional)
+     * @return true if valid
+     */
+    bool validate(JsonVariantConst config, bool partial = false, SchemaError* error = nullptr) const;
+
+    size_t getRuleCount() const { return m_rules.size(); }
+
+    /**
+     * @brief Bytes held by the compiled table (rules, names, enum values)
+     */
+    size_t getFootprint() const;
+
+private:
+    enum ValueType : uint8_t { ANY, INTEGER, NUMBER, STRING, BOOLEAN, ARRAY, OBJECT };
+
+    enum RuleFlags : uint8_t {
+        HAS_MINIMUM = 0x01,
+        HAS_MAXIMUM = 0x02,
+        EXCLUSIVE_MINIMUM = 0x04,
+        EXCLUSIVE_MAXIMUM = 0x08,
+        REQUIRED = 0x10
+    };
+
+    struct Rule {
+        double minimum;
+        double maximum;
+        uint16_t name;                // Offset of the key in m_strings
+        uint16_t minLength;
+        uint16_t maxLength;           // 0xFFFF = unbounded
+        uint16_t enumFirst;           // Index in m_enumValues
+        uint8_t enumCount;
+        uint8_t type;
+        uint8_t flags;
+    };
+
+    struct EnumValue {
+        double number;
+        uint16_t string;              // Offset in m_strings, NO_STRING for numbers
+    };
+
+    static const uint16_t NO_STRING = 0xFFFF;
+    static const uint16_t UNBOUNDED = 0xFFFF;
+
+    String m_componentType;
+    std::vector<Rule> m_rules;        // Sorted by name
+    std::vector<EnumValue> m_enumValues;
+    std::vector<char> m_strings;
+    uint16_t m_requiredCount = 0;
+
+    static std::vector<SchemaValidator*> s_validators;
+
+    bool build(const JsonDocument& schema);
+    uint16_t addString(const char* value);
+    const char* str(uint16_t offset) const { return &m_strings[offset]; }
+    const Rule* findRule(const char* key, size_t length) const;
+    bool checkValue(const Rule& rule, JsonVariantConst value, SchemaError* error) const;
+
+    static ValueType parseType(const char* type);
+    static const char* typeName(uint8_t type);
+    static bool fail(SchemaError* error, const char* field, size_t fieldLength, const char* format, ...);
+};
+
+#endif // SCHEMA_VALIDATOR_H
@@ -4,9 +4,80 @@
  */
 
 #include "TimeUtils.h"
+#include <esp_timer.h>
 
 // Static member initialization
 time_t TimeUtils::s_bootTime = 0;
+int64_t TimeUtils::s_epochOffsetUs = 0;
+bool TimeUtils::s_epochMapped = false;
+uint32_t TimeUtils::s_syncCount = 0;
+int64_t TimeUtils::s_lastSyncStepUs = 0;
+MonoTimeUs TimeUtils::s_lastSyncMono = 0;
+portMUX_TYPE TimeUtils::s_mappingLock = portMUX_INITIALIZER_UNLOCKED;
+
+MonoTimeUs TimeUtils::monoNowUs() {
+    return esp_timer_get_time();
+}
+
+MonoTimeUs TimeUtils::monoFromMillis(uint32_t millisTime) {
+    // millis() is the esp_timer count truncated to 32 bits, so the signed
+    // 32-bit distance to "now" places the stamp on the 64-bit timeline
+    MonoTimeUs now = monoNowUs();
+    uint32_t nowMs = (uint32_t)(now / 1000);
+    int32_t deltaMs = (int32_t)(millisTime - nowMs);
+    return now + (int64_t)deltaMs * 1000;
+}
+
+void TimeUtils::onNtpSync(struct timeval* tv) {
+    struct timeval current;
+    if (!tv) {
+        gettimeofday(&current, nullptr);
+        tv = &current;
+    }
+    
+    MonoTimeUs mono = monoNowUs();
+    int64_t offset = (int64_t)tv->tv_sec * 1000000LL + tv->tv_usec - mono;
+    
+    portENTER_CRITICAL(&s_mappingLock);
+    s_lastSyncStepUs = s_epochMapped ? offset - s_epochOffsetUs : 0;
+    s_epochOffsetUs = offset;
+    s_epochMapped = true;
+    s_lastSyncMono = mono;
+    s_syncCount++;
+    portEXIT_CRITICAL(&s_mappingLock);
+}
+
+bool TimeUtils::hasEpochMapping() {
+    return s_epochMapped;
+}
+
+int64_t TimeUtils::monoToEpochMs(MonoTimeUs mono) {
+    portENTER_CRITICAL(&s_mappingLock);
+    bool mapped = s_epochMapped;
+    int64_t offset = s_epochOffsetUs;
+    portEXIT_CRITICAL(&s_mappingLock);
+    
+    if (!mapped) {
+        return 0;
+    }
+    return (mono + offset) / 1000;
+}
+
+JsonDocument TimeUtils::getClockStats() {
+    JsonDocument stats;
+    MonoTimeUs now = monoNowUs();
+    
+    stats["mono_us"] = now;
+    stats["epoch_mapped"] = s_epochMapped;
+    stats["ntp_sync_count"] = s_syncCount;
+    if (s_epochMapped) {
+        stats["epoch_ms"] = monoToEpochMs(now);
+        stats["last_sync_age_s"] = (uint32_t)((now - s_lastSyncMono) / 1000000);
+        stats["last_sync_step_us"] = s_lastSyncStepUs;
+    }
+    
+    return stats;
+}
 
 time_t TimeUtils::getEpochTime() {
     time_t now = time(nullptr);
@@ -14,7 +85,7 @@ time_t TimeUtils::getEpochTime() {
         return now;  // NTP time available
     } else if (s_bootTime > 0) {
         // Fallback: boot time + elapsed seconds
-        return s_bootTime + (millis() / 1000);
+        return s_bootTime + (time_t)(monoNowUs() / 1000000);
     } else {
         return 0;  // No time reference available
     }
@@ -84,7 +155,7 @@ unsigned long TimeUtils::getBootMillis() {
 }
 
 unsigned long TimeUtils::getBootSeconds() {
-    return millis() / 1000;
+    return (unsigned long)(monoNowUs() / 1000000);
 }
 
 bool TimeUtils::isNTPAvailable() {
@@ -92,16 +163,12 @@ bool TimeUtils::isNTPAvailable() {
 }
 
 time_t TimeUtils::millisToEpoch(unsigned long millisTime) {
-    if (s_bootTime > 0) {
-        return s_bootTime + (millisTime / 1000);
+    if (s_epochMapped) {
+        return (time_t)(monoToEpochMs(monoFromMillis(millisTime)) / 1000);
     }
     
-    // Fallback: try to calculate from current time if NTP is available
-    time_t now = time(nullptr);
-    if (now > 0) {
-        unsigned long currentMillis = millis();
-        time_t calculatedBootTime = now - (currentMillis / 1000);
-        return calculatedBootTime + (millisTime / 1000);
+    if (s_bootTime > 0) {
+        return s_bootTime + (time_t)(monoFromMillis(millisTime) / 1000000);
     }
     
     return 0;  // Cannot convert without time reference
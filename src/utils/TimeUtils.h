@@ -10,10 +10,86 @@
 #define TIME_UTILS_H
 
 #include <Arduino.h>
+#include <ArduinoJson.h>
 #include <time.h>
+#include <sys/time.h>
+
+/**
+ * @brief Monotonic time in microseconds since boot
+ *
+ * Backed by the 64-bit esp_timer counter, so it does not wrap for the
+ * lifetime of the device (unlike the 32-bit millis(), which wraps after
+ * 49.7 days). Signed so that differences can be compared against zero.
+ */
+typedef int64_t MonoTimeUs;
 
 class TimeUtils {
 public:
+    // === Monotonic clock ===
+
+    /**
+     * @brief Get monotonic time
+     * @return Microseconds since boot
+     */
+    static MonoTimeUs monoNowUs();
+
+    /**
+     * @brief Get monotonic time in milliseconds (64-bit, never wraps)
+     * @return Milliseconds since boot
+     */
+    static uint64_t monoNowMs() { return (uint64_t)(monoNowUs() / 1000); }
+
+    /**
+     * @brief Extend a 32-bit millis() timestamp to monotonic time
+     *
+     * The stamp is interpreted relative to the current time, so it must lie
+     * within +/-24.8 days of now. This keeps `millis() + interval` schedules
+     * correct across the 49.7-day wrap.
+     *
+     * @param millisTime Timestamp from millis()
+     * @return Monotonic time of the stamp in microseconds
+     */
+    static MonoTimeUs monoFromMillis(uint32_t millisTime);
+
+    // === Wall-clock mapping ===
+
+    /**
+     * @brief Record an NTP sync (SNTP time-sync notification callback)
+     *
+     * Computes the offset between the monotonic clock and the epoch once per
+     * sync; conversions afterwards are a single addition.
+     *
+     * @param tv Time that was set, or nullptr to read the system clock
+     */
+    static void onNtpSync(struct timeval* tv);
+
+    /**
+     * @brief Check if a monotonic-to-epoch mapping is available
+     * @return true after the first NTP sync
+     */
+    static bool hasEpochMapping();
+
+    /**
+     * @brief Convert monotonic time to epoch milliseconds
+     * @param mono Monotonic time in microseconds
+     * @return Epoch milliseconds, or 0 if no NTP sync has happened yet
+     */
+    static int64_t monoToEpochMs(MonoTimeUs mono);
+
+    /**
+     * @brief Get current epoch time with millisecond precision
+     * @return Epoch milliseconds, or 0 if no NTP sync has happened yet
+     */
+    static int64_t getEpochMillis() { return monoToEpochMs(monoNowUs()); }
+
+    /**
+     * @brief Get clock and NTP sync statistics
+     * @return Sync count, last step and mapping state as JSON
+     */
+    static JsonDocument getClockStats();
+
+    // === Epoch / boot time (second resolution) ===
+
     /**
      * @brief Get current epoch timestamp (seconds since 1970)
      * @return Current epoch time, or 0 if NTP not available
@@ -53,7 +129,7 @@ public:
     
     /**
      * @brief Convert millis() timestamp to epoch time
-     * @param millisTime Timestamp from millis()
+     * @param millisTime Timestamp from millis() (within +/-24.8 days of now)
      * @return Epoch timestamp, or 0 if conversion not possible
      */
     static time_t millisToEpoch(unsigned long millisTime);
@@ -72,6 +148,14 @@ public:
 
 private:
     static time_t s_bootTime;  // Set by main.cpp during NTP initialization
+    
+    // Epoch mapping: epoch_us = mono_us + s_epochOffsetUs (written from the SNTP task)
+    static int64_t s_epochOffsetUs;
+    static bool s_epochMapped;
+    static uint32_t s_syncCount;
+    static int64_t s_lastSyncStepUs;   // Offset change applied by the last re-sync
+    static MonoTimeUs s_lastSyncMono;
+    static portMUX_TYPE s_mappingLock;
 };
 
 
@@ -0,0 +1,333 @@
+/**
+ * @file Tracer.cpp
+ * @brief Tracer implementation
+ */
+
+#include "Tracer.h"
+#include "Logger.h"
+#include <esp_timer.h>
+#include <stdio.h>
+#ifndef NATIVE_SIM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+// Out-of-line definitions for ODR-used constants
+const uint16_t Tracer::DEFAULT_EVENTS;
+const uint16_t Tracer::MAX_EVENTS;
+const uint8_t Tracer::MAX_TASKS;
+const uint8_t Tracer::MAX_NAMES;
+const uint8_t Tracer::NAME_LENGTH;
+const uint32_t Tracer::ALL_CATEGORIES;
+
+// Static member initialization
+std::atomic<TraceEvent*> Tracer::s_events(nullptr);
+uint32_t Tracer::s_capacity = 0;
+std::atomic<uint32_t> Tracer::s_head(0);
+std::atomic<uint32_t> Tracer::s_writers(0);
+volatile bool Tracer::s_recording = false;
+volatile uint32_t Tracer::s_categoryMask = Tracer::ALL_CATEGORIES;
+volatile bool Tracer::s_dumping = false;
+void* Tracer::s_taskHandles[Tracer::MAX_TASKS] = {};
+char Tracer::s_taskNames[Tracer::MAX_TASKS][Tracer::NAME_LENGTH] = {};
+std::atomic<uint8_t> Tracer::s_taskCount(0);
+char Tracer::s_names[Tracer::MAX_NAMES][Tracer::NAME_LENGTH] = {};
+uint8_t Tracer::s_nameCount = 0;
+
+static portMUX_TYPE s_nameLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Heap that must stay free after allocating the ring
+static const uint32_t HEAP_RESERVE_BYTES = 40000;
+static const uint8_t UNKNOWN_TASK = 0xFF;
+
+static const char* CATEGORY_NAMES[TRACE_CATEGORY_COUNT] = {
+    "orchestrator", "component", "action", "storage", "log", "http_client", "http_server"
+};
+
+bool Tracer::start(uint16_t events, uint32_t categoryMask) {
+    if (s_dumping) {
+        return false;
+    }
+
+    if (events > MAX_EVENTS) events = MAX_EVENTS;
+    if (events < 64) events = 64;
+    uint32_t capacity = 1;
+    while (capacity * 2 <= events) capacity *= 2;
+
+    s_recording = false;
+    TraceEvent* ring = detachRing();
+    if (capacity != s_capacity) {
+        free(ring);
+        ring = nullptr;
+        s_capacity = 0;
+
+        size_t bytes = capacity * sizeof(TraceEvent);
+        if (ESP.getMaxAllocHeap() < bytes || ESP.getFreeHeap() < bytes + HEAP_RESERVE_BYTES) {
+            Logger::warning("Tracer", String("Not enough heap for ") + capacity + " events");
+            return false;
+        }
+        ring = (TraceEvent*)malloc(bytes);
+        if (!ring) {
+            return false;
+        }
+        s_capacity = capacity;
+    }
+
+    memset(ring, 0, s_capacity * sizeof(TraceEvent));
+    s_head.store(0);
+    s_categoryMask = categoryMask ? categoryMask : ALL_CATEGORIES;
+    s_events.store(ring);
+    s_recording = true;
+
+    Logger::info("Tracer", String("Tracing started: ") + s_capacity + " events, " +
+                 (s_capacity * sizeof(TraceEvent)) + " bytes");
+    return true;
+}
+
+void Tracer::stop() {
+    if (!s_recording) {
+        return;
+    }
+    s_recording = false;
+    Logger::info("Tracer", String("Tracing stopped after ") + s_head.load() + " events");
+}
+
+bool Tracer::release() {
+    if (s_dumping) {
+        return false;
+    }
+    s_recording = false;
+    TraceEvent* ring = detachRing();
+    if (!ring) {
+        return true;
+    }
+
+    uint32_t bytes = s_capacity * sizeof(TraceEvent);
+    free(ring);
+    s_capacity = 0;
+    s_head.store(0);
+    Logger::info("Tracer", String("Trace ring released (") + bytes + " bytes)");
+    return true;
+}
+
+TraceEvent* Tracer::detachRing() {
+    // Recorders count themselves in before reading the pointer, so once it is swapped
+    // out and the count has drained, nothing can still write into the old ring
+    TraceEvent* events = s_events.exchange(nullptr);
+    while (s_writers.load() != 0) {
+        delay(1);
+    }
+    return events;
+}
+
+void Tracer::record(uint8_t category, char phase, const char* name) {
+    s_writers.fetch_add(1);
+    TraceEvent* events = s_events.load();
+    if (!events) {
+        s_writers.fetch_sub(1);
+        return;
+    }
+
+    uint32_t index = s_head.fetch_add(1, std::memory_order_relaxed);
+    TraceEvent& event = events[index & (s_capacity - 1)];
+    event.sequence = 0;
+    event.timestampUs = esp_timer_get_time();
+    event.name = name;
+    event.category = category;
+    event.phase = phase;
+#ifndef NATIVE_SIM
+    event.core = (uint8_t)xPortGetCoreID();
+#else
+    event.core = 0;
+#endif
+    event.task = currentTaskIndex();
+    std::atomic_thread_fence(std::memory_order_release);
+    event.sequence = index + 1;
+    s_writers.fetch_sub(1, std::memory_order_release);
+}
+
+uint8_t Tracer::currentTaskIndex() {
+#ifndef NATIVE_SIM
+    void* handle = (void*)xTaskGetCurrentTaskHandle();
+#else
+    void* handle = nullptr;
+#endif
+    uint8_t count = s_taskCount.load(std::memory_order_acquire);
+    if (count > MAX_TASKS) count = MAX_TASKS;
+    for (uint8_t i = 0; i < count; i++) {
+        if (s_taskHandles[i] == handle && s_taskNames[i][0] != '\0') {
+            return i;
+        }
+    }
+
+    // First event from this task: claim a slot and remember its name
+    uint8_t slot = s_taskCount.fetch_add(1);
+    if (slot >= MAX_TASKS) {
+        s_taskCount.store(MAX_TASKS);
+        return UNKNOWN_TASK;
+    }
+#ifndef NATIVE_SIM
+    const char* taskName = pcTaskGetTaskName(nullptr);
+#else
+    const char* taskName = "main";
+#endif
+    strncpy(s_taskNames[slot], taskName ? taskName : "task", NAME_LENGTH - 1);
+    s_taskNames[slot][NAME_LENGTH - 1] = '\0';
+    s_taskHandles[slot] = handle;
+    return slot;
+}
+
+const char* Tracer::internName(const String& name) {
+    const char* result = "component";
+
+    portENTER_CRITICAL(&s_nameLock);
+    for (uint8_t i = 0; i < s_nameCount; i++) {
+        if (strncmp(s_names[i], name.c_str(), NAME_LENGTH - 1) == 0) {
+            result = s_names[i];
+            portEXIT_CRITICAL(&s_nameLock);
+            return result;
+        }
+    }
+    if (s_nameCount < MAX_NAMES) {
+        char* slot = s_names[s_nameCount++];
+        size_t i = 0;
+        for (; i < NAME_LENGTH - 1 && i < name.length(); i++) {
+            char c = name[i];
+            slot[i] = (c == '"' || c == '\\' || c < 0x20) ? '_' : c;  // Keep the dump valid JSON
+        }
+        slot[i] = '\0';
+        result = slot;
+    }
+    portEXIT_CRITICAL(&s_nameLock);
+    return result;
+}
+
+uint32_t Tracer::parseCategories(const String& list) {
+    uint32_t mask = 0;
+    for (uint8_t i = 0; i < TRACE_CATEGORY_COUNT; i++) {
+        if (list.indexOf(CATEGORY_NAMES[i]) >= 0) {
+            mask |= 1u << i;
+        }
+    }
+    return mask ? mask : ALL_CATEGORIES;
+}
+
+const char* Tracer::categoryName(uint8_t category) {
+    return category < TRACE_CATEGORY_COUNT ? CATEGORY_NAMES[category] : "other";
+}
+
+JsonDocument Tracer::getStatus() {
+    JsonDocument status;
+    uint32_t head = s_head.load();
+
+    status["recording"] = (bool)s_recording;
+    status["capacity"] = s_capacity;
+    status["ring_bytes"] = s_capacity * sizeof(TraceEvent);
+    status["recorded"] = head;
+    status["buffered"] = head < s_capacity ? head : s_capacity;
+    status["overwritten"] = head > s_capacity ? head - s_capacity : 0;
+    status["tasks"] = s_taskCount.load() < MAX_TASKS ? s_taskCount.load() : MAX_TASKS;
+
+    JsonArray categories = status["categories"].to<JsonArray>();
+    for (uint8_t i = 0; i < TRACE_CATEGORY_COUNT; i++) {
+        if (s_categoryMask & (1u << i)) {
+            categories.add(CATEGORY_NAMES[i]);
+        }
+    }
+    return status;
+}
+
+bool Tracer::beginDump(DumpCursor& cursor) {
+    if (s_dumping) {
+        return false;
+    }
+    s_dumping = true;
+
+    // Freeze the ring so the dump is a consistent snapshot
+    cursor = DumpCursor();
+    cursor.resume = s_recording;
+    s_recording = false;
+
+    uint32_t head = s_head.load();
+    uint32_t count = head < s_capacity ? head : s_capacity;
+    cursor.next = head - count;
+    cursor.end = head;
+    return true;
+}
+
+void Tracer::endDump(DumpCursor& cursor) {
+    if (!s_dumping) {
+        return;
+    }
+    cursor.stage = 4;
+    s_dumping = false;
+    if (cursor.resume) {
+        s_recording = true;
+    }
+}
+
+size_t Tracer::write(DumpCursor& cursor, char* buffer, size_t maxLen) {
+    size_t used = 0;
+    char item[256];
+
+    while (cursor.stage < 4) {
+        // Render the next item on a copy; commit only if it fits this chunk
+        DumpCursor step = cursor;
+        int n = 0;
+
+        if (step.stage == 0) {
+            n = snprintf(item, sizeof(item),
+                         "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"source\":\"esp32-orchestrator\"},"
+                         "\"traceEvents\":[");
+            step.stage = 1;
+        } else if (step.stage == 1) {
+            uint8_t taskCount = s_taskCount.load() < MAX_TASKS ? s_taskCount.load() : MAX_TASKS;
+            if (step.taskIndex >= taskCount) {
+                cursor.stage = 2;
+                continue;
+            }
+            n = snprintf(item, sizeof(item),
+                         "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                         step.first ? "" : ",", step.taskIndex, s_taskNames[step.taskIndex]);
+            step.taskIndex++;
+            step.first = false;
+        } else if (step.stage == 2) {
+            TraceEvent* events = s_events.load();
+            if (step.next == step.end || !events) {
+                cursor.stage = 3;
+                continue;
+            }
+            const TraceEvent& event = events[step.next & (s_capacity - 1)];
+            if (event.sequence != step.next + 1 || !event.name) {
+                cursor.next++;  // Torn or overwritten slot
+                continue;
+            }
+            n = snprintf(item, sizeof(item),
+                         "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",%s\"ts\":%lld,\"pid\":1,\"tid\":%u,"
+                         "\"args\":{\"core\":%u}}",
+                         step.first ? "" : ",", event.name, categoryName(event.category), event.phase,
+                         event.phase == 'i' ? "\"s\":\"t\"," : "", (long long)event.timestampUs,
+                         event.task, event.core);
+            step.next++;
+            step.first = false;
+        } else {
+            n = snprintf(item, sizeof(item), "]}");
+            step.stage = 4;
+        }
+
+        if (n <= 0) {
+            cursor = step;
+            continue;
+        }
+        if ((size_t)n >= sizeof(item)) {
+            n = sizeof(item) - 1;
+        }
+        if (used + n > maxLen) {
+            break;
+        }
+        memcpy(buffer + used, item, n);
+        used += n;
+        cursor = step;
+    }
+    return used;
+}
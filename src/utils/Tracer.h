@@ -0,0 +1,181 @@
+/**
+ * @file Tracer.h
+ * @brief Span tracing into a RAM ring, exported in Chrome trace-event format
+ *
+ * Begin/end spans and instant events carry a monotonic microsecond
+ * timestamp, the recording task and the CPU core. Recording is lock-free
+ * (a slot increment and an in-flight count per event, any task) and costs
+ * a single flag test while tracing is off. The ring keeps the most recent events; the dump
+ * loads directly into chrome://tracing or ui.perfetto.dev.
+ *
+ * Event names are not copied: pass string literals, or a name obtained
+ * from internName() for runtime strings such as component ids.
+ */
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+
+/**
+ * @brief Event categories (Chrome "cat" field, selectable when starting)
+ */
+enum TraceCategory : uint8_t {
+    TRACE_ORCHESTRATOR = 0,   // Loop ticks, system checks
+    TRACE_COMPONENT,          // Component execute()
+    TRACE_ACTION,             // Component actions
+    TRACE_STORAGE,            // ConfigStorage file I/O
+    TRACE_LOG,                // Logger output
+    TRACE_HTTP_CLIENT,        // Outgoing HTTP requests
+    TRACE_HTTP_SERVER,        // Web server handlers
+    TRACE_CATEGORY_COUNT
+};
+
+/**
+ * @brief One ring slot (24 bytes on the ESP32)
+ */
+struct TraceEvent {
+    int64_t timestampUs;
+    const char* name;
+    uint32_t sequence;        // Index + 1 once written; detects slots torn by wrap-around
+    uint8_t category;
+    char phase;               // 'B' begin, 'E' end, 'i' instant
+    uint8_t core;
+    uint8_t task;             // Index into the task name table
+};
+
+/**
+ * @brief Static tracer
+ */
+class Tracer {
+public:
+    static const uint16_t DEFAULT_EVENTS = 1024;
+    static const uint16_t MAX_EVENTS = 4096;
+    static const uint8_t MAX_TASKS = 16;
+    static const uint8_t MAX_NAMES = 48;
+    static const uint8_t NAME_LENGTH = 24;
+    static const uint32_t ALL_CATEGORIES = (1u << TRACE_CATEGORY_COUNT) - 1;
+
+    /**
+     * @brief Allocate the ring (power of two, rounded down) and start recording
+     * @param events Ring capacity
+     * @param categoryMask Bit per TraceCategory to record
+     * @return false if the ring cannot be allocated without starving the heap
+     */
+    static bool start(uint16_t events = DEFAULT_EVENTS, uint32_t categoryMask = ALL_CATEGORIES);
+
+    /**
+     * @brief Stop recording; the ring is kept for dumping until the next start()
+     */
+    static void stop();
+
+    /**
+     * @brief Stop recording and free the ring (heap pressure)
+     *
+     * Yields until recorders already writing a slot are done; not from an ISR.
+     * @return false while a dump holds the ring
+     */
+    static bool release();
+
+    /**
+     * @brief Check if a category is being recorded (the only cost when tracing is off)
+     */
+    static inline bool isRecording(uint8_t category) {
+        return s_recording && (s_categoryMask & (1u << category));
+    }
+
+    static void begin(uint8_t category, const char* name) { if (isRecording(category)) record(category, 'B', name); }
+    static void end(uint8_t category, const char* name) { if (isRecording(category)) record(category, 'E', name); }
+    static void instant(uint8_t category, const char* name) { if (isRecording(category)) record(category, 'i', name); }
+
+    /**
+     * @brief Copy a runtime string into the permanent name table
+     * @param name Name to intern (truncated to NAME_LENGTH - 1)
+     * @return Stable pointer, or a generic name once the table is full
+     */
+    static const char* internName(const String& name);
+
+    /**
+     * @brief Parse a comma-separated category list ("component,storage")
+     * @return Category mask (ALL_CATEGORIES for an empty list)
+     */
+    static uint32_t parseCategories(const String& list);
+
+    /**
+     * @brief Recording status and ring usage
+     */
+    static JsonDocument getStatus();
+
+    /**
+     * @brief Incremental Chrome trace JSON writer over a frozen ring
+     *
+     * beginDump() pauses recording; call write() until it returns 0, then
+     * endDump() to resume (if recording was on).
+     */
+    struct DumpCursor {
+        uint32_t next = 0;        // Next ring index to emit
+        uint32_t end = 0;         // One past the last index
+        uint8_t stage = 0;        // 0 header, 1 task names, 2 events, 3 footer, 4 done
+        uint8_t taskIndex = 0;
+        bool first = true;
+        bool resume = false;
+    };
+
+    /**
+     * @return false if another dump is in progress
+     */
+    static bool beginDump(DumpCursor& cursor);
+    static size_t write(DumpCursor& cursor, char* buffer, size_t maxLen);
+    static void endDump(DumpCursor& cursor);
+
+private:
+    static std::atomic<TraceEvent*> s_events;
+    static uint32_t s_capacity;
+    static std::atomic<uint32_t> s_head;
+    static std::atomic<uint32_t> s_writers;   // Recorders between reading s_events and their last store
+    static volatile bool s_recording;
+    static volatile uint32_t s_categoryMask;
+    static volatile bool s_dumping;
+
+    static void* s_taskHandles[MAX_TASKS];
+    static char s_taskNames[MAX_TASKS][NAME_LENGTH];
+    static std::atomic<uint8_t> s_taskCount;
+
+    static char s_names[MAX_NAMES][NAME_LENGTH];
+    static uint8_t s_nameCount;
+
+    static void record(uint8_t category, char phase, const char* name);
+    static TraceEvent* detachRing();
+    static uint8_t currentTaskIndex();
+    static const char* categoryName(uint8_t category);
+};
+
+/**
+ * @brief RAII span: begin on construction, end on scope exit
+ */
+class TraceScope {
+public:
+    TraceScope(uint8_t category, const char* name) : m_category(category), m_name(name) {
+        Tracer::begin(category, name);
+    }
+    ~TraceScope() { Tracer::end(m_category, m_name); }
+
+private:
+    uint8_t m_category;
+    const char* m_name;
+};
+
+// Build with -DTRACE_DISABLED to compile the instrumentation out entirely
+#ifndef TRACE_DISABLED
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(category, name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(category, name)
+#define TRACE_INSTANT(category, name) Tracer::instant(category, name)
+#else
+#define TRACE_SCOPE(category, name) do {} while (0)
+#define TRACE_INSTANT(category, name) do {} while (0)
+#endif
+
+#endif // TRACER_H